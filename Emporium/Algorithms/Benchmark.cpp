@@ -0,0 +1,408 @@
+#include <Algorithms/Benchmark.h>
+
+#include <Algorithms/BitManipulation.h>
+#include <Algorithms/Compaction.h>
+#include <Algorithms/Parallel.h>
+#include <Algorithms/RadixSort.h>
+#include <Algorithms/Reduce.h>
+#include <Algorithms/Scan.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <random>
+
+namespace EMP
+{
+using Clock = std::chrono::steady_clock;
+
+static constexpr size_t VALUE_COUNT = 1 << 22;
+
+struct Timings
+{
+   double referenceMs = 0.0;  // Standard library
+   double singleMs    = 0.0;  // One thread
+   double parallelMs  = 0.0;  // Every hardware thread
+   bool matches       = true;
+};
+
+// Average time of func( threadCount ) over the iterations, prepare runs before each one untimed
+template <typename Prepare, typename Func>
+static double averageMs( uint32_t iterations, const Prepare& prepare, const Func& func )
+{
+   double totalMs = 0.0;
+   for( uint32_t i = 0; i < iterations; ++i )
+   {
+      prepare();
+
+      const auto start = Clock::now();
+      func();
+      totalMs += std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+   }
+
+   return totalMs / iterations;
+}
+
+static void report( const char* name, const Timings& timings, uint32_t threadCount )
+{
+   printf(
+       "Algorithms: %-20s std %8.3f ms, 1 thread %8.3f ms, %2u threads %8.3f ms, %s\n",
+       name,
+       timings.referenceMs,
+       timings.singleMs,
+       threadCount,
+       timings.parallelMs,
+       timings.matches ? "matches" : "MISMATCH" );
+}
+
+static bool isClose( float value, float reference )
+{
+   // Sums are accumulated in a different order than the reference
+   return std::abs( value - reference ) <= 1e-3f * std::max( std::abs( reference ), 1.0f );
+}
+
+// =================================================================================================
+// Sorts
+
+template <typename Key>
+static Timings benchmarkRadixSort( uint32_t iterations, const std::vector<Key>& sourceKeys )
+{
+   std::vector<uint32_t> sourceValues( sourceKeys.size() );
+   std::iota( sourceValues.begin(), sourceValues.end(), 0u );
+
+   // Sorting key-value pairs, the reference is stable as well to give the same payload order
+   std::vector<std::pair<Key, uint32_t>> referencePairs;
+   std::vector<Key> keys;
+   std::vector<uint32_t> values;
+
+   Timings timings;
+   timings.referenceMs = averageMs(
+       iterations,
+       [&]() {
+          referencePairs.resize( sourceKeys.size() );
+          for( size_t i = 0; i < sourceKeys.size(); ++i )
+          {
+             referencePairs[i] = {sourceKeys[i], sourceValues[i]};
+          }
+       },
+       [&]() {
+          std::stable_sort(
+              referencePairs.begin(),
+              referencePairs.end(),
+              []( const auto& a, const auto& b ) { return a.first < b.first; } );
+       } );
+
+   const auto prepare = [&]() {
+      keys   = sourceKeys;
+      values = sourceValues;
+   };
+   const auto matches = [&]() {
+      for( size_t i = 0; i < keys.size(); ++i )
+      {
+         if( keys[i] != referencePairs[i].first || values[i] != referencePairs[i].second )
+         {
+            return false;
+         }
+      }
+      return true;
+   };
+
+   timings.singleMs = averageMs( iterations, prepare, [&]() { RadixSort( keys, values, 1 ); } );
+   timings.matches  = matches();
+
+   timings.parallelMs = averageMs( iterations, prepare, [&]() { RadixSort( keys, values, 0 ); } );
+   timings.matches    = timings.matches && matches();
+
+   return timings;
+}
+
+// =================================================================================================
+// Scans
+
+template <typename T, typename Scan, typename ReferenceScan>
+static Timings benchmarkScan(
+    uint32_t iterations,
+    const std::vector<T>& source,
+    const Scan& scan,
+    const ReferenceScan& referenceScan )
+{
+   std::vector<T> reference( source.size() );
+   std::vector<T> result( source.size() );
+
+   const auto nothing = []() {};
+
+   Timings timings;
+   timings.referenceMs =
+       averageMs( iterations, nothing, [&]() { referenceScan( source, reference ); } );
+
+   const auto matches = [&]() {
+      for( size_t i = 0; i < result.size(); ++i )
+      {
+         if( !isClose( static_cast<float>( result[i] ), static_cast<float>( reference[i] ) ) )
+         {
+            return false;
+         }
+      }
+      return true;
+   };
+
+   timings.singleMs = averageMs( iterations, nothing, [&]() { scan( source, result, 1 ); } );
+   timings.matches  = matches();
+
+   timings.parallelMs = averageMs( iterations, nothing, [&]() { scan( source, result, 0 ); } );
+   timings.matches    = timings.matches && matches();
+
+   return timings;
+}
+
+// =================================================================================================
+// Reductions
+
+template <typename T, typename Reduce, typename ReferenceReduce>
+static Timings benchmarkReduce(
+    uint32_t iterations,
+    const std::vector<T>& source,
+    const Reduce& reduce,
+    const ReferenceReduce& referenceReduce )
+{
+   const auto nothing = []() {};
+
+   double reference = 0.0;
+   double result    = 0.0;
+
+   Timings timings;
+   timings.referenceMs =
+       averageMs( iterations, nothing, [&]() { reference = referenceReduce( source ); } );
+
+   timings.singleMs = averageMs( iterations, nothing, [&]() { result = reduce( source, 1 ); } );
+   timings.matches  = isClose( static_cast<float>( result ), static_cast<float>( reference ) );
+
+   timings.parallelMs = averageMs( iterations, nothing, [&]() { result = reduce( source, 0 ); } );
+   timings.matches =
+       timings.matches && isClose( static_cast<float>( result ), static_cast<float>( reference ) );
+
+   return timings;
+}
+
+// =================================================================================================
+// Compaction and partition
+
+template <typename Split, typename ReferenceSplit>
+static Timings benchmarkSplit(
+    uint32_t iterations,
+    const std::vector<uint32_t>& source,
+    const std::vector<uint8_t>& flags,
+    const Split& split,
+    const ReferenceSplit& referenceSplit )
+{
+   std::vector<uint32_t> reference( source.size() );
+   std::vector<uint32_t> result( source.size() );
+   size_t referenceCount = 0;
+   size_t resultCount    = 0;
+
+   const auto nothing = []() {};
+
+   Timings timings;
+   timings.referenceMs = averageMs(
+       iterations,
+       nothing,
+       [&]() { referenceCount = referenceSplit( source, flags, reference ); } );
+
+   const auto matches = [&]() { return resultCount == referenceCount && result == reference; };
+
+   timings.singleMs =
+       averageMs( iterations, nothing, [&]() { resultCount = split( source, flags, result, 1 ); } );
+   timings.matches = matches();
+
+   timings.parallelMs =
+       averageMs( iterations, nothing, [&]() { resultCount = split( source, flags, result, 0 ); } );
+   timings.matches = timings.matches && matches();
+
+   return timings;
+}
+
+void BenchmarkAlgorithms( uint32_t iterations )
+{
+   const uint32_t threadCount = ThreadCountFor( VALUE_COUNT, 0 );
+
+   printf( "Algorithms: %zu values, %u iterations\n", VALUE_COUNT, iterations );
+
+   std::mt19937_64 generator( 42 );
+
+   std::vector<uint32_t> keys32( VALUE_COUNT );
+   std::vector<uint64_t> keys64( VALUE_COUNT );
+   std::vector<uint32_t> smallValues( VALUE_COUNT );
+   std::vector<float> floats( VALUE_COUNT );
+   std::vector<uint8_t> flags( VALUE_COUNT );
+
+   // Positive so that the running sums grow away from 0 and compare with a relative tolerance
+   std::uniform_real_distribution<float> floatDistribution( 0.0f, 1.0f );
+   for( size_t i = 0; i < VALUE_COUNT; ++i )
+   {
+      const uint64_t random = generator();
+
+      keys32[i]      = static_cast<uint32_t>( random );
+      keys64[i]      = random;
+      smallValues[i] = static_cast<uint32_t>( random % 16 );
+      floats[i]      = floatDistribution( generator );
+
+      // Runs of visible and culled values, like neighbouring objects tend to be
+      flags[i] = ( ( i / 64 ) + ( random % 8 == 0 ) ) % 2 == 0;
+   }
+
+   report( "radix sort 32", benchmarkRadixSort( iterations, keys32 ), threadCount );
+   report( "radix sort 64", benchmarkRadixSort( iterations, keys64 ), threadCount );
+
+   report(
+       "inclusive scan u32",
+       benchmarkScan(
+           iterations,
+           smallValues,
+           []( const auto& in, auto& out, uint32_t threads ) {
+              InclusiveScan( in.data(), out.data(), in.size(), threads );
+           },
+           []( const auto& in, auto& out ) {
+              std::partial_sum( in.begin(), in.end(), out.begin() );
+           } ),
+       threadCount );
+
+   report(
+       "exclusive scan u32",
+       benchmarkScan(
+           iterations,
+           smallValues,
+           []( const auto& in, auto& out, uint32_t threads ) {
+              ExclusiveScan( in.data(), out.data(), in.size(), threads );
+           },
+           []( const auto& in, auto& out ) {
+              std::exclusive_scan( in.begin(), in.end(), out.begin(), 0u );
+           } ),
+       threadCount );
+
+   report(
+       "inclusive scan f32",
+       benchmarkScan(
+           iterations,
+           floats,
+           []( const auto& in, auto& out, uint32_t threads ) {
+              InclusiveScan( in.data(), out.data(), in.size(), threads );
+           },
+           []( const auto& in, auto& out ) {
+              std::partial_sum( in.begin(), in.end(), out.begin() );
+           } ),
+       threadCount );
+
+   report(
+       "sum u32",
+       benchmarkReduce(
+           iterations,
+           smallValues,
+           []( const auto& in, uint32_t threads ) {
+              return static_cast<double>( ReduceSum( in.data(), in.size(), threads ) );
+           },
+           []( const auto& in ) {
+              return static_cast<double>( std::accumulate( in.begin(), in.end(), uint64_t( 0 ) ) );
+           } ),
+       threadCount );
+
+   report(
+       "sum f32",
+       benchmarkReduce(
+           iterations,
+           floats,
+           []( const auto& in, uint32_t threads ) {
+              return static_cast<double>( ReduceSum( in.data(), in.size(), threads ) );
+           },
+           []( const auto& in ) {
+              return static_cast<double>( std::accumulate( in.begin(), in.end(), 0.0f ) );
+           } ),
+       threadCount );
+
+   report(
+       "max f32",
+       benchmarkReduce(
+           iterations,
+           floats,
+           []( const auto& in, uint32_t threads ) {
+              return static_cast<double>( ReduceMax( in.data(), in.size(), threads ) );
+           },
+           []( const auto& in ) {
+              return static_cast<double>( *std::max_element( in.begin(), in.end() ) );
+           } ),
+       threadCount );
+
+   report(
+       "compact",
+       benchmarkSplit(
+           iterations,
+           keys32,
+           flags,
+           []( const auto& in, const auto& inFlags, auto& out, uint32_t threads ) {
+              return Compact( in.data(), inFlags.data(), in.size(), out.data(), threads );
+           },
+           []( const auto& in, const auto& inFlags, auto& out ) {
+              size_t count = 0;
+              for( size_t i = 0; i < in.size(); ++i )
+              {
+                 if( inFlags[i] )
+                 {
+                    out[count++] = in[i];
+                 }
+              }
+              return count;
+           } ),
+       threadCount );
+
+   report(
+       "partition",
+       benchmarkSplit(
+           iterations,
+           keys32,
+           flags,
+           []( const auto& in, const auto& inFlags, auto& out, uint32_t threads ) {
+              return Partition( in.data(), inFlags.data(), in.size(), out.data(), threads );
+           },
+           []( const auto& in, const auto& inFlags, auto& out ) {
+              // Indices go through the standard partition so that the flags can be looked up
+              std::vector<uint32_t> indices( in.size() );
+              std::iota( indices.begin(), indices.end(), 0u );
+              const auto split = std::stable_partition(
+                  indices.begin(), indices.end(), [&]( uint32_t i ) { return inFlags[i] != 0; } );
+
+              for( size_t i = 0; i < indices.size(); ++i )
+              {
+                 out[i] = in[indices[i]];
+              }
+              return static_cast<size_t>( split - indices.begin() );
+           } ),
+       threadCount );
+
+   // Against the previous scalar version, one division per index
+   std::vector<uint32_t> reversed( VALUE_COUNT );
+   std::vector<uint32_t> reference( VALUE_COUNT );
+
+   Timings timings;
+   timings.referenceMs = averageMs(
+       iterations,
+       []() {},
+       [&]() {
+          for( uint32_t i = 0, j = 0; i < VALUE_COUNT; ++i )
+          {
+             reference[i] = j;
+
+             const uint32_t mask = i ^ ( i + 1 );
+             j ^= VALUE_COUNT - VALUE_COUNT / ( mask + 1 );
+          }
+       } );
+   timings.singleMs = averageMs(
+       iterations,
+       []() {},
+       [&]() { BitReversedIndices( reversed.data(), VALUE_COUNT ); } );
+   timings.parallelMs = timings.singleMs;
+   timings.matches    = reversed == reference;
+
+   report( "bit-reversed indices", timings, 1 );
+}
+}
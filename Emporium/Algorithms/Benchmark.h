@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+
+namespace EMP
+{
+// Times every algorithm on one thread and on all of them against its standard library
+// counterpart, checking that the results match, and prints the average of the iterations
+void BenchmarkAlgorithms( uint32_t iterations );
+}
@@ -1,30 +1,110 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
+#include <emmintrin.h>
+
 namespace EMP
 {
-template <typename T>
-void BitReversalPermutation( std::vector<T>& values )
+// Reverses the bitCount low bits of four values at once, the bits above have to be 0
+inline __m128i BitReverse( __m128i values, uint32_t bitCount )
+{
+   const __m128i odd     = _mm_set1_epi32( 0x55555555 );
+   const __m128i pairs   = _mm_set1_epi32( 0x33333333 );
+   const __m128i nibbles = _mm_set1_epi32( 0x0F0F0F0F );
+   const __m128i bytes   = _mm_set1_epi32( 0x00FF00FF );
+
+   // Swapping neighbouring bits, then pairs, nibbles, bytes and halves reverses all 32 bits
+   values = _mm_or_si128(
+       _mm_and_si128( _mm_srli_epi32( values, 1 ), odd ),
+       _mm_slli_epi32( _mm_and_si128( values, odd ), 1 ) );
+   values = _mm_or_si128(
+       _mm_and_si128( _mm_srli_epi32( values, 2 ), pairs ),
+       _mm_slli_epi32( _mm_and_si128( values, pairs ), 2 ) );
+   values = _mm_or_si128(
+       _mm_and_si128( _mm_srli_epi32( values, 4 ), nibbles ),
+       _mm_slli_epi32( _mm_and_si128( values, nibbles ), 4 ) );
+   values = _mm_or_si128(
+       _mm_and_si128( _mm_srli_epi32( values, 8 ), bytes ),
+       _mm_slli_epi32( _mm_and_si128( values, bytes ), 8 ) );
+   values = _mm_or_si128( _mm_srli_epi32( values, 16 ), _mm_slli_epi32( values, 16 ) );
+
+   return _mm_srl_epi32( values, _mm_cvtsi32_si128( 32 - static_cast<int>( bitCount ) ) );
+}
+
+// Bits needed for the indices of a power of two count of values
+inline uint32_t IndexBitCount( size_t count )
 {
-   // Bit reversal only valid for integral types for now
-   static_assert( std::is_integral_v<T> );
+   assert(
+       count > 0 && ( count & ( count - 1 ) ) == 0 &&
+       "BitManipulation: Bit reversal needs a power of two count" );
 
-   for( uint32_t i = 0, j = 0; i < values.size(); i++ )
+   uint32_t bitCount = 0;
+   while( ( size_t( 1 ) << bitCount ) < count )
    {
-      if( i < j )
+      ++bitCount;
+   }
+   return bitCount;
+}
+
+// pIndices[i] is i with its bits reversed, four indices at a time
+inline void BitReversedIndices( uint32_t* pIndices, uint32_t count )
+{
+   const uint32_t bitCount = IndexBitCount( count );
+   if( count < 4 )
+   {
+      // Reversing a single bit changes nothing
+      for( uint32_t i = 0; i < count; ++i )
       {
-         std::swap( values[i], values[j] );
+         pIndices[i] = i;
       }
+      return;
+   }
 
-      // Compute a mask of LSBs.
-      const uint32_t mask = i ^ ( i + 1 );
+   const __m128i step = _mm_set1_epi32( 4 );
+   __m128i indices    = _mm_setr_epi32( 0, 1, 2, 3 );
+   for( uint32_t i = 0; i < count; i += 4 )
+   {
+      const __m128i reversed = BitReverse( indices, bitCount );
+      _mm_storeu_si128( reinterpret_cast<__m128i*>( pIndices + i ), reversed );
 
-      // Using division to bit-reverse a single bit.
-      const uint32_t rev = static_cast<uint32_t>( values.size() ) / ( mask + 1 );
+      indices = _mm_add_epi32( indices, step );
+   }
+}
+
+// Moves every value to the index with the bits of its own reversed, the count has to be a power
+// of two
+template <typename T>
+void BitReversalPermutation( std::vector<T>& values )
+{
+   const uint32_t count = static_cast<uint32_t>( values.size() );
+   if( count < 4 )
+   {
+      return;
+   }
+
+   const uint32_t bitCount = IndexBitCount( count );
+
+   // Every pair is swapped once, from its lower index
+   const __m128i step = _mm_set1_epi32( 4 );
+   __m128i indices    = _mm_setr_epi32( 0, 1, 2, 3 );
+   for( uint32_t i = 0; i < count; i += 4 )
+   {
+      alignas( 16 ) uint32_t reversed[4];
+      _mm_store_si128( reinterpret_cast<__m128i*>( reversed ), BitReverse( indices, bitCount ) );
+
+      for( uint32_t lane = 0; lane < 4; ++lane )
+      {
+         if( i + lane < reversed[lane] )
+         {
+            std::swap( values[i + lane], values[reversed[lane]] );
+         }
+      }
 
-      // XOR with mask.
-      j ^= values.size() - rev;
+      indices = _mm_add_epi32( indices, step );
    }
 }
 }
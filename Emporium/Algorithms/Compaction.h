@@ -0,0 +1,178 @@
+#pragma once
+
+#include <Algorithms/Parallel.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <emmintrin.h>
+
+// Stream compaction and partition driven by one flag byte per value, culling results for example.
+// Flags are tested sixteen at a time with SSE2, runs where they all agree are copied in bulk. Both
+// are split over threadCount threads, 0 using every hardware thread, and keep the values in order.
+namespace EMP
+{
+namespace detail
+{
+// Bit i is set when flag i is not 0
+inline uint32_t FlagMask16( const uint8_t* pFlags )
+{
+   const __m128i flags  = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pFlags ) );
+   const __m128i isZero = _mm_cmpeq_epi8( flags, _mm_setzero_si128() );
+   return ~static_cast<uint32_t>( _mm_movemask_epi8( isZero ) ) & 0xFFFF;
+}
+
+inline size_t CountFlags( const uint8_t* pFlags, size_t begin, size_t end )
+{
+   // Flags are turned into 0 or 1 bytes, which SAD against zero sums eight at a time
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i ones = _mm_set1_epi8( 1 );
+   __m128i counts     = zero;
+
+   size_t i = begin;
+   for( ; i + 16 <= end; i += 16 )
+   {
+      const __m128i flags = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pFlags + i ) );
+      const __m128i isSet = _mm_andnot_si128( _mm_cmpeq_epi8( flags, zero ), ones );
+      counts              = _mm_add_epi64( counts, _mm_sad_epu8( isSet, zero ) );
+   }
+
+   alignas( 16 ) uint64_t lanes[2];
+   _mm_store_si128( reinterpret_cast<__m128i*>( lanes ), counts );
+
+   size_t count = static_cast<size_t>( lanes[0] + lanes[1] );
+   for( ; i < end; ++i )
+   {
+      count += pFlags[i] != 0;
+   }
+
+   return count;
+}
+
+// Copies the values of a range with a flag to pKept and the others to pRejected, which can be
+// null. Returns the end of the kept values.
+template <typename T>
+T* Split( const T* pIn, const uint8_t* pFlags, size_t begin, size_t end, T* pKept, T* pRejected )
+{
+   size_t i = begin;
+   for( ; i + 16 <= end; i += 16 )
+   {
+      const uint32_t mask = FlagMask16( pFlags + i );
+      if( mask == 0xFFFF )
+      {
+         pKept = std::copy( pIn + i, pIn + i + 16, pKept );
+      }
+      else if( mask == 0 )
+      {
+         if( pRejected )
+         {
+            pRejected = std::copy( pIn + i, pIn + i + 16, pRejected );
+         }
+      }
+      else
+      {
+         for( uint32_t lane = 0; lane < 16; ++lane )
+         {
+            if( mask & ( 1u << lane ) )
+            {
+               *pKept++ = pIn[i + lane];
+            }
+            else if( pRejected )
+            {
+               *pRejected++ = pIn[i + lane];
+            }
+         }
+      }
+   }
+
+   for( ; i < end; ++i )
+   {
+      if( pFlags[i] )
+      {
+         *pKept++ = pIn[i];
+      }
+      else if( pRejected )
+      {
+         *pRejected++ = pIn[i];
+      }
+   }
+
+   return pKept;
+}
+
+// Kept values first, then the rejected ones when partitioning. Returns the number of kept values.
+template <typename T>
+size_t SplitParallel(
+    const T* pIn,
+    const uint8_t* pFlags,
+    size_t count,
+    T* pOut,
+    bool partition,
+    uint32_t maxThreads )
+{
+   const uint32_t threadCount = ThreadCountFor( count, maxThreads );
+   if( threadCount == 1 && !partition )
+   {
+      return Split<T>( pIn, pFlags, 0, count, pOut, nullptr ) - pOut;
+   }
+
+   // Counting the flags of every range first tells where each range writes to
+   std::vector<size_t> keptOffsets( threadCount );
+   RunParallel( threadCount, [&]( uint32_t threadIdx ) {
+      keptOffsets[threadIdx] = CountFlags(
+          pFlags,
+          ChunkBegin( count, threadCount, threadIdx ),
+          ChunkBegin( count, threadCount, threadIdx + 1 ) );
+   } );
+
+   size_t keptCount = 0;
+   for( size_t& offset : keptOffsets )
+   {
+      const size_t rangeKeptCount = offset;
+      offset                      = keptCount;
+      keptCount += rangeKeptCount;
+   }
+
+   RunParallel( threadCount, [&]( uint32_t threadIdx ) {
+      const size_t begin = ChunkBegin( count, threadCount, threadIdx );
+      const size_t end   = ChunkBegin( count, threadCount, threadIdx + 1 );
+
+      // Every value before the range that was not kept was rejected
+      T* pKept     = pOut + keptOffsets[threadIdx];
+      T* pRejected = partition ? pOut + keptCount + ( begin - keptOffsets[threadIdx] ) : nullptr;
+
+      Split<T>( pIn, pFlags, begin, end, pKept, pRejected );
+   } );
+
+   return keptCount;
+}
+}
+
+// Copies the values whose flag is not 0 to pOut, returns how many were copied. pOut has to be large
+// enough for all of them and cannot overlap pIn.
+template <typename T>
+size_t Compact(
+    const T* pIn,
+    const uint8_t* pFlags,
+    size_t count,
+    T* pOut,
+    uint32_t threadCount = 1 )
+{
+   return detail::SplitParallel<T>( pIn, pFlags, count, pOut, false, threadCount );
+}
+
+// Copies the values whose flag is not 0 to the front of pOut and the others after them, returns how
+// many values are in the front part. pOut has room for count values and cannot overlap pIn.
+template <typename T>
+size_t Partition(
+    const T* pIn,
+    const uint8_t* pFlags,
+    size_t count,
+    T* pOut,
+    uint32_t threadCount = 1 )
+{
+   return detail::SplitParallel<T>( pIn, pFlags, count, pOut, true, threadCount );
+}
+}
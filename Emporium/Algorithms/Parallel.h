@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace EMP
+{
+// Below this many elements per thread, starting the thread costs more than it saves
+constexpr size_t MIN_ELEMENTS_PER_THREAD = 1 << 16;
+
+// Number of threads worth splitting count elements over, at most maxThreads. 0 allows every
+// hardware thread.
+inline uint32_t ThreadCountFor( size_t count, uint32_t maxThreads )
+{
+   if( maxThreads == 0 )
+   {
+      maxThreads = std::max( std::thread::hardware_concurrency(), 1u );
+   }
+
+   const size_t worthIt = std::max<size_t>( count / MIN_ELEMENTS_PER_THREAD, 1 );
+   return static_cast<uint32_t>( std::min<size_t>( maxThreads, worthIt ) );
+}
+
+// First element of the contiguous range of a thread, threadIdx == threadCount giving the end
+inline size_t ChunkBegin( size_t count, uint32_t threadCount, uint32_t threadIdx )
+{
+   return count / threadCount * threadIdx + std::min<size_t>( threadIdx, count % threadCount );
+}
+
+// Runs func( threadIdx ) on threadCount threads, the calling thread being the first one
+template <typename Func>
+void RunParallel( uint32_t threadCount, const Func& func )
+{
+   std::vector<std::thread> threads;
+   threads.reserve( threadCount - 1 );
+   for( uint32_t i = 1; i < threadCount; ++i )
+   {
+      threads.emplace_back( func, i );
+   }
+
+   func( 0 );
+
+   for( std::thread& thread : threads )
+   {
+      thread.join();
+   }
+}
+}
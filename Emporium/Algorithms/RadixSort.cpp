@@ -0,0 +1,135 @@
+#include <Algorithms/RadixSort.h>
+
+#include <Algorithms/Parallel.h>
+
+#include <array>
+#include <cassert>
+
+namespace EMP
+{
+static constexpr uint32_t RADIX_BITS = 8;
+static constexpr uint32_t RADIX      = 1 << RADIX_BITS;
+
+using Histogram = std::array<size_t, RADIX>;
+
+template <typename Key>
+static uint32_t digitOf( Key key, uint32_t pass )
+{
+   return static_cast<uint32_t>( key >> ( pass * RADIX_BITS ) ) & ( RADIX - 1 );
+}
+
+template <typename Key>
+static void radixSort( std::vector<Key>& keys, std::vector<uint32_t>& values, uint32_t maxThreads )
+{
+   static constexpr uint32_t PASS_COUNT = sizeof( Key ) * 8 / RADIX_BITS;
+
+   assert(
+       ( values.empty() || values.size() == keys.size() ) &&
+       "RadixSort: There has to be one value per key" );
+
+   const size_t count         = keys.size();
+   const bool hasValues       = !values.empty();
+   const uint32_t threadCount = ThreadCountFor( count, maxThreads );
+
+   const auto rangeBegin = [count, threadCount]( uint32_t threadIdx ) {
+      return ChunkBegin( count, threadCount, threadIdx );
+   };
+
+   // Digits of every pass in a single read, a pass is useless when all the keys share its digit
+   std::vector<std::array<Histogram, PASS_COUNT>> totals( threadCount );
+   RunParallel( threadCount, [&]( uint32_t threadIdx ) {
+      std::array<Histogram, PASS_COUNT>& histograms = totals[threadIdx];
+      for( Histogram& histogram : histograms )
+      {
+         histogram.fill( 0 );
+      }
+
+      for( size_t i = rangeBegin( threadIdx ); i < rangeBegin( threadIdx + 1 ); ++i )
+      {
+         for( uint32_t pass = 0; pass < PASS_COUNT; ++pass )
+         {
+            ++histograms[pass][digitOf( keys[i], pass )];
+         }
+      }
+   } );
+
+   std::vector<Key> tempKeys( count );
+   std::vector<uint32_t> tempValues( hasValues ? count : 0 );
+
+   std::vector<Histogram> offsets( threadCount );
+
+   bool scattered = false;
+
+   for( uint32_t pass = 0; pass < PASS_COUNT; ++pass )
+   {
+      const uint32_t firstDigit = count > 0 ? digitOf( keys[0], pass ) : 0;
+
+      size_t firstDigitCount = 0;
+      for( const auto& histograms : totals )
+      {
+         firstDigitCount += histograms[pass][firstDigit];
+      }
+
+      if( firstDigitCount == count )
+      {
+         continue;
+      }
+
+      // Ranges hold different keys after every pass, the histograms of this one are recounted
+      if( scattered && threadCount > 1 )
+      {
+         RunParallel( threadCount, [&]( uint32_t threadIdx ) {
+            Histogram& histogram = totals[threadIdx][pass];
+            histogram.fill( 0 );
+
+            for( size_t i = rangeBegin( threadIdx ); i < rangeBegin( threadIdx + 1 ); ++i )
+            {
+               ++histogram[digitOf( keys[i], pass )];
+            }
+         } );
+      }
+
+      // Each range writes a digit after the same digit of the previous ranges, which keeps the
+      // sort stable
+      size_t offset = 0;
+      for( uint32_t digit = 0; digit < RADIX; ++digit )
+      {
+         for( uint32_t threadIdx = 0; threadIdx < threadCount; ++threadIdx )
+         {
+            offsets[threadIdx][digit] = offset;
+            offset += totals[threadIdx][pass][digit];
+         }
+      }
+
+      RunParallel( threadCount, [&]( uint32_t threadIdx ) {
+         Histogram& rangeOffsets = offsets[threadIdx];
+
+         for( size_t i = rangeBegin( threadIdx ); i < rangeBegin( threadIdx + 1 ); ++i )
+         {
+            const Key key    = keys[i];
+            const size_t dst = rangeOffsets[digitOf( key, pass )]++;
+
+            tempKeys[dst] = key;
+            if( hasValues )
+            {
+               tempValues[dst] = values[i];
+            }
+         }
+      } );
+
+      keys.swap( tempKeys );
+      values.swap( tempValues );
+      scattered = true;
+   }
+}
+
+void RadixSort( std::vector<uint32_t>& keys, std::vector<uint32_t>& values, uint32_t threadCount )
+{
+   radixSort( keys, values, threadCount );
+}
+
+void RadixSort( std::vector<uint64_t>& keys, std::vector<uint32_t>& values, uint32_t threadCount )
+{
+   radixSort( keys, values, threadCount );
+}
+}
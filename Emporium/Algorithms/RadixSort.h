@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Stable LSD radix sorts of unsigned keys, a byte per pass. Passes where every key has the same
+// byte are skipped, so keys using only their low bits sort in fewer passes. Each pass histograms
+// and scatters contiguous ranges of keys on threadCount threads, 0 using every hardware thread. The
+// scatters are bound by memory and have nothing to gain from SSE2, which has no scatter stores.
+namespace EMP
+{
+// values carries a payload moved along with every key, like the index of what the key sorts. It
+// is either empty or as large as keys.
+void RadixSort(
+    std::vector<uint32_t>& keys,
+    std::vector<uint32_t>& values,
+    uint32_t threadCount = 1 );
+void RadixSort(
+    std::vector<uint64_t>& keys,
+    std::vector<uint32_t>& values,
+    uint32_t threadCount = 1 );
+}
@@ -0,0 +1,178 @@
+#include <Algorithms/Reduce.h>
+
+#include <Algorithms/Parallel.h>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include <emmintrin.h>
+
+namespace EMP
+{
+// Splits the values over the threads and combines the result of each range, in order
+template <typename Result, typename ReduceRange, typename Combine>
+static Result reduceParallel(
+    size_t count,
+    uint32_t maxThreads,
+    const ReduceRange& reduceRange,
+    const Combine& combine )
+{
+   const uint32_t threadCount = ThreadCountFor( count, maxThreads );
+   if( threadCount == 1 )
+   {
+      return reduceRange( 0, count );
+   }
+
+   std::vector<Result> results( threadCount );
+   RunParallel( threadCount, [&]( uint32_t threadIdx ) {
+      results[threadIdx] = reduceRange(
+          ChunkBegin( count, threadCount, threadIdx ),
+          ChunkBegin( count, threadCount, threadIdx + 1 ) );
+   } );
+
+   Result result = results[0];
+   for( uint32_t i = 1; i < threadCount; ++i )
+   {
+      result = combine( result, results[i] );
+   }
+
+   return result;
+}
+
+// =================================================================================================
+// Sums
+
+static uint64_t sumRange( const uint32_t* pValues, size_t begin, size_t end )
+{
+   // Widened to two 64-bit lanes per half so that large arrays cannot overflow
+   const __m128i zero = _mm_setzero_si128();
+   __m128i sums       = zero;
+
+   size_t i = begin;
+   for( ; i + 4 <= end; i += 4 )
+   {
+      const __m128i values = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pValues + i ) );
+
+      sums = _mm_add_epi64( sums, _mm_unpacklo_epi32( values, zero ) );
+      sums = _mm_add_epi64( sums, _mm_unpackhi_epi32( values, zero ) );
+   }
+
+   alignas( 16 ) uint64_t lanes[2];
+   _mm_store_si128( reinterpret_cast<__m128i*>( lanes ), sums );
+
+   uint64_t sum = lanes[0] + lanes[1];
+   for( ; i < end; ++i )
+   {
+      sum += pValues[i];
+   }
+
+   return sum;
+}
+
+static float sumRange( const float* pValues, size_t begin, size_t end )
+{
+   // Two independent accumulators hide the latency of the additions
+   __m128 sums0 = _mm_setzero_ps();
+   __m128 sums1 = _mm_setzero_ps();
+
+   size_t i = begin;
+   for( ; i + 8 <= end; i += 8 )
+   {
+      sums0 = _mm_add_ps( sums0, _mm_loadu_ps( pValues + i ) );
+      sums1 = _mm_add_ps( sums1, _mm_loadu_ps( pValues + i + 4 ) );
+   }
+   for( ; i + 4 <= end; i += 4 )
+   {
+      sums0 = _mm_add_ps( sums0, _mm_loadu_ps( pValues + i ) );
+   }
+
+   alignas( 16 ) float lanes[4];
+   _mm_store_ps( lanes, _mm_add_ps( sums0, sums1 ) );
+
+   float sum = ( lanes[0] + lanes[1] ) + ( lanes[2] + lanes[3] );
+   for( ; i < end; ++i )
+   {
+      sum += pValues[i];
+   }
+
+   return sum;
+}
+
+uint64_t ReduceSum( const uint32_t* pValues, size_t count, uint32_t threadCount )
+{
+   return reduceParallel<uint64_t>(
+       count,
+       threadCount,
+       [pValues]( size_t begin, size_t end ) { return sumRange( pValues, begin, end ); },
+       []( uint64_t a, uint64_t b ) { return a + b; } );
+}
+
+float ReduceSum( const float* pValues, size_t count, uint32_t threadCount )
+{
+   return reduceParallel<float>(
+       count,
+       threadCount,
+       [pValues]( size_t begin, size_t end ) { return sumRange( pValues, begin, end ); },
+       []( float a, float b ) { return a + b; } );
+}
+
+// =================================================================================================
+// Extrema
+
+template <bool MIN>
+static float extremumRange( const float* pValues, size_t begin, size_t end )
+{
+   // Every lane starts with the first value, which is as neutral as it gets
+   __m128 extrema = _mm_set1_ps( pValues[begin] );
+
+   size_t i = begin;
+   for( ; i + 4 <= end; i += 4 )
+   {
+      const __m128 values = _mm_loadu_ps( pValues + i );
+
+      extrema = MIN ? _mm_min_ps( extrema, values ) : _mm_max_ps( extrema, values );
+   }
+
+   alignas( 16 ) float lanes[4];
+   _mm_store_ps( lanes, extrema );
+
+   float extremum = lanes[0];
+   for( uint32_t lane = 1; lane < 4; ++lane )
+   {
+      extremum = MIN ? std::min( extremum, lanes[lane] ) : std::max( extremum, lanes[lane] );
+   }
+   for( ; i < end; ++i )
+   {
+      extremum = MIN ? std::min( extremum, pValues[i] ) : std::max( extremum, pValues[i] );
+   }
+
+   return extremum;
+}
+
+float ReduceMin( const float* pValues, size_t count, uint32_t threadCount )
+{
+   assert( count > 0 && "Reduce: The minimum of no values is undefined" );
+
+   return reduceParallel<float>(
+       count,
+       threadCount,
+       [pValues]( size_t begin, size_t end ) {
+          return extremumRange<true>( pValues, begin, end );
+       },
+       []( float a, float b ) { return std::min( a, b ); } );
+}
+
+float ReduceMax( const float* pValues, size_t count, uint32_t threadCount )
+{
+   assert( count > 0 && "Reduce: The maximum of no values is undefined" );
+
+   return reduceParallel<float>(
+       count,
+       threadCount,
+       [pValues]( size_t begin, size_t end ) {
+          return extremumRange<false>( pValues, begin, end );
+       },
+       []( float a, float b ) { return std::max( a, b ); } );
+}
+}
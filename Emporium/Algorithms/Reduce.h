@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Reductions of arrays, four lanes at a time with SSE2 and split over threadCount threads. Passing
+// 0 threads uses every hardware thread, small arrays always stay on the calling thread.
+namespace EMP
+{
+uint64_t ReduceSum( const uint32_t* pValues, size_t count, uint32_t threadCount = 1 );
+float ReduceSum( const float* pValues, size_t count, uint32_t threadCount = 1 );
+
+// There has to be at least one value
+float ReduceMin( const float* pValues, size_t count, uint32_t threadCount = 1 );
+float ReduceMax( const float* pValues, size_t count, uint32_t threadCount = 1 );
+}
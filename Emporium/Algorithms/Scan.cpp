@@ -0,0 +1,195 @@
+#include <Algorithms/Scan.h>
+
+#include <Algorithms/Parallel.h>
+
+#include <vector>
+
+#include <emmintrin.h>
+
+namespace EMP
+{
+// =================================================================================================
+// Lanes
+
+struct UIntLanes
+{
+   using Scalar = uint32_t;
+   using Vector = __m128i;
+
+   static Vector load( const Scalar* p )
+   {
+      return _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+   }
+   static void store( Scalar* p, Vector v )
+   {
+      _mm_storeu_si128( reinterpret_cast<__m128i*>( p ), v );
+   }
+   static Vector set1( Scalar value ) { return _mm_set1_epi32( static_cast<int>( value ) ); }
+   static Vector add( Vector a, Vector b ) { return _mm_add_epi32( a, b ); }
+
+   // Moves every lane up by count lanes, filling with zeros
+   template <int COUNT>
+   static Vector shiftUp( Vector v )
+   {
+      return _mm_slli_si128( v, COUNT * 4 );
+   }
+
+   static Vector broadcastLast( Vector v ) { return _mm_shuffle_epi32( v, 0xFF ); }
+   static Scalar first( Vector v ) { return static_cast<Scalar>( _mm_cvtsi128_si32( v ) ); }
+};
+
+struct FloatLanes
+{
+   using Scalar = float;
+   using Vector = __m128;
+
+   static Vector load( const Scalar* p ) { return _mm_loadu_ps( p ); }
+   static void store( Scalar* p, Vector v ) { _mm_storeu_ps( p, v ); }
+   static Vector set1( Scalar value ) { return _mm_set1_ps( value ); }
+   static Vector add( Vector a, Vector b ) { return _mm_add_ps( a, b ); }
+
+   template <int COUNT>
+   static Vector shiftUp( Vector v )
+   {
+      return _mm_castsi128_ps( _mm_slli_si128( _mm_castps_si128( v ), COUNT * 4 ) );
+   }
+
+   static Vector broadcastLast( Vector v ) { return _mm_shuffle_ps( v, v, 0xFF ); }
+   static Scalar first( Vector v ) { return _mm_cvtss_f32( v ); }
+};
+
+// =================================================================================================
+// Scans
+
+template <class Lanes>
+static typename Lanes::Scalar
+sumRange( const typename Lanes::Scalar* pIn, size_t begin, size_t end )
+{
+   using Scalar = typename Lanes::Scalar;
+   using Vector = typename Lanes::Vector;
+
+   Vector sums = Lanes::set1( 0 );
+
+   size_t i = begin;
+   for( ; i + 4 <= end; i += 4 )
+   {
+      sums = Lanes::add( sums, Lanes::load( pIn + i ) );
+   }
+
+   // Horizontal sum, the total ends up in the last lane
+   sums = Lanes::add( sums, Lanes::template shiftUp<1>( sums ) );
+   sums = Lanes::add( sums, Lanes::template shiftUp<2>( sums ) );
+
+   Scalar sum = Lanes::first( Lanes::broadcastLast( sums ) );
+   for( ; i < end; ++i )
+   {
+      sum += pIn[i];
+   }
+
+   return sum;
+}
+
+// Scans a range starting from carry, returns the carry of the next range
+template <class Lanes, bool INCLUSIVE>
+static typename Lanes::Scalar scanRange(
+    const typename Lanes::Scalar* pIn,
+    typename Lanes::Scalar* pOut,
+    size_t begin,
+    size_t end,
+    typename Lanes::Scalar carry )
+{
+   using Scalar = typename Lanes::Scalar;
+   using Vector = typename Lanes::Vector;
+
+   Vector carries = Lanes::set1( carry );
+
+   size_t i = begin;
+   for( ; i + 4 <= end; i += 4 )
+   {
+      // Inclusive prefix of the four lanes in two steps
+      Vector sums = Lanes::load( pIn + i );
+      sums        = Lanes::add( sums, Lanes::template shiftUp<1>( sums ) );
+      sums        = Lanes::add( sums, Lanes::template shiftUp<2>( sums ) );
+
+      // The exclusive prefix is the inclusive one moved up a lane
+      const Vector prefix = INCLUSIVE ? sums : Lanes::template shiftUp<1>( sums );
+      Lanes::store( pOut + i, Lanes::add( prefix, carries ) );
+
+      carries = Lanes::add( carries, Lanes::broadcastLast( sums ) );
+   }
+
+   Scalar sum = Lanes::first( carries );
+   for( ; i < end; ++i )
+   {
+      const Scalar value = pIn[i];
+      pOut[i]            = INCLUSIVE ? sum + value : sum;
+      sum += value;
+   }
+
+   return sum;
+}
+
+template <class Lanes, bool INCLUSIVE>
+static typename Lanes::Scalar scanParallel(
+    const typename Lanes::Scalar* pIn,
+    typename Lanes::Scalar* pOut,
+    size_t count,
+    uint32_t maxThreads )
+{
+   using Scalar = typename Lanes::Scalar;
+
+   const uint32_t threadCount = ThreadCountFor( count, maxThreads );
+   if( threadCount == 1 )
+   {
+      return scanRange<Lanes, INCLUSIVE>( pIn, pOut, 0, count, 0 );
+   }
+
+   // Sums of every range first, their own exclusive scan then gives where each range starts
+   std::vector<Scalar> carries( threadCount );
+   RunParallel( threadCount, [&]( uint32_t threadIdx ) {
+      carries[threadIdx] = sumRange<Lanes>(
+          pIn,
+          ChunkBegin( count, threadCount, threadIdx ),
+          ChunkBegin( count, threadCount, threadIdx + 1 ) );
+   } );
+
+   Scalar total = 0;
+   for( Scalar& carry : carries )
+   {
+      const Scalar sum = carry;
+      carry            = total;
+      total += sum;
+   }
+
+   RunParallel( threadCount, [&]( uint32_t threadIdx ) {
+      scanRange<Lanes, INCLUSIVE>(
+          pIn,
+          pOut,
+          ChunkBegin( count, threadCount, threadIdx ),
+          ChunkBegin( count, threadCount, threadIdx + 1 ),
+          carries[threadIdx] );
+   } );
+
+   return total;
+}
+
+uint32_t InclusiveScan( const uint32_t* pIn, uint32_t* pOut, size_t count, uint32_t threadCount )
+{
+   return scanParallel<UIntLanes, true>( pIn, pOut, count, threadCount );
+}
+
+float InclusiveScan( const float* pIn, float* pOut, size_t count, uint32_t threadCount )
+{
+   return scanParallel<FloatLanes, true>( pIn, pOut, count, threadCount );
+}
+
+uint32_t ExclusiveScan( const uint32_t* pIn, uint32_t* pOut, size_t count, uint32_t threadCount )
+{
+   return scanParallel<UIntLanes, false>( pIn, pOut, count, threadCount );
+}
+
+float ExclusiveScan( const float* pIn, float* pOut, size_t count, uint32_t threadCount )
+{
+   return scanParallel<FloatLanes, false>( pIn, pOut, count, threadCount );
+}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Prefix sums, four lanes at a time with SSE2 and split over threadCount threads. Passing 0 threads
+// uses every hardware thread, small arrays always stay on the calling thread. pOut can be pIn, and
+// every scan returns the sum of all the values.
+namespace EMP
+{
+// pOut[i] is the sum of the values up to and including pIn[i]
+uint32_t InclusiveScan(
+    const uint32_t* pIn,
+    uint32_t* pOut,
+    size_t count,
+    uint32_t threadCount = 1 );
+float InclusiveScan( const float* pIn, float* pOut, size_t count, uint32_t threadCount = 1 );
+
+// pOut[i] is the sum of the values before pIn[i], starting at 0
+uint32_t ExclusiveScan(
+    const uint32_t* pIn,
+    uint32_t* pOut,
+    size_t count,
+    uint32_t threadCount = 1 );
+float ExclusiveScan( const float* pIn, float* pOut, size_t count, uint32_t threadCount = 1 );
+}
@@ -3,14 +3,22 @@
 #include <Window/GLFWWindow.h>
 
 #include <chrono>
+#include <cstdio>
 #include <memory>
 
 namespace CYD
 {
-Application::Application( uint32_t width, uint32_t height, const char* title )
+Application::Application( uint32_t width, uint32_t height, const char* title, bool headless )
 {
    m_window = std::make_unique<Window>();
-   m_window->init( width, height, title );
+   if( headless )
+   {
+      m_window->initHeadless( width, height );
+   }
+   else
+   {
+      m_window->init( width, height, title );
+   }
 }
 
 void Application::startLoop()
@@ -19,6 +27,9 @@ void Application::startLoop()
 
    preLoop();
 
+   const auto loopStart = std::chrono::high_resolution_clock::now();
+   uint64_t frameCount  = 0;
+
    m_running = true;
    while( m_running )  // Main loop
    {
@@ -34,6 +45,23 @@ void Application::startLoop()
 
       // Determine if the main window was asked to be closed
       m_running = m_window->isRunning();
+
+      if( m_frameLimit > 0 && ++frameCount >= m_frameLimit )
+      {
+         m_running = false;
+      }
+   }
+
+   if( m_frameLimit > 0 )
+   {
+      const std::chrono::duration<double, std::milli> loopMs =
+          std::chrono::high_resolution_clock::now() - loopStart;
+
+      printf(
+          "Application: %llu frames in %.2f ms, %.3f ms per frame\n",
+          static_cast<unsigned long long>( frameCount ),
+          loopMs.count(),
+          frameCount > 0 ? loopMs.count() / frameCount : 0.0 );
    }
 
    postLoop();
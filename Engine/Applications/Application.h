@@ -21,12 +21,16 @@ namespace CYD
 class Application
 {
   public:
-   Application( uint32_t width, uint32_t height, const char* title );
+   // Headless applications render offscreen without opening a window, for benchmarks and CI
+   Application( uint32_t width, uint32_t height, const char* title, bool headless = false );
    NON_COPIABLE( Application );
    virtual ~Application();
 
    void startLoop();
 
+   // Stops the loop after this many frames and reports the frame times, 0 runs until closed
+   void setFrameLimit( uint64_t frameLimit ) noexcept { m_frameLimit = frameLimit; }
+
   protected:
    virtual void preLoop();              // Executed before the application enters the main loop
    virtual void tick( double deltaS );  // Executed as fast as possible
@@ -36,5 +40,7 @@ class Application
 
   private:
    bool m_running = false;
+
+   uint64_t m_frameLimit = 0;
 };
 }
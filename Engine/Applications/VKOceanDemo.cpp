@@ -1,80 +1,32 @@
 #include <Applications/VKOceanDemo.h>
 
+#include <Graphics/RenderGraph.h>
 #include <Graphics/RenderInterface.h>
-#include <Graphics/Utility/MeshGeneration.h>
-
-#include <ECS/EntityManager.h>
 
 #include <ECS/Systems/Input/InputSystem.h>
-#include <ECS/Systems/Physics/PlayerMoveSystem.h>
-#include <ECS/Systems/Physics/MovementSystem.h>
-#include <ECS/Systems/Rendering/RenderSystem.h>
-#include <ECS/Systems/Scene/CameraSystem.h>
 #include <ECS/Systems/Lighting/LightSystem.h>
-#include <ECS/Systems/Behaviour/EntityFollowSystem.h>
+#include <ECS/Systems/Physics/MotionSystem.h>
+#include <ECS/Systems/Physics/PlayerMoveSystem.h>
 #include <ECS/Systems/Procedural/FFTOceanSystem.h>
+#include <ECS/Systems/Rendering/ForwardRenderSystem.h>
+#include <ECS/Systems/Scene/CameraSystem.h>
 
+#include <ECS/Components/Lighting/LightComponent.h>
+#include <ECS/Components/Physics/MotionComponent.h>
 #include <ECS/Components/Procedural/FFTOceanComponent.h>
 #include <ECS/Components/Rendering/MeshComponent.h>
+#include <ECS/Components/Rendering/RenderableComponent.h>
 #include <ECS/Components/Transforms/TransformComponent.h>
-#include <ECS/Components/Behaviour/EntityFollowComponent.h>
-#include <ECS/Components/Rendering/SkyboxRenderableComponent.h>
 
+#include <ECS/SharedComponents/CameraComponent.h>
 #include <ECS/SharedComponents/InputComponent.h>
 
+#include <ECS/EntityManager.h>
+
 namespace CYD
 {
-static const std::vector<Vertex> skyboxVertices = {
-    // FT
-    {{{-250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}},
-     {{-250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, -1.0f}},
-     {{250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, -1.0f}},
-     {{250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, -1.0f}},
-     {{250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, -1.0f}},
-     {{-250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}},
-
-     // LF
-     {{-250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}},
-     {{-250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, -1.0f}},
-     {{-250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}},
-     {{-250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}},
-     {{-250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}},
-     {{-250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}},
-
-     // RT
-     {{250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, -1.0f}},
-     {{250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}},
-     {{250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}},
-     {{250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}},
-     {{250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, -1.0f}},
-     {{250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, -1.0f}},
-
-     // BK
-     {{-250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}},
-     {{-250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}},
-     {{250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}},
-     {{250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}},
-     {{250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}},
-     {{-250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}},
-
-     // UP
-     {{-250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, -1.0f}},
-     {{250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, -1.0f}},
-     {{250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}},
-     {{250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, -1.0f, 1.0f}},
-     {{-250.0f, 250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, 1.0f}},
-     {{-250.0f, 250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, -1.0f, -1.0f}},
-
-     // DN
-     {{-250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, -1.0f}},
-     {{-250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}},
-     {{250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}},
-     {{250.0f, -250.0f, -250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}},
-     {{-250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}},
-     {{250.0f, -250.0f, 250.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}}}};
-
-VKOceanDemo::VKOceanDemo( uint32_t width, uint32_t height, const char* title )
-    : Application( width, height, title )
+VKOceanDemo::VKOceanDemo( uint32_t width, uint32_t height, const char* title, bool headless )
+    : Application( width, height, title, headless )
 {
    // Core initializers
    GRIS::InitRenderBackend<VK>( *m_window );
@@ -83,41 +35,36 @@ VKOceanDemo::VKOceanDemo( uint32_t width, uint32_t height, const char* title )
 
 void VKOceanDemo::preLoop()
 {
-   // This order is the order in which the systems will be ticked
+   // This order is the order in which the systems will be ticked, the displacement has to be
+   // recorded before the render pass waiting on it
    ECS::AddSystem<InputSystem>( *m_window );
    ECS::AddSystem<CameraSystem>();
-
    ECS::AddSystem<PlayerMoveSystem>();
-   ECS::AddSystem<MovementSystem>();
-   ECS::AddSystem<EntityFollowSystem>();
-
+   ECS::AddSystem<MotionSystem>();
    ECS::AddSystem<LightSystem>();
    ECS::AddSystem<FFTOceanSystem>();
+   ECS::AddSystem<ForwardRenderSystem>();
 
-   ECS::AddSystem<RenderSystem>();
-
-   // Creating player entity
+   // Creating player entity, a few meters above the surface
    const EntityHandle player = ECS::CreateEntity();
    ECS::Assign<InputComponent>( player );
-   ECS::Assign<TransformComponent>( player, glm::vec3( 0.0f, 0.0f, 0.0f ) );
+   ECS::Assign<TransformComponent>( player, glm::vec3( 0.0f, 20.0f, 0.0f ) );
    ECS::Assign<MotionComponent>( player );
    ECS::Assign<CameraComponent>( player );
 
-   std::vector<Vertex> gridVerts;
-   std::vector<uint32_t> gridIndices;
-   MeshGen::Grid( 256, 256, gridVerts, gridIndices );
+   const EntityHandle sun = ECS::CreateEntity();
+   ECS::Assign<TransformComponent>( sun );
+   ECS::Assign<LightComponent>( sun );
 
+   // Large swells, then chop that does not visibly repeat close to the camera
+   const std::vector<uint32_t> cascades = {1000, 250, 60};
+
+   // The clipmap follows the camera, the displacement of every cascade is tiled over it
    const EntityHandle ocean = ECS::CreateEntity();
    ECS::Assign<TransformComponent>( ocean, glm::vec3( 0.0f, 0.0f, 0.0f ) );
-   ECS::Assign<MeshComponent>( ocean, gridVerts, gridIndices );
-   ECS::Assign<FFTOceanComponent>( ocean, 256, 1000, 10.0f, 40.0f, 1.0f, 0.0f );
-   ECS::Assign<RenderableComponent>( ocean );
-
-   const EntityHandle skybox = ECS::CreateEntity();
-   ECS::Assign<TransformComponent>( skybox );
-   ECS::Assign<MeshComponent>( skybox, skyboxVertices );
-   ECS::Assign<EntityFollowComponent>( skybox, player );
-   ECS::Assign<SkyboxRenderableComponent>( skybox, "MCLITE" );
+   ECS::Assign<MeshComponent>( ocean, RenderGraph::CLIPMAP_MESH_STRING );
+   ECS::Assign<FFTOceanComponent>( ocean, 256, cascades, 10.0f, 40.0f, 1.0f, 0.0f );
+   ECS::Assign<RenderableComponent>( ocean, StaticPipelines::Type::DISPLACEMENT, "" );
 }
 
 void VKOceanDemo::tick( double deltaS )
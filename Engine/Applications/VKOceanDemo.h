@@ -15,7 +15,7 @@ namespace CYD
 class VKOceanDemo final : public Application
 {
   public:
-   VKOceanDemo( uint32_t width, uint32_t height, const char* title );
+   VKOceanDemo( uint32_t width, uint32_t height, const char* title, bool headless = false );
    NON_COPIABLE( VKOceanDemo );
    ~VKOceanDemo() override;
 
@@ -22,8 +22,8 @@
 
 namespace CYD
 {
-VKSandbox::VKSandbox( uint32_t width, uint32_t height, const char* title )
-    : Application( width, height, title )
+VKSandbox::VKSandbox( uint32_t width, uint32_t height, const char* title, bool headless )
+    : Application( width, height, title, headless )
 {
    // Core initializers
    GRIS::InitRenderBackend<VK>( *m_window );
@@ -37,7 +37,7 @@ void VKSandbox::preLoop()
    ECS::AddSystem<PlayerMoveSystem>();
    ECS::AddSystem<MotionSystem>();
    ECS::AddSystem<LightSystem>();
-   ECS::AddSystem<ForwardRenderSystem>();
+   ECS::AddSystem<ForwardRenderSystem>( m_bindless );
 
    // Creating player entity
    const EntityHandle player = ECS::CreateEntity();
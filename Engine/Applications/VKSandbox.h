@@ -15,12 +15,18 @@ namespace CYD
 class VKSandbox final : public Application
 {
   public:
-   VKSandbox( uint32_t width, uint32_t height, const char* title );
+   VKSandbox( uint32_t width, uint32_t height, const char* title, bool headless = false );
    NON_COPIABLE( VKSandbox );
    ~VKSandbox() override;
 
+   // Has to be set before the loop starts
+   void setBindless( bool enabled ) noexcept { m_bindless = enabled; }
+
   protected:
    void preLoop() override;
    void tick( double deltaS ) override;
+
+  private:
+   bool m_bindless = false;
 };
 }
@@ -13,10 +13,9 @@ layout( set = 0, binding = 0 ) uniform Alpha
    mat4 proj;
 };
 
-layout( location = 0 ) in vec3 inPosition;
+// Inputs, compact layout declared in Pipelines.json
+layout( location = 0 ) in vec3 inPosition;  // Quantized, dequantized by the model matrix
 layout( location = 1 ) in vec4 inColor;
-layout( location = 2 ) in vec3 inTexCoords;
-layout( location = 3 ) in vec3 inNormals;
 
 layout( location = 0 ) out vec4 outColor;
 
@@ -3,7 +3,11 @@
 
 // Constant buffer
 // =================================================================================================
-layout( push_constant ) uniform Epsilon { mat4 model; };
+layout( push_constant ) uniform Epsilon
+{
+   mat4 model;              // Only translated, the camera is followed in the XZ plane
+   vec4 cascadeDimensions;  // Horizontal dimension of every cascade, 0 past the last one
+};
 
 // View and environment (Alpha)
 // =================================================================================================
@@ -13,8 +17,11 @@ layout( set = 0, binding = 0 ) uniform Alpha
    mat4 proj;
 };
 
-layout( set = 1, binding = 0, rgba32f ) readonly uniform image2D displacement;
+// XYZ displacement, one layer per cascade
+layout( set = 1, binding = 0, rgba32f ) readonly uniform image2DArray displacement;
 
+// Clipmap vertices from MeshGen::Clipmap, the texture coordinates hold the spacing and the outer
+// half extent of the level of the vertex, then the step the whole mesh follows the camera by
 layout( location = 0 ) in vec3 inPosition;
 layout( location = 1 ) in vec4 inColor;
 layout( location = 2 ) in vec3 inTexCoords;
@@ -22,11 +29,64 @@ layout( location = 3 ) in vec3 inNormals;
 
 layout( location = 0 ) out vec4 outColor;
 
+// Vertices start sliding onto the lattice of the next level at this fraction of the extent of
+// their level, and are on it at the edge so that levels meet without cracks
+const float MORPH_START = 0.75;
+
+// Bilinear, the patch of a cascade repeats every horizontal dimension
+vec3 sampleCascade( vec2 position, int cascade )
+{
+   const ivec2 size = imageSize( displacement ).xy;
+   const ivec2 mask = size - 1;
+
+   const vec2 coords  = position / cascadeDimensions[cascade] * vec2( size );
+   const vec2 cell    = floor( coords );
+   const vec2 weights = coords - cell;
+
+   const ivec2 c0 = ivec2( cell ) & mask;
+   const ivec2 c1 = ( c0 + 1 ) & mask;
+
+   const vec3 d00 = imageLoad( displacement, ivec3( c0.x, c0.y, cascade ) ).xyz;
+   const vec3 d10 = imageLoad( displacement, ivec3( c1.x, c0.y, cascade ) ).xyz;
+   const vec3 d01 = imageLoad( displacement, ivec3( c0.x, c1.y, cascade ) ).xyz;
+   const vec3 d11 = imageLoad( displacement, ivec3( c1.x, c1.y, cascade ) ).xyz;
+
+   return mix( mix( d00, d10, weights.x ), mix( d01, d11, weights.x ), weights.y );
+}
+
 void main()
 {
-   const vec3 displacement =
-       imageLoad( displacement, ivec2( gl_VertexIndex % 256, gl_VertexIndex / 256 ) ).rgb;
+   const float spacing    = inTexCoords.x;
+   const float halfExtent = inTexCoords.y;
+   const float snapStep   = inTexCoords.z;
+
+   // Following the camera by whole steps keeps the finest level on the same lattice
+   const vec3 cameraPos = -transpose( mat3( view ) ) * vec3( view[3] );
+   const vec2 center    = floor( ( cameraPos.xz - model[3].xz ) / snapStep ) * snapStep;
+
+   // Geomorphing towards the lattice of the next level, twice as coarse
+   const vec2 local     = inPosition.xz;
+   const float distance = max( abs( local.x ), abs( local.y ) );
+   const float morph =
+       clamp( ( distance / halfExtent - MORPH_START ) / ( 1.0 - MORPH_START ), 0.0, 1.0 );
+   const vec2 morphed = local - fract( local / ( 2.0 * spacing ) ) * ( 2.0 * spacing * morph );
+
+   const vec2 position = center + morphed;
+
+   // Cascades with texels much smaller than the vertex spacing would only alias. The spacing is
+   // morphed as well, so that both sides of the edge between two levels fade them the same way.
+   const float morphedSpacing = spacing * ( 1.0 + morph );
+   const float resolution     = float( imageSize( displacement ).x );
+
+   vec3 offset = vec3( 0.0 );
+   for( int i = 0; i < 4 && cascadeDimensions[i] > 0.0; ++i )
+   {
+      const float texelSize = cascadeDimensions[i] / resolution;
+      const float fade      = clamp( 2.0 - morphedSpacing / ( 2.0 * texelSize ), 0.0, 1.0 );
+
+      offset += fade * sampleCascade( position, i );
+   }
 
-   gl_Position = proj * view * model * vec4( ( displacement + inPosition ), 1.0 );
+   gl_Position = proj * view * model * vec4( vec3( position.x, 0.0, position.y ) + offset, 1.0 );
    outColor    = inColor;
 }
\ No newline at end of file
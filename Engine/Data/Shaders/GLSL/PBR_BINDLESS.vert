@@ -0,0 +1,81 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+// Constant buffer
+// =================================================================================================
+layout( push_constant ) uniform Epsilon
+{
+   mat4 model;
+   uint materialIdx;
+};
+
+// View and environment
+// =================================================================================================
+layout( set = 0, binding = 0 ) uniform Alpha
+{
+   vec4 pos;
+   mat4 view;
+   mat4 proj;
+};
+
+// Material properties
+// =================================================================================================
+struct Material
+{
+   uint albedo;
+   uint normalMap;
+   uint heightMap;
+   uint metallicMap;
+   uint roughnessMap;
+   uint aoMap;
+   uint pad0;
+   uint pad1;
+};
+
+layout( std430, set = 0, binding = 2 ) readonly buffer Materials { Material materials[]; };
+
+layout( set = 1, binding = 0 ) uniform sampler2D textures[];
+
+// Inputs, compact layout declared in Pipelines.json
+layout( location = 0 ) in vec3 inPosition;  // Quantized, dequantized by the model matrix
+layout( location = 2 ) in vec2 inTexCoord;
+layout( location = 3 ) in vec2 inNormal;  // Octahedral-encoded
+
+// Outputs
+layout( location = 0 ) out vec3 outTexCoord;
+layout( location = 1 ) out vec3 outNormal;
+layout( location = 2 ) out vec3 fragPos;
+layout( location = 3 ) out vec3 viewPos;
+
+const float heightModulator = 0.0;
+
+// =================================================================================================
+
+// Keep in sync with VertexPacking::OctahedralDecode
+vec3 octDecode( vec2 e )
+{
+   vec3 n        = vec3( e.xy, 1.0 - abs( e.x ) - abs( e.y ) );
+   const float t = max( -n.z, 0.0 );
+   n.x += n.x >= 0.0 ? -t : t;
+   n.y += n.y >= 0.0 ? -t : t;
+   return normalize( n );
+}
+
+void main()
+{
+   const Material material = materials[materialIdx];
+
+   fragPos     = vec3( model * vec4( inPosition, 1.0 ) );  // World coordinates
+   vec3 normal = octDecode( inNormal );
+
+   // Applying height map modulation
+   float heightValue = textureLod( textures[material.heightMap], inTexCoord.xy, 0.0 ).r;
+   fragPos += ( heightModulator * normal * heightValue );
+
+   gl_Position = proj * view * vec4( fragPos, 1.0 );
+
+   outTexCoord = vec3( inTexCoord, 0.0 );
+   outNormal   = normal;
+   viewPos     = vec3( pos );
+}
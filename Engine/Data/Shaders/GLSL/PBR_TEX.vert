@@ -18,10 +18,10 @@ layout( set = 0, binding = 0 ) uniform Alpha
 
 layout( set = 1, binding = 5 ) uniform sampler2D heightMap;
 
-// Inputs
-layout( location = 0 ) in vec3 inPosition;
-layout( location = 2 ) in vec3 inTexCoord;
-layout( location = 3 ) in vec3 inNormal;
+// Inputs, compact layout declared in Pipelines.json
+layout( location = 0 ) in vec3 inPosition;  // Quantized, dequantized by the model matrix
+layout( location = 2 ) in vec2 inTexCoord;
+layout( location = 3 ) in vec2 inNormal;  // Octahedral-encoded
 
 // Outputs
 layout( location = 0 ) out vec3 outTexCoord;
@@ -33,10 +33,20 @@ const float heightModulator = 0.0;
 
 // =================================================================================================
 
+// Keep in sync with VertexPacking::OctahedralDecode
+vec3 octDecode( vec2 e )
+{
+   vec3 n        = vec3( e.xy, 1.0 - abs( e.x ) - abs( e.y ) );
+   const float t = max( -n.z, 0.0 );
+   n.x += n.x >= 0.0 ? -t : t;
+   n.y += n.y >= 0.0 ? -t : t;
+   return normalize( n );
+}
+
 void main()
 {
    fragPos     = vec3( model * vec4( inPosition, 1.0 ) );  // World coordinates
-   vec3 normal = normalize( inNormal );
+   vec3 normal = octDecode( inNormal );
 
    // Applying height map modulation
    float heightValue = texture( heightMap, inTexCoord.xy ).r;
@@ -44,7 +54,7 @@ void main()
 
    gl_Position = proj * view * vec4( fragPos, 1.0 );
 
-   outTexCoord = inTexCoord;
+   outTexCoord = vec3( inTexCoord, 0.0 );
    outNormal   = normal;
    viewPos     = vec3( pos );
 }
@@ -15,10 +15,10 @@ layout( set = 0, binding = 0 ) uniform Alpha
 
 // =================================================================================================
 
-// Inputs
-layout( location = 0 ) in vec3 inPosition;
-layout( location = 2 ) in vec3 inTexCoord;
-layout( location = 3 ) in vec3 inNormal;
+// Inputs, compact layout declared in Pipelines.json
+layout( location = 0 ) in vec3 inPosition;  // Quantized, dequantized by the model matrix
+layout( location = 2 ) in vec2 inTexCoord;
+layout( location = 3 ) in vec2 inNormal;  // Octahedral-encoded
 
 // Outputs
 layout( location = 0 ) out vec3 outTexCoord;
@@ -27,12 +27,22 @@ layout( location = 2 ) out vec3 fragPos;
 
 // =================================================================================================
 
+// Keep in sync with VertexPacking::OctahedralDecode
+vec3 octDecode( vec2 e )
+{
+   vec3 n        = vec3( e.xy, 1.0 - abs( e.x ) - abs( e.y ) );
+   const float t = max( -n.z, 0.0 );
+   n.x += n.x >= 0.0 ? -t : t;
+   n.y += n.y >= 0.0 ? -t : t;
+   return normalize( n );
+}
+
 void main()
 {
    fragPos = vec3( model * vec4( inPosition, 1.0 ) );  // World coordinates
 
    gl_Position = proj * view * vec4( fragPos, 1.0 );
 
-   outTexCoord = inTexCoord;
-   outNormal   = normalize( inNormal );
+   outTexCoord = vec3( inTexCoord, 0.0 );
+   outNormal   = octDecode( inNormal );
 }
@@ -0,0 +1,54 @@
+#!/bin/sh
+# Same as GLSLtoSPIRV.bat, stops at the first shader failing to compile or to validate
+set -e
+cd "$(dirname "$0")"
+
+echo "============== COMPILING ALL SHADERS =============="
+
+echo "Compiling Default Shaders"
+
+glslc GLSL/PASSTHROUGH.vert -o SPIR-V/PASSTHROUGH_VERT.spv
+glslc GLSL/PASSTHROUGH.frag -o SPIR-V/PASSTHROUGH_FRAG.spv
+
+# Render Pipelines
+glslc GLSL/DEFAULT.vert -o SPIR-V/DEFAULT_VERT.spv
+glslc GLSL/DEFAULT.frag -o SPIR-V/DEFAULT_FRAG.spv
+
+glslc GLSL/SKYBOX.frag -o SPIR-V/SKYBOX_FRAG.spv
+
+glslc GLSL/DEFAULT_DISPLACEMENT.vert -o SPIR-V/DEFAULT_DISPLACEMENT_VERT.spv
+
+glslc GLSL/DEFAULT_TEX.vert -o SPIR-V/DEFAULT_TEX_VERT.spv
+glslc GLSL/DEFAULT_TEX.frag -o SPIR-V/DEFAULT_TEX_FRAG.spv
+
+glslc GLSL/PHONG_TEX.vert -o SPIR-V/PHONG_TEX_VERT.spv
+glslc GLSL/PHONG_TEX.frag -o SPIR-V/PHONG_TEX_FRAG.spv
+
+glslc GLSL/PBR_TEX.vert -o SPIR-V/PBR_TEX_VERT.spv
+glslc GLSL/PBR_TEX.frag -o SPIR-V/PBR_TEX_FRAG.spv
+
+glslc GLSL/PBR_BINDLESS.vert -o SPIR-V/PBR_BINDLESS_VERT.spv
+glslc GLSL/PBR_BINDLESS.frag -o SPIR-V/PBR_BINDLESS_FRAG.spv
+
+# Compute
+glslc GLSL/FFTOCEAN_SPECTRA.comp -o SPIR-V/FFTOCEAN_SPECTRA_COMP.spv
+glslc GLSL/FFTOCEAN_FOURIERCOMPONENTS.comp -o SPIR-V/FFTOCEAN_FOURIERCOMPONENTS_COMP.spv
+glslc GLSL/FFTOCEAN_BUTTERFLYTEX.comp -o SPIR-V/FFTOCEAN_BUTTERFLYTEX_COMP.spv
+glslc GLSL/FFTOCEAN_BUTTERFLY.comp -o SPIR-V/FFTOCEAN_BUTTERFLY_COMP.spv
+glslc GLSL/FFTOCEAN_FFT.comp -o SPIR-V/FFTOCEAN_FFT_COMP.spv
+glslc --target-env=vulkan1.1 -DUSE_SUBGROUPS GLSL/FFTOCEAN_FFT.comp -o SPIR-V/FFTOCEAN_FFT_SUBGROUP_COMP.spv
+glslc GLSL/FFTOCEAN_INVERSIONPERMUTATION.comp -o SPIR-V/FFTOCEAN_INVERSIONPERMUTATION_COMP.spv
+
+# Others
+glslc GLSL/PROTEANCLOUDs.frag -o SPIR-V/PROTEANCLOUDS_FRAG.spv
+
+echo "============== COMPILING DONE =============="
+
+echo "============== VALIDATING ALL SHADERS =============="
+
+# Vulkan 1.1 covers the subgroup FFT, the others target Vulkan 1.0
+for shader in SPIR-V/*.spv; do
+   spirv-val --target-env vulkan1.1 "$shader"
+done
+
+echo "============== VALIDATING DONE =============="
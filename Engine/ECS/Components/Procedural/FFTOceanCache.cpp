@@ -0,0 +1,149 @@
+#include <ECS/Components/Procedural/FFTOceanCache.h>
+
+#include <Common/Assert.h>
+
+#include <Graphics/RenderInterface.h>
+
+#include <Algorithms/BitManipulation.h>
+
+#include <cmath>
+#include <unordered_map>
+
+namespace CYD::FFTOceanCache
+{
+bool SpectraKey::operator==( const SpectraKey& other ) const
+{
+   return resolution == other.resolution && cascades == other.cascades &&
+          amplitude == other.amplitude && gravity == other.gravity &&
+          windSpeed == other.windSpeed && windDirX == other.windDirX && windDirZ == other.windDirZ;
+}
+
+struct PrecomputedEntry
+{
+   TextureHandle butterflyTexture;
+   BufferHandle bitReversedIndices;
+   uint32_t refCount = 0;
+};
+
+struct SpectraEntry
+{
+   TextureHandle spectrum1;
+   TextureHandle spectrum2;
+   uint32_t refCount = 0;
+};
+
+static std::unordered_map<uint32_t, PrecomputedEntry> precomputedEntries;
+static std::unordered_map<SpectraKey, SpectraEntry> spectraEntries;
+
+// =================================================================================================
+// Butterfly texture and bit-reversed indices
+
+bool AcquirePrecomputed(
+    CmdListHandle cmdList,
+    uint32_t resolution,
+    TextureHandle& butterflyTexture,
+    BufferHandle& bitReversedIndices )
+{
+   PrecomputedEntry& entry = precomputedEntries[resolution];
+
+   const bool created = entry.refCount == 0;
+   if( created )
+   {
+      const uint32_t numberOfStages = static_cast<uint32_t>( std::log2( resolution ) );
+
+      TextureDescription butterflyDesc = {};
+      butterflyDesc.size               = resolution * numberOfStages * 4 * sizeof( float );
+      butterflyDesc.width              = numberOfStages;
+      butterflyDesc.height             = resolution;
+      butterflyDesc.type               = ImageType::TEXTURE_2D;
+      butterflyDesc.format             = PixelFormat::RGBA32F;
+      butterflyDesc.usage              = ImageUsage::STORAGE;
+      butterflyDesc.stages             = ShaderStage::COMPUTE_STAGE;
+
+      entry.butterflyTexture = GRIS::CreateTexture( cmdList, butterflyDesc );
+
+      std::vector<uint32_t> indices( resolution );
+      EMP::BitReversedIndices( indices.data(), resolution );
+
+      const size_t indicesDataSize = indices.size() * sizeof( indices[0] );
+      entry.bitReversedIndices     = GRIS::CreateBuffer( indicesDataSize );
+      GRIS::CopyToBuffer( entry.bitReversedIndices, indices.data(), 0, indicesDataSize );
+   }
+
+   ++entry.refCount;
+
+   butterflyTexture   = entry.butterflyTexture;
+   bitReversedIndices = entry.bitReversedIndices;
+
+   return created;
+}
+
+void ReleasePrecomputed( uint32_t resolution )
+{
+   const auto it = precomputedEntries.find( resolution );
+   CYDASSERT(
+       it != precomputedEntries.end() &&
+       "FFTOceanCache: Releasing precomputed resources that were not acquired" );
+
+   if( --it->second.refCount == 0 )
+   {
+      GRIS::DestroyTexture( it->second.butterflyTexture );
+      GRIS::DestroyBuffer( it->second.bitReversedIndices );
+      precomputedEntries.erase( it );
+   }
+}
+
+// =================================================================================================
+// Phillips spectra
+
+bool AcquireSpectra(
+    CmdListHandle cmdList,
+    const SpectraKey& key,
+    TextureHandle& spectrum1,
+    TextureHandle& spectrum2 )
+{
+   SpectraEntry& entry = spectraEntries[key];
+
+   const bool created = entry.refCount == 0;
+   if( created )
+   {
+      const uint32_t cascadeCount = static_cast<uint32_t>( key.cascades.size() );
+      const size_t layerSize      = key.resolution * key.resolution * 2 * sizeof( float );
+
+      // One layer per cascade
+      TextureDescription spectrumDesc = {};
+      spectrumDesc.size               = layerSize * cascadeCount;
+      spectrumDesc.width              = key.resolution;
+      spectrumDesc.height             = key.resolution;
+      spectrumDesc.layers             = cascadeCount;
+      spectrumDesc.type               = ImageType::TEXTURE_2D_ARRAY;
+      spectrumDesc.format             = PixelFormat::RG32F;
+      spectrumDesc.usage              = ImageUsage::STORAGE;
+      spectrumDesc.stages             = ShaderStage::COMPUTE_STAGE;
+
+      entry.spectrum1 = GRIS::CreateTexture( cmdList, spectrumDesc );
+      entry.spectrum2 = GRIS::CreateTexture( cmdList, spectrumDesc );
+   }
+
+   ++entry.refCount;
+
+   spectrum1 = entry.spectrum1;
+   spectrum2 = entry.spectrum2;
+
+   return created;
+}
+
+void ReleaseSpectra( const SpectraKey& key )
+{
+   const auto it = spectraEntries.find( key );
+   CYDASSERT(
+       it != spectraEntries.end() && "FFTOceanCache: Releasing spectra that were not acquired" );
+
+   if( --it->second.refCount == 0 )
+   {
+      GRIS::DestroyTexture( it->second.spectrum1 );
+      GRIS::DestroyTexture( it->second.spectrum2 );
+      spectraEntries.erase( it );
+   }
+}
+}
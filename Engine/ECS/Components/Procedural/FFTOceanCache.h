@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <Graphics/Handles/ResourceHandle.h>
+
+#include <vector>
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * Time-independent resources of the FFT oceans, shared by every ocean that would compute the same
+ * ones. The butterfly texture and bit-reversed indices only depend on the resolution, the Phillips
+ * spectra on the resolution, the cascades and the wind. Resources are created by the first ocean to
+ * acquire them and destroyed when the last one releases them, so many small patches with the same
+ * settings cost a single set of them.
+ */
+namespace CYD::FFTOceanCache
+{
+// Everything the Phillips spectra of an ocean depend on
+struct SpectraKey
+{
+   bool operator==( const SpectraKey& other ) const;
+   uint32_t resolution = 0;
+   std::vector<uint32_t> cascades;
+   float amplitude = 0.0f;
+   float gravity   = 0.0f;
+   float windSpeed = 0.0f;
+   float windDirX  = 0.0f;
+   float windDirZ  = 0.0f;
+};
+
+// Both acquire functions return true when the resources were just created, in which case the caller
+// has to generate their content. The bit-reversed indices are filled in already.
+bool AcquirePrecomputed(
+    CmdListHandle cmdList,
+    uint32_t resolution,
+    TextureHandle& butterflyTexture,
+    BufferHandle& bitReversedIndices );
+void ReleasePrecomputed( uint32_t resolution );
+
+bool AcquireSpectra(
+    CmdListHandle cmdList,
+    const SpectraKey& key,
+    TextureHandle& spectrum1,
+    TextureHandle& spectrum2 );
+void ReleaseSpectra( const SpectraKey& key );
+}
+
+// ================================================================================================
+// Hashing Functions
+
+template <>
+struct std::hash<CYD::FFTOceanCache::SpectraKey>
+{
+   size_t operator()( const CYD::FFTOceanCache::SpectraKey& key ) const noexcept
+   {
+      size_t seed = 0;
+      hashCombine( seed, key.resolution );
+      for( const uint32_t cascade : key.cascades )
+      {
+         hashCombine( seed, cascade );
+      }
+      hashCombine( seed, key.amplitude );
+      hashCombine( seed, key.gravity );
+      hashCombine( seed, key.windSpeed );
+      hashCombine( seed, key.windDirX );
+      hashCombine( seed, key.windDirZ );
+
+      return seed;
+   }
+};
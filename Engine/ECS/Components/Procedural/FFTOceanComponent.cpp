@@ -1,5 +1,6 @@
 #include <ECS/Components/Procedural/FFTOceanComponent.h>
 
+#include <Common/Assert.h>
 #include <Common/PhysicsConstants.h>
 
 #include <Graphics/RenderInterface.h>
@@ -21,17 +22,49 @@ FFTOceanComponent::FFTOceanComponent(
    parameters.windSpeed           = windSpeed;
    parameters.windDirX            = windDirX;
    parameters.windDirZ            = windDirZ;
+
+   cascades.push_back( horizontalDimension );
+}
+
+FFTOceanComponent::FFTOceanComponent(
+    uint32_t resolution,
+    const std::vector<uint32_t>& horizontalDimensions,
+    float amplitude,
+    float windSpeed,
+    float windDirX,
+    float windDirZ )
+    : FFTOceanComponent(
+          resolution,
+          horizontalDimensions.front(),
+          amplitude,
+          windSpeed,
+          windDirX,
+          windDirZ )
+{
+   CYDASSERT(
+       horizontalDimensions.size() <= MAX_CASCADES &&
+       "FFTOceanComponent: Too many cascades for the displacement shader" );
+
+   cascades = horizontalDimensions;
 }
 
 FFTOceanComponent::~FFTOceanComponent()
 {
-   GRIS::DestroyTexture( spectrum1 );
-   GRIS::DestroyTexture( spectrum2 );
-   GRIS::DestroyTexture( butterflyTexture );
-   GRIS::DestroyBuffer( bitReversedIndices );
-
-   GRIS::DestroyTexture( fourierComponentsY );
-   GRIS::DestroyTexture( fourierComponentsX );
-   GRIS::DestroyTexture( fourierComponentsZ );
+   if( precomputedResolution > 0 )
+   {
+      FFTOceanCache::ReleasePrecomputed( precomputedResolution );
+   }
+   if( spectraKey.resolution > 0 )
+   {
+      FFTOceanCache::ReleaseSpectra( spectraKey );
+   }
+
+   GRIS::DestroyTexture( fourierComponents );
+   GRIS::DestroyTexture( pingpongTex );
+
+   for( const Readback& readback : readbacks )
+   {
+      GRIS::DestroyBuffer( readback.buffer );
+   }
 }
 }
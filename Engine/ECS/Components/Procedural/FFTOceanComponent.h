@@ -2,9 +2,13 @@
 
 #include <ECS/Components/BaseComponent.h>
 #include <ECS/Components/ComponentTypes.h>
+#include <ECS/Components/Procedural/FFTOceanCache.h>
+#include <ECS/Components/Procedural/FFTOceanHeightField.h>
 
 #include <Graphics/Handles/ResourceHandle.h>
 
+#include <vector>
+
 namespace CYD
 {
 class FFTOceanComponent : public BaseComponent
@@ -18,11 +22,21 @@ class FFTOceanComponent : public BaseComponent
        float windSpeed,
        float windDirX,
        float windDirZ );
+   FFTOceanComponent(
+       uint32_t resolution,
+       const std::vector<uint32_t>& horizontalDimensions,
+       float amplitude,
+       float windSpeed,
+       float windDirX,
+       float windDirZ );
    COPIABLE( FFTOceanComponent );
    virtual ~FFTOceanComponent();
 
    static constexpr ComponentType TYPE = ComponentType::OCEAN;
 
+   // The displacement shader takes the dimensions of the cascades as a single vec4
+   static constexpr uint32_t MAX_CASCADES = 4;
+
    // Properties used as a single push constant in the multiple shader passes
    struct Parameters
    {
@@ -31,36 +45,58 @@ class FFTOceanComponent : public BaseComponent
       uint32_t pingpong            = 0;  // Which texture should be used during the FFT operations
       uint32_t direction           = 0;  // 0-Horizontal 1-Vertical butterfly operation
       uint32_t stage               = 0;  // Which stage of the butterfly operation are we at (log2N)
-      uint32_t componentMask       = 0;  // Used in displacement computation for RGB/XYZ masking
       float amplitude              = 0.0f;  // A
       float gravity                = 0.0f;  // Usually 9.8m/s^2
       float windSpeed              = 0.0f;
       float windDirX               = 0.0f;
       float windDirZ               = 0.0f;
       float time                   = 0.0f;
+      uint32_t cascade             = 0;  // Which cascade a per-cascade pass is working on
    } parameters;
 
-   // Time-indepdendent textures (precomputed)
+   // Horizontal dimension of every cascade, from the largest to the smallest. Cascades share the
+   // resolution and the wind, they are the layers of the same textures and are computed in the same
+   // dispatches. Set resolutionChanged after changing them.
+   std::vector<uint32_t> cascades;
+
+   // Time-indepdendent textures (precomputed), one layer per cascade
    // These textures are sampled each frame and are constant across time until one of the properties
-   // for pre-computed textures below is changed.
+   // for pre-computed textures below is changed. They are shared with every other ocean computing
+   // the same ones, see FFTOceanCache.
    TextureHandle spectrum1;         // ~h0(k) - Phillips spectrum
    TextureHandle spectrum2;         // ~h0(-k) - Phillips spectrum
    TextureHandle butterflyTexture;  // twiddle indices
    BufferHandle bitReversedIndices;
 
-   // Time-dependent textures
-   // These textures are computed every frame.
-   TextureHandle fourierComponentsX;  //
-   TextureHandle fourierComponentsY;  // ~h(k,t)
-   TextureHandle fourierComponentsZ;  //
+   // What the shared resources above were acquired with, released along with the ocean
+   uint32_t precomputedResolution = 0;
+   FFTOceanCache::SpectraKey spectraKey;
 
+   // Time-dependent textures
+   // These textures are computed every frame. The X, Y and Z components of every cascade are the
+   // layers of a single texture so that every butterfly stage transforms all of them at once.
+   TextureHandle fourierComponents;  // ~h(k,t)
    TextureHandle pingpongTex;
 
+   // Host readback of the displacement
+   // The displacement map is copied to one of these buffers whenever one is free, and the most
+   // recent copy the device is done with becomes the height field. There is one buffer per frame in
+   // flight plus one, so the device never waits on the host and queries lag one to two frames.
+   static constexpr uint32_t READBACK_COUNT = 3;
+   struct Readback
+   {
+      BufferHandle buffer;
+      float time   = 0.0f;  // Ocean time of the copied displacement
+      bool pending = false;
+   };
+   Readback readbacks[READBACK_COUNT];
+   FFTOceanHeightField heightField;
+
    float modulationY = 1.0f;  // Modulations applied when rendering the heightmap
    float modulationX = 1.0f;
    float modulationZ = 1.0f;
 
-   bool needsUpdate       = true;
+   bool needsUpdate       = true;  // The wind or the amplitude changed, only the spectra follow
    bool resolutionChanged = true;
 };
 }
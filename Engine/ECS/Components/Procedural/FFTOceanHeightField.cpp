@@ -0,0 +1,263 @@
+#include <ECS/Components/Procedural/FFTOceanHeightField.h>
+
+#include <Common/Assert.h>
+
+#include <algorithm>
+
+#include <emmintrin.h>
+
+static constexpr uint32_t LANES = 4;
+
+namespace CYD
+{
+// =================================================================================================
+// SSE helpers
+
+// Integer part rounded towards negative infinity and what is left of the coordinate, SSE2 has no
+// floor instruction
+static void splitCoordinates( __m128 x, __m128i& outCell, __m128& outFraction )
+{
+   const __m128i truncated = _mm_cvttps_epi32( x );
+
+   // Truncation rounds negative coordinates up, the comparison mask is -1 in those lanes
+   const __m128 roundedUp = _mm_cmplt_ps( x, _mm_cvtepi32_ps( truncated ) );
+
+   outCell     = _mm_add_epi32( truncated, _mm_castps_si128( roundedUp ) );
+   outFraction = _mm_sub_ps( x, _mm_cvtepi32_ps( outCell ) );
+}
+
+// Bilinear blend of four 4-float values, the weights being already broadcast
+static __m128 blend(
+    const float* p00,
+    const float* p10,
+    const float* p01,
+    const float* p11,
+    const __m128* pWeights )
+{
+   const __m128 c00 = _mm_mul_ps( _mm_loadu_ps( p00 ), pWeights[0] );
+   const __m128 c10 = _mm_mul_ps( _mm_loadu_ps( p10 ), pWeights[1] );
+   const __m128 c01 = _mm_mul_ps( _mm_loadu_ps( p01 ), pWeights[2] );
+   const __m128 c11 = _mm_mul_ps( _mm_loadu_ps( p11 ), pWeights[3] );
+
+   return _mm_add_ps( _mm_add_ps( c00, c10 ), _mm_add_ps( c01, c11 ) );
+}
+
+// =================================================================================================
+// Snapshot
+
+static void storeXYZ( float* pDst, const glm::vec3& value )
+{
+   pDst[0] = value.x;
+   pDst[1] = value.y;
+   pDst[2] = value.z;
+   pDst[3] = 0.0f;
+}
+
+void FFTOceanHeightField::update(
+    const glm::vec4* pTexels,
+    uint32_t resolution,
+    const uint32_t* pDimensions,
+    uint32_t cascadeCount,
+    float time )
+{
+   CYDASSERT(
+       resolution > 0 && ( resolution & ( resolution - 1 ) ) == 0 &&
+       "FFTOceanHeightField: Resolution has to be a power of two" );
+   CYDASSERT( cascadeCount > 0 && "FFTOceanHeightField: There has to be at least one cascade" );
+
+   const size_t layerSize = static_cast<size_t>( resolution ) * resolution;
+
+   m_texels.resize( layerSize * cascadeCount );
+   m_texelsPerUnit.resize( cascadeCount );
+   m_resolution = resolution;
+   m_time       = time;
+
+   // The patches are periodic, neighbours wrap around
+   const uint32_t mask = resolution - 1;
+
+   for( uint32_t cascade = 0; cascade < cascadeCount; ++cascade )
+   {
+      const float texelsPerUnit = static_cast<float>( resolution ) / pDimensions[cascade];
+      m_texelsPerUnit[cascade]  = texelsPerUnit;
+
+      // Central differences span two texels
+      const float differenceScale = 0.5f * texelsPerUnit;
+
+      const glm::vec4* pLayer = pTexels + layerSize * cascade;
+      Texel* pLayerTexels     = m_texels.data() + layerSize * cascade;
+
+      for( uint32_t r = 0; r < resolution; ++r )
+      {
+         const size_t row  = static_cast<size_t>( r ) * resolution;
+         const size_t up   = static_cast<size_t>( ( r + 1 ) & mask ) * resolution;
+         const size_t down = static_cast<size_t>( ( r - 1 ) & mask ) * resolution;
+
+         for( uint32_t c = 0; c < resolution; ++c )
+         {
+            const uint32_t right = ( c + 1 ) & mask;
+            const uint32_t left  = ( c - 1 ) & mask;
+
+            const glm::vec3 slopeX( pLayer[row + right] - pLayer[row + left] );
+            const glm::vec3 slopeZ( pLayer[up + c] - pLayer[down + c] );
+
+            Texel& texel = pLayerTexels[row + c];
+            storeXYZ( texel.displacement, glm::vec3( pLayer[row + c] ) );
+            storeXYZ( texel.slopeX, slopeX * differenceScale );
+            storeXYZ( texel.slopeZ, slopeZ * differenceScale );
+         }
+      }
+   }
+}
+
+// =================================================================================================
+// Queries
+
+void FFTOceanHeightField::sample(
+    const glm::vec2* pPositions,
+    size_t count,
+    glm::vec3* pDisplacements,
+    glm::vec3* pNormals ) const
+{
+   if( isEmpty() )
+   {
+      if( pDisplacements )
+      {
+         std::fill( pDisplacements, pDisplacements + count, glm::vec3( 0.0f ) );
+      }
+      if( pNormals )
+      {
+         std::fill( pNormals, pNormals + count, glm::vec3( 0.0f, 1.0f, 0.0f ) );
+      }
+      return;
+   }
+
+   const size_t layerSize = static_cast<size_t>( m_resolution ) * m_resolution;
+
+   const __m128 one   = _mm_set1_ps( 1.0f );
+   const __m128i mask = _mm_set1_epi32( static_cast<int>( m_resolution - 1 ) );
+   const __m128i next = _mm_set1_epi32( 1 );
+
+   for( size_t first = 0; first < count; first += LANES )
+   {
+      const size_t laneCount = std::min<size_t>( LANES, count - first );
+
+      // The last batch is padded with the origin, the padding lanes are never written out
+      alignas( 16 ) float xs[LANES] = {};
+      alignas( 16 ) float zs[LANES] = {};
+      for( size_t lane = 0; lane < laneCount; ++lane )
+      {
+         xs[lane] = pPositions[first + lane].x;
+         zs[lane] = pPositions[first + lane].y;
+      }
+
+      const __m128 x = _mm_load_ps( xs );
+      const __m128 z = _mm_load_ps( zs );
+
+      // Sums of the cascades for each position
+      __m128 displacements[LANES];
+      __m128 slopesX[LANES];
+      __m128 slopesZ[LANES];
+      for( size_t lane = 0; lane < LANES; ++lane )
+      {
+         displacements[lane] = _mm_setzero_ps();
+         slopesX[lane]       = _mm_setzero_ps();
+         slopesZ[lane]       = _mm_setzero_ps();
+      }
+
+      for( size_t cascade = 0; cascade < m_texelsPerUnit.size(); ++cascade )
+      {
+         const Texel* pLayer = m_texels.data() + layerSize * cascade;
+         const __m128 scale  = _mm_set1_ps( m_texelsPerUnit[cascade] );
+
+         // Texel coordinates and bilinear weights of the four positions at once
+         __m128i cellU, cellV;
+         __m128 fracU, fracV;
+         splitCoordinates( _mm_mul_ps( x, scale ), cellU, fracU );
+         splitCoordinates( _mm_mul_ps( z, scale ), cellV, fracV );
+
+         alignas( 16 ) int32_t u0[LANES];
+         alignas( 16 ) int32_t u1[LANES];
+         alignas( 16 ) int32_t v0[LANES];
+         alignas( 16 ) int32_t v1[LANES];
+         _mm_store_si128( reinterpret_cast<__m128i*>( u0 ), _mm_and_si128( cellU, mask ) );
+         _mm_store_si128(
+             reinterpret_cast<__m128i*>( u1 ),
+             _mm_and_si128( _mm_add_epi32( cellU, next ), mask ) );
+         _mm_store_si128( reinterpret_cast<__m128i*>( v0 ), _mm_and_si128( cellV, mask ) );
+         _mm_store_si128(
+             reinterpret_cast<__m128i*>( v1 ),
+             _mm_and_si128( _mm_add_epi32( cellV, next ), mask ) );
+
+         const __m128 restU = _mm_sub_ps( one, fracU );
+         const __m128 restV = _mm_sub_ps( one, fracV );
+
+         alignas( 16 ) float weights[4][LANES];
+         _mm_store_ps( weights[0], _mm_mul_ps( restU, restV ) );
+         _mm_store_ps( weights[1], _mm_mul_ps( fracU, restV ) );
+         _mm_store_ps( weights[2], _mm_mul_ps( restU, fracV ) );
+         _mm_store_ps( weights[3], _mm_mul_ps( fracU, fracV ) );
+
+         // Each texel holding four floats per channel, the channels of a sample are blended at once
+         for( size_t lane = 0; lane < laneCount; ++lane )
+         {
+            const size_t row0 = static_cast<size_t>( v0[lane] ) * m_resolution;
+            const size_t row1 = static_cast<size_t>( v1[lane] ) * m_resolution;
+
+            const Texel& t00 = pLayer[row0 + u0[lane]];
+            const Texel& t10 = pLayer[row0 + u1[lane]];
+            const Texel& t01 = pLayer[row1 + u0[lane]];
+            const Texel& t11 = pLayer[row1 + u1[lane]];
+
+            const __m128 laneWeights[] = {_mm_set1_ps( weights[0][lane] ),
+                                          _mm_set1_ps( weights[1][lane] ),
+                                          _mm_set1_ps( weights[2][lane] ),
+                                          _mm_set1_ps( weights[3][lane] )};
+
+            if( pDisplacements )
+            {
+               displacements[lane] = _mm_add_ps(
+                   displacements[lane],
+                   blend(
+                       t00.displacement,
+                       t10.displacement,
+                       t01.displacement,
+                       t11.displacement,
+                       laneWeights ) );
+            }
+
+            if( pNormals )
+            {
+               slopesX[lane] = _mm_add_ps(
+                   slopesX[lane],
+                   blend( t00.slopeX, t10.slopeX, t01.slopeX, t11.slopeX, laneWeights ) );
+               slopesZ[lane] = _mm_add_ps(
+                   slopesZ[lane],
+                   blend( t00.slopeZ, t10.slopeZ, t01.slopeZ, t11.slopeZ, laneWeights ) );
+            }
+         }
+      }
+
+      alignas( 16 ) float result[4];
+      for( size_t lane = 0; lane < laneCount; ++lane )
+      {
+         if( pDisplacements )
+         {
+            _mm_store_ps( result, displacements[lane] );
+            pDisplacements[first + lane] = glm::vec3( result[0], result[1], result[2] );
+         }
+
+         if( pNormals )
+         {
+            // Tangents of the displaced surface along X and Z
+            _mm_store_ps( result, slopesX[lane] );
+            const glm::vec3 tangent( 1.0f + result[0], result[1], result[2] );
+
+            _mm_store_ps( result, slopesZ[lane] );
+            const glm::vec3 bitangent( result[0], result[1], 1.0f + result[2] );
+
+            pNormals[first + lane] = glm::normalize( glm::cross( bitangent, tangent ) );
+         }
+      }
+   }
+}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * Host copy of an FFT ocean's displacement maps, for gameplay and physics to query wave heights
+ * without going through the device. The slopes of every cascade are derived from its displacement
+ * once per snapshot, every texel keeping its displacement and slopes next to each other so that a
+ * bilinear sample is three SSE loads per corner.
+ *
+ * Positions are in the local space of the ocean, texel (c, r) of a cascade of dimension L resting
+ * at (c, r) * L / N like in the displacement shader, and each cascade repeats every L. The sampled
+ * displacement is the one of the point resting at the position, which is close enough to the wave
+ * height there as long as the horizontal displacement stays small next to a texel.
+ */
+namespace CYD
+{
+class FFTOceanHeightField final
+{
+  public:
+   FFTOceanHeightField() = default;
+   COPIABLE( FFTOceanHeightField );
+   ~FFTOceanHeightField() = default;
+
+   // Texels of the displacement maps as they are read back, one layer after the other with the XYZ
+   // displacement in RGB, and the horizontal dimension of each layer
+   void update(
+       const glm::vec4* pTexels,
+       uint32_t resolution,
+       const uint32_t* pDimensions,
+       uint32_t cascadeCount,
+       float time );
+
+   // No snapshot was read back yet, samples are all flat
+   bool isEmpty() const noexcept { return m_resolution == 0; }
+
+   uint32_t getResolution() const noexcept { return m_resolution; }
+   float getTime() const noexcept { return m_time; }  // Ocean time the snapshot was computed at
+
+   // Samples the displacement and normal at every position (x, z), summed over the cascades four
+   // positions at a time. Either output can be null when it is not needed.
+   void sample(
+       const glm::vec2* pPositions,
+       size_t count,
+       glm::vec3* pDisplacements,
+       glm::vec3* pNormals ) const;
+
+  private:
+   struct Texel
+   {
+      float displacement[4];  // XYZ, W unused
+      float slopeX[4];        // Derivatives of the displacement per unit along X and Z
+      float slopeZ[4];
+   };
+
+   std::vector<Texel> m_texels;         // One layer per cascade
+   std::vector<float> m_texelsPerUnit;  // N / L of every cascade
+   uint32_t m_resolution = 0;
+   float m_time          = 0.0f;
+};
+}
@@ -28,5 +28,8 @@ class MeshComponent : public BaseComponent
 
    // Path of the mesh asset
    std::string_view asset;
+
+   // Screen-space error in pixels tolerated when picking a coarser level of detail of the mesh
+   float lodPixelError = 1.0f;
 };
 }
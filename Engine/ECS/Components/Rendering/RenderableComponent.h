@@ -6,6 +6,7 @@
 
 #include <Graphics/GraphicsTypes.h>
 #include <Graphics/StaticPipelines.h>
+#include <Graphics/Handles/ResourceHandle.h>
 
 // ================================================================================================
 // Definition
@@ -34,6 +35,13 @@ class RenderableComponent : public BaseComponent
    // Name of the material asset
    std::string_view asset;
 
+   // Vertex displacement of the DISPLACEMENT pipeline, one layer per cascade. Created and filled
+   // by the system simulating the surface, for instance FFTOceanSystem.
+   TextureHandle displacement;
+
+   // Horizontal dimension covered by every layer of the displacement, 0 past the last one
+   glm::vec4 cascadeDimensions = glm::vec4( 0.0f );
+
    bool isOccluder = false;  // Should this renderable cast a shadow?
 };
 }
@@ -11,6 +11,12 @@ namespace CYD
 {
 InputSystem::InputSystem( const Window& window ) : m_window( window )
 {
+   if( m_window.isHeadless() )
+   {
+      // No window to receive input from
+      return;
+   }
+
    // Settings instance of input interpreter to this window
    // TODO Maybe there's a better way to do this?
    glfwSetWindowUserPointer( m_window.getGLFWwindow(), this );
@@ -43,7 +49,10 @@ void InputSystem::tick( double /*deltaS*/ )
    input.cursorDelta     = glm::vec2( 0.0f );
 
    // Polling GLFW to trigger the callbacks
-   glfwPollEvents();
+   if( !m_window.isHeadless() )
+   {
+      glfwPollEvents();
+   }
 }
 
 void InputSystem::_keyCallback(
@@ -0,0 +1,793 @@
+#include <ECS/Systems/Procedural/FFTOceanCPU.h>
+
+#include <Common/Assert.h>
+#include <Common/PhysicsConstants.h>
+
+#include <Graphics/RenderInterface.h>
+
+#include <ECS/Components/Rendering/RenderableComponent.h>
+#include <ECS/Systems/Procedural/FFTOceanSystem.h>
+
+#include <Algorithms/BitManipulation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+
+#include <emmintrin.h>
+
+static constexpr float PI = 3.1415926535897932384626433832795f;
+
+// Columns transformed together, a cache line of each plane
+static constexpr uint32_t COLUMN_BLOCK = 16;
+static constexpr uint32_t LANES        = 4;
+
+namespace CYD
+{
+// =================================================================================================
+// SSE helpers
+
+static void complexMul(
+    __m128 ar,
+    __m128 ai,
+    __m128 br,
+    __m128 bi,
+    __m128& outReal,
+    __m128& outImag )
+{
+   outReal = _mm_sub_ps( _mm_mul_ps( ar, br ), _mm_mul_ps( ai, bi ) );
+   outImag = _mm_add_ps( _mm_mul_ps( ar, bi ), _mm_mul_ps( ai, br ) );
+}
+
+// Cephes single precision sine and cosine, about 1e-7 of absolute error for arguments that are
+// not too large. Ocean waves go through thousands of periods in a session, which is well within.
+static void sinCos( __m128 x, __m128& outSin, __m128& outCos )
+{
+   const __m128 signMask = _mm_castsi128_ps( _mm_set1_epi32( static_cast<int>( 0x80000000 ) ) );
+
+   __m128 sinSign = _mm_and_ps( x, signMask );
+   x              = _mm_andnot_ps( signMask, x );
+
+   const __m128i one  = _mm_set1_epi32( 1 );
+   const __m128i two  = _mm_set1_epi32( 2 );
+   const __m128i four = _mm_set1_epi32( 4 );
+
+   // Octant of the argument, rounded up to an even one
+   __m128i octant = _mm_cvttps_epi32( _mm_mul_ps( x, _mm_set1_ps( 1.27323954473516f ) ) );
+   octant         = _mm_andnot_si128( one, _mm_add_epi32( octant, one ) );
+   const __m128 y = _mm_cvtepi32_ps( octant );
+
+   const __m128 swapSinSign =
+       _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( octant, four ), 29 ) );
+   const __m128 cosSign = _mm_castsi128_ps(
+       _mm_slli_epi32( _mm_andnot_si128( _mm_sub_epi32( octant, two ), four ), 29 ) );
+   const __m128 polyMask = _mm_castsi128_ps(
+       _mm_cmpeq_epi32( _mm_and_si128( octant, two ), _mm_setzero_si128() ) );
+
+   sinSign = _mm_xor_ps( sinSign, swapSinSign );
+
+   // Extended precision modular arithmetic, x - y * pi / 4
+   x = _mm_add_ps( x, _mm_mul_ps( y, _mm_set1_ps( -0.78515625f ) ) );
+   x = _mm_add_ps( x, _mm_mul_ps( y, _mm_set1_ps( -2.4187564849853515625e-4f ) ) );
+   x = _mm_add_ps( x, _mm_mul_ps( y, _mm_set1_ps( -3.77489497744594108e-8f ) ) );
+
+   const __m128 z = _mm_mul_ps( x, x );
+
+   __m128 cosPoly = _mm_set1_ps( 2.443315711809948e-5f );
+   cosPoly        = _mm_add_ps( _mm_mul_ps( cosPoly, z ), _mm_set1_ps( -1.388731625493765e-3f ) );
+   cosPoly        = _mm_add_ps( _mm_mul_ps( cosPoly, z ), _mm_set1_ps( 4.166664568298827e-2f ) );
+   cosPoly        = _mm_mul_ps( _mm_mul_ps( cosPoly, z ), z );
+   cosPoly        = _mm_sub_ps( cosPoly, _mm_mul_ps( z, _mm_set1_ps( 0.5f ) ) );
+   cosPoly        = _mm_add_ps( cosPoly, _mm_set1_ps( 1.0f ) );
+
+   __m128 sinPoly = _mm_set1_ps( -1.9515295891e-4f );
+   sinPoly        = _mm_add_ps( _mm_mul_ps( sinPoly, z ), _mm_set1_ps( 8.3321608736e-3f ) );
+   sinPoly        = _mm_add_ps( _mm_mul_ps( sinPoly, z ), _mm_set1_ps( -1.6666654611e-1f ) );
+   sinPoly        = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( sinPoly, z ), x ), x );
+
+   // Depending on the octant, the sine is either the sine or the cosine polynomial
+   const __m128 sinValue =
+       _mm_or_ps( _mm_and_ps( polyMask, sinPoly ), _mm_andnot_ps( polyMask, cosPoly ) );
+   const __m128 cosValue =
+       _mm_or_ps( _mm_and_ps( polyMask, cosPoly ), _mm_andnot_ps( polyMask, sinPoly ) );
+
+   outSin = _mm_xor_ps( sinValue, sinSign );
+   outCos = _mm_xor_ps( cosValue, cosSign );
+}
+
+// =================================================================================================
+// Spectra
+
+// Ports of the functions of FFTOCEAN_SPECTRA, GLSL's mod and fract included
+static float glslMod( float x, float y ) { return x - y * std::floor( x / y ); }
+
+static float random( float seedX, float seedY )
+{
+   const float dt = seedX * 12.9898f + seedY * 78.233f;
+   const float sn = glslMod( dt, 3.14f );
+   const float v  = std::sin( sn ) * 43758.5453f;
+   return v - std::floor( v );
+}
+
+static glm::vec4 boxMullerTransform( uint32_t x, uint32_t y, uint32_t resolution )
+{
+   const float u = static_cast<float>( x ) / static_cast<float>( resolution );
+   const float v = static_cast<float>( y ) / static_cast<float>( resolution );
+
+   const float noise0 = std::clamp( random( u, v ), 0.001f, 1.0f );
+   const float noise1 = std::clamp( random( -u, -v ), 0.001f, 1.0f );
+   const float noise2 = std::clamp( random( -u, v ), 0.001f, 1.0f );
+   const float noise3 = std::clamp( random( u, -v ), 0.001f, 1.0f );
+
+   const float u0 = 2.0f * PI * noise0;
+   const float v0 = std::sqrt( -2.0f * std::log( noise1 ) );
+   const float u1 = 2.0f * PI * noise2;
+   const float v1 = std::sqrt( -2.0f * std::log( noise3 ) );
+
+   return glm::vec4(
+       v0 * std::cos( u0 ), v0 * std::sin( u0 ), v1 * std::cos( u1 ), v1 * std::sin( u1 ) );
+}
+
+static glm::vec2
+getWaveVector( uint32_t x, uint32_t y, const FFTOceanComponent::Parameters& params )
+{
+   const float half = static_cast<float>( params.resolution ) / 2.0f;
+   const float dim  = static_cast<float>( params.horizontalDimension );
+   return glm::vec2(
+       2.0f * PI * ( static_cast<float>( x ) - half ) / dim,
+       2.0f * PI * ( static_cast<float>( y ) - half ) / dim );
+}
+
+// =================================================================================================
+// Simulation
+
+FFTOceanCPU::FFTOceanCPU()
+{
+   const uint32_t threadCount = std::max( std::thread::hardware_concurrency(), 1u );
+
+   m_workers.reserve( threadCount - 1 );
+   for( uint32_t i = 1; i < threadCount; ++i )
+   {
+      m_workers.emplace_back( &FFTOceanCPU::_workerLoop, this, i );
+   }
+}
+
+void FFTOceanCPU::setParameters( const FFTOceanComponent::Parameters& parameters )
+{
+   CYDASSERT(
+       parameters.resolution >= COLUMN_BLOCK &&
+       ( parameters.resolution & ( parameters.resolution - 1 ) ) == 0 &&
+       "FFTOceanCPU: Resolution has to be a power of two of at least 16" );
+
+   const FFTOceanComponent::Parameters& prev = m_parameters;
+
+   const bool resolutionChanged = parameters.resolution != prev.resolution;
+   const bool spectraChanged =
+       resolutionChanged || parameters.horizontalDimension != prev.horizontalDimension ||
+       parameters.amplitude != prev.amplitude || parameters.gravity != prev.gravity ||
+       parameters.windSpeed != prev.windSpeed || parameters.windDirX != prev.windDirX ||
+       parameters.windDirZ != prev.windDirZ;
+
+   m_parameters = parameters;
+
+   if( resolutionChanged )
+   {
+      _resize();
+   }
+
+   if( spectraChanged )
+   {
+      _generateSpectra();
+   }
+}
+
+void FFTOceanCPU::_resize()
+{
+   const uint32_t n        = m_parameters.resolution;
+   const size_t texelCount = static_cast<size_t>( n ) * n;
+
+   for( ComplexMap* pMap : {&m_spectrum1, &m_spectrum2} )
+   {
+      pMap->real.assign( texelCount, 0.0f );
+      pMap->imag.assign( texelCount, 0.0f );
+   }
+
+   for( ComplexMap& map : m_fourierComponents )
+   {
+      map.real.assign( texelCount, 0.0f );
+      map.imag.assign( texelCount, 0.0f );
+   }
+
+   m_dispersion.assign( texelCount, 0.0f );
+   m_directionX.assign( texelCount, 0.0f );
+   m_directionZ.assign( texelCount, 0.0f );
+   m_displacement.assign( texelCount, glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f ) );
+
+   // Same permutation the butterfly texture of the GPU path is built from
+   m_bitReversed.resize( n );
+   std::iota( m_bitReversed.begin(), m_bitReversed.end(), static_cast<uint32_t>( 0 ) );
+   EMP::BitReversalPermutation( m_bitReversed );
+
+   // Inverse transform, the twiddles turn counter-clockwise
+   m_twiddleReal.resize( n );
+   m_twiddleImag.resize( n );
+   for( uint32_t i = 0; i < n; ++i )
+   {
+      const double angle = 2.0 * 3.14159265358979323846 * i / n;
+      m_twiddleReal[i]   = static_cast<float>( std::cos( angle ) );
+      m_twiddleImag[i]   = static_cast<float>( std::sin( angle ) );
+   }
+
+   m_stageCount = static_cast<uint32_t>( std::log2( n ) );
+}
+
+void FFTOceanCPU::_generateSpectra()
+{
+   const FFTOceanComponent::Parameters& params = m_parameters;
+   const uint32_t n                            = params.resolution;
+
+   const float L                 = ( params.windSpeed * params.windSpeed ) / params.gravity;
+   const glm::vec2 windDirection = glm::normalize( glm::vec2( params.windDirX, params.windDirZ ) );
+   const float damping           = std::pow( params.horizontalDimension / 2000.0f, 2.0f );
+
+   _parallelFor( n, [&]( uint32_t begin, uint32_t end ) {
+      for( uint32_t y = begin; y < end; ++y )
+      {
+         for( uint32_t x = 0; x < n; ++x )
+         {
+            const size_t idx = static_cast<size_t>( y ) * n + x;
+
+            const glm::vec2 k              = getWaveVector( x, y, params );
+            const float magnitude          = std::max( glm::length( k ), 0.00001f );
+            const float magnitudeSquared   = magnitude * magnitude;
+
+            m_dispersion[idx] = std::sqrt( params.gravity * magnitude );
+            m_directionX[idx] = -k.x / magnitude;
+            m_directionZ[idx] = -k.y / magnitude;
+
+            // The wave vector of the constant term cannot be normalized, the compute shader gets
+            // an undefined value there and the CPU backend leaves it at zero
+            if( k.x == 0.0f && k.y == 0.0f )
+            {
+               m_spectrum1.real[idx] = m_spectrum1.imag[idx] = 0.0f;
+               m_spectrum2.real[idx] = m_spectrum2.imag[idx] = 0.0f;
+               continue;
+            }
+
+            const glm::vec2 kNorm = k / glm::length( k );
+
+            const float commonMultiplier =
+                ( params.amplitude / ( magnitudeSquared * magnitudeSquared ) ) *
+                std::exp( -( 1.0f / ( magnitudeSquared * L * L ) ) ) *
+                std::exp( -magnitudeSquared * damping );
+
+            const float kDotWind = glm::dot( kNorm, windDirection );
+            const float h0k      = std::clamp(
+                std::sqrt( commonMultiplier * kDotWind * kDotWind ) / std::sqrt( 2.0f ),
+                -4000.0f,
+                4000.0f );
+
+            // Same value as h0k, the direction is squared
+            const float h0minusk = h0k;
+
+            const glm::vec4 randomGauss = boxMullerTransform( x, y, n );
+
+            m_spectrum1.real[idx] = randomGauss.x * h0k;
+            m_spectrum1.imag[idx] = randomGauss.y * h0k;
+            m_spectrum2.real[idx] = randomGauss.z * h0minusk;
+            m_spectrum2.imag[idx] = randomGauss.w * h0minusk;
+         }
+      }
+   } );
+}
+
+void FFTOceanCPU::update( float time )
+{
+   computeFourierComponents( time );
+   computeDisplacement();
+}
+
+void FFTOceanCPU::computeFourierComponents( float time )
+{
+   const uint32_t n = m_parameters.resolution;
+
+   m_parameters.time = time;
+
+   _parallelFor( n, [&]( uint32_t begin, uint32_t end ) {
+      const __m128 t = _mm_set1_ps( time );
+
+      for( size_t idx = static_cast<size_t>( begin ) * n; idx < static_cast<size_t>( end ) * n;
+           idx += LANES )
+      {
+         __m128 sinWt, cosWt;
+         sinCos( _mm_mul_ps( _mm_loadu_ps( &m_dispersion[idx] ), t ), sinWt, cosWt );
+
+         const __m128 h1r = _mm_loadu_ps( &m_spectrum1.real[idx] );
+         const __m128 h1i = _mm_loadu_ps( &m_spectrum1.imag[idx] );
+         const __m128 h2r = _mm_loadu_ps( &m_spectrum2.real[idx] );
+         const __m128 h2i = _mm_loadu_ps( &m_spectrum2.imag[idx] );
+
+         // h0(k) * exp(iwt) + conj(h0(-k)) * exp(-iwt)
+         const __m128 yr = _mm_sub_ps(
+             _mm_mul_ps( _mm_add_ps( h1r, h2r ), cosWt ),
+             _mm_mul_ps( _mm_add_ps( h1i, h2i ), sinWt ) );
+         const __m128 yi = _mm_add_ps(
+             _mm_mul_ps( _mm_sub_ps( h1r, h2r ), sinWt ),
+             _mm_mul_ps( _mm_sub_ps( h1i, h2i ), cosWt ) );
+
+         // Horizontal components are the height multiplied by -i * k / |k|
+         const __m128 dx = _mm_loadu_ps( &m_directionX[idx] );
+         const __m128 dz = _mm_loadu_ps( &m_directionZ[idx] );
+
+         ComplexMap& mapX = m_fourierComponents[X];
+         ComplexMap& mapY = m_fourierComponents[Y];
+         ComplexMap& mapZ = m_fourierComponents[Z];
+
+         _mm_storeu_ps( &mapY.real[idx], yr );
+         _mm_storeu_ps( &mapY.imag[idx], yi );
+         _mm_storeu_ps( &mapX.real[idx], _mm_sub_ps( _mm_setzero_ps(), _mm_mul_ps( dx, yi ) ) );
+         _mm_storeu_ps( &mapX.imag[idx], _mm_mul_ps( dx, yr ) );
+         _mm_storeu_ps( &mapZ.real[idx], _mm_sub_ps( _mm_setzero_ps(), _mm_mul_ps( dz, yi ) ) );
+         _mm_storeu_ps( &mapZ.imag[idx], _mm_mul_ps( dz, yr ) );
+      }
+   } );
+}
+
+void FFTOceanCPU::computeDisplacement()
+{
+   _fft2D();
+
+   const uint32_t n     = m_parameters.resolution;
+   const float invCount = 1.0f / ( static_cast<float>( n ) * static_cast<float>( n ) );
+
+   _parallelFor( n, [&]( uint32_t begin, uint32_t end ) {
+      const __m128 ones = _mm_set1_ps( 1.0f );
+
+      for( uint32_t y = begin; y < end; ++y )
+      {
+         // Undoing the shift of the spectra to the center of the maps, signs alternate like a
+         // checkerboard
+         const float rowSign = ( y % 2 == 0 ) ? invCount : -invCount;
+         const __m128 perm   = _mm_setr_ps( rowSign, -rowSign, rowSign, -rowSign );
+
+         for( uint32_t x = 0; x < n; x += LANES )
+         {
+            const size_t idx = static_cast<size_t>( y ) * n + x;
+
+            __m128 dispX = _mm_mul_ps( _mm_loadu_ps( &m_fourierComponents[X].real[idx] ), perm );
+            __m128 dispY = _mm_mul_ps( _mm_loadu_ps( &m_fourierComponents[Y].real[idx] ), perm );
+            __m128 dispZ = _mm_mul_ps( _mm_loadu_ps( &m_fourierComponents[Z].real[idx] ), perm );
+            __m128 dispW = ones;
+            _MM_TRANSPOSE4_PS( dispX, dispY, dispZ, dispW );
+
+            float* pDst = &m_displacement[idx].x;
+            _mm_storeu_ps( pDst, dispX );
+            _mm_storeu_ps( pDst + 4, dispY );
+            _mm_storeu_ps( pDst + 8, dispZ );
+            _mm_storeu_ps( pDst + 12, dispW );
+         }
+      }
+   } );
+}
+
+// =================================================================================================
+// FFT
+
+void FFTOceanCPU::_fftBlock( ComplexMap& map, uint32_t first, bool alongRows, float* pScratch )
+{
+   const uint32_t n = m_parameters.resolution;
+
+   // The block is gathered to a contiguous buffer with one row per element and one lane per
+   // transformed line. It keeps the butterflies away from the power of two strides of the maps,
+   // and the input is put in bit-reversed order on the way.
+   float* pScratchPlanes[] = {pScratch, pScratch + static_cast<size_t>( n ) * COLUMN_BLOCK};
+   float* pMapPlanes[]     = {map.real.data(), map.imag.data()};
+
+   for( uint32_t plane = 0; plane < 2; ++plane )
+   {
+      const float* pSrc = pMapPlanes[plane];
+      float* pDst       = pScratchPlanes[plane];
+
+      if( !alongRows )
+      {
+         for( uint32_t i = 0; i < n; ++i )
+         {
+            const float* pRow = pSrc + static_cast<size_t>( m_bitReversed[i] ) * n + first;
+            memcpy( pDst + i * COLUMN_BLOCK, pRow, COLUMN_BLOCK * sizeof( float ) );
+         }
+         continue;
+      }
+
+      // Rows are turned into lanes four by four
+      for( uint32_t k = 0; k < n; k += LANES )
+      {
+         for( uint32_t quad = 0; quad < COLUMN_BLOCK; quad += LANES )
+         {
+            const float* pQuad = pSrc + static_cast<size_t>( first + quad ) * n + k;
+
+            __m128 r0 = _mm_loadu_ps( pQuad );
+            __m128 r1 = _mm_loadu_ps( pQuad + n );
+            __m128 r2 = _mm_loadu_ps( pQuad + 2 * n );
+            __m128 r3 = _mm_loadu_ps( pQuad + 3 * n );
+            _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+            _mm_storeu_ps( pDst + m_bitReversed[k] * COLUMN_BLOCK + quad, r0 );
+            _mm_storeu_ps( pDst + m_bitReversed[k + 1] * COLUMN_BLOCK + quad, r1 );
+            _mm_storeu_ps( pDst + m_bitReversed[k + 2] * COLUMN_BLOCK + quad, r2 );
+            _mm_storeu_ps( pDst + m_bitReversed[k + 3] * COLUMN_BLOCK + quad, r3 );
+         }
+      }
+   }
+
+   _butterflies( pScratchPlanes[0], pScratchPlanes[1] );
+
+   for( uint32_t plane = 0; plane < 2; ++plane )
+   {
+      const float* pSrc = pScratchPlanes[plane];
+      float* pDst       = pMapPlanes[plane];
+
+      if( !alongRows )
+      {
+         for( uint32_t i = 0; i < n; ++i )
+         {
+            float* pRow = pDst + static_cast<size_t>( i ) * n + first;
+            memcpy( pRow, pSrc + i * COLUMN_BLOCK, COLUMN_BLOCK * sizeof( float ) );
+         }
+         continue;
+      }
+
+      for( uint32_t k = 0; k < n; k += LANES )
+      {
+         for( uint32_t quad = 0; quad < COLUMN_BLOCK; quad += LANES )
+         {
+            __m128 r0 = _mm_loadu_ps( pSrc + k * COLUMN_BLOCK + quad );
+            __m128 r1 = _mm_loadu_ps( pSrc + ( k + 1 ) * COLUMN_BLOCK + quad );
+            __m128 r2 = _mm_loadu_ps( pSrc + ( k + 2 ) * COLUMN_BLOCK + quad );
+            __m128 r3 = _mm_loadu_ps( pSrc + ( k + 3 ) * COLUMN_BLOCK + quad );
+            _MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+            float* pQuad = pDst + static_cast<size_t>( first + quad ) * n + k;
+            _mm_storeu_ps( pQuad, r0 );
+            _mm_storeu_ps( pQuad + n, r1 );
+            _mm_storeu_ps( pQuad + 2 * n, r2 );
+            _mm_storeu_ps( pQuad + 3 * n, r3 );
+         }
+      }
+   }
+}
+
+void FFTOceanCPU::_butterflies( float* pReal, float* pImag ) const
+{
+   const uint32_t n = m_parameters.resolution;
+
+   const auto row = []( float* pPlane, uint32_t rowIdx, uint32_t lane ) {
+      return pPlane + rowIdx * COLUMN_BLOCK + lane * LANES;
+   };
+
+   uint32_t span = 1;
+
+   // A single radix-2 stage when the number of stages is odd
+   if( m_stageCount % 2 == 1 )
+   {
+      for( uint32_t i = 0; i < n; i += 2 )
+      {
+         for( uint32_t lane = 0; lane < COLUMN_BLOCK / LANES; ++lane )
+         {
+            for( float* pPlane : {pReal, pImag} )
+            {
+               const __m128 a0 = _mm_loadu_ps( row( pPlane, i, lane ) );
+               const __m128 a1 = _mm_loadu_ps( row( pPlane, i + 1, lane ) );
+               _mm_storeu_ps( row( pPlane, i, lane ), _mm_add_ps( a0, a1 ) );
+               _mm_storeu_ps( row( pPlane, i + 1, lane ), _mm_sub_ps( a0, a1 ) );
+            }
+         }
+      }
+
+      span = 2;
+   }
+
+   // Radix-4 stages, each one doing the work of two radix-2 stages with three complex
+   // multiplications instead of four and half the passes over the data
+   for( ; span < n; span *= 4 )
+   {
+      const uint32_t step = n / ( 4 * span );
+
+      for( uint32_t j = 0; j < span; ++j )
+      {
+         const __m128 w1r = _mm_set1_ps( m_twiddleReal[j * step] );
+         const __m128 w1i = _mm_set1_ps( m_twiddleImag[j * step] );
+         const __m128 w2r = _mm_set1_ps( m_twiddleReal[2 * j * step] );
+         const __m128 w2i = _mm_set1_ps( m_twiddleImag[2 * j * step] );
+         const __m128 w3r = _mm_set1_ps( m_twiddleReal[3 * j * step] );
+         const __m128 w3i = _mm_set1_ps( m_twiddleImag[3 * j * step] );
+
+         for( uint32_t group = 0; group < n; group += 4 * span )
+         {
+            const uint32_t r0 = group + j;
+            const uint32_t r1 = r0 + span;
+            const uint32_t r2 = r1 + span;
+            const uint32_t r3 = r2 + span;
+
+            for( uint32_t lane = 0; lane < COLUMN_BLOCK / LANES; ++lane )
+            {
+               const __m128 a0r = _mm_loadu_ps( row( pReal, r0, lane ) );
+               const __m128 a0i = _mm_loadu_ps( row( pImag, r0, lane ) );
+
+               __m128 c1r, c1i, c2r, c2i, c3r, c3i;
+               complexMul(
+                   _mm_loadu_ps( row( pReal, r1, lane ) ),
+                   _mm_loadu_ps( row( pImag, r1, lane ) ),
+                   w2r,
+                   w2i,
+                   c1r,
+                   c1i );
+               complexMul(
+                   _mm_loadu_ps( row( pReal, r2, lane ) ),
+                   _mm_loadu_ps( row( pImag, r2, lane ) ),
+                   w1r,
+                   w1i,
+                   c2r,
+                   c2i );
+               complexMul(
+                   _mm_loadu_ps( row( pReal, r3, lane ) ),
+                   _mm_loadu_ps( row( pImag, r3, lane ) ),
+                   w3r,
+                   w3i,
+                   c3r,
+                   c3i );
+
+               const __m128 b0r = _mm_add_ps( a0r, c1r );
+               const __m128 b0i = _mm_add_ps( a0i, c1i );
+               const __m128 b1r = _mm_sub_ps( a0r, c1r );
+               const __m128 b1i = _mm_sub_ps( a0i, c1i );
+               const __m128 sr  = _mm_add_ps( c2r, c3r );
+               const __m128 si  = _mm_add_ps( c2i, c3i );
+               const __m128 dr  = _mm_sub_ps( c2r, c3r );
+               const __m128 di  = _mm_sub_ps( c2i, c3i );
+
+               // The second half of the butterflies is rotated by a quarter turn, i * d
+               _mm_storeu_ps( row( pReal, r0, lane ), _mm_add_ps( b0r, sr ) );
+               _mm_storeu_ps( row( pImag, r0, lane ), _mm_add_ps( b0i, si ) );
+               _mm_storeu_ps( row( pReal, r1, lane ), _mm_sub_ps( b1r, di ) );
+               _mm_storeu_ps( row( pImag, r1, lane ), _mm_add_ps( b1i, dr ) );
+               _mm_storeu_ps( row( pReal, r2, lane ), _mm_sub_ps( b0r, sr ) );
+               _mm_storeu_ps( row( pImag, r2, lane ), _mm_sub_ps( b0i, si ) );
+               _mm_storeu_ps( row( pReal, r3, lane ), _mm_add_ps( b1r, di ) );
+               _mm_storeu_ps( row( pImag, r3, lane ), _mm_sub_ps( b1i, dr ) );
+            }
+         }
+      }
+   }
+}
+
+void FFTOceanCPU::_fft2D()
+{
+   const uint32_t n            = m_parameters.resolution;
+   const uint32_t blocksPerMap = n / COLUMN_BLOCK;
+
+   const auto makePass = [&]( bool alongRows ) {
+      return [&, alongRows]( uint32_t begin, uint32_t end ) {
+         std::vector<float> scratch( 2 * static_cast<size_t>( n ) * COLUMN_BLOCK );
+
+         for( uint32_t item = begin; item < end; ++item )
+         {
+            ComplexMap& map = m_fourierComponents[item / blocksPerMap];
+            _fftBlock( map, ( item % blocksPerMap ) * COLUMN_BLOCK, alongRows, scratch.data() );
+         }
+      };
+   };
+
+   // Vertical then horizontal butterflies, the order does not change the result
+   _parallelFor( COMPONENT_COUNT * blocksPerMap, makePass( false ) );
+   _parallelFor( COMPONENT_COUNT * blocksPerMap, makePass( true ) );
+}
+
+// =================================================================================================
+// Worker pool
+
+void FFTOceanCPU::_parallelFor( uint32_t count, const Task& task )
+{
+   const uint32_t threadCount = static_cast<uint32_t>( m_workers.size() ) + 1;
+   const uint32_t chunk       = ( count + threadCount - 1 ) / threadCount;
+
+   {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_task         = &task;
+      m_taskCount    = count;
+      m_taskChunk    = chunk;
+      m_pendingCount = threadCount - 1;
+      m_taskIdx++;
+   }
+   m_wakeCondition.notify_all();
+
+   task( 0, std::min( chunk, count ) );
+
+   std::unique_lock<std::mutex> lock( m_mutex );
+   m_doneCondition.wait( lock, [this]() { return m_pendingCount == 0; } );
+   m_task = nullptr;
+}
+
+void FFTOceanCPU::_workerLoop( uint32_t workerIdx )
+{
+   uint64_t lastTaskIdx = 0;
+
+   for( ;; )
+   {
+      const Task* task = nullptr;
+      uint32_t begin   = 0;
+      uint32_t end     = 0;
+      {
+         std::unique_lock<std::mutex> lock( m_mutex );
+         m_wakeCondition.wait(
+             lock, [this, lastTaskIdx]() { return m_stopWorkers || m_taskIdx != lastTaskIdx; } );
+
+         if( m_stopWorkers )
+         {
+            return;
+         }
+
+         lastTaskIdx = m_taskIdx;
+         task        = m_task;
+         begin       = std::min( workerIdx * m_taskChunk, m_taskCount );
+         end         = std::min( begin + m_taskChunk, m_taskCount );
+      }
+
+      if( begin < end )
+      {
+         ( *task )( begin, end );
+      }
+
+      bool lastDone;
+      {
+         std::lock_guard<std::mutex> lock( m_mutex );
+         lastDone = --m_pendingCount == 0;
+      }
+
+      if( lastDone )
+      {
+         m_doneCondition.notify_one();
+      }
+   }
+}
+
+FFTOceanCPU::~FFTOceanCPU()
+{
+   {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_stopWorkers = true;
+   }
+   m_wakeCondition.notify_all();
+
+   for( std::thread& worker : m_workers )
+   {
+      worker.join();
+   }
+}
+
+// =================================================================================================
+// Benchmark
+
+void FFTOceanCPU::Benchmark( uint32_t iterations )
+{
+   using Clock = std::chrono::steady_clock;
+
+   const auto elapsedMs = []( Clock::time_point start ) {
+      return std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+   };
+
+   // Same ocean as the demo
+   FFTOceanComponent::Parameters parameters = {};
+   parameters.horizontalDimension           = 1000;
+   parameters.amplitude                     = 10.0f;
+   parameters.gravity                       = PHYSICS::GRAV_ACCELERATION_CONSTANT;
+   parameters.windSpeed                     = 40.0f;
+   parameters.windDirX                      = 1.0f;
+   parameters.windDirZ                      = 0.0f;
+
+   FFTOceanCPU ocean;
+
+   // The compute shaders run the same ocean, waited on every update so that the round trip is
+   // timed as well
+   const FFTOceanSystem gpuSystem;
+
+   printf( "FFTOceanCPU: %zu threads, %u iterations\n", ocean.m_workers.size() + 1, iterations );
+
+   for( uint32_t resolution = 128; resolution <= 2048; resolution *= 2 )
+   {
+      parameters.resolution = resolution;
+
+      const auto spectraStart = Clock::now();
+      ocean.setParameters( parameters );
+      const double spectraMs = elapsedMs( spectraStart );
+
+      FFTOceanComponent gpuOcean(
+          resolution,
+          parameters.horizontalDimension,
+          parameters.amplitude,
+          parameters.windSpeed,
+          parameters.windDirX,
+          parameters.windDirZ );
+      RenderableComponent gpuRenderable;
+
+      const size_t texelCount     = static_cast<size_t>( resolution ) * resolution;
+      const BufferHandle readback = GRIS::CreateBuffer( texelCount * sizeof( glm::vec4 ) );
+
+      // Steps the device ocean by deltaS, copying its displacement to the readback buffer if asked
+      const auto gpuUpdate = [&]( float deltaS, bool copy ) {
+         const CmdListHandle cmdList = GRIS::CreateCommandList( COMPUTE );
+         GRIS::StartRecordingCommandList( cmdList );
+
+         gpuSystem.simulate( cmdList, gpuRenderable, gpuOcean, deltaS );
+         if( copy )
+         {
+            GRIS::CopyTextureToBuffer( cmdList, gpuRenderable.displacement, readback );
+         }
+
+         GRIS::EndRecordingCommandList( cmdList );
+         GRIS::SubmitCommandList( cmdList );
+         GRIS::WaitOnCommandList( cmdList );
+         GRIS::DestroyCommandList( cmdList );
+
+         GRIS::RenderBackendCleanup();
+      };
+
+      // Textures and spectra are created by the first update, kept out of the timings
+      gpuUpdate( 0.0f, false );
+
+      double componentsMs   = 0.0;
+      double displacementMs = 0.0;
+      double gpuMs          = 0.0;
+
+      // Both oceans accumulate the same float time
+      for( uint32_t i = 0; i < iterations; ++i )
+      {
+         const float deltaS = 1.0f / 60.0f;
+
+         const auto componentsStart = Clock::now();
+         ocean.computeFourierComponents( gpuOcean.parameters.time + deltaS );
+         componentsMs += elapsedMs( componentsStart );
+
+         const auto displacementStart = Clock::now();
+         ocean.computeDisplacement();
+         displacementMs += elapsedMs( displacementStart );
+
+         const auto gpuStart = Clock::now();
+         gpuUpdate( deltaS, i + 1 == iterations );
+         gpuMs += elapsedMs( gpuStart );
+      }
+
+      // Comparing the last update with the displacement read back from the device
+      std::vector<glm::vec4> reference( texelCount );
+      GRIS::ReadFromBuffer( readback, reference.data(), 0, reference.size() * sizeof( glm::vec4 ) );
+
+      GRIS::DestroyBuffer( readback );
+      GRIS::DestroyTexture( gpuRenderable.displacement );
+
+      float maxError     = 0.0f;
+      float maxMagnitude = 0.0f;
+      for( size_t i = 0; i < reference.size(); ++i )
+      {
+         for( uint32_t c = 0; c < COMPONENT_COUNT; ++c )
+         {
+            const float error = std::abs( ocean.getDisplacement()[i][c] - reference[i][c] );
+            maxError          = std::max( maxError, error );
+            maxMagnitude      = std::max( maxMagnitude, std::abs( reference[i][c] ) );
+         }
+      }
+
+      printf(
+          "FFTOceanCPU: N = %4u, spectra %8.2f ms, components %7.3f ms, FFT %8.3f ms, "
+          "compute shaders %7.3f ms, max error %.2e (%.2e of max displacement)\n",
+          resolution,
+          spectraMs,
+          componentsMs / iterations,
+          displacementMs / iterations,
+          gpuMs / iterations,
+          maxError,
+          maxMagnitude > 0.0f ? maxError / maxMagnitude : 0.0f );
+   }
+}
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <ECS/Components/Procedural/FFTOceanComponent.h>
+
+#include <glm/glm.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * CPU backend of the FFT ocean. It produces the same spectra, time-dependent Fourier components and
+ * displacement map as the compute shaders of FFTOceanSystem, so the ocean can be simulated on
+ * machines without a device.
+ *
+ * Complex maps are stored as separate real and imaginary planes. The 2D inverse FFT goes through
+ * the maps 16 columns then 16 rows at a time, each block being gathered to a contiguous buffer in
+ * bit-reversed order and transformed with radix-4 SSE butterflies, one line per lane. Every pass is
+ * split across a pool of worker threads owned by the ocean.
+ */
+namespace CYD
+{
+class FFTOceanCPU final
+{
+  public:
+   FFTOceanCPU();
+   NON_COPIABLE( FFTOceanCPU );
+   ~FFTOceanCPU();
+
+   struct ComplexMap
+   {
+      std::vector<float> real;
+      std::vector<float> imag;
+   };
+
+   // Same order as the channels of the displacement map
+   enum Component
+   {
+      X,
+      Y,
+      Z,
+      COMPONENT_COUNT
+   };
+
+   // The resolution has to be a power of two of at least 16. Spectra are only regenerated when
+   // something else than the time changed.
+   void setParameters( const FFTOceanComponent::Parameters& parameters );
+
+   // Fourier components at the given time, followed by their inverse FFT into the displacement
+   void update( float time );
+
+   void computeFourierComponents( float time );
+   void computeDisplacement();
+
+   uint32_t getResolution() const noexcept { return m_parameters.resolution; }
+
+   const ComplexMap& getSpectrum1() const noexcept { return m_spectrum1; }
+   const ComplexMap& getSpectrum2() const noexcept { return m_spectrum2; }
+
+   // Transformed in place by computeDisplacement, like the textures of the GPU path
+   const ComplexMap& getFourierComponents( Component component ) const noexcept
+   {
+      return m_fourierComponents[component];
+   }
+
+   // Same layout as the displacement texture of the GPU path, XYZ displacement in RGB
+   const std::vector<glm::vec4>& getDisplacement() const noexcept { return m_displacement; }
+
+   // Reports the time taken by the spectra and by an update for resolutions going from 128 to
+   // 2048, and how far the displacement is from the one of the compute shaders. Needs the render
+   // backend to be initialized, the displacement of the shaders being read back from the device.
+   static void Benchmark( uint32_t iterations );
+
+  private:
+   using Task = std::function<void( uint32_t begin, uint32_t end )>;
+
+   void _resize();
+   void _generateSpectra();
+
+   // Transforms 16 columns or 16 rows of the map starting at first, going through the scratch
+   void _fftBlock( ComplexMap& map, uint32_t first, bool alongRows, float* pScratch );
+   void _butterflies( float* pReal, float* pImag ) const;
+   void _fft2D();
+
+   // Splits [0, count) in one contiguous range per thread, returns once all of them are done
+   void _parallelFor( uint32_t count, const Task& task );
+   void _workerLoop( uint32_t workerIdx );
+
+   FFTOceanComponent::Parameters m_parameters;
+
+   // Time-independent, regenerated with the spectra
+   ComplexMap m_spectrum1;  // ~h0(k)
+   ComplexMap m_spectrum2;  // ~h0(-k)
+   std::vector<float> m_dispersion;
+   std::vector<float> m_directionX;
+   std::vector<float> m_directionZ;
+
+   // Depend on the resolution only
+   std::vector<uint32_t> m_bitReversed;
+   std::vector<float> m_twiddleReal;
+   std::vector<float> m_twiddleImag;
+   uint32_t m_stageCount = 0;
+
+   ComplexMap m_fourierComponents[COMPONENT_COUNT];
+   std::vector<glm::vec4> m_displacement;
+
+   // Worker pool, the calling thread always takes the first range
+   std::vector<std::thread> m_workers;
+   std::mutex m_mutex;
+   std::condition_variable m_wakeCondition;
+   std::condition_variable m_doneCondition;
+   const Task* m_task      = nullptr;
+   uint32_t m_taskCount    = 0;
+   uint32_t m_taskChunk    = 0;
+   uint64_t m_taskIdx      = 0;
+   uint32_t m_pendingCount = 0;
+   bool m_stopWorkers      = false;
+};
+}
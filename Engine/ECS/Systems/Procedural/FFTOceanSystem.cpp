@@ -5,10 +5,11 @@
 
 #include <ECS/Components/Procedural/FFTOceanComponent.h>
 
-#include <Algorithms/BitManipulation.h>
-
+#include <algorithm>
 #include <cmath>
-#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace CYD
 {
@@ -17,41 +18,124 @@ static ComputePipelineInfo fourierComponentsPip;     // X-Y-Z Fourier components
 static ComputePipelineInfo butterflyTexPip;          // Butterfly texture generation pipeline
 static ComputePipelineInfo butterflyPip;             // Butterfly operations pipeline
 static ComputePipelineInfo inversionPermutationPip;  // Inversion and permutation pipeline
+static ComputePipelineInfo sharedFFTPip;             // Single-dispatch FFT, layout only
+
+// Single-dispatch FFT pipelines specialized for each resolution
+static std::unordered_map<uint32_t, ComputePipelineInfo> sharedFFTPips;
+
+// Displacement read back from the device, before it is turned into a height field
+static std::vector<glm::vec4> readbackTexels;
+
+// X, Y and Z, the layers of each cascade in the Fourier components and ping-pong textures
+static constexpr uint32_t FOURIER_COMPONENT_COUNT = 3;
+
+// A workgroup of the single-dispatch FFT keeps a whole line in shared memory, with every invocation
+// owning RESOLUTION / MAX_SHARED_FFT_THREADS elements at most. Larger oceans go through one
+// dispatch per butterfly stage.
+static constexpr uint32_t MAX_SHARED_FFT_RESOLUTION = 1024;
+static constexpr uint32_t MAX_SHARED_FFT_THREADS    = 256;
+
+// Specialization constants of FFTOCEAN_FFT
+static constexpr uint32_t FFT_THREAD_COUNT_ID  = 0;
+static constexpr uint32_t FFT_RESOLUTION_ID    = 1;
+static constexpr uint32_t FFT_SUBGROUP_SIZE_ID = 2;
 
-enum class FourierComponent  // To compute the displacement for a specific component
+// Returns nullptr when the resolution has to go through the multi-pass FFT
+static const ComputePipelineInfo* findSharedFFTPipeline( uint32_t resolution )
 {
-   X,
-   Y,
-   Z
-};
+   const ComputeLimits& limits = GRIS::GetComputeLimits();
 
-static void computeDisplacement(
+   const size_t lineSize = resolution * 2 * sizeof( float );
+   if( resolution > MAX_SHARED_FFT_RESOLUTION || lineSize > limits.maxSharedMemorySize )
+   {
+      return nullptr;
+   }
+
+   const auto it = sharedFFTPips.find( resolution );
+   if( it != sharedFFTPips.end() )
+   {
+      return &it->second;
+   }
+
+   // Power of two so that it divides the resolution
+   uint32_t threadCount = std::min( resolution, MAX_SHARED_FFT_THREADS );
+   while( threadCount > limits.maxWorkGroupSize )
+   {
+      threadCount /= 2;
+   }
+
+   // Shuffles need every subgroup of the workgroup to be full
+   const bool useSubgroups = limits.subgroupSize > 0 && threadCount % limits.subgroupSize == 0;
+
+   ComputePipelineInfo pipInfo = sharedFFTPip;
+   pipInfo.shader              = useSubgroups ? "FFTOCEAN_FFT_SUBGROUP_COMP" : "FFTOCEAN_FFT_COMP";
+   pipInfo.constants.add( pipInfo.shader, FFT_THREAD_COUNT_ID, threadCount );
+   pipInfo.constants.add( pipInfo.shader, FFT_RESOLUTION_ID, resolution );
+   pipInfo.constants.add(
+       pipInfo.shader, FFT_SUBGROUP_SIZE_ID, useSubgroups ? limits.subgroupSize : 0u );
+
+   GRIS::PrecompilePipeline( pipInfo );
+
+   return &sharedFFTPips.insert( { resolution, pipInfo } ).first->second;
+}
+
+static uint32_t componentLayerCount( const FFTOceanComponent& ocean )
+{
+   return FOURIER_COMPONENT_COUNT * static_cast<uint32_t>( ocean.cascades.size() );
+}
+
+static void computeSharedFFT(
     CmdListHandle cmdList,
-    const RenderableComponent& renderable,
-    FFTOceanComponent& ocean,
-    FourierComponent fourierComponent )
+    const ComputePipelineInfo& pipInfo,
+    FFTOceanComponent& ocean )
+{
+   const uint32_t resolution = ocean.parameters.resolution;
+   const uint32_t layerCount = componentLayerCount( ocean );
+
+   // One workgroup per line of each layer, going through all the stages in shared memory
+   GRIS::BindPipeline( cmdList, pipInfo );
+
+   GRIS::BindImage( cmdList, ocean.butterflyTexture, 0, 0 );
+
+   // Horizontal pass, from the Fourier components to the ping-pong texture
+   ocean.parameters.direction = 0;
+   GRIS::BindImage( cmdList, ocean.fourierComponents, 0, 1 );
+   GRIS::BindImage( cmdList, ocean.pingpongTex, 0, 2 );
+   GRIS::UpdateConstantBuffer(
+       cmdList,
+       ShaderStage::COMPUTE_STAGE,
+       0,
+       sizeof( FFTOceanComponent::Parameters ),
+       &ocean.parameters );
+   GRIS::Dispatch( cmdList, resolution, 1, layerCount );
+
+   // Vertical pass, back to the Fourier components
+   ocean.parameters.direction = 1;
+   GRIS::BindImage( cmdList, ocean.pingpongTex, 0, 1 );
+   GRIS::BindImage( cmdList, ocean.fourierComponents, 0, 2 );
+   GRIS::UpdateConstantBuffer(
+       cmdList,
+       ShaderStage::COMPUTE_STAGE,
+       0,
+       sizeof( FFTOceanComponent::Parameters ),
+       &ocean.parameters );
+   GRIS::Dispatch( cmdList, resolution, 1, layerCount );
+
+   // The result ends up where the multi-pass FFT would have after an even number of stages
+   ocean.parameters.pingpong = 0;
+}
+
+static void computeMultiPassFFT( CmdListHandle cmdList, FFTOceanComponent& ocean )
 {
    const uint32_t resolution     = ocean.parameters.resolution;
    const uint32_t numberOfStages = static_cast<uint32_t>( std::log2( resolution ) );
+   const uint32_t layerCount     = componentLayerCount( ocean );
 
-   // Cooley-Tukey Radix-2 FFT GPU algorithm
+   // Cooley-Tukey Radix-2 FFT GPU algorithm, each stage goes through all the components at once
    GRIS::BindPipeline( cmdList, butterflyPip );
 
    GRIS::BindImage( cmdList, ocean.butterflyTexture, 0, 0 );
-
-   switch( fourierComponent )
-   {
-      case FourierComponent::X:
-         GRIS::BindImage( cmdList, ocean.fourierComponentsX, 0, 1 );
-         break;
-      case FourierComponent::Y:
-         GRIS::BindImage( cmdList, ocean.fourierComponentsY, 0, 1 );
-         break;
-      case FourierComponent::Z:
-         GRIS::BindImage( cmdList, ocean.fourierComponentsZ, 0, 1 );
-         break;
-   }
-
+   GRIS::BindImage( cmdList, ocean.fourierComponents, 0, 1 );
    GRIS::BindImage( cmdList, ocean.pingpongTex, 0, 2 );
 
    ocean.parameters.pingpong = 0;
@@ -68,10 +152,10 @@ static void computeDisplacement(
           sizeof( FFTOceanComponent::Parameters ),
           &ocean.parameters );
 
-      GRIS::Dispatch( cmdList, resolution / 16, resolution / 16, 1 );
+      GRIS::Dispatch( cmdList, resolution / 16, resolution / 16, layerCount );
 
       // Horizontal butterfly shaderpass
-      ocean.parameters.pingpong = ( ++ocean.parameters.pingpong ) % 2;
+      ocean.parameters.pingpong = ( ocean.parameters.pingpong + 1 ) % 2;
    }
 
    ocean.parameters.direction = 1;
@@ -86,34 +170,73 @@ static void computeDisplacement(
           sizeof( FFTOceanComponent::Parameters ),
           &ocean.parameters );
 
-      GRIS::Dispatch( cmdList, resolution / 16, resolution / 16, 1 );
+      GRIS::Dispatch( cmdList, resolution / 16, resolution / 16, layerCount );
 
       // Vertical butterfly shaderpass
-      ocean.parameters.pingpong = ( ++ocean.parameters.pingpong ) % 2;
+      ocean.parameters.pingpong = ( ocean.parameters.pingpong + 1 ) % 2;
    }
+}
 
-   // Inversion and permutation shaderpass
+static void computeDisplacement(
+    CmdListHandle cmdList,
+    const RenderableComponent& renderable,
+    FFTOceanComponent& ocean )
+{
+   const uint32_t resolution = ocean.parameters.resolution;
+
+   // Falling back on the multi-pass FFT while the single-dispatch one is compiling
+   const ComputePipelineInfo* pSharedFFTPip = findSharedFFTPipeline( resolution );
+   if( pSharedFFTPip && GRIS::IsPipelineReady( *pSharedFFTPip ) )
+   {
+      computeSharedFFT( cmdList, *pSharedFFTPip, ocean );
+   }
+   else
+   {
+      computeMultiPassFFT( cmdList, ocean );
+   }
+
+   // Inversion and permutation shaderpass, writing the XYZ displacement of every cascade at once
    GRIS::BindPipeline( cmdList, inversionPermutationPip );
 
    GRIS::BindImage( cmdList, renderable.displacement, 0, 0 );
+   GRIS::BindImage( cmdList, ocean.fourierComponents, 0, 1 );
+   GRIS::BindImage( cmdList, ocean.pingpongTex, 0, 2 );
+
+   GRIS::UpdateConstantBuffer(
+       cmdList,
+       ShaderStage::COMPUTE_STAGE,
+       0,
+       sizeof( FFTOceanComponent::Parameters ),
+       &ocean.parameters );
 
-   switch( fourierComponent )
+   GRIS::Dispatch(
+       cmdList, resolution / 16, resolution / 16, static_cast<uint32_t>( ocean.cascades.size() ) );
+}
+
+static void acquirePrecomputed( CmdListHandle cmdList, FFTOceanComponent& ocean )
+{
+   const uint32_t resolution     = ocean.parameters.resolution;
+   const uint32_t numberOfStages = static_cast<uint32_t>( std::log2( resolution ) );
+
+   // Acquiring before releasing, an ocean keeping its resolution keeps its resources
+   const uint32_t previousResolution = ocean.precomputedResolution;
+
+   const bool created = FFTOceanCache::AcquirePrecomputed(
+       cmdList, resolution, ocean.butterflyTexture, ocean.bitReversedIndices );
+   ocean.precomputedResolution = resolution;
+
+   if( previousResolution > 0 )
    {
-      case FourierComponent::X:
-         ocean.parameters.componentMask = 0x8;
-         GRIS::BindImage( cmdList, ocean.fourierComponentsX, 0, 1 );
-         break;
-      case FourierComponent::Y:
-         ocean.parameters.componentMask = 0x4;
-         GRIS::BindImage( cmdList, ocean.fourierComponentsY, 0, 1 );
-         break;
-      case FourierComponent::Z:
-         ocean.parameters.componentMask = 0x2;
-         GRIS::BindImage( cmdList, ocean.fourierComponentsZ, 0, 1 );
-         break;
+      FFTOceanCache::ReleasePrecomputed( previousResolution );
    }
 
-   GRIS::BindImage( cmdList, ocean.pingpongTex, 0, 2 );
+   if( !created )
+   {
+      return;
+   }
+
+   // Generating Butterfly texture, the bit-reversed indices are already filled in
+   GRIS::BindPipeline( cmdList, butterflyTexPip );
 
    GRIS::UpdateConstantBuffer(
        cmdList,
@@ -122,141 +245,210 @@ static void computeDisplacement(
        sizeof( FFTOceanComponent::Parameters ),
        &ocean.parameters );
 
-   GRIS::Dispatch( cmdList, resolution / 16, resolution / 16, 1 );
+   GRIS::BindImage( cmdList, ocean.butterflyTexture, 0, 0 );
+   GRIS::BindBuffer( cmdList, ocean.bitReversedIndices, 0, 1 );
+   GRIS::Dispatch( cmdList, numberOfStages, resolution / 16, 1 );
 }
 
-void FFTOceanSystem::tick( double deltaS )
+static void acquireSpectra( CmdListHandle cmdList, FFTOceanComponent& ocean )
 {
-   for( const auto& compPair : m_components )
+   const uint32_t resolution   = ocean.parameters.resolution;
+   const uint32_t cascadeCount = static_cast<uint32_t>( ocean.cascades.size() );
+
+   FFTOceanCache::SpectraKey key = {};
+   key.resolution                = resolution;
+   key.cascades                  = ocean.cascades;
+   key.amplitude                 = ocean.parameters.amplitude;
+   key.gravity                   = ocean.parameters.gravity;
+   key.windSpeed                 = ocean.parameters.windSpeed;
+   key.windDirX                  = ocean.parameters.windDirX;
+   key.windDirZ                  = ocean.parameters.windDirZ;
+
+   // Acquiring before releasing, an ocean flagged without any actual change keeps its spectra
+   const bool created =
+       FFTOceanCache::AcquireSpectra( cmdList, key, ocean.spectrum1, ocean.spectrum2 );
+
+   if( ocean.spectraKey.resolution > 0 )
    {
-      RenderableComponent& renderable = *std::get<RenderableComponent*>( compPair.second );
-      FFTOceanComponent& ocean        = *std::get<FFTOceanComponent*>( compPair.second );
+      FFTOceanCache::ReleaseSpectra( ocean.spectraKey );
+   }
+   ocean.spectraKey = std::move( key );
+
+   if( !created )
+   {
+      return;
+   }
 
-      // Updating time elapsed
-      ocean.parameters.time += static_cast<float>( deltaS );
+   // Generate the two Phillips spectrum textures, the patch size differing between cascades
+   GRIS::BindPipeline( cmdList, spectraGenPip );
 
-      const CmdListHandle cmdList = GRIS::CreateCommandList( GRAPHICS | COMPUTE | TRANSFER );
+   GRIS::BindImage( cmdList, ocean.spectrum1, 0, 0 );
+   GRIS::BindImage( cmdList, ocean.spectrum2, 0, 1 );
+
+   for( uint32_t cascade = 0; cascade < cascadeCount; ++cascade )
+   {
+      ocean.parameters.cascade             = cascade;
+      ocean.parameters.horizontalDimension = ocean.cascades[cascade];
+
+      GRIS::UpdateConstantBuffer(
+          cmdList,
+          ShaderStage::COMPUTE_STAGE,
+          0,
+          sizeof( FFTOceanComponent::Parameters ),
+          &ocean.parameters );
+
+      GRIS::Dispatch( cmdList, resolution / 16, resolution / 16, 1 );
+   }
+}
+
+static void collectReadbacks( FFTOceanComponent& ocean )
+{
+   // Copies the device is done with are all freed, only the most recent one is kept
+   const FFTOceanComponent::Readback* pLatest = nullptr;
+   for( FFTOceanComponent::Readback& readback : ocean.readbacks )
+   {
+      if( readback.pending && !GRIS::IsBufferInUse( readback.buffer ) )
+      {
+         readback.pending = false;
+         if( !pLatest || readback.time > pLatest->time )
+         {
+            pLatest = &readback;
+         }
+      }
+   }
+
+   if( pLatest )
+   {
+      const uint32_t resolution   = ocean.parameters.resolution;
+      const uint32_t cascadeCount = static_cast<uint32_t>( ocean.cascades.size() );
+
+      readbackTexels.resize( static_cast<size_t>( resolution ) * resolution * cascadeCount );
+      GRIS::ReadFromBuffer(
+          pLatest->buffer, readbackTexels.data(), 0, readbackTexels.size() * sizeof( glm::vec4 ) );
+
+      ocean.heightField.update(
+          readbackTexels.data(), resolution, ocean.cascades.data(), cascadeCount, pLatest->time );
+   }
+}
+
+static void recordReadback(
+    CmdListHandle cmdList,
+    const RenderableComponent& renderable,
+    FFTOceanComponent& ocean )
+{
+   // This frame is skipped rather than waiting when all the buffers are still in flight
+   for( FFTOceanComponent::Readback& readback : ocean.readbacks )
+   {
+      if( !readback.pending )
+      {
+         GRIS::CopyTextureToBuffer( cmdList, renderable.displacement, readback.buffer );
+         readback.time    = ocean.parameters.time;
+         readback.pending = true;
+         return;
+      }
+   }
+}
 
-      GRIS::StartRecordingCommandList( cmdList );
+void FFTOceanSystem::simulate(
+    CmdListHandle cmdList,
+    RenderableComponent& renderable,
+    FFTOceanComponent& ocean,
+    double deltaS ) const
+{
+   // Updating time elapsed
+   ocean.parameters.time += static_cast<float>( deltaS );
 
-      const uint32_t resolution     = ocean.parameters.resolution;
-      const uint32_t numberOfStages = static_cast<uint32_t>( std::log2( resolution ) );
+   const uint32_t resolution   = ocean.parameters.resolution;
+   const uint32_t cascadeCount = static_cast<uint32_t>( ocean.cascades.size() );
 
-      // Recreating textures if the resolution changed
-      // ===========================================================================================
-      if( ocean.resolutionChanged )
+   // Recreating textures if the resolution or the cascades changed
+   // ==============================================================================================
+   if( ocean.resolutionChanged )
+   {
+      // If resolution changed, we need to recreate the textures
+      GRIS::DestroyTexture( ocean.fourierComponents );
+      GRIS::DestroyTexture( ocean.pingpongTex );
+
+      // TODO In our case, if the entity would have another component modify this displacement
+      // texture, there would be no safeguard
+      GRIS::DestroyTexture( renderable.displacement );
+
+      // TODO Size based on dimensions and pixel format
+      TextureDescription rgTexDesc = {};
+      rgTexDesc.size               = resolution * resolution * 2 * sizeof( float );
+      rgTexDesc.width              = resolution;
+      rgTexDesc.height             = resolution;
+      rgTexDesc.type               = ImageType::TEXTURE_2D_ARRAY;
+      rgTexDesc.format             = PixelFormat::RG32F;
+      rgTexDesc.usage              = ImageUsage::STORAGE;
+      rgTexDesc.stages             = ShaderStage::COMPUTE_STAGE;
+
+      // One layer per Fourier component of every cascade
+      TextureDescription componentsDesc = rgTexDesc;
+      componentsDesc.size               = rgTexDesc.size * componentLayerCount( ocean );
+      componentsDesc.layers             = componentLayerCount( ocean );
+
+      ocean.fourierComponents = GRIS::CreateTexture( cmdList, componentsDesc );
+      ocean.pingpongTex       = GRIS::CreateTexture( cmdList, componentsDesc );
+
+      // One layer per cascade, RGBA texels being twice the size of the RG ones
+      TextureDescription dispTexDesc = {};
+      dispTexDesc.size               = rgTexDesc.size * 2 * cascadeCount;
+      dispTexDesc.width              = resolution;
+      dispTexDesc.height             = resolution;
+      dispTexDesc.layers             = cascadeCount;
+      dispTexDesc.type               = ImageType::TEXTURE_2D_ARRAY;
+      dispTexDesc.format             = PixelFormat::RGBA32F;
+      dispTexDesc.usage              = ImageUsage::STORAGE;
+      dispTexDesc.stages             = ShaderStage::COMPUTE_STAGE | ShaderStage::VERTEX_STAGE;
+
+      renderable.displacement = GRIS::CreateTexture( cmdList, dispTexDesc );
+
+      renderable.cascadeDimensions = glm::vec4( 0.0f );
+      for( uint32_t cascade = 0; cascade < cascadeCount; ++cascade )
       {
-         // If resolution changed, we need to recreate the textures
-         GRIS::DestroyTexture( ocean.spectrum1 );
-         GRIS::DestroyTexture( ocean.spectrum2 );
-         GRIS::DestroyTexture( ocean.butterflyTexture );
-         GRIS::DestroyBuffer( ocean.bitReversedIndices );
-
-         GRIS::DestroyTexture( ocean.fourierComponentsX );
-         GRIS::DestroyTexture( ocean.fourierComponentsY );
-         GRIS::DestroyTexture( ocean.fourierComponentsZ );
-         GRIS::DestroyTexture( ocean.pingpongTex );
-
-         // TODO In our case, if the entity would have another component modify this displacement
-         // texture, there would be no safeguard
-         GRIS::DestroyTexture( renderable.displacement );
-
-         // TODO Size based on dimensions and pixel format
-         TextureDescription rgTexDesc = {};
-         rgTexDesc.size               = resolution * resolution * 2 * sizeof( float );
-         rgTexDesc.width              = resolution;
-         rgTexDesc.height             = resolution;
-         rgTexDesc.type               = ImageType::TEXTURE_2D;
-         rgTexDesc.format             = PixelFormat::RG32F;
-         rgTexDesc.usage              = ImageUsage::STORAGE;
-         rgTexDesc.stages             = ShaderStage::COMPUTE_STAGE;
-
-         ocean.spectrum1 = GRIS::CreateTexture( cmdList, rgTexDesc );
-         ocean.spectrum2 = GRIS::CreateTexture( cmdList, rgTexDesc );
-
-         ocean.fourierComponentsY = GRIS::CreateTexture( cmdList, rgTexDesc );
-         ocean.fourierComponentsX = GRIS::CreateTexture( cmdList, rgTexDesc );
-         ocean.fourierComponentsZ = GRIS::CreateTexture( cmdList, rgTexDesc );
-
-         ocean.pingpongTex = GRIS::CreateTexture( cmdList, rgTexDesc );
-
-         TextureDescription dispTexDesc = {};
-         dispTexDesc.size               = resolution * resolution * 4 * sizeof( float );
-         dispTexDesc.width              = resolution;
-         dispTexDesc.height             = resolution;
-         dispTexDesc.type               = ImageType::TEXTURE_2D;
-         dispTexDesc.format             = PixelFormat::RGBA32F;
-         dispTexDesc.usage              = ImageUsage::STORAGE;
-         dispTexDesc.stages             = ShaderStage::COMPUTE_STAGE | ShaderStage::VERTEX_STAGE;
-
-         renderable.displacement = GRIS::CreateTexture( cmdList, dispTexDesc );
-
-         TextureDescription butterflyDesc = {};
-         butterflyDesc.size               = resolution * numberOfStages * 4 * sizeof( float );
-         butterflyDesc.width              = numberOfStages;
-         butterflyDesc.height             = resolution;
-         butterflyDesc.type               = ImageType::TEXTURE_2D;
-         butterflyDesc.format             = PixelFormat::RGBA32F;
-         butterflyDesc.usage              = ImageUsage::STORAGE;
-         butterflyDesc.stages             = ShaderStage::COMPUTE_STAGE;
-
-         ocean.butterflyTexture = GRIS::CreateTexture( cmdList, butterflyDesc );
-
-         ocean.bitReversedIndices = GRIS::CreateBuffer( sizeof( uint32_t ) * resolution );
-
-         ocean.resolutionChanged = false;
-
-         // Since the resolution changed, we force an update of the pre-computed textures
-         ocean.needsUpdate = true;
+         renderable.cascadeDimensions[cascade] = static_cast<float>( ocean.cascades[cascade] );
       }
 
-      // Generating pre-computed textures (independent)
-      // ===========================================================================================
-      if( ocean.needsUpdate )
+      // Copies of the previous resolution still in flight are dropped with their buffers
+      for( FFTOceanComponent::Readback& readback : ocean.readbacks )
       {
-         // Generate the two Phillips spectrum textures
-         GRIS::BindPipeline( cmdList, spectraGenPip );
-
-         GRIS::UpdateConstantBuffer(
-             cmdList,
-             ShaderStage::COMPUTE_STAGE,
-             0,
-             sizeof( FFTOceanComponent::Parameters ),
-             &ocean.parameters );
-
-         GRIS::BindImage( cmdList, ocean.spectrum1, 0, 0 );
-         GRIS::BindImage( cmdList, ocean.spectrum2, 0, 1 );
-         GRIS::Dispatch( cmdList, resolution / 16, resolution / 16, 1 );
-
-         // Generating Butterfly texture
-         std::vector<uint32_t> indices( resolution );  // Bit-reversed indices
-         std::iota( indices.begin(), indices.end(), static_cast<uint32_t>( 0 ) );
-         EMP::BitReversalPermutation( indices );
-
-         const size_t indicesDataSize = indices.size() * sizeof( indices[0] );
-         GRIS::CopyToBuffer( ocean.bitReversedIndices, indices.data(), 0, indicesDataSize );
-
-         GRIS::BindPipeline( cmdList, butterflyTexPip );
-
-         GRIS::UpdateConstantBuffer(
-             cmdList,
-             ShaderStage::COMPUTE_STAGE,
-             0,
-             sizeof( FFTOceanComponent::Parameters ),
-             &ocean.parameters );
-
-         GRIS::BindImage( cmdList, ocean.butterflyTexture, 0, 0 );
-         GRIS::BindBuffer( cmdList, ocean.bitReversedIndices, 0, 1 );
-         GRIS::Dispatch( cmdList, numberOfStages, resolution / 16, 1 );
-
-         ocean.needsUpdate = false;
+         GRIS::DestroyBuffer( readback.buffer );
+         readback.buffer  = GRIS::CreateBuffer( dispTexDesc.size );
+         readback.pending = false;
       }
 
-      // Generating time-dependent textures
-      // ===========================================================================================
+      acquirePrecomputed( cmdList, ocean );
+
+      ocean.resolutionChanged = false;
+
+      // The spectra depend on the resolution and the cascades as well
+      ocean.needsUpdate = true;
+   }
+
+   // Generating pre-computed textures (independent)
+   // ==============================================================================================
+   if( ocean.needsUpdate )
+   {
+      acquireSpectra( cmdList, ocean );
+
+      ocean.needsUpdate = false;
+   }
+
+   // Generating time-dependent textures
+   // ==============================================================================================
 
-      // Generating Fourier components time-dependent textures (dy, dx, dz)
-      GRIS::BindPipeline( cmdList, fourierComponentsPip );
+   // Generating Fourier components time-dependent textures (dx, dy, dz) of every cascade
+   GRIS::BindPipeline( cmdList, fourierComponentsPip );
+
+   GRIS::BindImage( cmdList, ocean.fourierComponents, 0, 0 );
+   GRIS::BindImage( cmdList, ocean.spectrum1, 0, 1 );
+   GRIS::BindImage( cmdList, ocean.spectrum2, 0, 2 );
+
+   for( uint32_t cascade = 0; cascade < cascadeCount; ++cascade )
+   {
+      ocean.parameters.cascade             = cascade;
+      ocean.parameters.horizontalDimension = ocean.cascades[cascade];
 
       GRIS::UpdateConstantBuffer(
           cmdList,
@@ -265,27 +457,47 @@ void FFTOceanSystem::tick( double deltaS )
           sizeof( FFTOceanComponent::Parameters ),
           &ocean.parameters );
 
-      GRIS::BindImage( cmdList, ocean.fourierComponentsY, 0, 0 );
-      GRIS::BindImage( cmdList, ocean.fourierComponentsX, 0, 1 );
-      GRIS::BindImage( cmdList, ocean.fourierComponentsZ, 0, 2 );
-      GRIS::BindImage( cmdList, ocean.spectrum1, 0, 3 );
-      GRIS::BindImage( cmdList, ocean.spectrum2, 0, 4 );
       GRIS::Dispatch( cmdList, resolution / 16, resolution / 16, 1 );
+   }
 
-      computeDisplacement( cmdList, renderable, ocean, FourierComponent::X );
-      computeDisplacement( cmdList, renderable, ocean, FourierComponent::Y );
-      computeDisplacement( cmdList, renderable, ocean, FourierComponent::Z );
+   computeDisplacement( cmdList, renderable, ocean );
+}
 
-      GRIS::EndRecordingCommandList( cmdList );
+void FFTOceanSystem::tick( double deltaS )
+{
+   if( m_components.empty() )
+   {
+      return;
+   }
+
+   // All the oceans are recorded in the same compute submission
+   const CmdListHandle cmdList = GRIS::CreateCommandList( COMPUTE );
+
+   GRIS::StartRecordingCommandList( cmdList );
+
+   for( const auto& compPair : m_components )
+   {
+      RenderableComponent& renderable = *std::get<RenderableComponent*>( compPair.second );
+      FFTOceanComponent& ocean        = *std::get<FFTOceanComponent*>( compPair.second );
 
-      GRIS::SubmitCommandList( cmdList );
-      GRIS::WaitOnCommandList( cmdList ); // TODO BAD
+      simulate( cmdList, renderable, ocean, deltaS );
 
-      GRIS::DestroyCommandList( cmdList );
+      // Host copy for the height queries, gathered a frame or two later
+      collectReadbacks( ocean );
+      recordReadback( cmdList, renderable, ocean );
    }
+
+   GRIS::EndRecordingCommandList( cmdList );
+
+   GRIS::SubmitCommandList( cmdList );
+
+   // The render pass waits on the displacement on the GPU instead of stalling the CPU here
+   GRIS::SyncOnSwapchain( cmdList );
+
+   GRIS::DestroyCommandList( cmdList );
 }
 
-bool FFTOceanSystem::FFTOceanSystem()
+FFTOceanSystem::FFTOceanSystem()
 {
    // FFT Ocean parameters push constant range. This push constant is used in every FFTOCEAN shaders
    const PushConstantRange oceanParamsRange = {
@@ -297,9 +509,9 @@ bool FFTOceanSystem::FFTOceanSystem()
       DescriptorSetLayoutInfo spectraGenSet = {};  // Set 0
 
       const ShaderResourceInfo spectrum1Info = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0, 0};
       const ShaderResourceInfo spectrum2Info = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1, 0};
 
       spectraGenSet.shaderResources.push_back( spectrum1Info );
       spectraGenSet.shaderResources.push_back( spectrum2Info );
@@ -315,21 +527,15 @@ bool FFTOceanSystem::FFTOceanSystem()
    {
       DescriptorSetLayoutInfo fourierComponentsSet = {};  // Set 0
 
-      const ShaderResourceInfo fourierYInfo = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0};
-      const ShaderResourceInfo fourierXInfo = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1};
-      const ShaderResourceInfo fourierZInfo = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 2};
+      const ShaderResourceInfo fourierComponentsInfo = {
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0, 0};
 
       const ShaderResourceInfo spectrum1Info = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 3};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1, 0};
       const ShaderResourceInfo spectrum2Info = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 4};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 2, 0};
 
-      fourierComponentsSet.shaderResources.push_back( fourierYInfo );
-      fourierComponentsSet.shaderResources.push_back( fourierXInfo );
-      fourierComponentsSet.shaderResources.push_back( fourierZInfo );
+      fourierComponentsSet.shaderResources.push_back( fourierComponentsInfo );
 
       fourierComponentsSet.shaderResources.push_back( spectrum1Info );
       fourierComponentsSet.shaderResources.push_back( spectrum2Info );
@@ -345,9 +551,9 @@ bool FFTOceanSystem::FFTOceanSystem()
       DescriptorSetLayoutInfo butterflyTexSet = {};  // Set 0
 
       const ShaderResourceInfo butterflyTexInfo = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0, 0};
       const ShaderResourceInfo bitReversedIndicesInfo = {
-          ShaderResourceType::STORAGE, ShaderStage::COMPUTE_STAGE, 1};
+          ShaderResourceType::STORAGE, ShaderStage::COMPUTE_STAGE, 1, 0};
 
       butterflyTexSet.shaderResources.push_back( butterflyTexInfo );
       butterflyTexSet.shaderResources.push_back( bitReversedIndicesInfo );
@@ -363,11 +569,11 @@ bool FFTOceanSystem::FFTOceanSystem()
       DescriptorSetLayoutInfo butterflySet = {};  // Set 0
 
       const ShaderResourceInfo butterflyTexInfo = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0, 0};
       const ShaderResourceInfo pingpong0Info = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1, 0};
       const ShaderResourceInfo pingpong1Info = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 2};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 2, 0};
 
       butterflySet.shaderResources.push_back( butterflyTexInfo );
       butterflySet.shaderResources.push_back( pingpong0Info );
@@ -378,17 +584,37 @@ bool FFTOceanSystem::FFTOceanSystem()
       butterflyPip.pipLayout.ranges.push_back( oceanParamsRange );
    }
 
+   // Single-dispatch FFT pipeline, specialized and compiled once the resolution is known
+   // ==============================================================================================
+   {
+      DescriptorSetLayoutInfo sharedFFTSet = {};  // Set 0
+
+      const ShaderResourceInfo butterflyTexInfo = {
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0, 0};
+      const ShaderResourceInfo sourceInfo = {
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1, 0};
+      const ShaderResourceInfo destinationInfo = {
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 2, 0};
+
+      sharedFFTSet.shaderResources.push_back( butterflyTexInfo );
+      sharedFFTSet.shaderResources.push_back( sourceInfo );
+      sharedFFTSet.shaderResources.push_back( destinationInfo );
+
+      sharedFFTPip.pipLayout.descSets.push_back( sharedFFTSet );
+      sharedFFTPip.pipLayout.ranges.push_back( oceanParamsRange );
+   }
+
    // Inversion and permutation pipeline
    // ==============================================================================================
    {
       DescriptorSetLayoutInfo inversionPermutationSet = {};  // Set 0
 
       const ShaderResourceInfo displacementInfo = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 0, 0};
       const ShaderResourceInfo pingpong0Info = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 1, 0};
       const ShaderResourceInfo pingpong1Info = {
-          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 2};
+          ShaderResourceType::STORAGE_IMAGE, ShaderStage::COMPUTE_STAGE, 2, 0};
 
       inversionPermutationSet.shaderResources.push_back( displacementInfo );
       inversionPermutationSet.shaderResources.push_back( pingpong0Info );
@@ -399,6 +625,11 @@ bool FFTOceanSystem::FFTOceanSystem()
       inversionPermutationPip.pipLayout.ranges.push_back( oceanParamsRange );
    }
 
-   return true;
+   // Compiling in the background, the first tick would otherwise wait on all of them
+   GRIS::PrecompilePipeline( spectraGenPip );
+   GRIS::PrecompilePipeline( fourierComponentsPip );
+   GRIS::PrecompilePipeline( butterflyTexPip );
+   GRIS::PrecompilePipeline( butterflyPip );
+   GRIS::PrecompilePipeline( inversionPermutationPip );
 }
 }
@@ -7,6 +7,8 @@
 #include <ECS/Components/Rendering/RenderableComponent.h>
 #include <ECS/Components/Procedural/FFTOceanComponent.h>
 
+#include <Graphics/Handles/ResourceHandle.h>
+
 // ================================================================================================
 // Definition
 // ================================================================================================
@@ -18,10 +20,18 @@ namespace CYD
 class FFTOceanSystem final : public CommonSystem<RenderableComponent, FFTOceanComponent>
 {
   public:
-   FFTOceanSystem() = default;
+   FFTOceanSystem();
    NON_COPIABLE( FFTOceanSystem );
    virtual ~FFTOceanSystem() = default;
 
    void tick( double deltaS ) override;
+
+   // Records the passes moving a single ocean forward by deltaS, including the creation of its
+   // textures, without the host readback. Used outside of the entity system by the benchmarks.
+   void simulate(
+       CmdListHandle cmdList,
+       RenderableComponent& renderable,
+       FFTOceanComponent& ocean,
+       double deltaS ) const;
 };
 }
@@ -6,8 +6,10 @@
 
 namespace CYD
 {
-ForwardRenderSystem::ForwardRenderSystem()
+ForwardRenderSystem::ForwardRenderSystem( bool bindless )
 {
+   _renderGraph.setBindless( bindless );
+
    // TODO: Will have to recall for resizing events
    // Flipping Y in viewport since we want Y to be up (like GL)
    _renderGraph.setViewport( 0, 1080, 1920, -1080 );
@@ -35,8 +37,22 @@ void ForwardRenderSystem::tick( double /*deltaS*/ )
           glm::scale( glm::translate( glm::mat4( 1.0f ), transform.position ), transform.scaling ) *
           glm::toMat4( transform.rotation );
 
+      // Displaced surfaces have no material, only the map their simulation fills
+      if( renderable.type == StaticPipelines::Type::DISPLACEMENT )
+      {
+         _renderGraph.addDisplacedRenderable(
+             modelMatrix, mesh.asset, renderable.displacement, renderable.cascadeDimensions );
+         continue;
+      }
+
       // Add renderable entity and its shader resources to the render graph
-      _renderGraph.add3DRenderable( modelMatrix, renderable.type, renderable.asset, mesh.asset );
+      _renderGraph.add3DRenderable(
+          modelMatrix,
+          renderable.type,
+          renderable.asset,
+          mesh.asset,
+          compPair.first,
+          mesh.lodPixelError );
    }
 
    const bool compileSuccess = _renderGraph.compile();
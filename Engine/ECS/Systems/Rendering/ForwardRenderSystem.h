@@ -19,7 +19,8 @@ class ForwardRenderSystem final
     : public CommonSystem<TransformComponent, MeshComponent, RenderableComponent>
 {
   public:
-   ForwardRenderSystem();
+   // PBR renderables are drawn through the bindless texture array when it is enabled and supported
+   explicit ForwardRenderSystem( bool bindless = false );
    NON_COPIABLE( ForwardRenderSystem );
    virtual ~ForwardRenderSystem() = default;
 
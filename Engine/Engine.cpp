@@ -1,12 +1,138 @@
+#include <Applications/VKOceanDemo.h>
 #include <Applications/VKSandbox.h>
 
-int main()
+#include <ECS/Systems/Procedural/FFTOceanCPU.h>
+
+#include <Graphics/RenderInterface.h>
+#include <Graphics/Handles/ResourceHandleManager.h>
+#include <Graphics/Utility/AssetCooker.h>
+
+#include <Window/GLFWWindow.h>
+
+#include <Algorithms/Benchmark.h>
+
+#include <cstdlib>
+#include <cstring>
+
+int main( int argc, char** argv )
 {
+   // --headless renders offscreen, --frames N stops after N frames and reports the frame times,
+   // --bindless draws the PBR renderables through the bindless texture array when supported,
+   // --ocean opens the FFT ocean demo instead of the sandbox,
+   // --cook converts the assets to packs, --benchmark-loads N compares raw and cooked load times,
+   // --benchmark-import N reports how fast OBJs are imported, --benchmark-ocean N times the CPU
+   // ocean and compares it to the compute shaders, --benchmark-algorithms N times the Emporium
+   // algorithms against the standard library, --stress-handles N hammers the handle table from
+   // every thread and checks that it stays consistent
+   bool headless                = false;
+   bool bindless                = false;
+   bool ocean                   = false;
+   bool cook                    = false;
+   uint64_t frameLimit          = 0;
+   uint32_t loadIterations      = 0;
+   uint32_t importIterations    = 0;
+   uint32_t oceanIterations     = 0;
+   uint32_t algorithmIterations = 0;
+   uint32_t handleIterations    = 0;
+   for( int i = 1; i < argc; ++i )
+   {
+      if( strcmp( argv[i], "--headless" ) == 0 )
+      {
+         headless = true;
+      }
+      else if( strcmp( argv[i], "--bindless" ) == 0 )
+      {
+         bindless = true;
+      }
+      else if( strcmp( argv[i], "--ocean" ) == 0 )
+      {
+         ocean = true;
+      }
+      else if( strcmp( argv[i], "--frames" ) == 0 && i + 1 < argc )
+      {
+         frameLimit = strtoull( argv[++i], nullptr, 10 );
+      }
+      else if( strcmp( argv[i], "--cook" ) == 0 )
+      {
+         cook = true;
+      }
+      else if( strcmp( argv[i], "--benchmark-loads" ) == 0 && i + 1 < argc )
+      {
+         loadIterations = static_cast<uint32_t>( strtoul( argv[++i], nullptr, 10 ) );
+      }
+      else if( strcmp( argv[i], "--benchmark-import" ) == 0 && i + 1 < argc )
+      {
+         importIterations = static_cast<uint32_t>( strtoul( argv[++i], nullptr, 10 ) );
+      }
+      else if( strcmp( argv[i], "--benchmark-ocean" ) == 0 && i + 1 < argc )
+      {
+         oceanIterations = static_cast<uint32_t>( strtoul( argv[++i], nullptr, 10 ) );
+      }
+      else if( strcmp( argv[i], "--benchmark-algorithms" ) == 0 && i + 1 < argc )
+      {
+         algorithmIterations = static_cast<uint32_t>( strtoul( argv[++i], nullptr, 10 ) );
+      }
+      else if( strcmp( argv[i], "--stress-handles" ) == 0 && i + 1 < argc )
+      {
+         handleIterations = static_cast<uint32_t>( strtoul( argv[++i], nullptr, 10 ) );
+      }
+   }
+
+   // Asset tools and benchmarks do not need a window, only the ocean is compared to a device
+   if( cook || loadIterations > 0 || importIterations > 0 || oceanIterations > 0 ||
+       algorithmIterations > 0 || handleIterations > 0 )
+   {
+      if( cook )
+      {
+         CYD::AssetCooker::CookAll();
+      }
+      if( loadIterations > 0 )
+      {
+         CYD::AssetCooker::Benchmark( loadIterations );
+      }
+      if( importIterations > 0 )
+      {
+         CYD::AssetCooker::BenchmarkImport( importIterations );
+      }
+      if( oceanIterations > 0 )
+      {
+         // The compute shaders run offscreen, on a backend that only lives for the benchmark
+         CYD::Window window;
+         window.initHeadless( 1, 1 );
+         CYD::GRIS::InitRenderBackend<CYD::VK>( window );
+
+         CYD::FFTOceanCPU::Benchmark( oceanIterations );
+
+         CYD::GRIS::UninitRenderBackend();
+      }
+      if( algorithmIterations > 0 )
+      {
+         EMP::BenchmarkAlgorithms( algorithmIterations );
+      }
+      if( handleIterations > 0 )
+      {
+         CYD::HandleManager::StressTest( handleIterations );
+      }
+      return 0;
+   }
+
+   if( ocean )
    {
-      CYD::VKSandbox app( 1920, 1080, "GARBAGIO" );
+      CYD::VKOceanDemo app( 1920, 1080, "GARBAGIO", headless );
+      app.setFrameLimit( frameLimit );
+      app.startLoop();
+   }
+   else
+   {
+      CYD::VKSandbox app( 1920, 1080, "GARBAGIO", headless );
+      app.setFrameLimit( frameLimit );
+      app.setBindless( bindless );
       app.startLoop();
    }
 
    // To see validation layer errors after destruction
-   system( "pause" );
+   if( !headless )
+   {
+      system( "pause" );
+   }
 }
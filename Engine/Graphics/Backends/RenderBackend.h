@@ -23,12 +23,14 @@ class RenderBackend
    // ==============================================================================================
    virtual CmdListHandle createCommandList( QueueUsageFlag usage, bool presentable ) = 0;
 
-   virtual void startRecordingCommandList( CmdListHandle cmdList ) = 0;
-   virtual void endRecordingCommandList( CmdListHandle cmdList )   = 0;
-   virtual void submitCommandList( CmdListHandle cmdList )         = 0;
-   virtual void resetCommandList( CmdListHandle cmdList )          = 0;
-   virtual void waitOnCommandList( CmdListHandle cmdList )         = 0;
-   virtual void destroyCommandList( CmdListHandle cmdList )        = 0;
+   virtual void startRecordingCommandList( CmdListHandle cmdList )        = 0;
+   virtual void endRecordingCommandList( CmdListHandle cmdList )          = 0;
+   virtual void submitCommandList( CmdListHandle cmdList )                = 0;
+   virtual void resetCommandList( CmdListHandle cmdList )                 = 0;
+   virtual void waitOnCommandList( CmdListHandle cmdList )                = 0;
+   virtual void syncOnCommandList( CmdListHandle from, CmdListHandle to ) = 0;
+   virtual void syncOnSwapchain( CmdListHandle from )                     = 0;
+   virtual void destroyCommandList( CmdListHandle cmdList )               = 0;
 
    // Pipeline Specification
    // ==============================================================================================
@@ -76,10 +78,19 @@ class RenderBackend
        CmdListHandle transferList,
        const TextureDescription& desc,
        const std::vector<std::string>& paths ) = 0;
+   virtual std::vector<TextureHandle> createTextures(
+       CmdListHandle transferList,
+       const TextureDescription& desc,
+       const std::vector<std::string>& paths ) = 0;
    virtual TextureHandle createTexture(
        CmdListHandle transferList,
        const TextureDescription& desc,
        const void* pTexels ) = 0;
+   virtual TextureHandle createTexture(
+       CmdListHandle transferList,
+       const TextureDescription& desc,
+       const void* pTexels,
+       size_t size ) = 0;
 
    virtual VertexBufferHandle createVertexBuffer(
        CmdListHandle transferList,
@@ -87,8 +98,11 @@ class RenderBackend
        uint32_t stride,
        const void* pVertices ) = 0;
 
-   virtual IndexBufferHandle
-   createIndexBuffer( CmdListHandle transferList, uint32_t count, const void* pIndices ) = 0;
+   virtual IndexBufferHandle createIndexBuffer(
+       CmdListHandle transferList,
+       uint32_t count,
+       const void* pIndices,
+       IndexType type ) = 0;
 
    virtual BufferHandle createUniformBuffer( size_t size ) = 0;
 
@@ -102,6 +116,40 @@ class RenderBackend
    virtual void destroyIndexBuffer( IndexBufferHandle bufferHandle )   = 0;
    virtual void destroyBuffer( BufferHandle bufferHandle )             = 0;
 
+   // Pipeline Warm-up
+   // ==============================================================================================
+   virtual void precompilePipeline( const GraphicsPipelineInfo& pipInfo, bool wantDepth ) = 0;
+   virtual void precompilePipeline( const ComputePipelineInfo& pipInfo )                 = 0;
+   virtual bool isPipelineReady( CmdListHandle cmdList, const GraphicsPipelineInfo& pipInfo ) = 0;
+   virtual bool isPipelineReady( const ComputePipelineInfo& pipInfo )                        = 0;
+
+   // Bindless
+   // ==============================================================================================
+   virtual bool supportsBindless()                              = 0;
+   virtual uint32_t getBindlessIndex( TextureHandle texHandle ) = 0;
+   virtual bool isTextureStreaming( TextureHandle texHandle )   = 0;
+
+   // Compute
+   // ==============================================================================================
+   virtual const ComputeLimits& getComputeLimits() = 0;
+
+   // Frame Readback
+   // ==============================================================================================
+   virtual void setFrameReadback( bool enable )              = 0;
+   virtual bool getLastFrame( std::vector<uint8_t>& pixels ) = 0;
+
+   // Texture Readback
+   // ==============================================================================================
+   virtual void copyTextureToBuffer(
+       CmdListHandle cmdList,
+       TextureHandle texHandle,
+       BufferHandle bufferHandle ) = 0;
+
+   virtual bool isBufferInUse( BufferHandle bufferHandle ) = 0;
+
+   virtual void
+   readFromBuffer( BufferHandle bufferHandle, void* pData, size_t offset, size_t size ) = 0;
+
    // Drawing
    // ==============================================================================================
    virtual void prepareFrame()                                                = 0;
@@ -112,7 +160,8 @@ class RenderBackend
        const std::vector<TextureHandle>& textures )                               = 0;
    virtual void endRenderPass( CmdListHandle cmdList )                            = 0;
    virtual void drawVertices( CmdListHandle cmdList, uint32_t vertexCount )       = 0;
-   virtual void drawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount ) = 0;
+   virtual void
+   drawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount, uint32_t firstIndex ) = 0;
    virtual void
    dispatch( CmdListHandle cmdList, uint32_t workX, uint32_t workY, uint32_t workZ ) = 0;
    virtual void presentFrame()                                                       = 0;
@@ -11,17 +11,25 @@
 #include <Graphics/Vulkan/Surface.h>
 #include <Graphics/Vulkan/DeviceHerder.h>
 #include <Graphics/Vulkan/Device.h>
+#include <Graphics/Vulkan/DescriptorPool.h>
+#include <Graphics/Vulkan/PipelineStash.h>
 #include <Graphics/Vulkan/Swapchain.h>
 #include <Graphics/Vulkan/CommandBuffer.h>
 #include <Graphics/Vulkan/Buffer.h>
 #include <Graphics/Vulkan/Texture.h>
+#include <Graphics/Vulkan/BindlessTable.h>
 #include <Graphics/Vulkan/BarriersHelper.h>
+#include <Graphics/Vulkan/StagingRing.h>
 
-#include <unordered_map>
+#include <memory>
 #include <vector>
 
 namespace CYD
 {
+// Staging memory shared by all uploads and the amount of it that can be consumed in one frame
+static constexpr size_t STAGING_RING_SIZE       = 64 * 1024 * 1024;
+static constexpr size_t UPLOAD_BUDGET_PER_FRAME = 32 * 1024 * 1024;
+
 // =================================================================================================
 // Implementation
 class VKRenderBackendImp
@@ -40,6 +48,9 @@ class VKRenderBackendImp
 
       m_mainDevice    = m_devices.getMainDevice();
       m_mainSwapchain = m_mainDevice->createSwapchain( scInfo );
+
+      m_stagingRing = std::make_unique<vk::StagingRing>(
+          *m_mainDevice, STAGING_RING_SIZE, UPLOAD_BUDGET_PER_FRAME );
    }
 
    ~VKRenderBackendImp() = default;
@@ -49,7 +60,7 @@ class VKRenderBackendImp
    CmdListHandle createCommandList( QueueUsageFlag usage, bool presentable )
    {
       const auto cmdBuffer = m_mainDevice->createCommandBuffer( usage, presentable );
-      return m_coreHandles.add( cmdBuffer, HandleType::CMDLIST );
+      return m_coreHandles.add<CmdListHandle>( cmdBuffer );
    }
 
    void startRecordingCommandList( CmdListHandle cmdList ) const
@@ -61,6 +72,10 @@ class VKRenderBackendImp
    void endRecordingCommandList( CmdListHandle cmdList ) const
    {
       auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( cmdList ) );
+
+      // Recording all the uploads staged on this command list as batched copies
+      m_stagingRing->flush( cmdBuffer );
+
       cmdBuffer->endRecording();
    }
 
@@ -68,6 +83,8 @@ class VKRenderBackendImp
    {
       auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( cmdList ) );
       cmdBuffer->submit();
+
+      m_stagingRing->onSubmit( cmdBuffer );
    }
 
    void resetCommandList( CmdListHandle cmdList ) const
@@ -82,18 +99,32 @@ class VKRenderBackendImp
       cmdBuffer->waitForCompletion();
    }
 
+   void syncOnCommandList( CmdListHandle from, CmdListHandle to ) const
+   {
+      const auto fromCmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( from ) );
+      const auto toCmdBuffer   = static_cast<vk::CommandBuffer*>( m_coreHandles.get( to ) );
+      toCmdBuffer->syncOnCommandBuffer( fromCmdBuffer );
+   }
+
+   void syncOnSwapchain( CmdListHandle from )
+   {
+      const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( from ) );
+      CYDASSERT(
+          cmdBuffer->wasSubmitted() &&
+          "VKRenderBackend: Only submitted command lists can be synced on by the swapchain" );
+
+      // Keeping the timeline value rather than the command buffer, it can be recycled before the
+      // swapchain pass begins
+      m_swapchainWaits.push_back( { cmdBuffer->getVKTimeline(), cmdBuffer->getSubmitValue() } );
+   }
+
    void destroyCommandList( CmdListHandle cmdList )
    {
-      auto it = m_cmdListDeps.find( cmdList );
-      if( it != m_cmdListDeps.end() )
+      const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( cmdList ) );
+      if( !cmdBuffer->wasSubmitted() )
       {
-         // This command list has buffer dependencies that need to be flagged as unused
-         for( auto& buffer : it->second )
-         {
-            buffer->decUse();
-         }
-
-         m_cmdListDeps.erase( it );
+         // Nothing will ever read what was staged for this command list
+         m_stagingRing->abandon( cmdBuffer );
       }
 
       m_coreHandles.remove( cmdList );
@@ -232,16 +263,9 @@ class VKRenderBackendImp
       // Creating GPU texture
       vk::Texture* texture = m_mainDevice->createTexture( desc );
 
-      if( desc.stages == ShaderStage::FRAGMENT_STAGE )
-      {
-         vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::SHADER_READ );
-      }
-      else
-      {
-         vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::GENERAL );
-      }
+      vk::Barriers::ImageMemory( cmdBuffer, texture, _getTargetLayout( desc ) );
 
-      return m_coreHandles.add( texture, HandleType::TEXTURE );
+      return m_coreHandles.add<TextureHandle>( texture );
    }
 
    TextureHandle createTexture(
@@ -249,88 +273,84 @@ class VKRenderBackendImp
        const TextureDescription& desc,
        const std::string& path )
    {
-      void* imageData = GraphicsIO::LoadImage( desc, path );
+      return createTextures( transferList, desc, std::vector<std::string>( 1, path ) ).front();
+   }
+
+   TextureHandle createTexture(
+       CmdListHandle transferList,
+       const TextureDescription& desc,
+       const std::vector<std::string>& paths )
+   {
+      CYDASSERT(
+          paths.size() <= desc.layers &&
+          "VKRenderBackend:: Number of textures could not fit in number of layers " );
 
-      if( !imageData )
+      for( const std::string& path : paths )
       {
-         return Handle();
+         if( !GraphicsIO::CheckImage( desc, path ) )
+         {
+            return {};
+         }
       }
 
       const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( transferList ) );
 
-      // Staging
-      vk::Buffer* staging = m_mainDevice->createStagingBuffer( desc.size );
-      staging->copy( imageData, 0, desc.size );
-      GraphicsIO::FreeImage( imageData );
-
-      m_cmdListDeps[transferList].emplace_back( staging );
-
-      // Uploading to GPU
+      // Uploading to GPU, the layers are decoded concurrently straight to the staging memory
       vk::Texture* texture = m_mainDevice->createTexture( desc );
 
-      vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::TRANSFER_DST );
+      unsigned char* pTexels = static_cast<unsigned char*>( m_stagingRing->reserveTexture(
+          cmdBuffer, texture, desc.size, _getTargetLayout( desc ) ) );
 
-      cmdBuffer->uploadBufferToTex( staging, texture );
+      const size_t layerSize = desc.size / desc.layers;
 
-      if( desc.stages == ShaderStage::FRAGMENT_STAGE )
-      {
-         vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::SHADER_READ );
-      }
-      else
+      std::vector<void*> destinations( paths.size() );
+      for( uint32_t i = 0; i < paths.size(); ++i )
       {
-         vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::GENERAL );
+         destinations[i] = pTexels + i * layerSize;
       }
 
-      return m_coreHandles.add( texture, HandleType::TEXTURE );
+      // Layers without an image are left black
+      const size_t usedSize = paths.size() * layerSize;
+      memset( pTexels + usedSize, 0, desc.size - usedSize );
+
+      GraphicsIO::LoadImages( desc, paths, destinations );
+
+      return m_coreHandles.add<TextureHandle>( texture );
    }
 
-   TextureHandle createTexture(
+   std::vector<TextureHandle> createTextures(
        CmdListHandle transferList,
        const TextureDescription& desc,
        const std::vector<std::string>& paths )
    {
-      CYDASSERT(
-          paths.size() <= desc.layers &&
-          "VKRenderBackend:: Number of textures could not fit in number of layers " );
-
       const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( transferList ) );
 
-      vk::Buffer* staging = m_mainDevice->createStagingBuffer( desc.size );
-
-      const size_t layerSize = desc.size / desc.layers;
+      std::vector<TextureHandle> textures( paths.size() );
 
+      // Missing images are found from their header alone, before any staging space is reserved
+      std::vector<std::string> foundPaths;
+      std::vector<void*> destinations;
       for( uint32_t i = 0; i < paths.size(); ++i )
       {
-         void* imageData = GraphicsIO::LoadImage( desc, paths[i] );
-
-         if( !imageData )
+         if( !GraphicsIO::CheckImage( desc, paths[i] ) )
          {
-            return Handle();
+            continue;
          }
 
-         staging->copy( imageData, i * layerSize, layerSize );
-         GraphicsIO::FreeImage( imageData );
-      }
-
-      m_cmdListDeps[transferList].emplace_back( staging );
+         // Uploading to GPU
+         vk::Texture* texture = m_mainDevice->createTexture( desc );
 
-      // Uploading to GPU
-      vk::Texture* texture = m_mainDevice->createTexture( desc );
+         destinations.push_back( m_stagingRing->reserveTexture(
+             cmdBuffer, texture, desc.size, _getTargetLayout( desc ) ) );
+         foundPaths.push_back( paths[i] );
 
-      vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::TRANSFER_DST );
-
-      cmdBuffer->uploadBufferToTex( staging, texture );
-
-      if( desc.stages == ShaderStage::FRAGMENT_STAGE )
-      {
-         vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::SHADER_READ );
-      }
-      else
-      {
-         vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::GENERAL );
+         textures[i] = m_coreHandles.add<TextureHandle>( texture );
       }
 
-      return m_coreHandles.add( texture, HandleType::TEXTURE );
+      // Every image is decoded on its own thread, straight to its slice of the staging memory
+      GraphicsIO::LoadImages( desc, foundPaths, destinations );
+
+      return textures;
    }
 
    TextureHandle
@@ -338,28 +358,29 @@ class VKRenderBackendImp
    {
       const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( transferList ) );
 
-      // Staging
-      vk::Buffer* staging = m_mainDevice->createStagingBuffer( desc.size );
-      staging->copy( pTexels, 0, desc.size );
-      m_cmdListDeps[transferList].emplace_back( staging );
-
       // Uploading to GPU
       vk::Texture* texture = m_mainDevice->createTexture( desc );
 
-      vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::TRANSFER_DST );
+      m_stagingRing->stageTexture(
+          cmdBuffer, texture, pTexels, desc.size, _getTargetLayout( desc ) );
+
+      return m_coreHandles.add<TextureHandle>( texture );
+   }
 
-      cmdBuffer->uploadBufferToTex( staging, texture );
+   TextureHandle createTexture(
+       CmdListHandle transferList,
+       const TextureDescription& desc,
+       const void* pTexels,
+       size_t size )
+   {
+      const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( transferList ) );
 
-      if( desc.stages == ShaderStage::FRAGMENT_STAGE )
-      {
-         vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::SHADER_READ );
-      }
-      else
-      {
-         vk::Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::GENERAL );
-      }
+      // Uploading to GPU, the staging ring tells from the size if the mips are provided
+      vk::Texture* texture = m_mainDevice->createTexture( desc );
+
+      m_stagingRing->stageTexture( cmdBuffer, texture, pTexels, size, _getTargetLayout( desc ) );
 
-      return m_coreHandles.add( texture, HandleType::TEXTURE );
+      return m_coreHandles.add<TextureHandle>( texture );
    }
 
    VertexBufferHandle createVertexBuffer(
@@ -372,50 +393,47 @@ class VKRenderBackendImp
 
       const size_t bufferSize = static_cast<size_t>( count ) * stride;
 
-      // Staging
-      vk::Buffer* staging = m_mainDevice->createStagingBuffer( bufferSize );
-      staging->copy( pVertices, 0, bufferSize );
-      m_cmdListDeps[transferList].emplace_back( staging );
-
       // Uploading to GPU
       vk::Buffer* vertexBuffer = m_mainDevice->createVertexBuffer( bufferSize );
-      cmdBuffer->copyBuffer( staging, vertexBuffer );
+      m_stagingRing->stageBuffer( cmdBuffer, vertexBuffer, pVertices, bufferSize );
 
-      return m_coreHandles.add( vertexBuffer, HandleType::VERTEXBUFFER );
+      return m_coreHandles.add<VertexBufferHandle>( vertexBuffer );
    }
 
-   IndexBufferHandle
-   createIndexBuffer( CmdListHandle transferList, uint32_t count, const void* pIndices )
+   IndexBufferHandle createIndexBuffer(
+       CmdListHandle transferList,
+       uint32_t count,
+       const void* pIndices,
+       IndexType type )
    {
-      const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( transferList ) );
+      CYDASSERT(
+          type != IndexType::UNSIGNED_INT8 && "VKRenderBackend: 8-bit indices are not supported" );
 
-      // TODO Dynamic uint32_t/uint16_t
-      const size_t bufferSize = count * sizeof( uint32_t );
+      const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( transferList ) );
 
-      // Staging
-      vk::Buffer* staging = m_mainDevice->createStagingBuffer( bufferSize );
-      staging->copy( pIndices, 0, bufferSize );
-      m_cmdListDeps[transferList].emplace_back( staging );
+      const size_t indexSize =
+          type == IndexType::UNSIGNED_INT16 ? sizeof( uint16_t ) : sizeof( uint32_t );
+      const size_t bufferSize = count * indexSize;
 
       // Uploading to GPU
       vk::Buffer* indexBuffer = m_mainDevice->createIndexBuffer( bufferSize );
-      cmdBuffer->copyBuffer( staging, indexBuffer );
+      m_stagingRing->stageBuffer( cmdBuffer, indexBuffer, pIndices, bufferSize );
 
-      return m_coreHandles.add( indexBuffer, HandleType::INDEXBUFFER );
+      return m_coreHandles.add<IndexBufferHandle>( indexBuffer );
    }
 
    BufferHandle createUniformBuffer( size_t size )
    {
       const auto uniformBuffer = m_mainDevice->createUniformBuffer( size );
 
-      return m_coreHandles.add( uniformBuffer, HandleType::BUFFER );
+      return m_coreHandles.add<BufferHandle>( uniformBuffer );
    }
 
    BufferHandle createBuffer( size_t size )
    {
       const auto deviceBuffer = m_mainDevice->createBuffer( size );
 
-      return m_coreHandles.add( deviceBuffer, HandleType::BUFFER );
+      return m_coreHandles.add<BufferHandle>( deviceBuffer );
    }
 
    void copyToBuffer( BufferHandle bufferHandle, const void* pData, size_t offset, size_t size )
@@ -432,6 +450,8 @@ class VKRenderBackendImp
    {
       if( texHandle )
       {
+         const auto texture = static_cast<vk::Texture*>( m_coreHandles.get( texHandle ) );
+         m_mainDevice->destroyTexture( texture );
          m_coreHandles.remove( texHandle );
       }
    }
@@ -440,6 +460,8 @@ class VKRenderBackendImp
    {
       if( bufferHandle )
       {
+         const auto buffer = static_cast<vk::Buffer*>( m_coreHandles.get( bufferHandle ) );
+         m_mainDevice->destroyBuffer( buffer );
          m_coreHandles.remove( bufferHandle );
       }
    }
@@ -448,6 +470,8 @@ class VKRenderBackendImp
    {
       if( bufferHandle )
       {
+         const auto buffer = static_cast<vk::Buffer*>( m_coreHandles.get( bufferHandle ) );
+         m_mainDevice->destroyBuffer( buffer );
          m_coreHandles.remove( bufferHandle );
       }
    }
@@ -456,15 +480,113 @@ class VKRenderBackendImp
    {
       if( bufferHandle )
       {
+         const auto buffer = static_cast<vk::Buffer*>( m_coreHandles.get( bufferHandle ) );
+         m_mainDevice->destroyBuffer( buffer );
          m_coreHandles.remove( bufferHandle );
       }
    }
 
-   void prepareFrame() const {}
+   void precompilePipeline( const GraphicsPipelineInfo& pipInfo, bool wantDepth ) const
+   {
+      // Only the swapchain render pass is known ahead of time
+      m_mainDevice->getPipelineStash().requestAsync(
+          pipInfo, m_mainSwapchain->getRenderPass( wantDepth ) );
+   }
+
+   void precompilePipeline( const ComputePipelineInfo& pipInfo ) const
+   {
+      m_mainDevice->getPipelineStash().requestAsync( pipInfo );
+   }
 
-   void beginRenderSwapchain( CmdListHandle cmdList, bool wantDepth ) const
+   bool isPipelineReady( CmdListHandle cmdList, const GraphicsPipelineInfo& pipInfo ) const
+   {
+      const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( cmdList ) );
+      return cmdBuffer->isPipelineReady( pipInfo );
+   }
+
+   bool isPipelineReady( const ComputePipelineInfo& pipInfo ) const
+   {
+      return m_mainDevice->getPipelineStash().isReady( pipInfo );
+   }
+
+   bool supportsBindless() const { return m_mainDevice->getBindlessTable() != nullptr; }
+
+   const ComputeLimits& getComputeLimits() const { return m_mainDevice->getComputeLimits(); }
+
+   uint32_t getBindlessIndex( TextureHandle texHandle ) const
+   {
+      if( texHandle )
+      {
+         const auto texture = static_cast<vk::Texture*>( m_coreHandles.get( texHandle ) );
+         return texture->getBindlessSlot();
+      }
+
+      return vk::BindlessTable::INVALID_SLOT;
+   }
+
+   bool isTextureStreaming( TextureHandle texHandle ) const
+   {
+      if( texHandle )
+      {
+         const auto texture = static_cast<vk::Texture*>( m_coreHandles.get( texHandle ) );
+         return texture->getStandIn() != nullptr;
+      }
+
+      return false;
+   }
+
+   void setFrameReadback( bool enable ) const { m_mainSwapchain->setReadback( enable ); }
+
+   bool getLastFrame( std::vector<uint8_t>& pixels ) const
+   {
+      return m_mainSwapchain->getLastFrame( pixels );
+   }
+
+   void copyTextureToBuffer(
+       CmdListHandle cmdList,
+       TextureHandle texHandle,
+       BufferHandle bufferHandle ) const
+   {
+      const auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( cmdList ) );
+      const auto texture   = static_cast<vk::Texture*>( m_coreHandles.get( texHandle ) );
+      const auto buffer    = static_cast<vk::Buffer*>( m_coreHandles.get( bufferHandle ) );
+      cmdBuffer->readbackTexture( texture, buffer );
+   }
+
+   bool isBufferInUse( BufferHandle bufferHandle ) const
+   {
+      const auto buffer = static_cast<vk::Buffer*>( m_coreHandles.get( bufferHandle ) );
+      return buffer->inUse();
+   }
+
+   void readFromBuffer( BufferHandle bufferHandle, void* pData, size_t offset, size_t size ) const
+   {
+      const auto buffer = static_cast<vk::Buffer*>( m_coreHandles.get( bufferHandle ) );
+      buffer->read( pData, offset, size );
+   }
+
+   void prepareFrame() const
+   {
+      // Reclaiming staging space from completed uploads and streaming the ones over budget
+      m_stagingRing->update();
+
+      // Descriptor sets of this frame go in a new page, the old one is reset once it is unused
+      m_mainDevice->getDescriptorPool().nextFrame();
+
+      // Persisting newly compiled pipelines every now and then
+      m_mainDevice->getPipelineStash().update();
+   }
+
+   void beginRenderSwapchain( CmdListHandle cmdList, bool wantDepth )
    {
       auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( cmdList ) );
+
+      for( const SwapchainWait& wait : m_swapchainWaits )
+      {
+         cmdBuffer->syncOnTimeline( wait.vkTimeline, wait.value );
+      }
+      m_swapchainWaits.clear();
+
       cmdBuffer->beginPass( *m_mainSwapchain, wantDepth );
    }
 
@@ -498,10 +620,10 @@ class VKRenderBackendImp
       cmdBuffer->draw( vertexCount );
    }
 
-   void drawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount ) const
+   void drawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount, uint32_t firstIndex ) const
    {
       auto cmdBuffer = static_cast<vk::CommandBuffer*>( m_coreHandles.get( cmdList ) );
-      cmdBuffer->drawIndexed( indexCount );
+      cmdBuffer->drawIndexed( indexCount, firstIndex );
    }
 
    void dispatch( CmdListHandle cmdList, uint32_t workX, uint32_t workY, uint32_t workZ ) const
@@ -513,6 +635,16 @@ class VKRenderBackendImp
    void presentFrame() const { m_mainSwapchain->present(); }
 
   private:
+   static ImageLayout _getTargetLayout( const TextureDescription& desc )
+   {
+      if( desc.stages == ShaderStage::FRAGMENT_STAGE )
+      {
+         return ImageLayout::SHADER_READ;
+      }
+
+      return ImageLayout::GENERAL;
+   }
+
    vk::Instance m_instance;
    vk::Surface m_surface;
    vk::DeviceHerder m_devices;
@@ -522,10 +654,16 @@ class VKRenderBackendImp
 
    HandleManager m_coreHandles;
 
-   // Used to store intermediate buffers like staging buffers to be able to flag them as unused once
-   // the command list is getting destroyed
-   using CmdListDependencyMap = std::unordered_map<uint32_t, std::vector<vk::Buffer*>>;
-   CmdListDependencyMap m_cmdListDeps;
+   // All uploads to device local resources go through this ring
+   std::unique_ptr<vk::StagingRing> m_stagingRing;
+
+   // Submissions the next swapchain pass has to wait on
+   struct SwapchainWait
+   {
+      VkSemaphore vkTimeline;
+      uint64_t value;
+   };
+   std::vector<SwapchainWait> m_swapchainWaits;
 };
 
 // =================================================================================================
@@ -568,6 +706,13 @@ void VKRenderBackend::waitOnCommandList( CmdListHandle cmdList )
    _imp->waitOnCommandList( cmdList );
 }
 
+void VKRenderBackend::syncOnCommandList( CmdListHandle from, CmdListHandle to )
+{
+   _imp->syncOnCommandList( from, to );
+}
+
+void VKRenderBackend::syncOnSwapchain( CmdListHandle from ) { _imp->syncOnSwapchain( from ); }
+
 void VKRenderBackend::destroyCommandList( CmdListHandle cmdList )
 {
    return _imp->destroyCommandList( cmdList );
@@ -675,6 +820,14 @@ TextureHandle VKRenderBackend::createTexture(
    return _imp->createTexture( transferList, desc, paths );
 }
 
+std::vector<TextureHandle> VKRenderBackend::createTextures(
+    CmdListHandle transferList,
+    const TextureDescription& desc,
+    const std::vector<std::string>& paths )
+{
+   return _imp->createTextures( transferList, desc, paths );
+}
+
 TextureHandle VKRenderBackend::createTexture(
     CmdListHandle transferList,
     const CYD::TextureDescription& desc,
@@ -683,6 +836,15 @@ TextureHandle VKRenderBackend::createTexture(
    return _imp->createTexture( transferList, desc, pTexels );
 }
 
+TextureHandle VKRenderBackend::createTexture(
+    CmdListHandle transferList,
+    const CYD::TextureDescription& desc,
+    const void* pTexels,
+    size_t size )
+{
+   return _imp->createTexture( transferList, desc, pTexels, size );
+}
+
 VertexBufferHandle VKRenderBackend::createVertexBuffer(
     CmdListHandle transferList,
     uint32_t count,
@@ -695,9 +857,10 @@ VertexBufferHandle VKRenderBackend::createVertexBuffer(
 IndexBufferHandle VKRenderBackend::createIndexBuffer(
     CmdListHandle transferList,
     uint32_t count,
-    const void* pIndices )
+    const void* pIndices,
+    IndexType type )
 {
-   return _imp->createIndexBuffer( transferList, count, pIndices );
+   return _imp->createIndexBuffer( transferList, count, pIndices, type );
 }
 
 BufferHandle VKRenderBackend::createUniformBuffer( size_t size )
@@ -736,6 +899,69 @@ void VKRenderBackend::destroyBuffer( BufferHandle bufferHandle )
    _imp->destroyBuffer( bufferHandle );
 }
 
+void VKRenderBackend::precompilePipeline( const GraphicsPipelineInfo& pipInfo, bool wantDepth )
+{
+   _imp->precompilePipeline( pipInfo, wantDepth );
+}
+
+void VKRenderBackend::precompilePipeline( const ComputePipelineInfo& pipInfo )
+{
+   _imp->precompilePipeline( pipInfo );
+}
+
+bool VKRenderBackend::isPipelineReady( CmdListHandle cmdList, const GraphicsPipelineInfo& pipInfo )
+{
+   return _imp->isPipelineReady( cmdList, pipInfo );
+}
+
+bool VKRenderBackend::isPipelineReady( const ComputePipelineInfo& pipInfo )
+{
+   return _imp->isPipelineReady( pipInfo );
+}
+
+bool VKRenderBackend::supportsBindless() { return _imp->supportsBindless(); }
+
+uint32_t VKRenderBackend::getBindlessIndex( TextureHandle texHandle )
+{
+   return _imp->getBindlessIndex( texHandle );
+}
+
+bool VKRenderBackend::isTextureStreaming( TextureHandle texHandle )
+{
+   return _imp->isTextureStreaming( texHandle );
+}
+
+const ComputeLimits& VKRenderBackend::getComputeLimits() { return _imp->getComputeLimits(); }
+
+void VKRenderBackend::setFrameReadback( bool enable ) { _imp->setFrameReadback( enable ); }
+
+bool VKRenderBackend::getLastFrame( std::vector<uint8_t>& pixels )
+{
+   return _imp->getLastFrame( pixels );
+}
+
+void VKRenderBackend::copyTextureToBuffer(
+    CmdListHandle cmdList,
+    TextureHandle texHandle,
+    BufferHandle bufferHandle )
+{
+   _imp->copyTextureToBuffer( cmdList, texHandle, bufferHandle );
+}
+
+bool VKRenderBackend::isBufferInUse( BufferHandle bufferHandle )
+{
+   return _imp->isBufferInUse( bufferHandle );
+}
+
+void VKRenderBackend::readFromBuffer(
+    BufferHandle bufferHandle,
+    void* pData,
+    size_t offset,
+    size_t size )
+{
+   _imp->readFromBuffer( bufferHandle, pData, offset, size );
+}
+
 void VKRenderBackend::prepareFrame() { _imp->prepareFrame(); }
 
 void VKRenderBackend::beginRenderSwapchain( CmdListHandle cmdList, bool wantDepth )
@@ -758,9 +984,12 @@ void VKRenderBackend::drawVertices( CmdListHandle cmdList, uint32_t vertexCount
    _imp->drawVertices( cmdList, vertexCount );
 }
 
-void VKRenderBackend::drawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount )
+void VKRenderBackend::drawVerticesIndexed(
+    CmdListHandle cmdList,
+    uint32_t indexCount,
+    uint32_t firstIndex )
 {
-   _imp->drawVerticesIndexed( cmdList, indexCount );
+   _imp->drawVerticesIndexed( cmdList, indexCount, firstIndex );
 }
 
 void VKRenderBackend::dispatch(
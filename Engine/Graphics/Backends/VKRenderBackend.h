@@ -38,6 +38,8 @@ class VKRenderBackend final : public RenderBackend
    void submitCommandList( CmdListHandle cmdList ) override;
    void resetCommandList( CmdListHandle cmdList ) override;
    void waitOnCommandList( CmdListHandle cmdList ) override;
+   void syncOnCommandList( CmdListHandle from, CmdListHandle to ) override;
+   void syncOnSwapchain( CmdListHandle from ) override;
    void destroyCommandList( CmdListHandle cmdList ) override;
 
    // Pipeline Specification
@@ -88,19 +90,33 @@ class VKRenderBackend final : public RenderBackend
        const TextureDescription& desc,
        const std::vector<std::string>& paths ) override;
 
+   std::vector<TextureHandle> createTextures(
+       CmdListHandle transferList,
+       const TextureDescription& desc,
+       const std::vector<std::string>& paths ) override;
+
    TextureHandle createTexture(
        CmdListHandle transferList,
        const TextureDescription& desc,
        const void* pTexels ) override;
 
+   TextureHandle createTexture(
+       CmdListHandle transferList,
+       const TextureDescription& desc,
+       const void* pTexels,
+       size_t size ) override;
+
    VertexBufferHandle createVertexBuffer(
        CmdListHandle transferList,
        uint32_t count,
        uint32_t stride,
        const void* pVertices ) override;
 
-   IndexBufferHandle
-   createIndexBuffer( CmdListHandle transferList, uint32_t count, const void* pIndices ) override;
+   IndexBufferHandle createIndexBuffer(
+       CmdListHandle transferList,
+       uint32_t count,
+       const void* pIndices,
+       IndexType type ) override;
 
    BufferHandle createUniformBuffer( size_t size ) override;
 
@@ -114,6 +130,38 @@ class VKRenderBackend final : public RenderBackend
    void destroyIndexBuffer( IndexBufferHandle bufferHandle ) override;
    void destroyBuffer( BufferHandle bufferHandle ) override;
 
+   // Pipeline Warm-up
+   // ==============================================================================================
+   void precompilePipeline( const GraphicsPipelineInfo& pipInfo, bool wantDepth ) override;
+   void precompilePipeline( const ComputePipelineInfo& pipInfo ) override;
+   bool isPipelineReady( CmdListHandle cmdList, const GraphicsPipelineInfo& pipInfo ) override;
+   bool isPipelineReady( const ComputePipelineInfo& pipInfo ) override;
+
+   // Bindless
+   // ==============================================================================================
+   bool supportsBindless() override;
+   uint32_t getBindlessIndex( TextureHandle texHandle ) override;
+   bool isTextureStreaming( TextureHandle texHandle ) override;
+
+   // Compute
+   // ==============================================================================================
+   const ComputeLimits& getComputeLimits() override;
+
+   // Frame Readback
+   // ==============================================================================================
+   void setFrameReadback( bool enable ) override;
+   bool getLastFrame( std::vector<uint8_t>& pixels ) override;
+
+   // Texture Readback
+   // ==============================================================================================
+   void copyTextureToBuffer(
+       CmdListHandle cmdList,
+       TextureHandle texHandle,
+       BufferHandle bufferHandle ) override;
+   bool isBufferInUse( BufferHandle bufferHandle ) override;
+   void readFromBuffer( BufferHandle bufferHandle, void* pData, size_t offset, size_t size )
+       override;
+
    // Drawing
    // ==============================================================================================
    void prepareFrame() override;
@@ -124,7 +172,8 @@ class VKRenderBackend final : public RenderBackend
        const std::vector<TextureHandle>& textures ) override;
    void endRenderPass( CmdListHandle cmdList ) override;
    void drawVertices( CmdListHandle cmdList, uint32_t vertexCount ) override;
-   void drawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount ) override;
+   void drawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount, uint32_t firstIndex )
+       override;
    void dispatch( CmdListHandle cmdList, uint32_t workX, uint32_t workY, uint32_t workZ );
    void presentFrame() override;
 
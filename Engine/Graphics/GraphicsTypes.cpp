@@ -4,7 +4,61 @@ namespace CYD
 {
 bool Vertex::operator==( const Vertex& other ) const
 {
-   return pos == other.pos && col == other.col && uv == other.uv;
+   return pos == other.pos && col == other.col && uv == other.uv && normal == other.normal;
+}
+
+bool VertexAttribute::operator==( const VertexAttribute& other ) const
+{
+   return semantic == other.semantic && format == other.format && offset == other.offset;
+}
+
+static uint32_t getVertexFormatSize( VertexFormat format )
+{
+   switch( format )
+   {
+      case VertexFormat::FLOAT2:
+         return 8;
+      case VertexFormat::FLOAT3:
+         return 12;
+      case VertexFormat::FLOAT4:
+         return 16;
+      case VertexFormat::HALF2:
+      case VertexFormat::UNORM8x4:
+      case VertexFormat::SNORM8x4:
+      case VertexFormat::UNORM16x2:
+      case VertexFormat::SNORM16x2:
+         return 4;
+      case VertexFormat::HALF4:
+      case VertexFormat::UNORM16x4:
+      case VertexFormat::SNORM16x4:
+         return 8;
+   }
+
+   return 0;
+}
+
+bool VertexLayout::operator==( const VertexLayout& other ) const
+{
+   return attributes == other.attributes && stride == other.stride;
+}
+
+VertexLayout& VertexLayout::add( VertexSemantic semantic, VertexFormat format )
+{
+   attributes.push_back( {semantic, format, stride} );
+   stride += getVertexFormatSize( format );
+   return *this;
+}
+
+const VertexAttribute* VertexLayout::find( VertexSemantic semantic ) const
+{
+   for( const VertexAttribute& attribute : attributes )
+   {
+      if( attribute.semantic == semantic )
+      {
+         return &attribute;
+      }
+   }
+   return nullptr;
 }
 
 bool Extent2D::operator==( const Extent2D& other ) const
@@ -58,6 +112,7 @@ bool SamplerInfo::operator==( const SamplerInfo& other ) const
 {
    return useAnisotropy == other.useAnisotropy && maxAnisotropy == other.maxAnisotropy &&
           magFilter == other.magFilter && minFilter == other.minFilter &&
-          addressMode == other.addressMode;
+          mipFilter == other.mipFilter && addressMode == other.addressMode &&
+          minLod == other.minLod && maxLod == other.maxLod && lodBias == other.lodBias;
 }
 }
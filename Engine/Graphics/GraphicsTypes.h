@@ -164,6 +164,7 @@ enum class ImageType
 {
    TEXTURE_1D,
    TEXTURE_2D,
+   TEXTURE_2D_ARRAY,  // Viewed as an array whatever the number of layers, never as a cube map
    TEXTURE_3D
 };
 
@@ -173,7 +174,8 @@ enum class ShaderResourceType
    STORAGE,
    COMBINED_IMAGE_SAMPLER,
    STORAGE_IMAGE,
-   SAMPLED_IMAGE
+   SAMPLED_IMAGE,
+   BINDLESS_TEXTURES  // Array of every sampled texture, requires descriptor indexing
 };
 
 enum class Filter
@@ -192,15 +194,43 @@ enum class AddressMode
    MIRROR_CLAMP_TO_EDGE,
 };
 
+enum class VertexFormat
+{
+   FLOAT2,
+   FLOAT3,
+   FLOAT4,
+   HALF2,
+   HALF4,
+   UNORM8x4,
+   SNORM8x4,
+   UNORM16x2,
+   SNORM16x2,
+   UNORM16x4,
+   SNORM16x4
+};
+
+// The values are the input locations used by the shaders
+enum class VertexSemantic : uint32_t
+{
+   POSITION = 0,
+   COLOR    = 1,
+   TEXCOORD = 2,
+   NORMAL   = 3
+};
+
 // ================================================================================================
 // Basic structs
 
 struct TextureDescription
 {
-   size_t size            = 0;
+   // Clamped to the number of levels down to 1x1
+   static constexpr uint32_t FULL_MIP_CHAIN = ~0u;
+
+   size_t size            = 0;                      // Size of the first mip level, all layers
    uint32_t width         = 0;
    uint32_t height        = 0;
    uint32_t layers        = 1;
+   uint32_t mipLevels     = 1;                      // Levels past the first are generated on upload
    ImageType type         = ImageType::TEXTURE_2D;  // 1D, 2D, 3D...
    PixelFormat format     = PixelFormat::RGBA32F;   // The texture's pixel format
    ImageUsageFlag usage   = 0;                      // How this image will be used
@@ -238,7 +268,7 @@ struct Viewport
 
 struct Vertex
 {
-   // Keep in sync with the VkVertexInputAttributeDescription in PipelineStash
+   // Keep in sync with VertexPacking::GetStandardLayout
    bool operator==( const Vertex& other ) const;
    glm::vec3 pos;
    glm::vec4 col;
@@ -246,6 +276,30 @@ struct Vertex
    glm::vec3 normal;
 };
 
+struct VertexAttribute
+{
+   bool operator==( const VertexAttribute& other ) const;
+   VertexSemantic semantic;
+   VertexFormat format;
+   uint32_t offset;
+};
+
+/*
+ * Interleaved vertex layout read by a pipeline. How an attribute is encoded depends on both its
+ * semantic and its format, see VertexPacking.
+ */
+struct VertexLayout
+{
+   bool operator==( const VertexLayout& other ) const;
+
+   // Appends an attribute right after the previous ones
+   VertexLayout& add( VertexSemantic semantic, VertexFormat format );
+   const VertexAttribute* find( VertexSemantic semantic ) const;
+
+   std::vector<VertexAttribute> attributes;
+   uint32_t stride = 0;
+};
+
 struct ShaderResourceInfo
 {
    bool operator==( const ShaderResourceInfo& other ) const;
@@ -279,10 +333,14 @@ struct SamplerInfo
 {
    bool operator==( const SamplerInfo& other ) const;
    bool useAnisotropy      = true;
-   float maxAnisotropy     = 16.0f;
+   float maxAnisotropy     = 16.0f;  // Clamped to the device limit
    Filter magFilter        = Filter::NEAREST;
    Filter minFilter        = Filter::NEAREST;
+   Filter mipFilter        = Filter::LINEAR;
    AddressMode addressMode = AddressMode::REPEAT;
+   float minLod            = 0.0f;
+   float maxLod            = 1000.0f;  // No clamping, every mip level can be sampled
+   float lodBias           = 0.0f;
 };
 
 struct RenderPassInfo
@@ -311,6 +369,13 @@ struct SwapchainInfo
    ColorSpace space;
    PresentMode mode;
 };
+
+struct ComputeLimits
+{
+   uint32_t maxWorkGroupSize    = 0;  // Invocations in a workgroup laid out along X
+   uint32_t maxSharedMemorySize = 0;  // Bytes of workgroup shared memory
+   uint32_t subgroupSize        = 0;  // 0 when compute shaders cannot shuffle within subgroups
+};
 }
 
 // ================================================================================================
@@ -331,7 +396,27 @@ struct std::hash<CYD::Vertex>
       hashCombine( seed, vertex.col.a );
       hashCombine( seed, vertex.uv.x );
       hashCombine( seed, vertex.uv.y );
+      hashCombine( seed, vertex.normal.x );
+      hashCombine( seed, vertex.normal.y );
+      hashCombine( seed, vertex.normal.z );
+
+      return seed;
+   }
+};
 
+template <>
+struct std::hash<CYD::VertexLayout>
+{
+   size_t operator()( const CYD::VertexLayout& layout ) const noexcept
+   {
+      size_t seed = 0;
+      for( const auto& attribute : layout.attributes )
+      {
+         hashCombine( seed, attribute.semantic );
+         hashCombine( seed, attribute.format );
+         hashCombine( seed, attribute.offset );
+      }
+      hashCombine( seed, layout.stride );
       return seed;
    }
 };
@@ -443,7 +528,11 @@ struct std::hash<CYD::SamplerInfo>
       hashCombine( seed, samplerInfo.maxAnisotropy );
       hashCombine( seed, samplerInfo.magFilter );
       hashCombine( seed, samplerInfo.minFilter );
+      hashCombine( seed, samplerInfo.mipFilter );
       hashCombine( seed, samplerInfo.addressMode );
+      hashCombine( seed, samplerInfo.minLod );
+      hashCombine( seed, samplerInfo.maxLod );
+      hashCombine( seed, samplerInfo.lodBias );
 
       return seed;
    }
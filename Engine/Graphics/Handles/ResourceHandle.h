@@ -27,21 +27,43 @@ struct Handle
    {
    }
 
-   operator uint32_t() const { return _type << 27 | _counter << 12 | _index; }
+   // A default handle does not refer to anything, counters start at 1
+   explicit operator bool() const { return _counter != 0; }
+
+   bool operator==( const Handle& other ) const
+   {
+      return _index == other._index && _counter == other._counter && _type == other._type;
+   }
+   bool operator!=( const Handle& other ) const { return !( *this == other ); }
+
+   HandleType getType() const { return static_cast<HandleType>( _type ); }
 
    // The resource's index
-   uint32_t _index : 12;
+   uint32_t _index;
 
    // The number of times the resource was reused/updated
-   uint32_t _counter : 15;
+   uint32_t _counter : 27;
 
    // Used to determine the type of the data the handle is referring to
    uint32_t _type : 5;
 };
 
-using CmdListHandle      = Handle;
-using VertexBufferHandle = Handle;
-using IndexBufferHandle  = Handle;
-using TextureHandle      = Handle;
-using BufferHandle       = Handle;
+/*
+ * Handles of different types do not convert to each other, passing a texture handle where a
+ * buffer is expected does not compile.
+ */
+template <HandleType TYPE>
+struct TypedHandle final : public Handle
+{
+   static constexpr HandleType Type = TYPE;
+
+   TypedHandle() = default;
+   TypedHandle( uint32_t index, uint32_t counter ) : Handle( index, counter, TYPE ) {}
+};
+
+using CmdListHandle      = TypedHandle<HandleType::CMDLIST>;
+using VertexBufferHandle = TypedHandle<HandleType::VERTEXBUFFER>;
+using IndexBufferHandle  = TypedHandle<HandleType::INDEXBUFFER>;
+using TextureHandle      = TypedHandle<HandleType::TEXTURE>;
+using BufferHandle       = TypedHandle<HandleType::BUFFER>;
 }
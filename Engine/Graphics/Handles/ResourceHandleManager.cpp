@@ -2,80 +2,204 @@
 
 #include <Common/Assert.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <random>
+#include <thread>
+#include <vector>
 
 namespace CYD
 {
-HandleManager::HandleEntry::HandleEntry()
-    : _nextFreeIndex( 0 ), _counter( 1 ), _active( 0 ), _endOfList( 0 ), _entry( nullptr )
+static constexpr uint32_t COUNTER_MASK  = ( 1u << 27 ) - 1;
+static constexpr uint32_t INVALID_INDEX = ~0u;
+
+static uint64_t packState( uint32_t counter, bool active, HandleType type )
 {
+   return static_cast<uint64_t>( counter & COUNTER_MASK ) << 8 |
+          static_cast<uint64_t>( active ) << 5 | static_cast<uint64_t>( type );
 }
 
-HandleManager::HandleEntry::HandleEntry( uint32_t nextFreeIndex )
-    : _nextFreeIndex( nextFreeIndex ), _counter( 1 ), _active( 0 ), _endOfList( 0 ), _entry( NULL )
+static uint32_t getCounter( uint64_t state ) { return static_cast<uint32_t>( state >> 8 ); }
+
+static bool isActive( uint64_t state ) { return ( state >> 5 ) & 1; }
+
+HandleManager::HandleManager()
 {
+   for( auto& page : m_pages )
+   {
+      page.store( nullptr, std::memory_order_relaxed );
+   }
 }
 
-HandleManager::HandleManager() { reset(); }
+HandleManager::~HandleManager()
+{
+   for( auto& page : m_pages )
+   {
+      delete[] page.load( std::memory_order_relaxed );
+   }
+}
+
+HandleManager::Slot* HandleManager::_getSlot( uint32_t index ) const
+{
+   const uint32_t pageIdx = index / PAGE_SIZE;
+   if( pageIdx >= MAX_PAGES )
+   {
+      return nullptr;
+   }
+
+   Slot* page = m_pages[pageIdx].load( std::memory_order_acquire );
+   return page ? &page[index % PAGE_SIZE] : nullptr;
+}
 
-void HandleManager::reset()
+HandleManager::Slot* HandleManager::_getOrCreateSlot( uint32_t index )
 {
-   _activeEntryCount = 0;
-   _firstFreeEntry   = 0;
+   const uint32_t pageIdx = index / PAGE_SIZE;
+   if( pageIdx >= MAX_PAGES )
+   {
+      CYDASSERT( !"HandleManager: Reached maximum number of handles" );
+      return nullptr;
+   }
+
+   Slot* page = m_pages[pageIdx].load( std::memory_order_acquire );
+   if( !page )
+   {
+      // Several threads can race to create the same page, only one of them wins
+      Slot* newPage = new Slot[PAGE_SIZE]();
+      if( m_pages[pageIdx].compare_exchange_strong(
+              page, newPage, std::memory_order_acq_rel, std::memory_order_acquire ) )
+      {
+         page = newPage;
+      }
+      else
+      {
+         delete[] newPage;
+      }
+   }
 
-   for( int i = 0; i < MAX_ENTRIES - 1; ++i ) _entries[i] = HandleEntry( i + 1 );
-   _entries[MAX_ENTRIES - 1]            = HandleEntry();
-   _entries[MAX_ENTRIES - 1]._endOfList = true;
+   return &page[index % PAGE_SIZE];
 }
 
-Handle HandleManager::add( void* p, HandleType handleType )
+uint32_t HandleManager::_popFree()
 {
-   uint32_t type = static_cast<uint32_t>( handleType );
+   uint64_t head = m_freeHead.load( std::memory_order_acquire );
+   for( ;; )
+   {
+      const uint32_t first = static_cast<uint32_t>( head );
+      if( first == 0 )
+      {
+         return INVALID_INDEX;
+      }
 
-   CYDASSERT( _activeEntryCount < ( MAX_ENTRIES - 1 ) );
+      // The next index may be stale if the slot was popped and pushed back in the meantime, the
+      // tag makes the exchange fail in that case
+      const uint32_t next    = _getSlot( first - 1 )->nextFree.load( std::memory_order_relaxed );
+      const uint64_t newHead = ( ( head >> 32 ) + 1 ) << 32 | next;
 
-   CYDASSERT( type >= 0 && type <= 31 );
+      if( m_freeHead.compare_exchange_weak(
+              head, newHead, std::memory_order_acquire, std::memory_order_acquire ) )
+      {
+         return first - 1;
+      }
+   }
+}
 
-   const int newIndex = _firstFreeEntry;
-   CYDASSERT( newIndex < MAX_ENTRIES );
-   CYDASSERT( _entries[newIndex]._active == false );
-   CYDASSERT( !_entries[newIndex]._endOfList );
+void HandleManager::_pushFree( uint32_t index )
+{
+   Slot* slot = _getSlot( index );
 
-   _firstFreeEntry                   = _entries[newIndex]._nextFreeIndex;
-   _entries[newIndex]._nextFreeIndex = 0;
-   _entries[newIndex]._counter       = _entries[newIndex]._counter + 1;
-   if( _entries[newIndex]._counter == 0 )
+   uint64_t head = m_freeHead.load( std::memory_order_relaxed );
+   uint64_t newHead;
+   do
    {
-      _entries[newIndex]._counter = 1;
+      slot->nextFree.store( static_cast<uint32_t>( head ), std::memory_order_relaxed );
+      newHead = ( ( head >> 32 ) + 1 ) << 32 | ( index + 1 );
+   } while( !m_freeHead.compare_exchange_weak(
+       head, newHead, std::memory_order_release, std::memory_order_relaxed ) );
+}
+
+uint32_t HandleManager::_add( void* p, HandleType type, uint32_t& counter )
+{
+   CYDASSERT( static_cast<uint32_t>( type ) <= 31 );
+
+   uint32_t index = _popFree();
+   if( index == INVALID_INDEX )
+   {
+      // Never going past the last page, adds failing on a full table cannot wrap the index around
+      index = m_nextUnused.load( std::memory_order_relaxed );
+      do
+      {
+         if( index >= MAX_PAGES * PAGE_SIZE )
+         {
+            CYDASSERT( !"HandleManager: Reached maximum number of handles" );
+            counter = 0;
+            return INVALID_INDEX;
+         }
+      } while( !m_nextUnused.compare_exchange_weak(
+          index, index + 1, std::memory_order_relaxed, std::memory_order_relaxed ) );
    }
-   _entries[newIndex]._active = true;
-   _entries[newIndex]._entry  = p;
 
-   ++_activeEntryCount;
+   Slot* slot = _getOrCreateSlot( index );
+   if( !slot )
+   {
+      counter = 0;
+      return INVALID_INDEX;
+   }
+
+   const uint64_t prevState = slot->state.load( std::memory_order_relaxed );
+   CYDASSERT( !isActive( prevState ) && "HandleManager: Handing out a slot still in use" );
 
-   return Handle( newIndex, _entries[newIndex]._counter, handleType );
+   counter = ( getCounter( prevState ) + 1 ) & COUNTER_MASK;
+   if( counter == 0 )
+   {
+      counter = 1;
+   }
+
+   // Publishing the data before the slot becomes valid for lookups
+   slot->data.store( p, std::memory_order_relaxed );
+   slot->state.store( packState( counter, true, type ), std::memory_order_release );
+
+   m_activeCount.fetch_add( 1, std::memory_order_relaxed );
+
+   return index;
 }
 
 void HandleManager::update( Handle handle, void* newData )
 {
-   const int index = handle._index;
-   CYDASSERT( _entries[index]._counter == handle._counter );
-   CYDASSERT( _entries[index]._active == true );
+   Slot* slot = _getSlot( handle._index );
+   CYDASSERT(
+       slot &&
+       slot->state.load( std::memory_order_acquire ) ==
+           packState( handle._counter, true, handle.getType() ) &&
+       "HandleManager: Updating a stale or invalid handle" );
 
-   _entries[index]._entry = newData;
+   slot->data.store( newData, std::memory_order_release );
 }
 
 void HandleManager::remove( const Handle handle )
 {
-   const uint32_t index = handle._index;
-   CYDASSERT( _entries[index]._counter == handle._counter );
-   CYDASSERT( _entries[index]._active == true );
+   Slot* slot = _getSlot( handle._index );
+   if( !slot )
+   {
+      CYDASSERT( !"HandleManager: Removing an invalid handle" );
+      return;
+   }
 
-   _entries[index]._nextFreeIndex = _firstFreeEntry;
-   _entries[index]._active        = 0;
-   _firstFreeEntry                = index;
+   // Only one thread can succeed at deactivating the slot
+   uint64_t expected = packState( handle._counter, true, handle.getType() );
+   if( !slot->state.compare_exchange_strong(
+           expected,
+           packState( handle._counter, false, handle.getType() ),
+           std::memory_order_acq_rel ) )
+   {
+      CYDASSERT( !"HandleManager: Removing a stale handle" );
+      return;
+   }
+
+   slot->data.store( nullptr, std::memory_order_relaxed );
+   _pushFree( handle._index );
 
-   --_activeEntryCount;
+   m_activeCount.fetch_sub( 1, std::memory_order_relaxed );
 }
 
 void* HandleManager::get( Handle handle ) const
@@ -87,11 +211,239 @@ void* HandleManager::get( Handle handle ) const
 
 bool HandleManager::get( const Handle handle, void*& out ) const
 {
-   const int index = handle._index;
-   if( _entries[index]._counter != handle._counter || _entries[index]._active == false )
+   const Slot* slot = _getSlot( handle._index );
+   if( !handle || !slot )
+   {
+      return false;
+   }
+
+   const uint64_t expected = packState( handle._counter, true, handle.getType() );
+   if( slot->state.load( std::memory_order_acquire ) != expected )
+   {
       return false;
+   }
+
+   out = slot->data.load( std::memory_order_acquire );
+
+   // The slot could have been released while reading, not retrying keeps lookups wait-free
+   return slot->state.load( std::memory_order_acquire ) == expected;
+}
+
+// =================================================================================================
+// Stress test
+
+// Live handles of each thread stay under this so that slots are constantly recycled
+static constexpr uint32_t STRESS_MAX_LIVE = 256;
+
+// Recently removed handles of each thread, looked up again to check that they are rejected
+static constexpr uint32_t STRESS_STALE_HISTORY = 64;
+
+// Every resource points to its own handle, a lookup landing on another resource is caught
+static void* encodeHandle( const Handle& handle )
+{
+   return reinterpret_cast<void*>(
+       static_cast<uintptr_t>( static_cast<uint64_t>( handle._index ) << 32 | handle._counter ) );
+}
+
+static uint64_t packHandle( const Handle& handle )
+{
+   return static_cast<uint64_t>( handle._index ) << 32 | handle._counter;
+}
+
+static Handle unpackHandle( uint64_t packed )
+{
+   return Handle(
+       static_cast<uint32_t>( packed >> 32 ),
+       static_cast<uint32_t>( packed ),
+       HandleType::TEXTURE );
+}
+
+void HandleManager::StressTest( uint32_t iterations )
+{
+   using Clock = std::chrono::steady_clock;
+
+   const uint32_t threadCount = std::max( std::thread::hardware_concurrency(), 4u );
+
+   HandleManager manager;
+
+   // A thread can hold one slot in between deactivating and freeing it, any slot past these was
+   // handed out while free slots were lost
+   const uint32_t slotBound = threadCount * ( STRESS_MAX_LIVE + 1 );
+
+   // Set while a live handle refers to the slot
+   std::vector<std::atomic<uint8_t>> slotInUse( slotBound );
+
+   // One live handle of every thread, looked up by the others while it can be removed at any time
+   std::vector<std::atomic<uint64_t>> published( threadCount );
+
+   std::atomic<uint64_t> fullTable      = 0;
+   std::atomic<uint64_t> duplicateSlots = 0;
+   std::atomic<uint64_t> lostSlots      = 0;
+   std::atomic<uint64_t> staleAccepted  = 0;
+   std::atomic<uint64_t> wrongResources = 0;
+
+   const auto stress = [&]( uint32_t threadIdx ) {
+      std::mt19937 generator( threadIdx );
+
+      std::vector<TextureHandle> live;
+      live.reserve( STRESS_MAX_LIVE );
+
+      Handle stale[STRESS_STALE_HISTORY];
+      uint32_t staleCount = 0;
+
+      uint64_t full       = 0;
+      uint64_t duplicates = 0;
+      uint64_t lost       = 0;
+      uint64_t staleHits  = 0;
+      uint64_t wrong      = 0;
+
+      const auto removeAt = [&]( size_t liveIdx ) {
+         const TextureHandle handle = live[liveIdx];
+         live[liveIdx]              = live.back();
+         live.pop_back();
+
+         // Cleared before the slot can be handed out again
+         if( handle._index < slotBound )
+         {
+            slotInUse[handle._index].store( 0, std::memory_order_relaxed );
+         }
+         manager.remove( handle );
+
+         stale[staleCount++ % STRESS_STALE_HISTORY] = handle;
+      };
+
+      for( uint32_t i = 0; i < iterations; ++i )
+      {
+         const bool adding = live.empty() || ( live.size() < STRESS_MAX_LIVE && generator() % 2 );
+         if( adding )
+         {
+            const TextureHandle handle = manager.add<TextureHandle>( nullptr );
+            if( !handle )
+            {
+               ++full;
+               continue;
+            }
+
+            if( handle._index >= slotBound )
+            {
+               ++lost;
+            }
+            else if( slotInUse[handle._index].exchange( 1, std::memory_order_relaxed ) )
+            {
+               ++duplicates;
+            }
+
+            manager.update( handle, encodeHandle( handle ) );
+            live.push_back( handle );
+            published[threadIdx].store( packHandle( handle ), std::memory_order_release );
+         }
+         else
+         {
+            removeAt( generator() % live.size() );
+         }
+
+         void* data = nullptr;
+
+         if( !live.empty() )
+         {
+            const TextureHandle& handle = live[generator() % live.size()];
+            if( !manager.get( handle, data ) || data != encodeHandle( handle ) )
+            {
+               ++wrong;
+            }
+         }
+
+         if( staleCount > 0 )
+         {
+            const uint32_t staleIdx = generator() % std::min( staleCount, STRESS_STALE_HISTORY );
+            if( manager.get( stale[staleIdx], data ) )
+            {
+               ++staleHits;
+            }
+         }
+
+         // Another thread's handle is either rejected or reaches its own resource, which can still
+         // be null if it was looked up before being updated
+         const uint32_t offset = 1 + generator() % ( threadCount - 1 );
+         const uint64_t packed =
+             published[( threadIdx + offset ) % threadCount].load( std::memory_order_acquire );
+         if( packed )
+         {
+            const Handle other = unpackHandle( packed );
+            if( manager.get( other, data ) && data && data != encodeHandle( other ) )
+            {
+               ++wrong;
+            }
+         }
+      }
+
+      while( !live.empty() )
+      {
+         removeAt( live.size() - 1 );
+      }
+
+      fullTable += full;
+      duplicateSlots += duplicates;
+      lostSlots += lost;
+      staleAccepted += staleHits;
+      wrongResources += wrong;
+   };
+
+   const auto start = Clock::now();
+
+   std::vector<std::thread> threads;
+   threads.reserve( threadCount - 1 );
+   for( uint32_t i = 1; i < threadCount; ++i )
+   {
+      threads.emplace_back( stress, i );
+   }
+   stress( 0 );
+   for( std::thread& thread : threads )
+   {
+      thread.join();
+   }
+
+   const double elapsedMs =
+       std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+
+   // Everything was removed, every slot ever handed out has to be on the free list exactly once
+   const uint32_t slotCount = manager.m_nextUnused.load();
+   std::vector<bool> isFree( slotCount, false );
+   uint32_t freeCount = 0;
+
+   uint32_t first = static_cast<uint32_t>( manager.m_freeHead.load() );
+   while( first != 0 )
+   {
+      if( first > slotCount || isFree[first - 1] )
+      {
+         ++duplicateSlots;
+         break;
+      }
+
+      isFree[first - 1] = true;
+      ++freeCount;
+
+      first = manager._getSlot( first - 1 )->nextFree.load();
+   }
+   lostSlots += slotCount - std::min( freeCount, slotCount );
+
+   const bool passed = fullTable == 0 && duplicateSlots == 0 && lostSlots == 0 &&
+                       staleAccepted == 0 && wrongResources == 0 && manager.getCount() == 0;
 
-   out = _entries[index]._entry;
-   return true;
+   printf(
+       "HandleManager: %u threads x %u iterations in %8.2f ms, %u slots used\n",
+       threadCount,
+       iterations,
+       elapsedMs,
+       slotCount );
+   printf(
+       "HandleManager: %llu full, %llu duplicate slots, %llu lost slots, %llu stale handles "
+       "accepted, %llu wrong resources, %s\n",
+       static_cast<unsigned long long>( fullTable.load() ),
+       static_cast<unsigned long long>( duplicateSlots.load() ),
+       static_cast<unsigned long long>( lostSlots.load() ),
+       static_cast<unsigned long long>( staleAccepted.load() ),
+       static_cast<unsigned long long>( wrongResources.load() ),
+       passed ? "passed" : "FAILED" );
 }
 }
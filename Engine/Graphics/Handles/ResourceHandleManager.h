@@ -2,27 +2,43 @@
 
 #include <Graphics/Handles/ResourceHandle.h>
 
+#include <atomic>
 #include <cstdint>
 
 namespace CYD
 {
+/*
+ * Paged table mapping handles to resources. Pages are allocated as the table grows and are never
+ * moved or freed before the table is destroyed, so lookups never wait on anything.
+ *
+ * Adding and removing are lock-free and can be called from any thread. Freed slots go on a tagged
+ * free list, and every slot has a counter that is bumped each time it is reused so that stale
+ * handles are detected instead of reaching the new resource.
+ */
 class HandleManager
 {
   public:
    HandleManager();
    HandleManager( const HandleManager& ) = delete;
    HandleManager& operator=( const HandleManager& ) = delete;
-   ~HandleManager()                                 = default;
+   ~HandleManager();
+
+   // Returns an invalid handle when the table is full
+   template <class HandleT>
+   HandleT add( void* data )
+   {
+      uint32_t counter;
+      const uint32_t index = _add( data, HandleT::Type, counter );
+      return counter ? HandleT( index, counter ) : HandleT();
+   }
 
-   void reset();
-   Handle add( void* data, HandleType handleType );
    void update( Handle handle, void* newData );
    void remove( Handle handle );
 
    void* get( Handle handle ) const;
    bool get( Handle handle, void*& out ) const;
 
-   int getCount() const { return _activeEntryCount; }
+   uint32_t getCount() const { return m_activeCount.load( std::memory_order_relaxed ); }
 
    template <typename T>
    bool getAs( Handle handle, T& out ) const
@@ -30,29 +46,45 @@ class HandleManager
       void* outAsVoid;
       const bool rv = get( handle, outAsVoid );
 
-      out = union_cast<T>( outAsVoid );
+      out = static_cast<T>( outAsVoid );
 
       return rv;
    };
 
+   // Adds, updates, removes and looks up handles from every hardware thread at once, checking that
+   // no slot is handed out twice or lost and that stale handles never reach a resource
+   static void StressTest( uint32_t iterations );
+
   private:
-   static constexpr uint32_t MAX_ENTRIES = 512;
+   static constexpr uint32_t PAGE_SIZE = 1024;
+   static constexpr uint32_t MAX_PAGES = 4096;
+
+   // Packed as counter | active | type, changes atomically whenever the slot is reused
+   using SlotState = uint64_t;
 
-   struct HandleEntry
+   struct Slot
    {
-      HandleEntry();
-      explicit HandleEntry( uint32_t nextFreeIndex );
-
-      uint32_t _nextFreeIndex : 12;
-      uint32_t _counter : 15;
-      uint32_t _active : 1;
-      uint32_t _endOfList : 1;
-      void* _entry;
+      std::atomic<SlotState> state;
+      std::atomic<void*> data;
+      std::atomic<uint32_t> nextFree;
    };
 
-   HandleEntry _entries[MAX_ENTRIES];
+   uint32_t _add( void* data, HandleType type, uint32_t& counter );
+   uint32_t _popFree();
+   void _pushFree( uint32_t index );
+
+   Slot* _getSlot( uint32_t index ) const;
+   Slot* _getOrCreateSlot( uint32_t index );
+
+   std::atomic<Slot*> m_pages[MAX_PAGES] = {};
+
+   // Index + 1 of the first free slot in the low bits, 0 when empty. The high bits are a tag
+   // bumped on every change to avoid ABA issues.
+   std::atomic<uint64_t> m_freeHead = 0;
+
+   // Slots past this one were never handed out
+   std::atomic<uint32_t> m_nextUnused = 0;
 
-   int _activeEntryCount;
-   uint32_t _firstFreeEntry;
+   std::atomic<uint32_t> m_activeCount = 0;
 };
 }
@@ -1,17 +1,22 @@
 #include <Graphics/PipelineInfos.h>
 
+#include <Graphics/Utility/VertexPacking.h>
+
 namespace CYD
 {
 PipelineInfo::PipelineInfo()  = default;
 PipelineInfo::~PipelineInfo() = default;
 
-GraphicsPipelineInfo::GraphicsPipelineInfo() : PipelineInfo( PipelineType::GRAPHICS ) {}
+GraphicsPipelineInfo::GraphicsPipelineInfo()
+    : PipelineInfo( PipelineType::GRAPHICS ), vertexLayout( VertexPacking::GetStandardLayout() )
+{
+}
 
-// TODO Also compare shader constants
 bool GraphicsPipelineInfo::operator==( const GraphicsPipelineInfo& other ) const
 {
    return pipLayout == other.pipLayout && drawPrim == other.drawPrim &&
-          polyMode == other.polyMode && extent == other.extent && shaders == other.shaders;
+          polyMode == other.polyMode && extent == other.extent && shaders == other.shaders &&
+          vertexLayout == other.vertexLayout && constants == other.constants;
 }
 GraphicsPipelineInfo::~GraphicsPipelineInfo() = default;
 
@@ -19,7 +24,7 @@ ComputePipelineInfo::ComputePipelineInfo() : PipelineInfo( PipelineType::COMPUTE
 
 bool ComputePipelineInfo::operator==( const ComputePipelineInfo& other ) const
 {
-   return pipLayout == other.pipLayout && shader == other.shader;
+   return pipLayout == other.pipLayout && shader == other.shader && constants == other.constants;
 }
 ComputePipelineInfo::~ComputePipelineInfo() = default;
 }
\ No newline at end of file
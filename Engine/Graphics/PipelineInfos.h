@@ -37,6 +37,7 @@ struct GraphicsPipelineInfo final : public PipelineInfo
    DrawPrimitive drawPrim;
    PolygonMode polyMode;
    Extent2D extent;
+   VertexLayout vertexLayout;  // Standard Vertex layout by default
 };
 
 struct ComputePipelineInfo final : public PipelineInfo
@@ -62,6 +63,8 @@ struct std::hash<CYD::GraphicsPipelineInfo>
       hashCombine( seed, pipInfo.drawPrim );
       hashCombine( seed, pipInfo.polyMode );
       hashCombine( seed, pipInfo.extent );
+      hashCombine( seed, pipInfo.vertexLayout );
+      hashCombine( seed, pipInfo.constants );
       for( const auto& shader : pipInfo.shaders )
       {
          hashCombine( seed, shader );
@@ -80,6 +83,7 @@ struct std::hash<CYD::ComputePipelineInfo>
       hashCombine( seed, pipInfo.type );
       hashCombine( seed, pipInfo.pipLayout );
       hashCombine( seed, pipInfo.shader );
+      hashCombine( seed, pipInfo.constants );
 
       return seed;
    }
@@ -2,14 +2,27 @@
 
 #include <Common/Assert.h>
 
+#include <Graphics/PipelineInfos.h>
 #include <Graphics/RenderInterface.h>
+#include <Graphics/Utility/AssetPack.h>
 #include <Graphics/Utility/GraphicsIO.h>
+#include <Graphics/Utility/MeshGeneration.h>
+#include <Graphics/Utility/MeshOptimizer.h>
+#include <Graphics/Utility/VertexPacking.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace CYD
 {
+// Eight levels of a meter at the finest reach about 8km away for ~100k vertices
+static constexpr uint32_t CLIPMAP_HALF_CELLS = 64;
+static constexpr uint32_t CLIPMAP_LEVELS     = 8;
+static constexpr float CLIPMAP_SPACING       = 1.0f;
+
 RenderGraph::RenderGraph()
 {
-   m_meshes.reserve( INITIAL_AMOUNT_RESOURCES );
    m_materials.reserve( INITIAL_AMOUNT_RESOURCES );
    m_buffers.reserve( INITIAL_AMOUNT_RESOURCES );
 
@@ -21,6 +34,7 @@ RenderGraph::~RenderGraph()
 {
    // Go through all handles and destroy them
 
+   GRIS::DestroyBuffer( m_materialBuffer );
    GRIS::DestroyBuffer( m_lightBuffer );
    GRIS::DestroyBuffer( m_viewBuffer );
 }
@@ -29,7 +43,9 @@ void RenderGraph::add3DRenderable(
     const glm::mat4& modelMatrix,
     StaticPipelines::Type pipType,
     const std::string_view materialPath,
-    const std::string_view meshPath )
+    const std::string_view meshPath,
+    size_t id,
+    float lodPixelError )
 {
    const uint32_t pipIdx = static_cast<uint32_t>( pipType );
 
@@ -37,6 +53,28 @@ void RenderGraph::add3DRenderable(
    renderable.modelMatrix   = modelMatrix;
    renderable.materialPath  = materialPath;
    renderable.meshPath      = meshPath;
+   renderable.id            = id;
+   renderable.lodPixelError = lodPixelError;
+   renderable.lod           = 0;
+}
+
+void RenderGraph::addDisplacedRenderable(
+    const glm::mat4& modelMatrix,
+    const std::string_view meshPath,
+    TextureHandle displacement,
+    const glm::vec4& cascadeDimensions )
+{
+   const uint32_t pipIdx = static_cast<uint32_t>( StaticPipelines::Type::DISPLACEMENT );
+
+   Renderable3D& renderable     = m_renderables[pipIdx][m_renderableCounts[pipIdx]++];
+   renderable.modelMatrix       = modelMatrix;
+   renderable.materialPath      = {};
+   renderable.meshPath          = meshPath;
+   renderable.id                = INVALID_RENDERABLE_ID;
+   renderable.lodPixelError     = DEFAULT_LOD_PIXEL_ERROR;
+   renderable.lod               = 0;
+   renderable.displacement      = displacement;
+   renderable.cascadeDimensions = cascadeDimensions;
 }
 
 void RenderGraph::addView(
@@ -68,6 +106,11 @@ void RenderGraph::addLight(
    m_light.color     = color;
 }
 
+void RenderGraph::setBindless( bool enabled )
+{
+   m_bindless = enabled && GRIS::SupportsBindless();
+}
+
 void RenderGraph::setViewport( float offsetX, float offsetY, float width, float height )
 {
    m_viewport = Viewport{offsetX, offsetY, width, height};  // ...Default minDepth and maxDepth
@@ -87,6 +130,17 @@ void RenderGraph::reset()
    m_views.clear();
 }
 
+static const VertexLayout& getVertexLayout( StaticPipelines::Type pipType )
+{
+   return static_cast<const GraphicsPipelineInfo*>( StaticPipelines::Get( pipType ) )->vertexLayout;
+}
+
+StaticPipelines::Type RenderGraph::_getBoundPipeline( StaticPipelines::Type pipType ) const
+{
+   return m_bindless && pipType == StaticPipelines::Type::PBR ? StaticPipelines::Type::PBR_BINDLESS
+                                                              : pipType;
+}
+
 bool RenderGraph::compile()
 {
    const CmdListHandle transferList = GRIS::CreateCommandList( TRANSFER );
@@ -98,12 +152,20 @@ bool RenderGraph::compile()
    for( uint32_t pipIdx = 0; pipIdx < (uint32_t)StaticPipelines::Type::COUNT; ++pipIdx )
    {
       const uint32_t renderableCount = m_renderableCounts[pipIdx];
+      if( renderableCount == 0 )
+      {
+         continue;
+      }
+
+      const StaticPipelines::Type boundType =
+          _getBoundPipeline( static_cast<StaticPipelines::Type>( pipIdx ) );
+      const VertexLayout& layout = getVertexLayout( boundType );
 
       for( uint32_t i = 0; i < renderableCount; ++i )
       {
          const Renderable3D& renderable = m_renderables[pipIdx][i];
 
-         neededTransfer |= _loadMesh( transferList, renderable.meshPath );
+         neededTransfer |= _loadMesh( transferList, layout, renderable.meshPath );
          neededTransfer |= _loadMaterial( transferList, pipIdx, renderable.materialPath );
       }
    }
@@ -115,6 +177,13 @@ bool RenderGraph::compile()
 
    GRIS::DestroyCommandList( transferList );
 
+   if( m_bindless && ( m_materialIndices.size() != m_materials.size() || m_materialsStreaming ) )
+   {
+      _updateMaterialBuffer();
+   }
+
+   _selectLods();
+
    return true;
 }
 
@@ -138,6 +207,12 @@ bool RenderGraph::execute() const
    GRIS::CopyToBuffer( m_lightBuffer, &m_light, 0, sizeof( Light ) );
    GRIS::BindUniformBuffer( cmdList, m_lightBuffer, 0, 1 );
 
+   // Material buffer indexing the bindless texture array
+   if( m_bindless && m_materialBuffer )
+   {
+      GRIS::BindBuffer( cmdList, m_materialBuffer, 0, 2 );
+   }
+
    GRIS::StartRecordingCommandList( cmdList );
 
    // Dynamic state
@@ -157,19 +232,81 @@ bool RenderGraph::execute() const
       }
 
       const StaticPipelines::Type pipType = static_cast<StaticPipelines::Type>( pipIdx );
-      GRIS::BindPipeline( cmdList, pipType );
+
+      const StaticPipelines::Type boundType = _getBoundPipeline( pipType );
+      const bool isBindless                 = boundType != pipType;
+
+      // Skipping these renderables for a few frames rather than stalling on the compiler
+      if( !GRIS::IsPipelineReady( cmdList, boundType ) )
+      {
+         continue;
+      }
+
+      GRIS::BindPipeline( cmdList, boundType );
+
+      const auto meshesIt = m_meshes.find( getVertexLayout( boundType ) );
+      if( meshesIt == m_meshes.end() )
+      {
+         continue;
+      }
+
+      const MeshMap& meshes = meshesIt->second;
 
       for( uint32_t i = 0; i < renderableCount; ++i )
       {
          const Renderable3D& renderable = m_renderables[pipIdx][i];
 
-         // Prepare rendering
-         GRIS::UpdateConstantBuffer(
-             cmdList, ShaderStage::VERTEX_STAGE, 0, sizeof( glm::mat4 ), &renderable.modelMatrix );
+         auto meshIt = meshes.find( renderable.meshPath );
+         if( meshIt == meshes.end() )
+         {
+            continue;
+         }
+
+         const Mesh& mesh = meshIt->second;
+
+         const glm::mat4 modelMatrix = renderable.modelMatrix * mesh.dequantization;
+
+         if( isBindless )
+         {
+            // The material is only an index, no descriptor set has to change in between draws
+            BindlessConstants constants = {};
+            constants.modelMatrix       = modelMatrix;
+
+            auto indexIt = m_materialIndices.find( renderable.materialPath );
+            if( indexIt != m_materialIndices.end() )
+            {
+               constants.materialIdx = indexIt->second;
+            }
+
+            GRIS::UpdateConstantBuffer(
+                cmdList, ShaderStage::ALL_GRAPHICS_STAGES, 0, sizeof( constants ), &constants );
+         }
+         else if( pipType == StaticPipelines::Type::DISPLACEMENT )
+         {
+            // Nothing to displace the mesh with until its simulation created the map
+            if( !renderable.displacement )
+            {
+               continue;
+            }
+
+            DisplacementConstants constants = {};
+            constants.modelMatrix           = modelMatrix;
+            constants.cascadeDimensions     = renderable.cascadeDimensions;
+
+            GRIS::UpdateConstantBuffer(
+                cmdList, ShaderStage::VERTEX_STAGE, 0, sizeof( constants ), &constants );
+            GRIS::BindImage( cmdList, renderable.displacement, 1, 0 );
+         }
+         else
+         {
+            // Prepare rendering
+            GRIS::UpdateConstantBuffer(
+                cmdList, ShaderStage::VERTEX_STAGE, 0, sizeof( glm::mat4 ), &modelMatrix );
+         }
 
          // Bind material
          auto materialIt = m_materials.find( renderable.materialPath );
-         if( materialIt != m_materials.end() )
+         if( !isBindless && materialIt != m_materials.end() )
          {
             const Material& material = materialIt->second;
 
@@ -184,23 +321,26 @@ bool RenderGraph::execute() const
          }
 
          // Draw mesh
-         auto meshIt = m_meshes.find( renderable.meshPath );
-         if( meshIt != m_meshes.end() )
-         {
-            const Mesh& mesh = meshIt->second;
-
-            GRIS::BindVertexBuffer( cmdList, mesh.vertexBuffer );
+         GRIS::BindVertexBuffer( cmdList, mesh.vertexBuffer );
 
-            if( mesh.indexBuffer )
+         if( mesh.indexBuffer )
+         {
+            // This renderable has an index buffer, use it to draw
+            if( mesh.indexType == IndexType::UNSIGNED_INT16 )
             {
-               // This renderable has an index buffer, use it to draw
-               GRIS::BindIndexBuffer<uint32_t>( cmdList, mesh.indexBuffer );
-               GRIS::DrawVerticesIndexed( cmdList, mesh.indexCount );
+               GRIS::BindIndexBuffer<uint16_t>( cmdList, mesh.indexBuffer );
             }
             else
             {
-               GRIS::DrawVertices( cmdList, mesh.vertexCount );
+               GRIS::BindIndexBuffer<uint32_t>( cmdList, mesh.indexBuffer );
             }
+
+            const MeshOpt::Lod& lod = mesh.lods[renderable.lod];
+            GRIS::DrawVerticesIndexed( cmdList, lod.indexCount, lod.indexOffset );
+         }
+         else
+         {
+            GRIS::DrawVertices( cmdList, mesh.vertexCount );
          }
       }
    }
@@ -217,36 +357,220 @@ bool RenderGraph::execute() const
    return true;
 }
 
-bool RenderGraph::_loadMesh( CmdListHandle transferList, const std::string_view meshPath )
+void RenderGraph::_selectLods()
+{
+   m_currentLods.clear();
+
+   const auto viewIt = m_views.find( MAIN_VIEW_STRING );
+   if( viewIt == m_views.end() )
+   {
+      return;
+   }
+
+   // Pixels covered by one unit seen from a distance of one
+   const View& view          = viewIt->second;
+   const glm::vec3 viewPos   = glm::vec3( view.position );
+   const float pixelsPerUnit = std::abs( view.projectionMatrix[1][1] * m_viewport.height ) * 0.5f;
+
+   for( uint32_t pipIdx = 0; pipIdx < (uint32_t)StaticPipelines::Type::COUNT; ++pipIdx )
+   {
+      const uint32_t renderableCount = m_renderableCounts[pipIdx];
+      if( renderableCount == 0 )
+      {
+         continue;
+      }
+
+      const StaticPipelines::Type boundType =
+          _getBoundPipeline( static_cast<StaticPipelines::Type>( pipIdx ) );
+
+      const auto meshesIt = m_meshes.find( getVertexLayout( boundType ) );
+      if( meshesIt == m_meshes.end() )
+      {
+         continue;
+      }
+
+      for( uint32_t i = 0; i < renderableCount; ++i )
+      {
+         Renderable3D& renderable = m_renderables[pipIdx][i];
+
+         const auto meshIt = meshesIt->second.find( renderable.meshPath );
+         if( meshIt == meshesIt->second.end() || meshIt->second.lods.size() < 2 )
+         {
+            continue;
+         }
+
+         const Mesh& mesh = meshIt->second;
+
+         // Errors and bounds are scaled by the largest axis of the model matrix
+         const glm::mat4& model = renderable.modelMatrix;
+         const float scale      = std::max(
+             { glm::length( glm::vec3( model[0] ) ),
+               glm::length( glm::vec3( model[1] ) ),
+               glm::length( glm::vec3( model[2] ) ) } );
+
+         const glm::vec3 center = glm::vec3( model * glm::vec4( mesh.boundsCenter, 1.0f ) );
+         const float distance   = std::max(
+             glm::distance( center, viewPos ) - mesh.boundsRadius * scale, MIN_LOD_DISTANCE );
+
+         // Pixels covered by one unit of error at the closest point of the bounds
+         const float pixelsPerError = pixelsPerUnit * scale / distance;
+
+         // Switching to a coarser LOD than the previous one requires some margin
+         uint32_t previousLod = static_cast<uint32_t>( mesh.lods.size() );
+         const auto previousIt = m_previousLods.find( renderable.id );
+         if( previousIt != m_previousLods.end() )
+         {
+            previousLod = previousIt->second;
+         }
+
+         uint32_t lod = 0;
+         for( uint32_t l = static_cast<uint32_t>( mesh.lods.size() ) - 1; l > 0; --l )
+         {
+            const float threshold = l > previousLod ? renderable.lodPixelError * LOD_HYSTERESIS
+                                                    : renderable.lodPixelError;
+
+            if( mesh.lods[l].error * pixelsPerError <= threshold )
+            {
+               lod = l;
+               break;
+            }
+         }
+
+         renderable.lod = lod;
+
+         if( renderable.id != INVALID_RENDERABLE_ID )
+         {
+            m_currentLods[renderable.id] = lod;
+         }
+      }
+   }
+
+   // Renderables that were not drawn this frame are forgotten
+   std::swap( m_previousLods, m_currentLods );
+}
+
+bool RenderGraph::_loadMesh(
+    CmdListHandle transferList,
+    const VertexLayout& layout,
+    const std::string_view meshPath )
 {
    if( meshPath.empty() )
    {
       return false;
    }
 
-   auto it = m_meshes.find( meshPath );
-   if( it == m_meshes.end() )
+   MeshMap& meshes = m_meshes[layout];
+   if( meshes.empty() )
+   {
+      meshes.reserve( INITIAL_AMOUNT_RESOURCES );
+   }
+
+   auto it = meshes.find( meshPath );
+   if( it == meshes.end() )
    {
-      // Mesh was not previously loaded, load it
+      Mesh& mesh = meshes[meshPath];
+
+      // Vertices are uploaded as they are when the pipeline reads the standard layout, otherwise
+      // they are packed in the layout it declares
+      const auto createVertexBuffer = [&]( const Vertex* pVertices, uint32_t vertexCount ) {
+         mesh.vertexCount = vertexCount;
+
+         if( layout == VertexPacking::GetStandardLayout() )
+         {
+            mesh.vertexBuffer = GRIS::CreateVertexBuffer(
+                transferList, vertexCount, static_cast<uint32_t>( sizeof( Vertex ) ), pVertices );
+            return;
+         }
+
+         const VertexPacking::PackedVertices packed =
+             VertexPacking::Pack( layout, pVertices, vertexCount );
+
+         mesh.vertexBuffer = GRIS::CreateVertexBuffer(
+             transferList, vertexCount, packed.stride, packed.data.data() );
+         mesh.dequantization = VertexPacking::GetDequantizationMatrix( packed );
+      };
+
+      // Procedural meshes are generated rather than read from disk
+      if( meshPath == CLIPMAP_MESH_STRING )
+      {
+         std::vector<Vertex> vertices;
+         std::vector<uint32_t> indices;
+         MeshGen::Clipmap( CLIPMAP_HALF_CELLS, CLIPMAP_LEVELS, CLIPMAP_SPACING, vertices, indices );
+
+         createVertexBuffer( vertices.data(), static_cast<uint32_t>( vertices.size() ) );
+
+         mesh.indexCount = static_cast<uint32_t>( indices.size() );
+         mesh.indexBuffer =
+             GRIS::CreateIndexBuffer( transferList, mesh.indexCount, indices.data() );
+
+         // The vertex shader moves it along with the camera, there is nothing to pick a LOD from
+         mesh.lods = {MeshOpt::Lod{0, mesh.indexCount, 0.0f}};
+
+         return true;
+      }
+
+      // Cooked meshes are mapped and their streams copied straight to staging memory
+      MeshPack pack;
+      if( pack.open( GetMeshPackPath( std::string( meshPath ) ) ) )
+      {
+         const MeshPackHeader& header = pack.getHeader();
+         CYDASSERT(
+             header.vertexStride == sizeof( Vertex ) &&
+             "RenderGraph: Mesh packs are expected to store standard vertices" );
+
+         createVertexBuffer( pack.getVertices(), header.vertexCount );
+
+         mesh.indexBuffer = GRIS::CreateIndexBuffer(
+             transferList, header.indexCount, pack.getIndices(), pack.getIndexType() );
+         mesh.indexCount = header.indexCount;
+         mesh.indexType  = pack.getIndexType();
+
+         mesh.lods.assign( header.lods, header.lods + header.lodCount );
+         mesh.boundsCenter = ( header.boundsMin + header.boundsMax ) * 0.5f;
+         mesh.boundsRadius = glm::length( header.boundsMax - header.boundsMin ) * 0.5f;
+
+         return true;
+      }
+
+      // Mesh was not cooked, load it from the source
       std::vector<Vertex> vertices;
       std::vector<uint32_t> indices;
       GraphicsIO::LoadMesh( std::string( meshPath ), vertices, indices );
 
-      Mesh& mesh = m_meshes[meshPath];
+      createVertexBuffer( vertices.data(), static_cast<uint32_t>( vertices.size() ) );
 
-      mesh.vertexBuffer = GRIS::CreateVertexBuffer(
-          transferList,
-          static_cast<uint32_t>( vertices.size() ),
-          static_cast<uint32_t>( sizeof( Vertex ) ),
-          vertices.data() );
+      mesh.lods = MeshOpt::GenerateLods( std::string( meshPath ).c_str(), vertices, indices );
 
-      mesh.vertexCount = static_cast<uint32_t>( vertices.size() );
+      if( !vertices.empty() )
+      {
+         glm::vec3 boundsMin = vertices[0].pos;
+         glm::vec3 boundsMax = vertices[0].pos;
+         for( const Vertex& vertex : vertices )
+         {
+            boundsMin = glm::min( boundsMin, vertex.pos );
+            boundsMax = glm::max( boundsMax, vertex.pos );
+         }
 
-      mesh.indexBuffer = GRIS::CreateIndexBuffer(
-          transferList, static_cast<uint32_t>( indices.size() ), indices.data() );
+         mesh.boundsCenter = ( boundsMin + boundsMax ) * 0.5f;
+         mesh.boundsRadius = glm::length( boundsMax - boundsMin ) * 0.5f;
+      }
 
       mesh.indexCount = static_cast<uint32_t>( indices.size() );
 
+      if( MeshOpt::CanUse16BitIndices( vertices.size() ) )
+      {
+         const std::vector<uint16_t> indices16 = MeshOpt::To16BitIndices( indices );
+
+         mesh.indexBuffer = GRIS::CreateIndexBuffer(
+             transferList, mesh.indexCount, indices16.data(), IndexType::UNSIGNED_INT16 );
+         mesh.indexType = IndexType::UNSIGNED_INT16;
+      }
+      else
+      {
+         mesh.indexBuffer =
+             GRIS::CreateIndexBuffer( transferList, mesh.indexCount, indices.data() );
+      }
+
       return true;
    }
 
@@ -270,6 +594,7 @@ bool RenderGraph::_loadMaterial(
       texDesc.width              = 2048;
       texDesc.height             = 2048;
       texDesc.size               = texDesc.width * texDesc.height * sizeof( uint32_t );
+      texDesc.mipLevels          = TextureDescription::FULL_MIP_CHAIN;
       texDesc.type               = ImageType::TEXTURE_2D;
       texDesc.format             = PixelFormat::RGBA8_SRGB;
       texDesc.usage              = ImageUsage::TRANSFER_DST | ImageUsage::SAMPLED;
@@ -278,21 +603,43 @@ bool RenderGraph::_loadMaterial(
       // TODO More dynamic resource loading. Maybe depending on the pipeline, load only what we need
       const std::string fullPath = "Data/Materials/" + std::string( materialPath ) + "/";
 
-      const std::string albedoPath    = fullPath + "albedo.png";
-      const std::string normalPath    = fullPath + "normal.png";
-      const std::string metalnessPath = fullPath + "metalness.png";
-      const std::string roughnessPath = fullPath + "roughness.png";
-      const std::string aoPath        = fullPath + "ao.png";
-      const std::string heightPath    = fullPath + "height.png";
-
       Material& material = m_materials[materialPath];
 
-      material.albedo    = GRIS::CreateTexture( transferList, texDesc, albedoPath );
-      material.normal    = GRIS::CreateTexture( transferList, texDesc, normalPath );
-      material.height    = GRIS::CreateTexture( transferList, texDesc, heightPath );
-      material.metalness = GRIS::CreateTexture( transferList, texDesc, metalnessPath );
-      material.roughness = GRIS::CreateTexture( transferList, texDesc, roughnessPath );
-      material.ao        = GRIS::CreateTexture( transferList, texDesc, aoPath );
+      const std::pair<std::string, TextureHandle*> textures[] = {
+          {fullPath + "albedo.png", &material.albedo},
+          {fullPath + "normal.png", &material.normal},
+          {fullPath + "height.png", &material.height},
+          {fullPath + "metalness.png", &material.metalness},
+          {fullPath + "roughness.png", &material.roughness},
+          {fullPath + "ao.png", &material.ao}};
+
+      // Cooked textures already have their mips, they do not need to be generated on upload
+      std::vector<std::string> imagePaths;
+      std::vector<TextureHandle*> imageTextures;
+      for( const auto& [path, pTexture] : textures )
+      {
+         TexturePack pack;
+         if( pack.open( GetTexturePackPath( path ) ) )
+         {
+            TextureDescription packDesc = texDesc;
+            pack.fillDescription( packDesc );
+
+            *pTexture = GRIS::CreateTexture(
+                transferList, packDesc, pack.getTexels(), pack.getTexelsSize() );
+            continue;
+         }
+
+         imagePaths.push_back( path );
+         imageTextures.push_back( pTexture );
+      }
+
+      // The remaining images are decoded concurrently
+      const std::vector<TextureHandle> imageHandles =
+          GRIS::CreateTextures( transferList, texDesc, imagePaths );
+      for( uint32_t i = 0; i < imageHandles.size(); ++i )
+      {
+         *imageTextures[i] = imageHandles[i];
+      }
 
       return true;
    }
@@ -300,6 +647,53 @@ bool RenderGraph::_loadMaterial(
    return false;
 }
 
+void RenderGraph::_updateMaterialBuffer()
+{
+   std::vector<MaterialIndices> materials;
+   materials.reserve( m_materials.size() );
+
+   // Maps that are still streaming resolve to their stand-in for now
+   const auto resolve = [this]( TextureHandle texture ) {
+      m_materialsStreaming |= GRIS::IsTextureStreaming( texture );
+      return GRIS::GetBindlessIndex( texture );
+   };
+
+   m_materialsStreaming = false;
+   m_materialIndices.clear();
+   for( const auto& materialPair : m_materials )
+   {
+      const Material& material = materialPair.second;
+
+      MaterialIndices indices = {};
+      indices.albedo          = resolve( material.albedo );
+      indices.normal          = resolve( material.normal );
+      indices.height          = resolve( material.height );
+      indices.metalness       = resolve( material.metalness );
+      indices.roughness       = resolve( material.roughness );
+      indices.ao              = resolve( material.ao );
+
+      m_materialIndices[materialPair.first] = static_cast<uint32_t>( materials.size() );
+      materials.push_back( indices );
+   }
+
+   // Nothing finished streaming since the last time
+   const size_t bufferSize = materials.size() * sizeof( MaterialIndices );
+   if( materials.size() == m_materialTable.size() &&
+       ( materials.empty() ||
+         memcmp( materials.data(), m_materialTable.data(), bufferSize ) == 0 ) )
+   {
+      return;
+   }
+
+   // The buffer is recreated with all of the materials, the last frame could still be reading it
+   GRIS::DestroyBuffer( m_materialBuffer );
+
+   m_materialBuffer = GRIS::CreateBuffer( bufferSize );
+   GRIS::CopyToBuffer( m_materialBuffer, materials.data(), 0, bufferSize );
+
+   m_materialTable = std::move( materials );
+}
+
 // State machine used to transfer in between states and detect state anomalies
 void RenderGraph::_updateState( State desiredState )
 {
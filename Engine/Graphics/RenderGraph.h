@@ -7,10 +7,13 @@
 #include <Graphics/GraphicsTypes.h>
 #include <Graphics/StaticPipelines.h>
 #include <Graphics/Handles/ResourceHandle.h>
+#include <Graphics/Utility/MeshOptimizer.h>
 
 #include <cstdint>
+#include <limits>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace CYD
 {
@@ -23,11 +26,30 @@ class RenderGraph final : public EMP::NodeGraph
 
    void reset() override;
 
+   // Renderables are drawn with the coarsest LOD of their mesh whose error covers less than
+   // lodPixelError pixels on screen. Renderables identified across frames switch LODs with some
+   // hysteresis so that they do not keep popping around a threshold.
+   static constexpr size_t INVALID_RENDERABLE_ID  = std::numeric_limits<size_t>::max();
+   static constexpr float DEFAULT_LOD_PIXEL_ERROR = 1.0f;
+
    void add3DRenderable(
        const glm::mat4& modelMatrix,
        StaticPipelines::Type pipType,
        std::string_view materialPath,
-       std::string_view meshPath );
+       std::string_view meshPath,
+       size_t id           = INVALID_RENDERABLE_ID,
+       float lodPixelError = DEFAULT_LOD_PIXEL_ERROR );
+
+   // Renderables of the DISPLACEMENT pipeline are offset by a displacement map with one layer per
+   // cascade, the horizontal dimension of every cascade being a component of cascadeDimensions
+   void addDisplacedRenderable(
+       const glm::mat4& modelMatrix,
+       std::string_view meshPath,
+       TextureHandle displacement,
+       const glm::vec4& cascadeDimensions );
+
+   // Generated instead of loaded, a clipmap following the camera for displaced surfaces
+   static constexpr std::string_view CLIPMAP_MESH_STRING = "CLIPMAP";
 
    static constexpr std::string_view MAIN_VIEW_STRING = "MAIN";
    void addView(
@@ -38,6 +60,10 @@ class RenderGraph final : public EMP::NodeGraph
 
    void addLight( const glm::vec4& enabled, const glm::vec4& direction, const glm::vec4& color );
 
+   // PBR renderables sample their material through the bindless texture array instead of binding
+   // each map for every draw. Ignored when the backend does not support bindless.
+   void setBindless( bool enabled );
+
    // Dynamic State
    void setViewport( float offsetX, float offsetY, float width, float height );
    void setScissor( int32_t offsetX, int32_t offsetY, uint32_t width, uint32_t height );
@@ -65,10 +91,20 @@ class RenderGraph final : public EMP::NodeGraph
 
    void _updateState( State desiredState );
 
+   // PBR renderables are drawn with the bindless pipeline when it is enabled
+   StaticPipelines::Type _getBoundPipeline( StaticPipelines::Type pipType ) const;
+
    // Load resource functions called during compile time
-   bool _loadMesh( CmdListHandle transferList, std::string_view meshPath );
+   bool _loadMesh(
+       CmdListHandle transferList,
+       const VertexLayout& layout,
+       std::string_view meshPath );
    bool
    _loadMaterial( CmdListHandle transferList, uint32_t pipType, std::string_view materialPath );
+   void _updateMaterialBuffer();
+
+   // Picks the LOD of every renderable from its projected size in the main view
+   void _selectLods();
 
    // Viewport
    // =============================================================================================
@@ -82,6 +118,13 @@ class RenderGraph final : public EMP::NodeGraph
       glm::mat4 modelMatrix = glm::mat4( 1.0f );
       std::string_view meshPath;
       std::string_view materialPath;
+      size_t id           = INVALID_RENDERABLE_ID;
+      float lodPixelError = DEFAULT_LOD_PIXEL_ERROR;
+      uint32_t lod        = 0;  // Selected when compiling
+
+      // DISPLACEMENT pipeline only
+      TextureHandle displacement;
+      glm::vec4 cascadeDimensions = glm::vec4( 0.0f );
    };
    static constexpr uint32_t MAX_NUMBER_RENDERABLES = 512;
 
@@ -126,6 +169,15 @@ class RenderGraph final : public EMP::NodeGraph
       IndexBufferHandle indexBuffer;
       uint32_t vertexCount = 0;
       uint32_t indexCount  = 0;
+      IndexType indexType  = IndexType::UNSIGNED_INT32;
+
+      // Decodes quantized positions, folded into the model matrix
+      glm::mat4 dequantization = glm::mat4( 1.0f );
+
+      // Every LOD is a range of the index buffer, the full-resolution mesh first
+      std::vector<MeshOpt::Lod> lods;
+      glm::vec3 boundsCenter = glm::vec3( 0.0f );
+      float boundsRadius     = 0.0f;
    };
 
    struct Material
@@ -138,8 +190,64 @@ class RenderGraph final : public EMP::NodeGraph
       TextureHandle ao;         // Ambient occlusion map
    };
 
-   std::unordered_map<std::string_view, Mesh> m_meshes;
+   // Meshes are encoded in the vertex layout of the pipelines drawing them
+   using MeshMap = std::unordered_map<std::string_view, Mesh>;
+   std::unordered_map<VertexLayout, MeshMap> m_meshes;
    std::unordered_map<std::string_view, Material> m_materials;
    std::unordered_map<std::string_view, BufferHandle> m_buffers;
+
+   // LODs
+   // =============================================================================================
+   // Coarser LODs are only switched to once their error is this far under the threshold
+   static constexpr float LOD_HYSTERESIS = 0.75f;
+
+   // Renderables closer than this to the view are considered to be this close
+   static constexpr float MIN_LOD_DISTANCE = 0.01f;
+
+   // LOD drawn by each identified renderable in the previous and current frames
+   std::unordered_map<size_t, uint32_t> m_previousLods;
+   std::unordered_map<size_t, uint32_t> m_currentLods;
+
+   // Bindless
+   // =============================================================================================
+   // Materials as indices into the bindless texture array, laid out like the shaders' std430 struct
+   struct MaterialIndices
+   {
+      uint32_t albedo;
+      uint32_t normal;
+      uint32_t height;
+      uint32_t metalness;
+      uint32_t roughness;
+      uint32_t ao;
+      uint32_t pad[2];
+   };
+
+   // Constant buffer of the bindless pipelines, the only thing updated in between draws
+   struct BindlessConstants
+   {
+      glm::mat4 modelMatrix;
+      uint32_t materialIdx;
+      uint32_t pad[3];
+   };
+
+   bool m_bindless = false;
+
+   // Index of each material in the material buffer
+   std::unordered_map<std::string_view, uint32_t> m_materialIndices;
+   BufferHandle m_materialBuffer;
+
+   // Content of the material buffer. While some maps are still streaming and resolved to their
+   // stand-in, the indices are resolved again every compile.
+   std::vector<MaterialIndices> m_materialTable;
+   bool m_materialsStreaming = false;
+
+   // Displacement
+   // =============================================================================================
+   // Constant buffer of the DISPLACEMENT pipeline
+   struct DisplacementConstants
+   {
+      glm::mat4 modelMatrix;
+      glm::vec4 cascadeDimensions;
+   };
 };
 }
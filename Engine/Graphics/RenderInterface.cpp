@@ -17,6 +17,25 @@ static RenderBackend* b = nullptr;
 //
 static void CommonInit() { StaticPipelines::Initialize(); }
 
+static void WarmUpPipelines()
+{
+   // Every static pipeline is compiled in the background for the swapchain, so that the first
+   // frames using them do not have to wait on the compiler
+   for( uint32_t i = 0; i < static_cast<uint32_t>( StaticPipelines::Type::COUNT ); ++i )
+   {
+      const StaticPipelines::Type type = static_cast<StaticPipelines::Type>( i );
+      if( type == StaticPipelines::Type::PBR_BINDLESS && !b->supportsBindless() )
+      {
+         continue;
+      }
+
+      if( StaticPipelines::Get( type ) )
+      {
+         PrecompilePipeline( type, true );
+      }
+   }
+}
+
 template <>
 bool InitRenderBackend<VK>( const Window& window )
 {
@@ -25,6 +44,7 @@ bool InitRenderBackend<VK>( const Window& window )
    b = new VKRenderBackend( window );
 
    CommonInit();
+   WarmUpPipelines();
 
    return true;
 }
@@ -64,6 +84,11 @@ void EndRecordingCommandList( CmdListHandle cmdList ) { b->endRecordingCommandLi
 void SubmitCommandList( CmdListHandle cmdList ) { b->submitCommandList( cmdList ); }
 void ResetCommandList( CmdListHandle cmdList ) { b->resetCommandList( cmdList ); }
 void WaitOnCommandList( CmdListHandle cmdList ) { b->waitOnCommandList( cmdList ); }
+void SyncOnCommandList( CmdListHandle from, CmdListHandle to )
+{
+   b->syncOnCommandList( from, to );
+}
+void SyncOnSwapchain( CmdListHandle from ) { b->syncOnSwapchain( from ); }
 void DestroyCommandList( CmdListHandle cmdList ) { b->destroyCommandList( cmdList ); }
 
 // =================================================================================================
@@ -184,12 +209,29 @@ TextureHandle CreateTexture(
    return b->createTexture( transferList, desc, paths );
 }
 
+std::vector<TextureHandle> CreateTextures(
+    CmdListHandle transferList,
+    const TextureDescription& desc,
+    const std::vector<std::string>& paths )
+{
+   return b->createTextures( transferList, desc, paths );
+}
+
 TextureHandle
 CreateTexture( CmdListHandle transferList, const TextureDescription& desc, const void* pTexels )
 {
    return b->createTexture( transferList, desc, pTexels );
 }
 
+TextureHandle CreateTexture(
+    CmdListHandle transferList,
+    const TextureDescription& desc,
+    const void* pTexels,
+    size_t size )
+{
+   return b->createTexture( transferList, desc, pTexels, size );
+}
+
 VertexBufferHandle CreateVertexBuffer(
     CmdListHandle transferList,
     uint32_t count,
@@ -199,10 +241,13 @@ VertexBufferHandle CreateVertexBuffer(
    return b->createVertexBuffer( transferList, count, stride, pVertices );
 }
 
-IndexBufferHandle
-CreateIndexBuffer( CmdListHandle transferList, uint32_t count, const void* pIndices )
+IndexBufferHandle CreateIndexBuffer(
+    CmdListHandle transferList,
+    uint32_t count,
+    const void* pIndices,
+    IndexType type )
 {
-   return b->createIndexBuffer( transferList, count, pIndices );
+   return b->createIndexBuffer( transferList, count, pIndices, type );
 }
 
 BufferHandle CreateUniformBuffer( size_t size ) { return b->createUniformBuffer( size ); }
@@ -225,6 +270,101 @@ void DestroyIndexBuffer( IndexBufferHandle bufferHandle ) { b->destroyIndexBuffe
 
 void DestroyBuffer( BufferHandle bufferHandle ) { b->destroyBuffer( bufferHandle ); }
 
+// =================================================================================================
+// Pipeline Warm-up
+//
+void PrecompilePipeline( const GraphicsPipelineInfo& pipInfo, bool wantDepth )
+{
+   b->precompilePipeline( pipInfo, wantDepth );
+}
+
+void PrecompilePipeline( const ComputePipelineInfo& pipInfo ) { b->precompilePipeline( pipInfo ); }
+
+void PrecompilePipeline( StaticPipelines::Type pipType, bool wantDepth )
+{
+   const PipelineInfo* pPipInfo = StaticPipelines::Get( pipType );
+
+   if( pPipInfo )
+   {
+      switch( pPipInfo->type )
+      {
+         case PipelineType::GRAPHICS:
+            b->precompilePipeline(
+                *static_cast<const GraphicsPipelineInfo*>( pPipInfo ), wantDepth );
+            break;
+         case PipelineType::COMPUTE:
+            b->precompilePipeline( *static_cast<const ComputePipelineInfo*>( pPipInfo ) );
+            break;
+      }
+   }
+}
+
+bool IsPipelineReady( CmdListHandle cmdList, const GraphicsPipelineInfo& pipInfo )
+{
+   return b->isPipelineReady( cmdList, pipInfo );
+}
+
+bool IsPipelineReady( const ComputePipelineInfo& pipInfo ) { return b->isPipelineReady( pipInfo ); }
+
+bool IsPipelineReady( CmdListHandle cmdList, StaticPipelines::Type pipType )
+{
+   const PipelineInfo* pPipInfo = StaticPipelines::Get( pipType );
+
+   if( pPipInfo )
+   {
+      switch( pPipInfo->type )
+      {
+         case PipelineType::GRAPHICS:
+            return b->isPipelineReady(
+                cmdList, *static_cast<const GraphicsPipelineInfo*>( pPipInfo ) );
+         case PipelineType::COMPUTE:
+            return b->isPipelineReady( *static_cast<const ComputePipelineInfo*>( pPipInfo ) );
+      }
+   }
+
+   CYDASSERT( !"RenderInterface: Could not find static pipeline" );
+   return false;
+}
+
+// =================================================================================================
+// Bindless
+//
+bool SupportsBindless() { return b->supportsBindless(); }
+
+uint32_t GetBindlessIndex( TextureHandle texHandle ) { return b->getBindlessIndex( texHandle ); }
+
+bool IsTextureStreaming( TextureHandle texHandle ) { return b->isTextureStreaming( texHandle ); }
+
+// =================================================================================================
+// Compute
+//
+const ComputeLimits& GetComputeLimits() { return b->getComputeLimits(); }
+
+// =================================================================================================
+// Frame Readback
+//
+void SetFrameReadback( bool enable ) { b->setFrameReadback( enable ); }
+
+bool GetLastFrame( std::vector<uint8_t>& pixels ) { return b->getLastFrame( pixels ); }
+
+// =================================================================================================
+// Texture Readback
+//
+void CopyTextureToBuffer(
+    CmdListHandle cmdList,
+    TextureHandle texHandle,
+    BufferHandle bufferHandle )
+{
+   b->copyTextureToBuffer( cmdList, texHandle, bufferHandle );
+}
+
+bool IsBufferInUse( BufferHandle bufferHandle ) { return b->isBufferInUse( bufferHandle ); }
+
+void ReadFromBuffer( BufferHandle bufferHandle, void* pData, size_t offset, size_t size )
+{
+   b->readFromBuffer( bufferHandle, pData, offset, size );
+}
+
 // =================================================================================================
 // Drawing
 //
@@ -250,9 +390,9 @@ void DrawVertices( CmdListHandle cmdList, uint32_t vertexCount )
    b->drawVertices( cmdList, vertexCount );
 }
 
-void DrawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount )
+void DrawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount, uint32_t firstIndex )
 {
-   b->drawVerticesIndexed( cmdList, indexCount );
+   b->drawVerticesIndexed( cmdList, indexCount, firstIndex );
 }
 
 void Dispatch( CmdListHandle cmdList, uint32_t workX, uint32_t workY, uint32_t workZ )
@@ -36,6 +36,11 @@ void EndRecordingCommandList( CmdListHandle cmdList );
 void SubmitCommandList( CmdListHandle cmdList );
 void ResetCommandList( CmdListHandle cmdList );
 void WaitOnCommandList( CmdListHandle cmdList );
+// GPU-side wait, "to" will only start executing once "from" has completed
+void SyncOnCommandList( CmdListHandle from, CmdListHandle to );
+// GPU-side wait, the next command list rendering to the swapchain will only start executing once
+// "from" has completed. "from" has to be submitted already but can be destroyed right after.
+void SyncOnSwapchain( CmdListHandle from );
 void DestroyCommandList( CmdListHandle cmdList );
 
 // TODO Render pass abstraction
@@ -75,15 +80,29 @@ TextureHandle CreateTexture(
     CmdListHandle transferList,
     const TextureDescription& desc,
     const std::vector<std::string>& paths );
+// One texture per path, all decoded concurrently. Images that could not be found get no handle.
+std::vector<TextureHandle> CreateTextures(
+    CmdListHandle transferList,
+    const TextureDescription& desc,
+    const std::vector<std::string>& paths );
 TextureHandle
 CreateTexture( CmdListHandle transferList, const TextureDescription& desc, const void* pTexels );
+// pTexels either holds the first mip level only, or all of them one after the other
+TextureHandle CreateTexture(
+    CmdListHandle transferList,
+    const TextureDescription& desc,
+    const void* pTexels,
+    size_t size );
 VertexBufferHandle CreateVertexBuffer(
     CmdListHandle transferList,
     uint32_t count,
     uint32_t stride,
     const void* pVertices );
-IndexBufferHandle
-CreateIndexBuffer( CmdListHandle transferList, uint32_t count, const void* pIndices );
+IndexBufferHandle CreateIndexBuffer(
+    CmdListHandle transferList,
+    uint32_t count,
+    const void* pIndices,
+    IndexType type = IndexType::UNSIGNED_INT32 );
 BufferHandle CreateUniformBuffer( size_t size );
 BufferHandle CreateBuffer( size_t size );
 void CopyToBuffer( BufferHandle bufferHandle, const void* pData, size_t offset, size_t size );
@@ -93,6 +112,46 @@ void DestroyVertexBuffer( VertexBufferHandle bufferHandle );
 void DestroyIndexBuffer( IndexBufferHandle bufferHandle );
 void DestroyBuffer( BufferHandle bufferHandle );
 
+// Pipeline Warm-up
+// Pipelines are compiled in the background, binding one that is not ready yet stalls until it is.
+// Graphics pipelines are precompiled for the swapchain render pass.
+void PrecompilePipeline( const GraphicsPipelineInfo& pipInfo, bool wantDepth = false );
+void PrecompilePipeline( const ComputePipelineInfo& pipInfo );
+void PrecompilePipeline( StaticPipelines::Type pipType, bool wantDepth = false );
+bool IsPipelineReady( CmdListHandle cmdList, const GraphicsPipelineInfo& pipInfo );
+bool IsPipelineReady( const ComputePipelineInfo& pipInfo );
+bool IsPipelineReady( CmdListHandle cmdList, StaticPipelines::Type pipType );
+
+// Bindless
+// Every sampled 2D texture gets an index shaders can sample it with, through a resource of type
+// BINDLESS_TEXTURES. The index is ~0 when bindless is not supported by the backend.
+bool SupportsBindless();
+uint32_t GetBindlessIndex( TextureHandle texHandle );
+
+// Textures still being streamed in share the index of their stand-in until they are complete
+bool IsTextureStreaming( TextureHandle texHandle );
+
+// Compute
+// What compute shaders can be specialized for on the device
+const ComputeLimits& GetComputeLimits();
+
+// Frame Readback
+// Headless only, presented frames are copied back to host memory asynchronously. The last frame is
+// the most recent one done copying, a frame or two behind the one being rendered.
+void SetFrameReadback( bool enable );
+bool GetLastFrame( std::vector<uint8_t>& pixels );
+
+// Texture Readback
+// The copy is recorded in the command list, the host can read the buffer once it is not in use
+// anymore. Buffers stop being in use during the cleanup following the completion of the command
+// lists using them, checking never waits on the device.
+void CopyTextureToBuffer(
+    CmdListHandle cmdList,
+    TextureHandle texHandle,
+    BufferHandle bufferHandle );
+bool IsBufferInUse( BufferHandle bufferHandle );
+void ReadFromBuffer( BufferHandle bufferHandle, void* pData, size_t offset, size_t size );
+
 // Drawing
 void PrepareFrame();
 void BeginRenderPassSwapchain( CmdListHandle cmdList, bool wantDepth = false );
@@ -102,7 +161,7 @@ void BeginRenderPassTargets(
     const std::vector<TextureHandle>& textures );
 void EndRenderPass( CmdListHandle cmdList );
 void DrawVertices( CmdListHandle cmdList, uint32_t vertexCount );
-void DrawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount );
+void DrawVerticesIndexed( CmdListHandle cmdList, uint32_t indexCount, uint32_t firstIndex = 0 );
 void Dispatch( CmdListHandle cmdList, uint32_t workX, uint32_t workY, uint32_t workZ );
 void PresentFrame();
 }
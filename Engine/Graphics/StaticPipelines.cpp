@@ -9,6 +9,7 @@
 #include <array>
 #include <fstream>
 #include <memory>
+#include <utility>
 
 namespace CYD::StaticPipelines
 {
@@ -26,6 +27,18 @@ static ShaderResourceType StringToResourceType( const std::string& typeString )
    {
       return ShaderResourceType::COMBINED_IMAGE_SAMPLER;
    }
+   if( typeString == "STORAGE" )
+   {
+      return ShaderResourceType::STORAGE;
+   }
+   if( typeString == "IMAGE" )
+   {
+      return ShaderResourceType::STORAGE_IMAGE;
+   }
+   if( typeString == "BINDLESS_TEXTURES" )
+   {
+      return ShaderResourceType::BINDLESS_TEXTURES;
+   }
 
    CYDASSERT( !"Pipelines: Could not recognize string as a shader resource type" );
    return ShaderResourceType::UNIFORM;
@@ -45,11 +58,64 @@ static ShaderStage::ShaderStage StringToShaderStage( const std::string& stageStr
    {
       return ShaderStage::COMPUTE_STAGE;
    }
+   if( stageString == "ALL_GRAPHICS" )
+   {
+      return ShaderStage::ALL_GRAPHICS_STAGES;
+   }
 
    CYDASSERT( !"Pipelines: Could not recognize string as a shader stage" );
    return ShaderStage::VERTEX_STAGE;
 }
 
+static VertexFormat StringToVertexFormat( const std::string& formatString )
+{
+   static constexpr std::pair<const char*, VertexFormat> FORMATS[] = {
+       {"FLOAT2", VertexFormat::FLOAT2},
+       {"FLOAT3", VertexFormat::FLOAT3},
+       {"FLOAT4", VertexFormat::FLOAT4},
+       {"HALF2", VertexFormat::HALF2},
+       {"HALF4", VertexFormat::HALF4},
+       {"UNORM8x4", VertexFormat::UNORM8x4},
+       {"SNORM8x4", VertexFormat::SNORM8x4},
+       {"UNORM16x2", VertexFormat::UNORM16x2},
+       {"SNORM16x2", VertexFormat::SNORM16x2},
+       {"UNORM16x4", VertexFormat::UNORM16x4},
+       {"SNORM16x4", VertexFormat::SNORM16x4}};
+
+   for( const auto& format : FORMATS )
+   {
+      if( formatString == format.first )
+      {
+         return format.second;
+      }
+   }
+
+   CYDASSERT( !"Pipelines: Could not recognize string as a vertex format" );
+   return VertexFormat::FLOAT3;
+}
+
+static VertexLayout ParseVertexLayout( const nlohmann::json& layoutDescription )
+{
+   // Attributes are interleaved in the order of their location
+   static constexpr std::pair<const char*, VertexSemantic> SEMANTICS[] = {
+       {"POSITION", VertexSemantic::POSITION},
+       {"COLOR", VertexSemantic::COLOR},
+       {"TEXCOORD", VertexSemantic::TEXCOORD},
+       {"NORMAL", VertexSemantic::NORMAL}};
+
+   VertexLayout layout;
+   for( const auto& semantic : SEMANTICS )
+   {
+      const auto& formatIt = layoutDescription.find( semantic.first );
+      if( formatIt != layoutDescription.end() )
+      {
+         layout.add( semantic.second, StringToVertexFormat( formatIt->get<std::string>() ) );
+      }
+   }
+
+   return layout;
+}
+
 bool Initialize()
 {
    // Parse pipeline infos from JSON description
@@ -100,6 +166,13 @@ bool Initialize()
             // TODO
          }
 
+         // Pipelines reading compact vertices declare how they are laid out
+         const auto& layoutIt = pipeline.find( "VERTEX_LAYOUT" );
+         if( layoutIt != pipeline.end() )
+         {
+            pipInfo.vertexLayout = ParseVertexLayout( *layoutIt );
+         }
+
          pipIt = new GraphicsPipelineInfo( pipInfo );
       }
       else if( pipelineType == "COMPUTE" )  // COMPUTE PIPELINE
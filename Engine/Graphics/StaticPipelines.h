@@ -22,6 +22,7 @@ enum class Type : uint8_t
    PHONG_TEX    = 4,
    PBR          = 5,
    SKYBOX       = 6,
+   PBR_BINDLESS = 7,  // Needs bindless support, see GRIS::SupportsBindless
 
    COUNT
 };
@@ -0,0 +1,606 @@
+#include <Graphics/Utility/AssetCooker.h>
+
+#include <Graphics/GraphicsTypes.h>
+#include <Graphics/Utility/AssetPack.h>
+#include <Graphics/Utility/GraphicsIO.h>
+#include <Graphics/Utility/MeshOptimizer.h>
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace CYD
+{
+static const char MESH_DIRECTORY[]     = "Data/Meshes";
+static const char MATERIAL_DIRECTORY[] = "Data/Materials";
+
+// Same format as the material textures loaded by the render graph
+static constexpr PixelFormat MATERIAL_FORMAT = PixelFormat::RGBA8_SRGB;
+
+using Clock = std::chrono::steady_clock;
+
+static double getElapsedMs( Clock::time_point start )
+{
+   return std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+}
+
+static size_t alignUp( size_t value, size_t alignment )
+{
+   return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+static bool writeFile( const std::string& path, const std::vector<char>& data )
+{
+   // Writing to a temporary file first, an interrupted cook leaves the previous pack intact
+   const std::string tempPath = path + ".tmp";
+   {
+      std::ofstream file( tempPath, std::ios::binary | std::ios::trunc );
+      if( !file.is_open() )
+      {
+         return false;
+      }
+
+      file.write( data.data(), data.size() );
+      if( !file )
+      {
+         return false;
+      }
+   }
+
+   std::error_code error;
+   std::filesystem::rename( tempPath, path, error );
+   return !error;
+}
+
+// =================================================================================================
+// Textures
+
+static uint32_t getMaxMipLevels( uint32_t width, uint32_t height )
+{
+   uint32_t levels = 1;
+   for( uint32_t size = std::max( width, height ); size > 1; size /= 2 )
+   {
+      levels++;
+   }
+   return levels;
+}
+
+static bool isSupportedFormat( PixelFormat format )
+{
+   return format == PixelFormat::RGBA8_SRGB || format == PixelFormat::BGRA8_UNORM ||
+          format == PixelFormat::RGBA32F;
+}
+
+static size_t getTexelSize( PixelFormat format )
+{
+   return format == PixelFormat::RGBA32F ? sizeof( float ) * 4 : sizeof( uint32_t );
+}
+
+static bool describeImage( const std::string& path, PixelFormat format, TextureDescription& desc )
+{
+   int width, height, channels;
+   if( !stbi_info( path.c_str(), &width, &height, &channels ) )
+   {
+      return false;
+   }
+
+   desc.width  = static_cast<uint32_t>( width );
+   desc.height = static_cast<uint32_t>( height );
+   desc.size   = desc.width * desc.height * getTexelSize( format );
+   desc.format = format;
+   return true;
+}
+
+static float srgbToLinear( float value )
+{
+   return value <= 0.04045f ? value / 12.92f : std::pow( ( value + 0.055f ) / 1.055f, 2.4f );
+}
+
+static float linearToSrgb( float value )
+{
+   return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow( value, 1.0f / 2.4f ) - 0.055f;
+}
+
+static float toLinear( uint8_t value, bool srgb )
+{
+   // Decoding sRGB for every texel read is the bulk of the work, there are only 256 values
+   static const auto srgbTable = [] {
+      std::vector<float> table( 256 );
+      for( uint32_t i = 0; i < 256; ++i )
+      {
+         table[i] = srgbToLinear( i / 255.0f );
+      }
+      return table;
+   }();
+
+   return srgb ? srgbTable[value] : value / 255.0f;
+}
+
+static float toLinear( float value, bool /*srgb*/ ) { return value; }
+
+static void fromLinear( float value, bool srgb, uint8_t& out )
+{
+   const float encoded = srgb ? linearToSrgb( value ) : value;
+   out = static_cast<uint8_t>( std::clamp( encoded * 255.0f + 0.5f, 0.0f, 255.0f ) );
+}
+
+static void fromLinear( float value, bool /*srgb*/, float& out ) { out = value; }
+
+// Averages 2x2 blocks of RGBA texels, the last row or column is repeated for odd sizes. The color
+// channels of sRGB textures are averaged in linear space.
+template <typename T>
+static void downsample( const T* pSrc, uint32_t srcWidth, uint32_t srcHeight, T* pDst, bool srgb )
+{
+   const uint32_t dstWidth  = std::max( srcWidth / 2, 1u );
+   const uint32_t dstHeight = std::max( srcHeight / 2, 1u );
+
+   for( uint32_t y = 0; y < dstHeight; ++y )
+   {
+      const uint32_t y0 = std::min( y * 2, srcHeight - 1 );
+      const uint32_t y1 = std::min( y * 2 + 1, srcHeight - 1 );
+
+      for( uint32_t x = 0; x < dstWidth; ++x )
+      {
+         const uint32_t x0 = std::min( x * 2, srcWidth - 1 );
+         const uint32_t x1 = std::min( x * 2 + 1, srcWidth - 1 );
+
+         const T* texels[] = {
+             &pSrc[( y0 * srcWidth + x0 ) * 4],
+             &pSrc[( y0 * srcWidth + x1 ) * 4],
+             &pSrc[( y1 * srcWidth + x0 ) * 4],
+             &pSrc[( y1 * srcWidth + x1 ) * 4] };
+
+         for( uint32_t c = 0; c < 4; ++c )
+         {
+            // Alpha is always linear
+            const bool isSrgb = srgb && c != 3;
+
+            float sum = 0.0f;
+            for( const T* texel : texels )
+            {
+               sum += toLinear( texel[c], isSrgb );
+            }
+
+            fromLinear( sum / 4.0f, isSrgb, pDst[( y * dstWidth + x ) * 4 + c] );
+         }
+      }
+   }
+}
+
+bool AssetCooker::CookTexture( const std::string& path, PixelFormat format )
+{
+   if( !isSupportedFormat( format ) )
+   {
+      printf( "AssetCooker: Unsupported format for %s\n", path.c_str() );
+      return false;
+   }
+
+   TextureDescription desc = {};
+   if( !describeImage( path, format, desc ) )
+   {
+      printf( "AssetCooker: Could not read %s\n", path.c_str() );
+      return false;
+   }
+
+   void* imageData = GraphicsIO::LoadImage( desc, path );
+   if( !imageData )
+   {
+      printf( "AssetCooker: Could not decode %s\n", path.c_str() );
+      return false;
+   }
+
+   const size_t texelSize   = getTexelSize( format );
+   const uint32_t mipLevels = getMaxMipLevels( desc.width, desc.height );
+
+   size_t dataSize = 0;
+   for( uint32_t level = 0; level < mipLevels; ++level )
+   {
+      dataSize += std::max( desc.width >> level, 1u ) * std::max( desc.height >> level, 1u ) *
+                  texelSize;
+   }
+
+   TexturePackHeader header = {};
+   header.magic             = TEXTURE_PACK_MAGIC;
+   header.version           = ASSET_PACK_VERSION;
+   header.width             = desc.width;
+   header.height            = desc.height;
+   header.layers            = 1;
+   header.mipLevels         = mipLevels;
+   header.format            = static_cast<uint32_t>( format );
+   header.baseSize          = desc.size;
+   header.dataSize          = dataSize;
+   header.dataOffset        = alignUp( sizeof( TexturePackHeader ), ASSET_PACK_ALIGNMENT );
+
+   std::vector<char> pack( static_cast<size_t>( header.dataOffset + dataSize ) );
+   memcpy( pack.data(), &header, sizeof( header ) );
+
+   char* pLevel = pack.data() + header.dataOffset;
+   memcpy( pLevel, imageData, desc.size );
+   GraphicsIO::FreeImage( imageData );
+
+   // Every level is generated from the previous one
+   uint32_t width  = desc.width;
+   uint32_t height = desc.height;
+   for( uint32_t level = 1; level < mipLevels; ++level )
+   {
+      char* pNextLevel = pLevel + width * height * texelSize;
+      if( format == PixelFormat::RGBA32F )
+      {
+         downsample(
+             reinterpret_cast<const float*>( pLevel ),
+             width,
+             height,
+             reinterpret_cast<float*>( pNextLevel ),
+             false );
+      }
+      else
+      {
+         downsample(
+             reinterpret_cast<const uint8_t*>( pLevel ),
+             width,
+             height,
+             reinterpret_cast<uint8_t*>( pNextLevel ),
+             format == PixelFormat::RGBA8_SRGB );
+      }
+
+      pLevel = pNextLevel;
+      width  = std::max( width / 2, 1u );
+      height = std::max( height / 2, 1u );
+   }
+
+   const std::string packPath = GetTexturePackPath( path );
+   if( !writeFile( packPath, pack ) )
+   {
+      printf( "AssetCooker: Could not write %s\n", packPath.c_str() );
+      return false;
+   }
+
+   printf(
+       "AssetCooker: %s, %ux%u with %u levels, %zu bytes\n",
+       packPath.c_str(),
+       desc.width,
+       desc.height,
+       mipLevels,
+       pack.size() );
+
+   return true;
+}
+
+// =================================================================================================
+// Meshes
+
+bool AssetCooker::CookMesh( const std::string& name )
+{
+   // Vertices come out of the loader already deduplicated and optimized
+   std::vector<Vertex> vertices;
+   std::vector<uint32_t> indices;
+   GraphicsIO::LoadMesh( name, vertices, indices );
+
+   if( vertices.empty() )
+   {
+      printf( "AssetCooker: %s has no vertices\n", name.c_str() );
+      return false;
+   }
+
+   const std::vector<MeshOpt::Lod> lods = MeshOpt::GenerateLods( name.c_str(), vertices, indices );
+
+   std::vector<uint16_t> indices16;
+   const void* pIndices = indices.data();
+   size_t indexSize     = sizeof( uint32_t );
+   if( MeshOpt::CanUse16BitIndices( vertices.size() ) )
+   {
+      indices16 = MeshOpt::To16BitIndices( indices );
+      pIndices  = indices16.data();
+      indexSize = sizeof( uint16_t );
+   }
+
+   const size_t verticesSize = vertices.size() * sizeof( Vertex );
+   const size_t indicesSize  = indices.size() * indexSize;
+
+   MeshPackHeader header = {};
+   header.magic          = MESH_PACK_MAGIC;
+   header.version        = ASSET_PACK_VERSION;
+   header.vertexCount    = static_cast<uint32_t>( vertices.size() );
+   header.vertexStride   = static_cast<uint32_t>( sizeof( Vertex ) );
+   header.indexCount     = static_cast<uint32_t>( indices.size() );
+   header.indexSize      = static_cast<uint32_t>( indexSize );
+   header.boundsMin      = vertices[0].pos;
+   header.boundsMax      = vertices[0].pos;
+   header.vertexOffset   = alignUp( sizeof( MeshPackHeader ), ASSET_PACK_ALIGNMENT );
+   header.indexOffset    = alignUp( header.vertexOffset + verticesSize, ASSET_PACK_ALIGNMENT );
+   header.lodCount       = static_cast<uint32_t>( lods.size() );
+   std::copy( lods.begin(), lods.end(), header.lods );
+
+   for( const Vertex& vertex : vertices )
+   {
+      header.boundsMin = glm::min( header.boundsMin, vertex.pos );
+      header.boundsMax = glm::max( header.boundsMax, vertex.pos );
+   }
+
+   std::vector<char> pack( static_cast<size_t>( header.indexOffset + indicesSize ) );
+   memcpy( pack.data(), &header, sizeof( header ) );
+   memcpy( pack.data() + header.vertexOffset, vertices.data(), verticesSize );
+   memcpy( pack.data() + header.indexOffset, pIndices, indicesSize );
+
+   const std::string packPath = GetMeshPackPath( name );
+   if( !writeFile( packPath, pack ) )
+   {
+      printf( "AssetCooker: Could not write %s\n", packPath.c_str() );
+      return false;
+   }
+
+   printf(
+       "AssetCooker: %s, %u vertices, %u indices in %u LODs, %zu bytes\n",
+       packPath.c_str(),
+       header.vertexCount,
+       header.indexCount,
+       header.lodCount,
+       pack.size() );
+
+   return true;
+}
+
+// =================================================================================================
+// Cooking
+
+uint32_t AssetCooker::CookAll()
+{
+   const auto cookStart = Clock::now();
+
+   uint32_t packCount = 0;
+
+   // Missing directories are skipped, the iterators are then empty
+   std::error_code error;
+   for( const auto& entry : std::filesystem::directory_iterator( MESH_DIRECTORY, error ) )
+   {
+      if( entry.path().extension() == ".obj" && CookMesh( entry.path().stem().string() ) )
+      {
+         packCount++;
+      }
+   }
+
+   for( const auto& entry :
+        std::filesystem::recursive_directory_iterator( MATERIAL_DIRECTORY, error ) )
+   {
+      if( entry.path().extension() == ".png" &&
+          CookTexture( entry.path().generic_string(), MATERIAL_FORMAT ) )
+      {
+         packCount++;
+      }
+   }
+
+   printf( "AssetCooker: Cooked %u packs in %.2f ms\n", packCount, getElapsedMs( cookStart ) );
+
+   return packCount;
+}
+
+// =================================================================================================
+// Benchmark
+
+struct LoadTimings
+{
+   uint32_t assetCount = 0;
+   double rawMs        = 0.0;
+   double cookedMs     = 0.0;
+};
+
+static void printTimings( const char* assetType, const LoadTimings& timings, uint32_t iterations )
+{
+   if( timings.assetCount == 0 )
+   {
+      printf( "AssetCooker: No cooked %s to benchmark\n", assetType );
+      return;
+   }
+
+   printf(
+       "AssetCooker: %u %s, raw %.2f ms, cooked %.2f ms, %.1fx faster\n",
+       timings.assetCount,
+       assetType,
+       timings.rawMs / iterations,
+       timings.cookedMs / iterations,
+       timings.rawMs / std::max( timings.cookedMs, 1e-6 ) );
+}
+
+void AssetCooker::Benchmark( uint32_t iterations )
+{
+   iterations = std::max( iterations, 1u );
+
+   // Stands in for the staging ring, every load ends with its data copied to it
+   std::vector<char> staging;
+   const auto copyToStaging = [&staging]( const void* pData, size_t size ) {
+      staging.resize( std::max( staging.size(), size ) );
+      memcpy( staging.data(), pData, size );
+   };
+
+   LoadTimings meshTimings;
+   std::error_code error;
+   for( const auto& entry : std::filesystem::directory_iterator( MESH_DIRECTORY, error ) )
+   {
+      const std::string name = entry.path().stem().string();
+      if( entry.path().extension() != ".obj" ||
+          !std::filesystem::exists( GetMeshPackPath( name ) ) )
+      {
+         continue;
+      }
+
+      for( uint32_t i = 0; i < iterations; ++i )
+      {
+         auto start = Clock::now();
+         {
+            std::vector<Vertex> vertices;
+            std::vector<uint32_t> indices;
+            GraphicsIO::LoadMesh( name, vertices, indices );
+
+            copyToStaging( vertices.data(), vertices.size() * sizeof( Vertex ) );
+            copyToStaging( indices.data(), indices.size() * sizeof( uint32_t ) );
+         }
+         meshTimings.rawMs += getElapsedMs( start );
+
+         start = Clock::now();
+         {
+            MeshPack pack;
+            if( pack.open( GetMeshPackPath( name ) ) )
+            {
+               const MeshPackHeader& header = pack.getHeader();
+               copyToStaging( pack.getVertices(), header.vertexCount * sizeof( Vertex ) );
+               copyToStaging( pack.getIndices(), header.indexCount * header.indexSize );
+            }
+         }
+         meshTimings.cookedMs += getElapsedMs( start );
+      }
+
+      meshTimings.assetCount++;
+   }
+
+   LoadTimings textureTimings;
+   for( const auto& entry :
+        std::filesystem::recursive_directory_iterator( MATERIAL_DIRECTORY, error ) )
+   {
+      const std::string path = entry.path().generic_string();
+      if( entry.path().extension() != ".png" ||
+          !std::filesystem::exists( GetTexturePackPath( path ) ) )
+      {
+         continue;
+      }
+
+      for( uint32_t i = 0; i < iterations; ++i )
+      {
+         // Raw loads only have their first level, the others would still be generated on the GPU
+         auto start = Clock::now();
+         {
+            TextureDescription desc = {};
+            if( describeImage( path, MATERIAL_FORMAT, desc ) )
+            {
+               void* imageData = GraphicsIO::LoadImage( desc, path );
+               if( imageData )
+               {
+                  copyToStaging( imageData, desc.size );
+                  GraphicsIO::FreeImage( imageData );
+               }
+            }
+         }
+         textureTimings.rawMs += getElapsedMs( start );
+
+         start = Clock::now();
+         {
+            TexturePack pack;
+            if( pack.open( GetTexturePackPath( path ) ) )
+            {
+               copyToStaging( pack.getTexels(), pack.getTexelsSize() );
+            }
+         }
+         textureTimings.cookedMs += getElapsedMs( start );
+      }
+
+      textureTimings.assetCount++;
+   }
+
+   printf( "AssetCooker: Load times averaged over %u iterations\n", iterations );
+   printTimings( "meshes", meshTimings, iterations );
+   printTimings( "textures", textureTimings, iterations );
+}
+
+// Written before the import benchmark and deleted after it
+static const char IMPORT_BENCHMARK_MESH[] = "ImportBenchmark";
+
+// 2 * 707 * 707 triangles, just above a million
+static constexpr uint32_t IMPORT_BENCHMARK_GRID_SIZE = 708;
+
+static bool writeBenchmarkObj( const std::string& path )
+{
+   FILE* file = fopen( path.c_str(), "w" );
+   if( !file )
+   {
+      return false;
+   }
+
+   // A bumpy grid, every vertex has its own position, texture coordinates and normal
+   const uint32_t size = IMPORT_BENCHMARK_GRID_SIZE;
+   for( uint32_t y = 0; y < size; ++y )
+   {
+      for( uint32_t x = 0; x < size; ++x )
+      {
+         const float u = static_cast<float>( x ) / ( size - 1 );
+         const float v = static_cast<float>( y ) / ( size - 1 );
+         const float h = 0.05f * std::sin( u * 40.0f ) * std::cos( v * 40.0f );
+
+         const glm::vec3 normal =
+             glm::normalize( glm::vec3( -2.0f * std::cos( u * 40.0f ), 1.0f, 0.0f ) );
+
+         fprintf( file, "v %f %f %f\n", u, h, v );
+         fprintf( file, "vt %f %f\n", u, v );
+         fprintf( file, "vn %f %f %f\n", normal.x, normal.y, normal.z );
+      }
+   }
+
+   for( uint32_t y = 0; y < size - 1; ++y )
+   {
+      for( uint32_t x = 0; x < size - 1; ++x )
+      {
+         // OBJ indices start at 1
+         const uint32_t a = y * size + x + 1;
+         const uint32_t b = a + 1;
+         const uint32_t c = a + size;
+         const uint32_t d = c + 1;
+         fprintf( file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, c, c, c, b, b, b );
+         fprintf( file, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", b, b, b, c, c, c, d, d, d );
+      }
+   }
+
+   return fclose( file ) == 0;
+}
+
+void AssetCooker::BenchmarkImport( uint32_t iterations )
+{
+   iterations = std::max( iterations, 1u );
+
+   const std::string benchmarkPath =
+       std::string( MESH_DIRECTORY ) + "/" + IMPORT_BENCHMARK_MESH + ".obj";
+   if( !writeBenchmarkObj( benchmarkPath ) )
+   {
+      printf( "AssetCooker: Could not write %s\n", benchmarkPath.c_str() );
+   }
+
+   std::error_code error;
+   for( const auto& entry : std::filesystem::directory_iterator( MESH_DIRECTORY, error ) )
+   {
+      if( entry.path().extension() != ".obj" )
+      {
+         continue;
+      }
+
+      const std::string name = entry.path().stem().string();
+
+      size_t triangleCount = 0;
+      double totalMs       = 0.0;
+      for( uint32_t i = 0; i < iterations; ++i )
+      {
+         std::vector<Vertex> vertices;
+         std::vector<uint32_t> indices;
+
+         const auto start = Clock::now();
+         GraphicsIO::LoadMesh( name, vertices, indices );
+         totalMs += getElapsedMs( start );
+
+         triangleCount = indices.size() / 3;
+      }
+
+      const double averageMs = totalMs / iterations;
+      printf(
+          "AssetCooker: %s, %zu triangles imported in %.2f ms, %.2f million triangles/s\n",
+          name.c_str(),
+          triangleCount,
+          averageMs,
+          triangleCount / ( std::max( averageMs, 1e-6 ) * 1000.0 ) );
+   }
+
+   std::filesystem::remove( benchmarkPath, error );
+}
+}
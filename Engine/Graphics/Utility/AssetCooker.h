@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace CYD
+{
+enum class PixelFormat;
+
+/*
+ * Offline conversion of source assets to the binary packs in AssetPack.h. Meshes are deduplicated
+ * and their bounds computed once, textures are decoded and their whole mip chain is generated on
+ * the CPU so that none of this work is left for load time.
+ */
+namespace AssetCooker
+{
+// Cooks every mesh in Data/Meshes and every material texture in Data/Materials, returns the number
+// of packs written
+uint32_t CookAll();
+
+// Data/Meshes/<name>.obj to Data/Meshes/<name>.cmesh
+bool CookMesh( const std::string& name );
+
+// <path>.png to <path>.ctex, only 8-bit RGBA and RGBA32F formats are supported
+bool CookTexture( const std::string& path, PixelFormat format );
+
+// Times loading every cooked asset against loading the asset it was cooked from, up to the point
+// where its data is in memory ready to be copied to staging
+void Benchmark( uint32_t iterations );
+
+// Times importing every OBJ in Data/Meshes, along with a generated one with a million triangles,
+// and reports the number of triangles imported per second
+void BenchmarkImport( uint32_t iterations );
+}
+}
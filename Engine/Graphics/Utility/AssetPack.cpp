@@ -0,0 +1,121 @@
+#include <Graphics/Utility/AssetPack.h>
+
+#include <cstdio>
+
+namespace CYD
+{
+static const char MESH_PATH[]              = "Data/Meshes/";
+static const char MESH_PACK_EXTENSION[]    = ".cmesh";
+static const char TEXTURE_PACK_EXTENSION[] = ".ctex";
+
+std::string GetMeshPackPath( const std::string& meshName )
+{
+   return MESH_PATH + meshName + MESH_PACK_EXTENSION;
+}
+
+std::string GetTexturePackPath( const std::string& imagePath )
+{
+   const size_t extensionPos = imagePath.find_last_of( '.' );
+   return imagePath.substr( 0, extensionPos ) + TEXTURE_PACK_EXTENSION;
+}
+
+// =================================================================================================
+// Mesh Pack
+
+bool MeshPack::open( const std::string& path )
+{
+   if( !m_file.open( path ) )
+   {
+      return false;
+   }
+
+   // Only the header is checked, touching the streams would read the whole file
+   const MeshPackHeader* pHeader = static_cast<const MeshPackHeader*>( m_file.getData() );
+   if( m_file.getSize() < sizeof( MeshPackHeader ) || pHeader->magic != MESH_PACK_MAGIC ||
+       pHeader->version != ASSET_PACK_VERSION || pHeader->vertexStride != sizeof( Vertex ) ||
+       ( pHeader->indexSize != sizeof( uint16_t ) && pHeader->indexSize != sizeof( uint32_t ) ) ||
+       pHeader->lodCount == 0 || pHeader->lodCount > MeshOpt::MAX_LOD_COUNT )
+   {
+      printf(
+          "MeshPack: %s was cooked by another version and needs to be recooked\n", path.c_str() );
+      m_file.close();
+      return false;
+   }
+
+   const uint64_t verticesEnd = pHeader->vertexOffset + pHeader->vertexCount * sizeof( Vertex );
+   const uint64_t indicesEnd  = pHeader->indexOffset + pHeader->indexCount * pHeader->indexSize;
+   if( verticesEnd > m_file.getSize() || indicesEnd > m_file.getSize() )
+   {
+      printf( "MeshPack: %s is truncated\n", path.c_str() );
+      m_file.close();
+      return false;
+   }
+
+   m_pHeader = pHeader;
+   return true;
+}
+
+const Vertex* MeshPack::getVertices() const
+{
+   const char* pData = static_cast<const char*>( m_file.getData() );
+   return reinterpret_cast<const Vertex*>( pData + m_pHeader->vertexOffset );
+}
+
+const void* MeshPack::getIndices() const
+{
+   return static_cast<const char*>( m_file.getData() ) + m_pHeader->indexOffset;
+}
+
+IndexType MeshPack::getIndexType() const
+{
+   return m_pHeader->indexSize == sizeof( uint16_t ) ? IndexType::UNSIGNED_INT16
+                                                     : IndexType::UNSIGNED_INT32;
+}
+
+// =================================================================================================
+// Texture Pack
+
+bool TexturePack::open( const std::string& path )
+{
+   if( !m_file.open( path ) )
+   {
+      return false;
+   }
+
+   const TexturePackHeader* pHeader = static_cast<const TexturePackHeader*>( m_file.getData() );
+   if( m_file.getSize() < sizeof( TexturePackHeader ) || pHeader->magic != TEXTURE_PACK_MAGIC ||
+       pHeader->version != ASSET_PACK_VERSION )
+   {
+      printf(
+          "TexturePack: %s was cooked by another version and needs to be recooked\n",
+          path.c_str() );
+      m_file.close();
+      return false;
+   }
+
+   if( pHeader->dataOffset + pHeader->dataSize > m_file.getSize() )
+   {
+      printf( "TexturePack: %s is truncated\n", path.c_str() );
+      m_file.close();
+      return false;
+   }
+
+   m_pHeader = pHeader;
+   return true;
+}
+
+void TexturePack::fillDescription( TextureDescription& desc ) const
+{
+   desc.size      = static_cast<size_t>( m_pHeader->baseSize );
+   desc.width     = m_pHeader->width;
+   desc.height    = m_pHeader->height;
+   desc.layers    = m_pHeader->layers;
+   desc.mipLevels = m_pHeader->mipLevels;
+   desc.format    = static_cast<PixelFormat>( m_pHeader->format );
+}
+
+const void* TexturePack::getTexels() const
+{
+   return static_cast<const char*>( m_file.getData() ) + m_pHeader->dataOffset;
+}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <Graphics/GraphicsTypes.h>
+#include <Graphics/Utility/MappedFile.h>
+#include <Graphics/Utility/MeshOptimizer.h>
+
+#include <cstdint>
+#include <string>
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * Binary packs produced by the asset cooker. They are laid out exactly like the data the GPU
+ * expects so that loading one is only a matter of mapping the file and copying its streams to
+ * staging memory, without any parsing or decoding.
+ */
+namespace CYD
+{
+static constexpr uint32_t MESH_PACK_MAGIC      = 0x504D5943;  // "CYMP"
+static constexpr uint32_t TEXTURE_PACK_MAGIC   = 0x50545943;  // "CYTP"
+static constexpr uint32_t ASSET_PACK_VERSION   = 4;
+static constexpr uint32_t ASSET_PACK_ALIGNMENT = 16;
+
+// Followed by the vertices then the indices, both starting on an aligned offset. The indices of all
+// the levels of detail follow each other, the full-resolution ones first.
+struct MeshPackHeader
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t vertexCount;
+   uint32_t vertexStride;  // Size of a vertex when the mesh was cooked
+   uint32_t indexCount;
+   uint32_t indexSize;  // 16-bit indices are used when the vertex count allows it
+   glm::vec3 boundsMin;
+   glm::vec3 boundsMax;
+   uint64_t vertexOffset;
+   uint64_t indexOffset;
+   uint32_t lodCount;
+   uint32_t reserved;
+   MeshOpt::Lod lods[MeshOpt::MAX_LOD_COUNT];
+};
+
+// Followed by every mip level of the texture starting with the first, layers tightly packed
+struct TexturePackHeader
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t width;
+   uint32_t height;
+   uint32_t layers;
+   uint32_t mipLevels;
+   uint32_t format;
+   uint32_t reserved;
+
+   // Size of the first mip level and of all of them, all layers included
+   uint64_t baseSize;
+   uint64_t dataSize;
+   uint64_t dataOffset;
+};
+
+// Cooked files sit right next to the asset they were cooked from
+std::string GetMeshPackPath( const std::string& meshName );
+std::string GetTexturePackPath( const std::string& imagePath );
+
+class MeshPack final
+{
+  public:
+   MeshPack() = default;
+   NON_COPIABLE( MeshPack );
+   ~MeshPack() = default;
+
+   // Returns false if the pack does not exist, or was cooked by an incompatible version
+   bool open( const std::string& path );
+
+   const MeshPackHeader& getHeader() const { return *m_pHeader; }
+   const Vertex* getVertices() const;
+   const void* getIndices() const;
+   IndexType getIndexType() const;
+
+  private:
+   MappedFile m_file;
+   const MeshPackHeader* m_pHeader = nullptr;
+};
+
+class TexturePack final
+{
+  public:
+   TexturePack() = default;
+   NON_COPIABLE( TexturePack );
+   ~TexturePack() = default;
+
+   // Returns false if the pack does not exist, or was cooked by an incompatible version
+   bool open( const std::string& path );
+
+   const TexturePackHeader& getHeader() const { return *m_pHeader; }
+
+   // Overrides the dimensions and format of the description with the ones of the pack
+   void fillDescription( TextureDescription& desc ) const;
+
+   const void* getTexels() const;
+   size_t getTexelsSize() const { return static_cast<size_t>( m_pHeader->dataSize ); }
+
+  private:
+   MappedFile m_file;
+   const TexturePackHeader* m_pHeader = nullptr;
+};
+}
@@ -3,6 +3,7 @@
 #include <Common/Assert.h>
 
 #include <Graphics/GraphicsTypes.h>
+#include <Graphics/Utility/MeshOptimizer.h>
 
 #define TINYOBJLOADER_IMPLEMENTATION
 #include <tinyobjloader/tiny_obj_loader.h>
@@ -10,12 +11,93 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
-#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+#include <thread>
 
 namespace CYD
 {
 static const char MESH_PATH[] = "Data/Meshes/";
 
+// Under this many corners, the import is faster on a single thread
+static constexpr size_t PARALLEL_CORNER_THRESHOLD = 1 << 16;
+
+static constexpr uint32_t INVALID_CORNER = ~0u;
+
+static_assert(
+    sizeof( Vertex ) == 13 * sizeof( float ),
+    "GraphicsIO: Vertices are hashed and compared as packed floats" );
+
+// Equal vertices are bitwise identical, hashing their bits avoids going through every float
+static uint64_t hashVertex( const Vertex& vertex )
+{
+   uint32_t words[sizeof( Vertex ) / sizeof( uint32_t )];
+   memcpy( words, &vertex, sizeof( Vertex ) );
+
+   uint64_t hash = 0x9E3779B97F4A7C15ULL;
+   for( const uint32_t word : words )
+   {
+      hash = ( hash ^ word ) * 0xBF58476D1CE4E5B9ULL;
+      hash ^= hash >> 31;
+   }
+   return hash;
+}
+
+static bool isSameVertex( const Vertex& a, const Vertex& b )
+{
+   return memcmp( &a, &b, sizeof( Vertex ) ) == 0;
+}
+
+static Vertex makeVertex( const tinyobj::attrib_t& attrib, const tinyobj::index_t& index )
+{
+   Vertex vertex = {};
+
+   vertex.pos = {
+       attrib.vertices[3 * index.vertex_index + 0],
+       attrib.vertices[3 * index.vertex_index + 1],
+       attrib.vertices[3 * index.vertex_index + 2] };
+
+   // Normals and texture coordinates are optional in OBJs
+   if( index.normal_index >= 0 )
+   {
+      vertex.normal = {
+          attrib.normals[3 * index.normal_index + 0],
+          attrib.normals[3 * index.normal_index + 1],
+          attrib.normals[3 * index.normal_index + 2] };
+   }
+
+   if( index.texcoord_index >= 0 )
+   {
+      vertex.uv = {
+          attrib.texcoords[2 * index.texcoord_index + 0],
+          1.0f - attrib.texcoords[2 * index.texcoord_index + 1],
+          0.0f };
+   }
+
+   vertex.col = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+   return vertex;
+}
+
+// Runs func( threadIdx ) on threadCount threads, the calling thread being the first one
+template <typename Func>
+static void runParallel( uint32_t threadCount, const Func& func )
+{
+   std::vector<std::thread> threads;
+   threads.reserve( threadCount - 1 );
+   for( uint32_t i = 1; i < threadCount; ++i )
+   {
+      threads.emplace_back( func, i );
+   }
+
+   func( 0 );
+
+   for( std::thread& thread : threads )
+   {
+      thread.join();
+   }
+}
+
 void GraphicsIO::LoadMesh(
     const std::string& path,
     std::vector<Vertex>& vertices,
@@ -30,43 +112,123 @@ void GraphicsIO::LoadMesh(
        &attrib, &shapes, &materials, &warn, &err, ( MESH_PATH + path + ".obj" ).c_str() );
    CYDASSERT( res && "Model loading failed" );
 
-   vertices.reserve( shapes[0].mesh.num_face_vertices.size() );
-   indices.reserve( shapes[0].mesh.indices.size() );
+   // All the shapes end up in the same mesh, their corners are processed as a single list
+   std::vector<tinyobj::index_t> allCorners;
+   const std::vector<tinyobj::index_t>* pCorners = &shapes[0].mesh.indices;
+   if( shapes.size() > 1 )
+   {
+      size_t totalCorners = 0;
+      for( const auto& shape : shapes )
+      {
+         totalCorners += shape.mesh.indices.size();
+      }
+
+      allCorners.reserve( totalCorners );
+      for( const auto& shape : shapes )
+      {
+         const auto& shapeCorners = shape.mesh.indices;
+         allCorners.insert( allCorners.end(), shapeCorners.begin(), shapeCorners.end() );
+      }
+      pCorners = &allCorners;
+   }
 
-   std::unordered_map<Vertex, uint32_t> uniqueVertices = {};
+   const std::vector<tinyobj::index_t>& corners = *pCorners;
+   const size_t cornerCount                     = corners.size();
 
-   for( const auto& shape : shapes )
-   {
-      for( const auto& index : shape.mesh.indices )
+   const uint32_t threadCount = cornerCount < PARALLEL_CORNER_THRESHOLD
+                                    ? 1
+                                    : std::max( std::thread::hardware_concurrency(), 1u );
+
+   // Building and hashing every corner. Each thread takes a contiguous range of corners and sorts
+   // them into one bucket per thread depending on their hash, buckets of a thread are then
+   // deduplicated independently of the others.
+   std::vector<Vertex> cornerVertices( cornerCount );
+   std::vector<uint64_t> cornerHashes( cornerCount );
+   std::vector<std::vector<uint32_t>> buckets( threadCount * threadCount );
+
+   const size_t rangeSize = ( cornerCount + threadCount - 1 ) / threadCount;
+
+   runParallel( threadCount, [&]( uint32_t threadIdx ) {
+      const size_t rangeStart = std::min( threadIdx * rangeSize, cornerCount );
+      const size_t rangeEnd   = std::min( rangeStart + rangeSize, cornerCount );
+
+      for( size_t i = rangeStart; i < rangeEnd; ++i )
       {
-         Vertex vertex = {};
+         cornerVertices[i] = makeVertex( attrib, corners[i] );
+         cornerHashes[i]   = hashVertex( cornerVertices[i] );
 
-         vertex.pos = {
-             attrib.vertices[3 * index.vertex_index + 0],
-             attrib.vertices[3 * index.vertex_index + 1],
-             attrib.vertices[3 * index.vertex_index + 2] };
+         const uint32_t bucket = static_cast<uint32_t>( ( cornerHashes[i] >> 32 ) % threadCount );
+         buckets[threadIdx * threadCount + bucket].push_back( static_cast<uint32_t>( i ) );
+      }
+   } );
+
+   // Finding the first corner of every vertex with a flat open-addressing table. Going through the
+   // ranges in order keeps the corners of a bucket in order, so the first one inserted wins.
+   std::vector<uint32_t> firstCorners( cornerCount );
 
-         vertex.normal = {
-             attrib.normals[3 * index.normal_index + 0],
-             attrib.normals[3 * index.normal_index + 1],
-             attrib.normals[3 * index.normal_index + 2] };
+   runParallel( threadCount, [&]( uint32_t bucket ) {
+      size_t bucketSize = 0;
+      for( uint32_t range = 0; range < threadCount; ++range )
+      {
+         bucketSize += buckets[range * threadCount + bucket].size();
+      }
 
-         vertex.uv = {
-             attrib.texcoords[2 * index.texcoord_index + 0],
-             1.0f - attrib.texcoords[2 * index.texcoord_index + 1],
-             0.0f };
+      // At most half full so that probe sequences stay short
+      size_t capacity = 16;
+      while( capacity < bucketSize * 2 )
+      {
+         capacity *= 2;
+      }
 
-         vertex.col = { 1.0f, 1.0f, 1.0f, 1.0f };
+      const size_t mask = capacity - 1;
+      std::vector<uint32_t> table( capacity, INVALID_CORNER );
 
-         if( uniqueVertices.count( vertex ) == 0 )
+      for( uint32_t range = 0; range < threadCount; ++range )
+      {
+         for( const uint32_t corner : buckets[range * threadCount + bucket] )
          {
-            uniqueVertices[vertex] = static_cast<uint32_t>( vertices.size() );
-            vertices.push_back( vertex );
+            const uint64_t hash = cornerHashes[corner];
+
+            size_t slot = static_cast<size_t>( hash ) & mask;
+            while( table[slot] != INVALID_CORNER )
+            {
+               const uint32_t other = table[slot];
+               if( cornerHashes[other] == hash &&
+                   isSameVertex( cornerVertices[other], cornerVertices[corner] ) )
+               {
+                  break;
+               }
+               slot = ( slot + 1 ) & mask;
+            }
+
+            if( table[slot] == INVALID_CORNER )
+            {
+               table[slot] = corner;
+            }
+
+            firstCorners[corner] = table[slot];
          }
+      }
+   } );
 
-         indices.push_back( uniqueVertices[vertex] );
+   // Vertices are numbered in the order they first appear in
+   vertices.clear();
+   indices.resize( cornerCount );
+   for( size_t i = 0; i < cornerCount; ++i )
+   {
+      const uint32_t firstCorner = firstCorners[i];
+      if( firstCorner == i )
+      {
+         indices[i] = static_cast<uint32_t>( vertices.size() );
+         vertices.push_back( cornerVertices[i] );
+      }
+      else
+      {
+         indices[i] = indices[firstCorner];
       }
    }
+
+   MeshOpt::Optimize( path.c_str(), vertices, indices );
 }
 
 void* GraphicsIO::LoadImage( const TextureDescription& desc, const std::string& path )
@@ -103,4 +265,64 @@ void* GraphicsIO::LoadImage( const TextureDescription& desc, const std::string&
 }
 
 void GraphicsIO::FreeImage( void* imageData ) { stbi_image_free( imageData ); }
+
+bool GraphicsIO::CheckImage( const TextureDescription& desc, const std::string& path )
+{
+   int width, height, channels;
+   if( !stbi_info( path.c_str(), &width, &height, &channels ) )
+   {
+      return false;
+   }
+
+   if( static_cast<uint32_t>( width ) != desc.width ||
+       static_cast<uint32_t>( height ) != desc.height )
+   {
+      CYDASSERT( !"GraphicsIO: Mismatch with texture description and actual image" );
+      return false;
+   }
+
+   return true;
+}
+
+bool GraphicsIO::LoadImages(
+    const TextureDescription& desc,
+    const std::vector<std::string>& paths,
+    const std::vector<void*>& destinations )
+{
+   CYDASSERT(
+       paths.size() == destinations.size() && "GraphicsIO: Every image needs a destination" );
+
+   const uint32_t imageCount = static_cast<uint32_t>( paths.size() );
+   if( imageCount == 0 )
+   {
+      return true;
+   }
+
+   const size_t imageSize = desc.size / desc.layers;
+
+   // Decoding is the expensive part, every image gets its own thread when there are enough cores
+   const uint32_t threadCount = std::clamp( std::thread::hardware_concurrency(), 1u, imageCount );
+
+   std::vector<uint8_t> decoded( imageCount, 0 );
+
+   runParallel( threadCount, [&]( uint32_t threadIdx ) {
+      for( uint32_t i = threadIdx; i < imageCount; i += threadCount )
+      {
+         // stb always decodes to memory it allocates, the image is copied to its destination from
+         // the thread that decoded it
+         void* imageData = LoadImage( desc, paths[i] );
+         if( !imageData )
+         {
+            memset( destinations[i], 0, imageSize );
+            continue;
+         }
+
+         memcpy( destinations[i], imageData, imageSize );
+         FreeImage( imageData );
+         decoded[i] = 1;
+      }
+   } );
+
+   return std::all_of( decoded.begin(), decoded.end(), []( uint8_t d ) { return d != 0; } );
+}
 }
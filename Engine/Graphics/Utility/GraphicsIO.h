@@ -18,5 +18,15 @@ void LoadMesh(
 
 void* LoadImage( const TextureDescription& desc, const std::string& path );
 void FreeImage( void* imageData );
+
+// Only reads the header of the image, to know whether it exists and matches the description
+bool CheckImage( const TextureDescription& desc, const std::string& path );
+
+// Decodes the images concurrently, each one being written to its destination. Destinations of
+// images that could not be decoded are zeroed, returns false if there were any.
+bool LoadImages(
+    const TextureDescription& desc,
+    const std::vector<std::string>& paths,
+    const std::vector<void*>& destinations );
 }
 }
\ No newline at end of file
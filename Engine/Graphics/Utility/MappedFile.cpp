@@ -0,0 +1,114 @@
+#include <Graphics/Utility/MappedFile.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace CYD
+{
+bool MappedFile::open( const std::string& path )
+{
+   close();
+
+#ifdef _WIN32
+   m_fileHandle = CreateFileA(
+       path.c_str(),
+       GENERIC_READ,
+       FILE_SHARE_READ,
+       nullptr,
+       OPEN_EXISTING,
+       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+       nullptr );
+   if( m_fileHandle == INVALID_HANDLE_VALUE )
+   {
+      m_fileHandle = nullptr;
+      return false;
+   }
+
+   LARGE_INTEGER fileSize = {};
+   if( !GetFileSizeEx( m_fileHandle, &fileSize ) || fileSize.QuadPart == 0 )
+   {
+      close();
+      return false;
+   }
+
+   m_mappingHandle = CreateFileMappingA( m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr );
+   if( !m_mappingHandle )
+   {
+      close();
+      return false;
+   }
+
+   m_pData = MapViewOfFile( m_mappingHandle, FILE_MAP_READ, 0, 0, 0 );
+   if( !m_pData )
+   {
+      close();
+      return false;
+   }
+
+   m_size = static_cast<size_t>( fileSize.QuadPart );
+#else
+   const int fd = ::open( path.c_str(), O_RDONLY );
+   if( fd < 0 )
+   {
+      return false;
+   }
+
+   struct stat fileStat = {};
+   if( fstat( fd, &fileStat ) != 0 || fileStat.st_size == 0 )
+   {
+      ::close( fd );
+      return false;
+   }
+
+   // The mapping keeps the file alive, the descriptor is not needed past this point
+   void* pData = mmap( nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+   ::close( fd );
+   if( pData == MAP_FAILED )
+   {
+      return false;
+   }
+
+   m_pData = pData;
+   m_size  = static_cast<size_t>( fileStat.st_size );
+#endif
+
+   return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+   if( m_pData )
+   {
+      UnmapViewOfFile( m_pData );
+   }
+   if( m_mappingHandle )
+   {
+      CloseHandle( m_mappingHandle );
+   }
+   if( m_fileHandle )
+   {
+      CloseHandle( m_fileHandle );
+   }
+
+   m_mappingHandle = nullptr;
+   m_fileHandle    = nullptr;
+#else
+   if( m_pData )
+   {
+      munmap( const_cast<void*>( m_pData ), m_size );
+   }
+#endif
+
+   m_pData = nullptr;
+   m_size  = 0;
+}
+
+MappedFile::~MappedFile() { close(); }
+}
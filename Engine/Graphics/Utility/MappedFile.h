@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <cstddef>
+#include <string>
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * Read-only view of a whole file mapped in memory. Pages are only read from disk when they are
+ * first touched, and are shared with the file cache so opening the same file twice is cheap.
+ */
+namespace CYD
+{
+class MappedFile final
+{
+  public:
+   MappedFile() = default;
+   NON_COPIABLE( MappedFile );
+   ~MappedFile();
+
+   // Returns false if the file does not exist or could not be mapped
+   bool open( const std::string& path );
+   void close();
+
+   bool isOpen() const noexcept { return m_pData != nullptr; }
+
+   const void* getData() const noexcept { return m_pData; }
+   size_t getSize() const noexcept { return m_size; }
+
+  private:
+   const void* m_pData = nullptr;
+   size_t m_size       = 0;
+
+#ifdef _WIN32
+   void* m_fileHandle    = nullptr;
+   void* m_mappingHandle = nullptr;
+#endif
+};
+}
@@ -1,6 +1,11 @@
 #include <Graphics/Utility/MeshGeneration.h>
 
 #include <Graphics/GraphicsTypes.h>
+#include <Graphics/Utility/MeshOptimizer.h>
+
+#include <Common/Assert.h>
+
+#include <cstdlib>
 
 namespace CYD::MeshGen
 {
@@ -41,5 +46,92 @@ void Grid(
          indices.push_back( c + ( r * columns + 1 ) );
       }
    }
+
+   // Only the triangles are reordered, displacement shaders find the vertices of the grid from
+   // their index. The grid is flat so there is no overdraw to optimize either.
+   MeshOpt::OptimizeVertexCache( indices, vertices.size() );
+}
+
+void Clipmap(
+    uint32_t halfCells,
+    uint32_t levels,
+    float spacing,
+    std::vector<Vertex>& vertices,
+    std::vector<uint32_t>& indices )
+{
+   CYDASSERT(
+       halfCells > 0 && halfCells % 2 == 0 &&
+       "MeshGen: The hole of a clipmap ring has to fall on its vertices" );
+
+   const uint32_t side     = 2 * halfCells + 1;  // Vertices per side of a level
+   const int32_t holeCells = static_cast<int32_t>( halfCells / 2 );
+
+   // Following the camera by two of the finest cells keeps the first two levels on their lattice
+   const float snapStep = 2.0f * spacing;
+
+   std::vector<uint32_t> levelIndices( side * side );
+
+   for( uint32_t level = 0; level < levels; ++level )
+   {
+      const float levelSpacing = spacing * static_cast<float>( 1u << level );
+      const float halfExtent   = levelSpacing * halfCells;
+
+      // Rings skip what the previous level covers, the hole spanning [-holeCells, holeCells] cells
+      // on both axes. Vertices on its edges are shared positions with the previous level.
+      const auto isVertexInHole = [level, holeCells]( int32_t x, int32_t z ) {
+         return level > 0 && std::abs( x ) < holeCells && std::abs( z ) < holeCells;
+      };
+      const auto isCellInHole = [level, holeCells]( int32_t x, int32_t z ) {
+         return level > 0 && x >= -holeCells && x < holeCells && z >= -holeCells && z < holeCells;
+      };
+
+      // Vertices
+      for( uint32_t r = 0; r < side; ++r )
+      {
+         for( uint32_t c = 0; c < side; ++c )
+         {
+            const int32_t x = static_cast<int32_t>( c ) - static_cast<int32_t>( halfCells );
+            const int32_t z = static_cast<int32_t>( r ) - static_cast<int32_t>( halfCells );
+
+            if( isVertexInHole( x, z ) )
+            {
+               continue;
+            }
+
+            Vertex vertex = {};
+            vertex.pos    = glm::vec3( x * levelSpacing, 0.0f, z * levelSpacing );
+            vertex.col    = glm::vec4( 1.0f, 1.0f, 1.0f, 1.0f );
+            vertex.uv     = glm::vec3( levelSpacing, halfExtent, snapStep );
+            vertex.normal = glm::vec3( 0.0, 1.0f, 0.0f );
+
+            levelIndices[( r * side ) + c] = static_cast<uint32_t>( vertices.size() );
+            vertices.push_back( vertex );
+         }
+      }
+
+      // Indices in quads, with the same winding as the grid
+      for( uint32_t r = 0; r < ( side - 1 ); ++r )
+      {
+         for( uint32_t c = 0; c < ( side - 1 ); ++c )
+         {
+            const int32_t x = static_cast<int32_t>( c ) - static_cast<int32_t>( halfCells );
+            const int32_t z = static_cast<int32_t>( r ) - static_cast<int32_t>( halfCells );
+            if( isCellInHole( x, z ) )
+            {
+               continue;
+            }
+
+            indices.push_back( levelIndices[c + ( r * side )] );
+            indices.push_back( levelIndices[c + ( ( r + 1 ) * side )] );
+            indices.push_back( levelIndices[c + ( ( r + 1 ) * side ) + 1] );
+
+            indices.push_back( levelIndices[c + ( r * side )] );
+            indices.push_back( levelIndices[c + ( ( r + 1 ) * side ) + 1] );
+            indices.push_back( levelIndices[c + ( r * side + 1 )] );
+         }
+      }
+   }
+
+   MeshOpt::OptimizeVertexCache( indices, vertices.size() );
 }
 }
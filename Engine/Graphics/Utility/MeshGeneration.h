@@ -11,11 +11,26 @@ namespace MeshGen
 {
 // Returns a vector of vertices for a grid mesh centered at the origin (0, 0, 0). The actual length
 // of the grid is always 1. Changing the width and the height only changes the resolution/detail of
-// the grid. The primitive used for rendering should be triangle strips
+// the grid. The primitive used for rendering should be triangle lists, they are ordered for the
+// vertex cache
 void Grid(
     uint32_t row,
     uint32_t columns,
     std::vector<Vertex>& vertices,
     std::vector<uint32_t>& indices );
+
+// Returns the vertices of a camera-centred clipmap, nested square rings whose spacing doubles from
+// one level to the next so that the vertex count grows with the number of levels and not with the
+// area covered. The first level is a full grid of 2 * halfCells cells per side, every following
+// level is a ring of as many cells around the previous one. The texture coordinates hold the
+// spacing and outer half extent of the level of the vertex and the step the whole mesh follows the
+// camera by, for the vertex shader to geomorph between levels. The primitive used for rendering
+// should be triangle lists.
+void Clipmap(
+    uint32_t halfCells,
+    uint32_t levels,
+    float spacing,
+    std::vector<Vertex>& vertices,
+    std::vector<uint32_t>& indices );
 }
 }
@@ -0,0 +1,737 @@
+#include <Graphics/Utility/MeshOptimizer.h>
+
+#include <Common/Assert.h>
+
+#include <Graphics/GraphicsTypes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+
+namespace CYD::MeshOpt
+{
+static constexpr uint32_t INVALID_INDEX = ~0u;
+
+CacheStatistics AnalyzeVertexCache( const std::vector<uint32_t>& indices, size_t vertexCount )
+{
+   CacheStatistics stats = {};
+   if( indices.empty() || vertexCount == 0 )
+   {
+      return stats;
+   }
+
+   // A vertex is in the FIFO cache if it was pushed less than VERTEX_CACHE_SIZE misses ago
+   std::vector<uint32_t> timestamps( vertexCount, 0 );
+   uint32_t misses = 0;
+   for( const uint32_t index : indices )
+   {
+      if( timestamps[index] == 0 || misses - timestamps[index] + 1 > VERTEX_CACHE_SIZE )
+      {
+         misses++;
+         timestamps[index] = misses;
+      }
+   }
+
+   stats.acmr = static_cast<float>( misses ) / ( indices.size() / 3 );
+   stats.atvr = static_cast<float>( misses ) / vertexCount;
+   return stats;
+}
+
+// =================================================================================================
+// Vertex Cache
+
+namespace
+{
+// Triangles adjacent to every vertex, stored contiguously
+struct Adjacency
+{
+   std::vector<uint32_t> offsets;
+   std::vector<uint32_t> triangles;
+   std::vector<uint32_t> liveCounts;
+};
+}
+
+static void buildAdjacency(
+    const std::vector<uint32_t>& indices,
+    size_t vertexCount,
+    Adjacency& adjacency )
+{
+   adjacency.liveCounts.assign( vertexCount, 0 );
+   for( const uint32_t index : indices )
+   {
+      adjacency.liveCounts[index]++;
+   }
+
+   adjacency.offsets.resize( vertexCount + 1 );
+   adjacency.offsets[0] = 0;
+   for( size_t v = 0; v < vertexCount; ++v )
+   {
+      adjacency.offsets[v + 1] = adjacency.offsets[v] + adjacency.liveCounts[v];
+   }
+
+   std::vector<uint32_t> cursors( adjacency.offsets.begin(), adjacency.offsets.end() - 1 );
+   adjacency.triangles.resize( indices.size() );
+   for( size_t i = 0; i < indices.size(); ++i )
+   {
+      adjacency.triangles[cursors[indices[i]]++] = static_cast<uint32_t>( i / 3 );
+   }
+}
+
+void OptimizeVertexCache(
+    std::vector<uint32_t>& indices,
+    size_t vertexCount,
+    std::vector<uint32_t>* pClusters )
+{
+   CYDASSERT( indices.size() % 3 == 0 && "MeshOpt: Only triangle lists can be optimized" );
+
+   const size_t triangleCount = indices.size() / 3;
+   if( triangleCount == 0 )
+   {
+      return;
+   }
+
+   Adjacency adjacency;
+   buildAdjacency( indices, vertexCount, adjacency );
+
+   std::vector<uint32_t> output;
+   output.reserve( indices.size() );
+
+   std::vector<bool> emitted( triangleCount, false );
+   std::vector<uint32_t> cacheTimes( vertexCount, 0 );
+   std::vector<uint32_t> deadEnds;
+   std::vector<uint32_t> candidates;
+
+   // Tipsify, fans around a vertex then moves on to the candidate that stays in cache the longest
+   uint32_t time       = VERTEX_CACHE_SIZE + 1;
+   uint32_t scanCursor = 0;
+   uint32_t fanning    = 0;
+
+   if( pClusters )
+   {
+      pClusters->clear();
+      pClusters->push_back( 0 );
+   }
+
+   for( ;; )
+   {
+      candidates.clear();
+
+      for( uint32_t a = adjacency.offsets[fanning]; a < adjacency.offsets[fanning + 1]; ++a )
+      {
+         const uint32_t triangle = adjacency.triangles[a];
+         if( emitted[triangle] )
+         {
+            continue;
+         }
+
+         for( uint32_t corner = 0; corner < 3; ++corner )
+         {
+            const uint32_t v = indices[triangle * 3 + corner];
+            output.push_back( v );
+            deadEnds.push_back( v );
+            candidates.push_back( v );
+            adjacency.liveCounts[v]--;
+
+            if( time - cacheTimes[v] > VERTEX_CACHE_SIZE )
+            {
+               cacheTimes[v] = time++;
+            }
+         }
+
+         emitted[triangle] = true;
+      }
+
+      // Picking the candidate that will still be in cache once all of its triangles are emitted
+      uint32_t next     = INVALID_INDEX;
+      int32_t bestScore = -1;
+      for( const uint32_t v : candidates )
+      {
+         if( adjacency.liveCounts[v] == 0 )
+         {
+            continue;
+         }
+
+         int32_t score = 0;
+         if( time - cacheTimes[v] + 2 * adjacency.liveCounts[v] <= VERTEX_CACHE_SIZE )
+         {
+            score = static_cast<int32_t>( time - cacheTimes[v] );
+         }
+
+         if( score > bestScore )
+         {
+            bestScore = score;
+            next      = v;
+         }
+      }
+
+      if( next == INVALID_INDEX )
+      {
+         // Dead end, going back to a recently used vertex or to the next one with triangles left
+         while( !deadEnds.empty() && next == INVALID_INDEX )
+         {
+            const uint32_t v = deadEnds.back();
+            deadEnds.pop_back();
+            if( adjacency.liveCounts[v] > 0 )
+            {
+               next = v;
+            }
+         }
+
+         while( next == INVALID_INDEX && scanCursor < vertexCount )
+         {
+            if( adjacency.liveCounts[scanCursor] > 0 )
+            {
+               next = scanCursor;
+            }
+            scanCursor++;
+         }
+
+         if( next == INVALID_INDEX )
+         {
+            break;
+         }
+
+         // The cache is mostly cold past a dead end, which is where clusters are split
+         const uint32_t emittedCount = static_cast<uint32_t>( output.size() / 3 );
+         if( pClusters && pClusters->back() != emittedCount )
+         {
+            pClusters->push_back( emittedCount );
+         }
+      }
+
+      fanning = next;
+   }
+
+   indices = std::move( output );
+}
+
+// =================================================================================================
+// Overdraw
+
+namespace
+{
+struct Cluster
+{
+   uint32_t start;
+   uint32_t end;
+   glm::vec3 centroid;
+   glm::vec3 normal;
+   float occlusion;
+};
+}
+
+void OptimizeOverdraw(
+    std::vector<uint32_t>& indices,
+    const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& clusterStarts )
+{
+   const uint32_t triangleCount = static_cast<uint32_t>( indices.size() / 3 );
+   if( clusterStarts.size() < 2 )
+   {
+      return;
+   }
+
+   std::vector<Cluster> clusters( clusterStarts.size() );
+
+   // Area weighted centroids and normals of the clusters, and centroid of the whole mesh
+   glm::vec3 meshCentroid( 0.0f );
+   float meshArea = 0.0f;
+   for( size_t c = 0; c < clusters.size(); ++c )
+   {
+      Cluster& cluster = clusters[c];
+      cluster.start    = clusterStarts[c];
+      cluster.end      = c + 1 < clusters.size() ? clusterStarts[c + 1] : triangleCount;
+      cluster.centroid = glm::vec3( 0.0f );
+      cluster.normal   = glm::vec3( 0.0f );
+
+      float clusterArea = 0.0f;
+      for( uint32_t t = cluster.start; t < cluster.end; ++t )
+      {
+         const glm::vec3& p0 = vertices[indices[t * 3 + 0]].pos;
+         const glm::vec3& p1 = vertices[indices[t * 3 + 1]].pos;
+         const glm::vec3& p2 = vertices[indices[t * 3 + 2]].pos;
+
+         // The length of the cross product is twice the area, the factor cancels out
+         const glm::vec3 normal = glm::cross( p1 - p0, p2 - p0 );
+         const float area       = glm::length( normal );
+
+         cluster.centroid += ( p0 + p1 + p2 ) * ( area / 3.0f );
+         cluster.normal += normal;
+         clusterArea += area;
+      }
+
+      meshCentroid += cluster.centroid;
+      meshArea += clusterArea;
+
+      if( clusterArea > 0.0f )
+      {
+         cluster.centroid /= clusterArea;
+      }
+   }
+
+   if( meshArea > 0.0f )
+   {
+      meshCentroid /= meshArea;
+   }
+
+   // Clusters far from the center and facing away from it are likely to occlude the others
+   for( Cluster& cluster : clusters )
+   {
+      const float normalLength = glm::length( cluster.normal );
+      cluster.occlusion =
+          normalLength > 0.0f
+              ? glm::dot( cluster.centroid - meshCentroid, cluster.normal / normalLength )
+              : 0.0f;
+   }
+
+   std::stable_sort(
+       clusters.begin(), clusters.end(), []( const Cluster& a, const Cluster& b ) {
+          return a.occlusion > b.occlusion;
+       } );
+
+   std::vector<uint32_t> output;
+   output.reserve( indices.size() );
+   for( const Cluster& cluster : clusters )
+   {
+      output.insert(
+          output.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3 );
+   }
+
+   indices = std::move( output );
+}
+
+// =================================================================================================
+// Vertex Fetch
+
+void OptimizeVertexFetch( std::vector<Vertex>& vertices, std::vector<uint32_t>& indices )
+{
+   std::vector<uint32_t> remap( vertices.size(), INVALID_INDEX );
+
+   std::vector<Vertex> output;
+   output.reserve( vertices.size() );
+
+   for( uint32_t& index : indices )
+   {
+      if( remap[index] == INVALID_INDEX )
+      {
+         remap[index] = static_cast<uint32_t>( output.size() );
+         output.push_back( vertices[index] );
+      }
+
+      index = remap[index];
+   }
+
+   vertices = std::move( output );
+}
+
+// =================================================================================================
+// Simplification
+
+namespace
+{
+// Sum of the squared distances to a set of planes weighted by their area, as a symmetric 4x4 matrix
+struct Quadric
+{
+   void addPlane( const glm::dvec3& n, double d, double w )
+   {
+      a00 += w * n.x * n.x;
+      a01 += w * n.x * n.y;
+      a02 += w * n.x * n.z;
+      a03 += w * n.x * d;
+      a11 += w * n.y * n.y;
+      a12 += w * n.y * n.z;
+      a13 += w * n.y * d;
+      a22 += w * n.z * n.z;
+      a23 += w * n.z * d;
+      a33 += w * d * d;
+      weight += w;
+   }
+
+   void add( const Quadric& other )
+   {
+      a00 += other.a00;
+      a01 += other.a01;
+      a02 += other.a02;
+      a03 += other.a03;
+      a11 += other.a11;
+      a12 += other.a12;
+      a13 += other.a13;
+      a22 += other.a22;
+      a23 += other.a23;
+      a33 += other.a33;
+      weight += other.weight;
+   }
+
+   // Mean squared distance of the point to the planes
+   double evaluate( const glm::vec3& p ) const
+   {
+      const double x = p.x;
+      const double y = p.y;
+      const double z = p.z;
+
+      const double error = a00 * x * x + a11 * y * y + a22 * z * z + a33 +
+                           2.0 * ( a01 * x * y + a02 * x * z + a12 * y * z ) +
+                           2.0 * ( a03 * x + a13 * y + a23 * z );
+
+      return weight > 0.0 ? std::max( error, 0.0 ) / weight : 0.0;
+   }
+
+   double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+   double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+   double a22 = 0.0, a23 = 0.0;
+   double a33    = 0.0;
+   double weight = 0.0;
+};
+
+struct Collapse
+{
+   uint32_t from;
+   uint32_t to;
+   double cost;
+};
+}
+
+// Whether moving a vertex onto another one would flip or squash the triangles around it
+static bool collapseFlips(
+    const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& indices,
+    const uint32_t* pTriangles,
+    uint32_t triangleCount,
+    uint32_t from,
+    uint32_t to )
+{
+   for( uint32_t i = 0; i < triangleCount; ++i )
+   {
+      const uint32_t* pTriangle = &indices[pTriangles[i] * 3];
+      if( pTriangle[0] == to || pTriangle[1] == to || pTriangle[2] == to )
+      {
+         // Removed by the collapse
+         continue;
+      }
+
+      glm::vec3 before[3];
+      glm::vec3 after[3];
+      for( uint32_t k = 0; k < 3; ++k )
+      {
+         before[k] = vertices[pTriangle[k]].pos;
+         after[k]  = pTriangle[k] == from ? vertices[to].pos : before[k];
+      }
+
+      const glm::vec3 normalBefore = glm::cross( before[1] - before[0], before[2] - before[0] );
+      const glm::vec3 normalAfter  = glm::cross( after[1] - after[0], after[2] - after[0] );
+
+      // Rejecting normals that rotate by more than about 75 degrees
+      if( glm::dot( normalBefore, normalAfter ) <=
+          0.25f * glm::length( normalBefore ) * glm::length( normalAfter ) )
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+float Simplify(
+    const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& indices,
+    size_t targetIndexCount,
+    std::vector<uint32_t>& result )
+{
+   result = indices;
+
+   const uint32_t vertexCount = static_cast<uint32_t>( vertices.size() );
+   if( result.size() <= targetIndexCount || vertexCount == 0 )
+   {
+      return 0.0f;
+   }
+
+   // Vertices sharing a position lie on an attribute seam, they are kept in place so that the
+   // seam does not tear
+   std::vector<uint32_t> sorted( vertexCount );
+   std::iota( sorted.begin(), sorted.end(), 0 );
+   std::sort( sorted.begin(), sorted.end(), [&vertices]( uint32_t a, uint32_t b ) {
+      const glm::vec3& pa = vertices[a].pos;
+      const glm::vec3& pb = vertices[b].pos;
+      return std::tie( pa.x, pa.y, pa.z ) < std::tie( pb.x, pb.y, pb.z );
+   } );
+
+   std::vector<uint32_t> positionIds( vertexCount );
+   std::vector<uint8_t> locked( vertexCount, 0 );
+   for( uint32_t i = 0; i < vertexCount; )
+   {
+      uint32_t end = i + 1;
+      while( end < vertexCount && vertices[sorted[end]].pos == vertices[sorted[i]].pos )
+      {
+         end++;
+      }
+
+      for( uint32_t j = i; j < end; ++j )
+      {
+         positionIds[sorted[j]] = sorted[i];
+         locked[sorted[j]]      = end - i > 1;
+      }
+
+      i = end;
+   }
+
+   // Vertices on borders and non-manifold edges are kept in place as well
+   const auto getEdgeKey = [&positionIds]( uint32_t a, uint32_t b ) {
+      const uint64_t pa = positionIds[a];
+      const uint64_t pb = positionIds[b];
+      return pa < pb ? pa << 32 | pb : pb << 32 | pa;
+   };
+
+   std::unordered_map<uint64_t, uint32_t> edgeCounts;
+   edgeCounts.reserve( result.size() );
+   for( size_t i = 0; i < result.size(); ++i )
+   {
+      edgeCounts[getEdgeKey( result[i], result[i - i % 3 + ( i + 1 ) % 3] )]++;
+   }
+
+   for( size_t i = 0; i < result.size(); ++i )
+   {
+      const uint32_t a = result[i];
+      const uint32_t b = result[i - i % 3 + ( i + 1 ) % 3];
+      if( edgeCounts[getEdgeKey( a, b )] != 2 )
+      {
+         locked[a] = 1;
+         locked[b] = 1;
+      }
+   }
+
+   // Every vertex starts with the planes of the triangles around it
+   std::vector<Quadric> quadrics( vertexCount );
+   for( size_t t = 0; t < result.size(); t += 3 )
+   {
+      const glm::dvec3 p0 = vertices[result[t + 0]].pos;
+      const glm::dvec3 p1 = vertices[result[t + 1]].pos;
+      const glm::dvec3 p2 = vertices[result[t + 2]].pos;
+
+      const glm::dvec3 normal = glm::cross( p1 - p0, p2 - p0 );
+      const double length     = glm::length( normal );
+      if( length == 0.0 )
+      {
+         continue;
+      }
+
+      const glm::dvec3 n = normal / length;
+      for( uint32_t k = 0; k < 3; ++k )
+      {
+         quadrics[result[t + k]].addPlane( n, -glm::dot( n, p0 ), length * 0.5 );
+      }
+   }
+
+   std::vector<uint32_t> triangleOffsets( vertexCount + 1 );
+   std::vector<uint32_t> adjacentTriangles;
+   std::vector<uint32_t> collapseTargets( vertexCount );
+   std::vector<uint8_t> touched( vertexCount );
+   std::vector<Collapse> collapses;
+
+   double error = 0.0;
+
+   // Every pass collapses the cheapest edges that do not overlap, until the target is reached or
+   // nothing can be collapsed anymore
+   while( result.size() > targetIndexCount )
+   {
+      const uint32_t triangleCount = static_cast<uint32_t>( result.size() / 3 );
+
+      std::fill( triangleOffsets.begin(), triangleOffsets.end(), 0 );
+      for( const uint32_t index : result )
+      {
+         triangleOffsets[index + 1]++;
+      }
+      std::partial_sum( triangleOffsets.begin(), triangleOffsets.end(), triangleOffsets.begin() );
+
+      std::vector<uint32_t> cursors( triangleOffsets.begin(), triangleOffsets.end() - 1 );
+      adjacentTriangles.resize( result.size() );
+      for( uint32_t t = 0; t < triangleCount; ++t )
+      {
+         for( uint32_t k = 0; k < 3; ++k )
+         {
+            adjacentTriangles[cursors[result[t * 3 + k]]++] = t;
+         }
+      }
+
+      // Edges can be collapsed both ways, onto any of their two vertices
+      collapses.clear();
+      for( size_t i = 0; i < result.size(); ++i )
+      {
+         const uint32_t a = result[i];
+         const uint32_t b = result[i - i % 3 + ( i + 1 ) % 3];
+         if( !locked[a] )
+         {
+            collapses.push_back( {a, b, quadrics[a].evaluate( vertices[b].pos )} );
+         }
+         if( !locked[b] )
+         {
+            collapses.push_back( {b, a, quadrics[b].evaluate( vertices[a].pos )} );
+         }
+      }
+
+      std::sort( collapses.begin(), collapses.end(), []( const Collapse& a, const Collapse& b ) {
+         return a.cost < b.cost;
+      } );
+
+      std::iota( collapseTargets.begin(), collapseTargets.end(), 0 );
+      std::fill( touched.begin(), touched.end(), 0 );
+
+      const size_t trianglesToRemove = ( result.size() - targetIndexCount + 2 ) / 3;
+      size_t removedCount            = 0;
+      for( const Collapse& collapse : collapses )
+      {
+         if( touched[collapse.from] || touched[collapse.to] )
+         {
+            continue;
+         }
+
+         const uint32_t firstTriangle = triangleOffsets[collapse.from];
+         const uint32_t fanSize       = triangleOffsets[collapse.from + 1] - firstTriangle;
+         if( collapseFlips(
+                 vertices,
+                 result,
+                 &adjacentTriangles[firstTriangle],
+                 fanSize,
+                 collapse.from,
+                 collapse.to ) )
+         {
+            continue;
+         }
+
+         collapseTargets[collapse.from] = collapse.to;
+         quadrics[collapse.to].add( quadrics[collapse.from] );
+         error = std::max( error, collapse.cost );
+
+         // The triangles around the collapsed vertex changed, none of them is touched again
+         // before the next pass
+         for( uint32_t i = 0; i < fanSize; ++i )
+         {
+            const uint32_t t = adjacentTriangles[firstTriangle + i];
+            touched[result[t * 3 + 0]] = 1;
+            touched[result[t * 3 + 1]] = 1;
+            touched[result[t * 3 + 2]] = 1;
+         }
+
+         // The two triangles sharing an interior edge disappear with it
+         removedCount += 2;
+         if( removedCount >= trianglesToRemove )
+         {
+            break;
+         }
+      }
+
+      if( removedCount == 0 )
+      {
+         break;
+      }
+
+      size_t outputCount = 0;
+      for( size_t t = 0; t < result.size(); t += 3 )
+      {
+         const uint32_t a = collapseTargets[result[t + 0]];
+         const uint32_t b = collapseTargets[result[t + 1]];
+         const uint32_t c = collapseTargets[result[t + 2]];
+         if( a != b && b != c && a != c )
+         {
+            result[outputCount++] = a;
+            result[outputCount++] = b;
+            result[outputCount++] = c;
+         }
+      }
+      result.resize( outputCount );
+   }
+
+   return static_cast<float>( std::sqrt( error ) );
+}
+
+// =================================================================================================
+// Levels of Detail
+
+// Below this, drawing the mesh is cheap enough that coarser versions are not worth it
+static constexpr size_t MIN_LOD_INDEX_COUNT = 3 * 64;
+
+// A LOD has to remove at least this proportion of the triangles of the previous one
+static constexpr float MIN_LOD_REDUCTION = 0.2f;
+
+std::vector<Lod> GenerateLods(
+    const char* name,
+    const std::vector<Vertex>& vertices,
+    std::vector<uint32_t>& indices )
+{
+   std::vector<Lod> lods;
+   lods.push_back( {0, static_cast<uint32_t>( indices.size() ), 0.0f} );
+
+   // Every LOD is simplified from the full-resolution mesh so that errors do not compound
+   const std::vector<uint32_t> source = indices;
+   std::vector<uint32_t> lodIndices;
+
+   while( lods.size() < MAX_LOD_COUNT )
+   {
+      const Lod& previous           = lods.back();
+      const size_t targetIndexCount = previous.indexCount / 6 * 3;
+      if( targetIndexCount < MIN_LOD_INDEX_COUNT )
+      {
+         break;
+      }
+
+      const float error = Simplify( vertices, source, targetIndexCount, lodIndices );
+      if( lodIndices.size() > previous.indexCount * ( 1.0f - MIN_LOD_REDUCTION ) )
+      {
+         // Seams and borders are preventing the mesh from getting any simpler
+         break;
+      }
+
+      OptimizeVertexCache( lodIndices, vertices.size() );
+
+      Lod lod         = {};
+      lod.indexOffset = static_cast<uint32_t>( indices.size() );
+      lod.indexCount  = static_cast<uint32_t>( lodIndices.size() );
+      lod.error       = std::max( error, previous.error );
+
+      indices.insert( indices.end(), lodIndices.begin(), lodIndices.end() );
+      lods.push_back( lod );
+   }
+
+   printf( "MeshOpt: %s, %zu LODs,", name, lods.size() );
+   for( const Lod& lod : lods )
+   {
+      printf( " %u (%.4f)", lod.indexCount / 3, lod.error );
+   }
+   printf( " triangles\n" );
+
+   return lods;
+}
+
+// =================================================================================================
+// All Optimizations
+
+void Optimize( const char* name, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices )
+{
+   const CacheStatistics before = AnalyzeVertexCache( indices, vertices.size() );
+
+   std::vector<uint32_t> clusters;
+   OptimizeVertexCache( indices, vertices.size(), &clusters );
+   OptimizeOverdraw( indices, vertices, clusters );
+   OptimizeVertexFetch( vertices, indices );
+
+   const CacheStatistics after = AnalyzeVertexCache( indices, vertices.size() );
+
+   printf(
+       "MeshOpt: %s, ACMR %.3f -> %.3f, ATVR %.3f -> %.3f, %zu clusters\n",
+       name,
+       before.acmr,
+       after.acmr,
+       before.atvr,
+       after.atvr,
+       clusters.size() );
+}
+
+bool CanUse16BitIndices( size_t vertexCount ) { return vertexCount <= UINT16_MAX + 1; }
+
+std::vector<uint16_t> To16BitIndices( const std::vector<uint32_t>& indices )
+{
+   return std::vector<uint16_t>( indices.begin(), indices.end() );
+}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CYD
+{
+struct Vertex;
+
+/*
+ * Reorders indexed triangle lists so that they are cheaper to draw. Triangles are reordered to hit
+ * the post-transform vertex cache as often as possible (Tipsify), clusters of triangles facing
+ * outwards are drawn first to reduce overdraw, and vertices are sorted in the order they are
+ * fetched in.
+ *
+ * Coarser levels of detail are built by collapsing the edges that move the surface the least,
+ * measured with quadric error metrics.
+ */
+namespace MeshOpt
+{
+// Size of the FIFO vertex cache the optimizations target and the statistics are computed with
+static constexpr uint32_t VERTEX_CACHE_SIZE = 16;
+
+struct CacheStatistics
+{
+   float acmr = 0.0f;  // Average cache miss ratio, vertices transformed per triangle
+   float atvr = 0.0f;  // Average transformed vertex ratio, vertices transformed per vertex
+};
+
+CacheStatistics AnalyzeVertexCache( const std::vector<uint32_t>& indices, size_t vertexCount );
+
+// Reorders the triangles in place. The index of the first triangle of every cluster is written in
+// pClusters if provided, clusters can be freely reordered without hurting the cache much.
+void OptimizeVertexCache(
+    std::vector<uint32_t>& indices,
+    size_t vertexCount,
+    std::vector<uint32_t>* pClusters = nullptr );
+
+// Reorders the clusters in place so that the ones likely to occlude others are drawn first
+void OptimizeOverdraw(
+    std::vector<uint32_t>& indices,
+    const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& clusters );
+
+// Sorts the vertices in the order they are first referenced in, unreferenced ones are removed
+void OptimizeVertexFetch( std::vector<Vertex>& vertices, std::vector<uint32_t>& indices );
+
+// Runs all the optimizations above and reports the cache statistics before and after
+void Optimize( const char* name, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices );
+
+// Collapses edges until the mesh has at most targetIndexCount indices, or until no edge can be
+// collapsed without flipping triangles. Vertices on borders and attribute seams are kept in place.
+// Returns an estimate of how far the surface moved, in mesh units.
+float Simplify(
+    const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& indices,
+    size_t targetIndexCount,
+    std::vector<uint32_t>& result );
+
+// Levels of detail share the vertices of the full-resolution mesh but have their own indices
+static constexpr uint32_t MAX_LOD_COUNT = 5;
+
+struct Lod
+{
+   uint32_t indexOffset = 0;
+   uint32_t indexCount  = 0;
+   float error          = 0.0f;  // Distance to the full-resolution surface, in mesh units
+};
+
+// Each LOD has about half the triangles of the previous one, their indices are appended after the
+// full-resolution ones. The full-resolution mesh is the first LOD returned.
+std::vector<Lod> GenerateLods(
+    const char* name,
+    const std::vector<Vertex>& vertices,
+    std::vector<uint32_t>& indices );
+
+// Indices fit in 16 bits, vertex counts up to 65536 included
+bool CanUse16BitIndices( size_t vertexCount );
+std::vector<uint16_t> To16BitIndices( const std::vector<uint32_t>& indices );
+}
+}
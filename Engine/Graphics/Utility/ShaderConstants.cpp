@@ -6,6 +6,21 @@
 
 namespace CYD
 {
+bool ShaderConstants::operator==( const ShaderConstants& other ) const
+{
+   return m_map == other.m_map;
+}
+
+bool ShaderConstants::Info::operator==( const Info& other ) const
+{
+   return offset == other.offset && size == other.size;
+}
+
+bool ShaderConstants::Entry::operator==( const Entry& other ) const
+{
+   return m_constantInfos == other.m_constantInfos && m_data == other.m_data;
+}
+
 const ShaderConstants::Entry* ShaderConstants::getEntry( const std::string& shaderName ) const
 {
    const auto it = m_map.find( shaderName );
@@ -3,6 +3,8 @@
 #include <Common/Include.h>
 
 #include <cstdint>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -15,8 +17,13 @@ class ShaderConstants final
    COPIABLE( ShaderConstants );
    ~ShaderConstants() = default;
 
+   // Pipelines specialized with different constants are different pipelines
+   bool operator==( const ShaderConstants& other ) const;
+
    struct Info
    {
+      bool operator==( const Info& other ) const;
+
       // Each constant has a size and an offset in the data buffer
       uint32_t offset;
       size_t size;
@@ -27,6 +34,8 @@ class ShaderConstants final
 
    struct Entry
    {
+      bool operator==( const Entry& other ) const;
+
       const void* getData() const { return m_data.data(); }
       size_t getDataSize() const { return sizeof( m_data[0] ) * m_data.size(); }
 
@@ -45,11 +54,36 @@ class ShaderConstants final
    // Will return nullptr if there is no entry for this particular shader
    const Entry* getEntry( const std::string& shaderName ) const;
 
+   using EntryMap = std::unordered_map<std::string, Entry>;
+   const EntryMap& getEntries() const { return m_map; }
+
    template <typename T>
    void add( const std::string& shaderName, uint32_t id, T value );
 
   private:
    // Map containing per shader shader constants
-   std::unordered_map<std::string, Entry> m_map;
+   EntryMap m_map;
 };
 }
+
+template <>
+struct std::hash<CYD::ShaderConstants>
+{
+   size_t operator()( const CYD::ShaderConstants& constants ) const noexcept
+   {
+      // Entries are combined in a way that does not depend on their order in the map
+      size_t seed = 0;
+      for( const auto& entry : constants.getEntries() )
+      {
+         const std::string_view data(
+             static_cast<const char*>( entry.second.getData() ), entry.second.getDataSize() );
+
+         size_t entrySeed = 0;
+         hashCombine( entrySeed, entry.first );
+         hashCombine( entrySeed, data );
+         seed ^= entrySeed;
+      }
+
+      return seed;
+   }
+};
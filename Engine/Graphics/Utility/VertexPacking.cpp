@@ -0,0 +1,228 @@
+#include <Graphics/Utility/VertexPacking.h>
+
+#include <Common/Assert.h>
+
+#include <Graphics/GraphicsTypes.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace CYD::VertexPacking
+{
+const VertexLayout& GetStandardLayout()
+{
+   static const VertexLayout layout = VertexLayout()
+                                          .add( VertexSemantic::POSITION, VertexFormat::FLOAT3 )
+                                          .add( VertexSemantic::COLOR, VertexFormat::FLOAT4 )
+                                          .add( VertexSemantic::TEXCOORD, VertexFormat::FLOAT3 )
+                                          .add( VertexSemantic::NORMAL, VertexFormat::FLOAT3 );
+
+   CYDASSERT( layout.stride == sizeof( Vertex ) && "VertexPacking: Standard layout out of sync" );
+
+   return layout;
+}
+
+static bool isNormalized( VertexFormat format )
+{
+   switch( format )
+   {
+      case VertexFormat::UNORM8x4:
+      case VertexFormat::SNORM8x4:
+      case VertexFormat::UNORM16x2:
+      case VertexFormat::SNORM16x2:
+      case VertexFormat::UNORM16x4:
+      case VertexFormat::SNORM16x4:
+         return true;
+      default:
+         return false;
+   }
+}
+
+static bool isSigned( VertexFormat format )
+{
+   return format == VertexFormat::SNORM8x4 || format == VertexFormat::SNORM16x2 ||
+          format == VertexFormat::SNORM16x4;
+}
+
+static uint32_t getComponentCount( VertexFormat format )
+{
+   switch( format )
+   {
+      case VertexFormat::FLOAT2:
+      case VertexFormat::HALF2:
+      case VertexFormat::UNORM16x2:
+      case VertexFormat::SNORM16x2:
+         return 2;
+      case VertexFormat::FLOAT3:
+         return 3;
+      default:
+         return 4;
+   }
+}
+
+static void writeComponents( uint8_t* pDst, VertexFormat format, const glm::vec4& value )
+{
+   const glm::vec2 xy( value.x, value.y );
+   const glm::vec2 zw( value.z, value.w );
+
+   uint32_t words[2] = {};
+   switch( format )
+   {
+      case VertexFormat::FLOAT2:
+      case VertexFormat::FLOAT3:
+      case VertexFormat::FLOAT4:
+         memcpy( pDst, &value, getComponentCount( format ) * sizeof( float ) );
+         return;
+      case VertexFormat::HALF2:
+         words[0] = glm::packHalf2x16( xy );
+         break;
+      case VertexFormat::HALF4:
+         words[0] = glm::packHalf2x16( xy );
+         words[1] = glm::packHalf2x16( zw );
+         break;
+      case VertexFormat::UNORM8x4:
+         words[0] = glm::packUnorm4x8( value );
+         break;
+      case VertexFormat::SNORM8x4:
+         words[0] = glm::packSnorm4x8( value );
+         break;
+      case VertexFormat::UNORM16x2:
+         words[0] = glm::packUnorm2x16( xy );
+         break;
+      case VertexFormat::SNORM16x2:
+         words[0] = glm::packSnorm2x16( xy );
+         break;
+      case VertexFormat::UNORM16x4:
+         words[0] = glm::packUnorm2x16( xy );
+         words[1] = glm::packUnorm2x16( zw );
+         break;
+      case VertexFormat::SNORM16x4:
+         words[0] = glm::packSnorm2x16( xy );
+         words[1] = glm::packSnorm2x16( zw );
+         break;
+   }
+
+   // Every packed format is made of 2 or 4 components, 4 or 8 bytes
+   const bool isWide = format == VertexFormat::HALF4 || format == VertexFormat::UNORM16x4 ||
+                       format == VertexFormat::SNORM16x4;
+   memcpy( pDst, words, isWide ? 8 : 4 );
+}
+
+PackedVertices Pack( const VertexLayout& layout, const Vertex* pVertices, size_t vertexCount )
+{
+   PackedVertices packed;
+   packed.stride = layout.stride;
+   packed.data.resize( layout.stride * vertexCount );
+
+   // Quantized positions are remapped from the bounds of the mesh to the range of the format
+   const VertexAttribute* pPosition = layout.find( VertexSemantic::POSITION );
+   if( pPosition && isNormalized( pPosition->format ) && vertexCount > 0 )
+   {
+      glm::vec3 boundsMin = pVertices[0].pos;
+      glm::vec3 boundsMax = pVertices[0].pos;
+      for( size_t i = 1; i < vertexCount; ++i )
+      {
+         boundsMin = glm::min( boundsMin, pVertices[i].pos );
+         boundsMax = glm::max( boundsMax, pVertices[i].pos );
+      }
+
+      if( isSigned( pPosition->format ) )
+      {
+         packed.scale  = ( boundsMax - boundsMin ) * 0.5f;
+         packed.offset = ( boundsMax + boundsMin ) * 0.5f;
+      }
+      else
+      {
+         packed.scale  = boundsMax - boundsMin;
+         packed.offset = boundsMin;
+      }
+
+      // Flat meshes have nothing to remap on some axes
+      for( uint32_t axis = 0; axis < 3; ++axis )
+      {
+         if( packed.scale[axis] <= 0.0f )
+         {
+            packed.scale[axis] = 1.0f;
+         }
+      }
+   }
+
+   const glm::vec3 invScale = 1.0f / packed.scale;
+
+   for( size_t i = 0; i < vertexCount; ++i )
+   {
+      const Vertex& vertex = pVertices[i];
+      uint8_t* pDst        = &packed.data[i * layout.stride];
+
+      for( const VertexAttribute& attribute : layout.attributes )
+      {
+         glm::vec4 value;
+         switch( attribute.semantic )
+         {
+            case VertexSemantic::POSITION:
+               value = glm::vec4( ( vertex.pos - packed.offset ) * invScale, 1.0f );
+               break;
+            case VertexSemantic::COLOR:
+               value = vertex.col;
+               break;
+            case VertexSemantic::TEXCOORD:
+               value = glm::vec4( vertex.uv, 0.0f );
+               break;
+            case VertexSemantic::NORMAL:
+               value = getComponentCount( attribute.format ) == 2
+                           ? glm::vec4( OctahedralEncode( vertex.normal ), 0.0f, 0.0f )
+                           : glm::vec4( vertex.normal, 0.0f );
+               break;
+         }
+
+         writeComponents( pDst + attribute.offset, attribute.format, value );
+      }
+   }
+
+   return packed;
+}
+
+glm::mat4 GetDequantizationMatrix( const PackedVertices& packed )
+{
+   glm::mat4 dequantization( 1.0f );
+   dequantization[0][0] = packed.scale.x;
+   dequantization[1][1] = packed.scale.y;
+   dequantization[2][2] = packed.scale.z;
+   dequantization[3]    = glm::vec4( packed.offset, 1.0f );
+
+   return dequantization;
+}
+
+glm::vec2 OctahedralEncode( const glm::vec3& normal )
+{
+   const float length = std::abs( normal.x ) + std::abs( normal.y ) + std::abs( normal.z );
+   if( length == 0.0f )
+   {
+      return glm::vec2( 0.0f );
+   }
+
+   // Projecting on the octahedron, then folding the lower half over the upper one
+   const glm::vec3 n = normal / length;
+   if( n.z >= 0.0f )
+   {
+      return glm::vec2( n.x, n.y );
+   }
+
+   return glm::vec2(
+       ( 1.0f - std::abs( n.y ) ) * ( n.x >= 0.0f ? 1.0f : -1.0f ),
+       ( 1.0f - std::abs( n.x ) ) * ( n.y >= 0.0f ? 1.0f : -1.0f ) );
+}
+
+glm::vec3 OctahedralDecode( const glm::vec2& encoded )
+{
+   // Keep in sync with octDecode in PBR_BINDLESS.vert
+   glm::vec3 n( encoded.x, encoded.y, 1.0f - std::abs( encoded.x ) - std::abs( encoded.y ) );
+
+   const float t = std::max( -n.z, 0.0f );
+   n.x += n.x >= 0.0f ? -t : t;
+   n.y += n.y >= 0.0f ? -t : t;
+
+   return glm::normalize( n );
+}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace CYD
+{
+struct Vertex;
+struct VertexLayout;
+
+/*
+ * Encodes vertices following the layout a pipeline declares. Normalized formats are what make a
+ * layout compact:
+ * - Positions in UNORM/SNORM formats are quantized to the bounds of the mesh and have to be
+ *   dequantized by the renderer, usually by folding the dequantization in the model matrix
+ * - Normals in two-component formats are octahedral-encoded
+ * - Colors and texture coordinates are stored as they are, clamped to the range of the format
+ */
+namespace VertexPacking
+{
+// The layout of the Vertex struct, used by pipelines that do not declare one
+const VertexLayout& GetStandardLayout();
+
+struct PackedVertices
+{
+   std::vector<uint8_t> data;
+   uint32_t stride = 0;
+
+   // Positions are decoded as encoded * scale + offset, identity when they are not quantized
+   glm::vec3 scale  = glm::vec3( 1.0f );
+   glm::vec3 offset = glm::vec3( 0.0f );
+};
+
+PackedVertices Pack( const VertexLayout& layout, const Vertex* pVertices, size_t vertexCount );
+
+// Matrix decoding quantized positions, to be multiplied to the right of the model matrix
+glm::mat4 GetDequantizationMatrix( const PackedVertices& packed );
+
+// Maps a unit vector to the [-1, 1] square and back
+glm::vec2 OctahedralEncode( const glm::vec3& normal );
+glm::vec3 OctahedralDecode( const glm::vec2& encoded );
+}
+}
@@ -4,15 +4,43 @@
 #include <Common/Vulkan.h>
 
 #include <Graphics/Vulkan/CommandBuffer.h>
+#include <Graphics/Vulkan/Buffer.h>
 #include <Graphics/Vulkan/Texture.h>
 #include <Graphics/Vulkan/TypeConversions.h>
 
 namespace vk::Barriers
 {
-void ImageMemory( const CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLayout targetLayout )
+// Queue families without graphics or compute capabilities cannot use these stages in a barrier
+static VkPipelineStageFlags
+filterStages( const CommandBuffer* cmdBuffer, VkPipelineStageFlags stages, VkAccessFlags& access )
+{
+   const CYD::QueueUsageFlag queueType = cmdBuffer->getQueueType();
+   if( !( queueType & CYD::QueueUsage::GRAPHICS ) )
+   {
+      stages &= ~( VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                   VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT );
+   }
+   if( !( queueType & CYD::QueueUsage::COMPUTE ) )
+   {
+      stages &= ~VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+   }
+
+   if( !stages )
+   {
+      // The accesses will be made visible by the ownership transfer to the family using them
+      access = 0;
+   }
+
+   return stages;
+}
+
+void ImageMemory( CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLayout targetLayout )
 {
    CYDASSERT( texture && "BarriersHelper: No texture passed to make barrier" );
 
+   // The image could still belong to another queue family
+   cmdBuffer->takeOwnership( texture );
+
    const CYD::ImageLayout initialLayout    = texture->getLayout();
    const CYD::ShaderStageFlag targetStages = texture->getStages();
 
@@ -26,7 +54,7 @@ void ImageMemory( const CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLa
    barrier.image                           = texture->getVKImage();
    barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
    barrier.subresourceRange.baseMipLevel   = 0;
-   barrier.subresourceRange.levelCount     = 1;
+   barrier.subresourceRange.levelCount     = texture->getMipLevels();
    barrier.subresourceRange.baseArrayLayer = 0;
    barrier.subresourceRange.layerCount     = texture->getLayers();
 
@@ -37,14 +65,44 @@ void ImageMemory( const CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLa
    switch( initialLayout )
    {
       case CYD::ImageLayout::UNKNOWN:
-      case CYD::ImageLayout::GENERAL:
          barrier.srcAccessMask |= 0;
          srcPipelineStage |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
          break;
+      case CYD::ImageLayout::GENERAL:
+         // Storage images, the shaders writing to them have to be done
+         barrier.srcAccessMask |= VK_ACCESS_SHADER_WRITE_BIT;
+         if( targetStages & CYD::ShaderStage::FRAGMENT_STAGE )
+         {
+            srcPipelineStage |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+         }
+         if( targetStages & CYD::ShaderStage::COMPUTE_STAGE )
+         {
+            srcPipelineStage |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+         }
+         break;
       case CYD::ImageLayout::TRANSFER_DST:
          barrier.srcAccessMask |= VK_ACCESS_TRANSFER_WRITE_BIT;
          srcPipelineStage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
          break;
+      case CYD::ImageLayout::TRANSFER_SRC:
+         barrier.srcAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+         srcPipelineStage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+         break;
+      case CYD::ImageLayout::COLOR_ATTACHMENT:
+         barrier.srcAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+         srcPipelineStage |= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+         break;
+      case CYD::ImageLayout::SHADER_READ:
+         barrier.srcAccessMask |= VK_ACCESS_SHADER_READ_BIT;
+         if( targetStages & CYD::ShaderStage::FRAGMENT_STAGE )
+         {
+            srcPipelineStage |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+         }
+         if( targetStages & CYD::ShaderStage::COMPUTE_STAGE )
+         {
+            srcPipelineStage |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+         }
+         break;
       default:
          CYDASSERT( !"BarriersHelper: Could not determine source access mask based on current image layout for barrier" );
    }
@@ -54,6 +112,9 @@ void ImageMemory( const CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLa
       case CYD::ImageLayout::TRANSFER_DST:
          barrier.dstAccessMask |= VK_ACCESS_TRANSFER_WRITE_BIT;
          break;
+      case CYD::ImageLayout::TRANSFER_SRC:
+         barrier.dstAccessMask |= VK_ACCESS_TRANSFER_READ_BIT;
+         break;
       case CYD::ImageLayout::SHADER_READ:
          barrier.dstAccessMask |= VK_ACCESS_SHADER_READ_BIT;
          break;
@@ -64,7 +125,8 @@ void ImageMemory( const CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLa
          CYDASSERT( !"BarriersHelper: Could not determine destination access mask based on target image layout for barrier" );
    }
 
-   if( targetLayout == CYD::ImageLayout::TRANSFER_DST )
+   if( ( targetLayout == CYD::ImageLayout::TRANSFER_DST ) ||
+       ( targetLayout == CYD::ImageLayout::TRANSFER_SRC ) )
    {
       dstPipelineStage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
    }
@@ -82,6 +144,18 @@ void ImageMemory( const CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLa
       }
    }
 
+   srcPipelineStage = filterStages( cmdBuffer, srcPipelineStage, barrier.srcAccessMask );
+   if( !srcPipelineStage )
+   {
+      srcPipelineStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+   }
+
+   dstPipelineStage = filterStages( cmdBuffer, dstPipelineStage, barrier.dstAccessMask );
+   if( !dstPipelineStage )
+   {
+      dstPipelineStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+   }
+
    vkCmdPipelineBarrier(
        cmdBuffer->getVKBuffer(),
        srcPipelineStage,
@@ -97,4 +171,142 @@ void ImageMemory( const CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLa
    // Updating layout
    texture->setLayout( targetLayout );
 }
+
+// The release half only has to make the writes available and the acquire half only has to make them
+// visible, the semaphore between the two submissions takes care of the execution dependency
+static void ownershipScopes(
+    const CommandBuffer* cmdBuffer,
+    uint32_t srcFamily,
+    VkAccessFlags& srcAccess,
+    VkAccessFlags& dstAccess,
+    VkPipelineStageFlags& srcStage,
+    VkPipelineStageFlags& dstStage )
+{
+   if( cmdBuffer->getFamilyIndex() == srcFamily )
+   {
+      srcAccess = VK_ACCESS_MEMORY_WRITE_BIT;
+      dstAccess = 0;
+      srcStage  = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+      dstStage  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+   }
+   else
+   {
+      srcAccess = 0;
+      dstAccess = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+      srcStage  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+      dstStage  = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+   }
+}
+
+void ImageOwnership(
+    const CommandBuffer* cmdBuffer,
+    const Texture* texture,
+    CYD::ImageLayout layout,
+    uint32_t srcFamily,
+    uint32_t dstFamily )
+{
+   CYDASSERT( texture && "BarriersHelper: No texture passed to make barrier" );
+
+   // Layouts must match on both halves, the transfer does not transition the image
+   VkImageMemoryBarrier barrier            = {};
+   barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+   barrier.oldLayout                       = TypeConversions::cydToVkImageLayout( layout );
+   barrier.newLayout                       = TypeConversions::cydToVkImageLayout( layout );
+   barrier.srcQueueFamilyIndex             = srcFamily;
+   barrier.dstQueueFamilyIndex             = dstFamily;
+   barrier.image                           = texture->getVKImage();
+   barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+   barrier.subresourceRange.baseMipLevel   = 0;
+   barrier.subresourceRange.levelCount     = texture->getMipLevels();
+   barrier.subresourceRange.baseArrayLayer = 0;
+   barrier.subresourceRange.layerCount     = texture->getLayers();
+
+   VkPipelineStageFlags srcPipelineStage = 0;
+   VkPipelineStageFlags dstPipelineStage = 0;
+   ownershipScopes(
+       cmdBuffer,
+       srcFamily,
+       barrier.srcAccessMask,
+       barrier.dstAccessMask,
+       srcPipelineStage,
+       dstPipelineStage );
+
+   vkCmdPipelineBarrier(
+       cmdBuffer->getVKBuffer(),
+       srcPipelineStage,
+       dstPipelineStage,
+       0,
+       0,
+       nullptr,
+       0,
+       nullptr,
+       1,
+       &barrier );
+}
+
+void BufferOwnership(
+    const CommandBuffer* cmdBuffer,
+    const Buffer* buffer,
+    uint32_t srcFamily,
+    uint32_t dstFamily )
+{
+   CYDASSERT( buffer && "BarriersHelper: No buffer passed to make barrier" );
+
+   VkBufferMemoryBarrier barrier = {};
+   barrier.sType                 = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+   barrier.srcQueueFamilyIndex   = srcFamily;
+   barrier.dstQueueFamilyIndex   = dstFamily;
+   barrier.buffer                = buffer->getVKBuffer();
+   barrier.offset                = 0;
+   barrier.size                  = VK_WHOLE_SIZE;
+
+   VkPipelineStageFlags srcPipelineStage = 0;
+   VkPipelineStageFlags dstPipelineStage = 0;
+   ownershipScopes(
+       cmdBuffer,
+       srcFamily,
+       barrier.srcAccessMask,
+       barrier.dstAccessMask,
+       srcPipelineStage,
+       dstPipelineStage );
+
+   vkCmdPipelineBarrier(
+       cmdBuffer->getVKBuffer(),
+       srcPipelineStage,
+       dstPipelineStage,
+       0,
+       0,
+       nullptr,
+       1,
+       &barrier,
+       0,
+       nullptr );
+}
+
+void HostRead( const CommandBuffer* cmdBuffer, const Buffer* buffer )
+{
+   CYDASSERT( buffer && "BarriersHelper: No buffer passed to make barrier" );
+
+   VkBufferMemoryBarrier barrier = {};
+   barrier.sType                 = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+   barrier.srcAccessMask         = VK_ACCESS_TRANSFER_WRITE_BIT;
+   barrier.dstAccessMask         = VK_ACCESS_HOST_READ_BIT;
+   barrier.srcQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
+   barrier.dstQueueFamilyIndex   = VK_QUEUE_FAMILY_IGNORED;
+   barrier.buffer                = buffer->getVKBuffer();
+   barrier.offset                = 0;
+   barrier.size                  = VK_WHOLE_SIZE;
+
+   vkCmdPipelineBarrier(
+       cmdBuffer->getVKBuffer(),
+       VK_PIPELINE_STAGE_TRANSFER_BIT,
+       VK_PIPELINE_STAGE_HOST_BIT,
+       0,
+       0,
+       nullptr,
+       1,
+       &barrier,
+       0,
+       nullptr );
+}
 }
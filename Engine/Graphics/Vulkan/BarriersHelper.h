@@ -4,11 +4,30 @@
 
 namespace vk
 {
+class Buffer;
 class Texture;
 class CommandBuffer;
 }
 
 namespace vk::Barriers
 {
-void ImageMemory( const CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLayout targetLayout );
+void ImageMemory( CommandBuffer* cmdBuffer, Texture* texture, CYD::ImageLayout targetLayout );
+
+// One half of a queue family ownership transfer. Recorded on a command buffer of the source family
+// it releases the resource, recorded on one of the destination family it acquires it.
+void ImageOwnership(
+    const CommandBuffer* cmdBuffer,
+    const Texture* texture,
+    CYD::ImageLayout layout,
+    uint32_t srcFamily,
+    uint32_t dstFamily );
+void BufferOwnership(
+    const CommandBuffer* cmdBuffer,
+    const Buffer* buffer,
+    uint32_t srcFamily,
+    uint32_t dstFamily );
+
+// Makes the transfer writes to a host visible buffer visible to the host, once the command buffer
+// has completed
+void HostRead( const CommandBuffer* cmdBuffer, const Buffer* buffer );
 }
@@ -0,0 +1,115 @@
+#include <Graphics/Vulkan/BindlessTable.h>
+
+#include <Common/Assert.h>
+#include <Common/Vulkan.h>
+
+#include <Graphics/GraphicsTypes.h>
+
+#include <Graphics/Vulkan/Device.h>
+#include <Graphics/Vulkan/PipelineStash.h>
+#include <Graphics/Vulkan/Texture.h>
+
+namespace vk
+{
+BindlessTable::BindlessTable( const Device& device ) : m_device( device )
+{
+   const uint32_t capacity = m_device.getBindlessCapacity();
+   CYDASSERT( capacity > 0 && "BindlessTable: Device does not support descriptor indexing" );
+
+   m_textures.resize( capacity, nullptr );
+
+   // Handing out the lowest slots first
+   m_freeSlots.reserve( capacity );
+   for( uint32_t slot = capacity; slot > 0; --slot )
+   {
+      m_freeSlots.push_back( slot - 1 );
+   }
+
+   VkDescriptorPoolSize poolSize = {};
+   poolSize.type                 = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+   poolSize.descriptorCount      = capacity;
+
+   VkDescriptorPoolCreateInfo poolInfo = {};
+   poolInfo.sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+   poolInfo.flags                      = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+   poolInfo.poolSizeCount              = 1;
+   poolInfo.pPoolSizes                 = &poolSize;
+   poolInfo.maxSets                    = 1;
+
+   VkResult result =
+       vkCreateDescriptorPool( m_device.getVKDevice(), &poolInfo, nullptr, &m_vkPool );
+   CYDASSERT( result == VK_SUCCESS && "BindlessTable: Could not create descriptor pool" );
+
+   // The pipeline stash creates the same layout for every set with a bindless shader resource,
+   // which makes this set compatible with all of them
+   CYD::DescriptorSetLayoutInfo layoutInfo;
+   layoutInfo.shaderResources.push_back(
+       { CYD::ShaderResourceType::BINDLESS_TEXTURES, CYD::ShaderStage::ALL_STAGES, 0, 0 } );
+
+   const VkDescriptorSetLayout vkLayout = m_device.getPipelineStash().findOrCreate( layoutInfo );
+
+   VkDescriptorSetAllocateInfo allocInfo = {};
+   allocInfo.sType                       = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+   allocInfo.descriptorPool              = m_vkPool;
+   allocInfo.descriptorSetCount          = 1;
+   allocInfo.pSetLayouts                 = &vkLayout;
+
+   result = vkAllocateDescriptorSets( m_device.getVKDevice(), &allocInfo, &m_vkDescSet );
+   CYDASSERT( result == VK_SUCCESS && "BindlessTable: Could not allocate descriptor set" );
+}
+
+uint32_t BindlessTable::add( Texture* texture, VkSampler sampler )
+{
+   if( m_freeSlots.empty() )
+   {
+      CYDASSERT( !"BindlessTable: No more free slots" );
+      return INVALID_SLOT;
+   }
+
+   const uint32_t slot = m_freeSlots.back();
+   m_freeSlots.pop_back();
+
+   m_textures[slot] = texture;
+   _write( slot, texture, sampler );
+
+   return slot;
+}
+
+void BindlessTable::remove( uint32_t slot )
+{
+   if( slot == INVALID_SLOT )
+   {
+      return;
+   }
+
+   // The descriptor is left as is, the array is partially bound and nothing reads this slot
+   // anymore. It will be written over when the slot is handed out again.
+   m_textures[slot] = nullptr;
+   m_freeSlots.push_back( slot );
+}
+
+void BindlessTable::_write( uint32_t slot, const Texture* texture, VkSampler sampler ) const
+{
+   VkDescriptorImageInfo imageInfo = {};
+   imageInfo.imageLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+   imageInfo.imageView             = texture->getVKImageView();
+   imageInfo.sampler               = sampler;
+
+   VkWriteDescriptorSet descriptorWrite = {};
+   descriptorWrite.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+   descriptorWrite.dstSet               = m_vkDescSet;
+   descriptorWrite.dstBinding           = 0;
+   descriptorWrite.dstArrayElement      = slot;
+   descriptorWrite.descriptorType       = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+   descriptorWrite.descriptorCount      = 1;
+   descriptorWrite.pImageInfo           = &imageInfo;
+
+   vkUpdateDescriptorSets( m_device.getVKDevice(), 1, &descriptorWrite, 0, nullptr );
+}
+
+BindlessTable::~BindlessTable()
+{
+   // The set is freed with the pool, the layout belongs to the pipeline stash
+   vkDestroyDescriptorPool( m_device.getVKDevice(), m_vkPool, nullptr );
+}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <cstdint>
+#include <vector>
+
+// ================================================================================================
+// Forwards
+// ================================================================================================
+FWDHANDLE( VkDescriptorPool );
+FWDHANDLE( VkDescriptorSet );
+FWDHANDLE( VkSampler );
+
+namespace vk
+{
+class Device;
+class Texture;
+}
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * Single descriptor set holding every sampled 2D texture of the device in one large array, built
+ * on VK_EXT_descriptor_indexing. Textures get a slot in the array when they are created and give
+ * it back when they are released, shaders index the array directly with the slot.
+ *
+ * The array is partially bound and updated after bind, so slots can be written while command
+ * buffers using other slots of the set are still in flight. Textures are expected to be in the
+ * shader read-only layout whenever they are sampled through the array.
+ */
+namespace vk
+{
+class BindlessTable final
+{
+  public:
+   explicit BindlessTable( const Device& device );
+   NON_COPIABLE( BindlessTable );
+   ~BindlessTable();
+
+   // Slot of textures that are not in the table
+   static constexpr uint32_t INVALID_SLOT = ~0U;
+
+   uint32_t add( Texture* texture, VkSampler sampler );
+   void remove( uint32_t slot );
+
+   // Textures currently in the table, in no particular order and with holes
+   const std::vector<Texture*>& getTextures() const noexcept { return m_textures; }
+
+   VkDescriptorSet getVKDescSet() const noexcept { return m_vkDescSet; }
+
+  private:
+   void _write( uint32_t slot, const Texture* texture, VkSampler sampler ) const;
+
+   const Device& m_device;
+
+   std::vector<Texture*> m_textures;
+   std::vector<uint32_t> m_freeSlots;
+
+   VkDescriptorPool m_vkPool   = nullptr;
+   VkDescriptorSet m_vkDescSet = nullptr;
+};
+}
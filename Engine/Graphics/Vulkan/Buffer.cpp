@@ -21,6 +21,7 @@ void Buffer::acquire(
        m_useCount == 0 && "Buffer: Use count was not 0. This buffer was probably not released" );
 
    m_useCount = 1;
+   m_generation++;
 
    VkBufferCreateInfo bufferInfo = {};
    bufferInfo.sType              = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -65,15 +66,16 @@ void Buffer::release()
    if( m_pDevice )
    {
       vkDestroyBuffer( m_pDevice->getVKDevice(), m_vkBuffer, nullptr );
-      vkFreeMemory( m_pDevice->getVKDevice(), m_vkMemory, nullptr );
+      m_pDevice->getMemoryAllocator().free( m_allocation );
 
       m_size       = 0;
       m_memoryType = 0;
       m_pDevice    = nullptr;
       m_vkBuffer   = nullptr;
-      m_vkMemory   = nullptr;
 
-      m_useCount = 0;
+      m_ownerFamily = NO_OWNER_FAMILY;
+      m_useCount    = 0;
+      m_streaming   = false;
    }
 }
 
@@ -91,38 +93,25 @@ void Buffer::copy( const void* pData, size_t offset, size_t size )
       return;
    }
 
-   _mapMemory();
-   memcpy( static_cast<unsigned char*>( m_data ) + offset, pData, size );
-   _unmapMemory();
+   // Host visible memory is persistently mapped by the allocator
+   memcpy( static_cast<unsigned char*>( m_allocation.pMapped ) + offset, pData, size );
 }
 
-void Buffer::_mapMemory()
+void Buffer::read( void* pData, size_t offset, size_t size ) const
 {
    if( !( m_memoryType & CYD::MemoryType::HOST_VISIBLE ) )
    {
-      CYDASSERT( !"Buffer: Cannot map memory, buffer memory not host visible" );
+      CYDASSERT( !"Buffer: Cannot read from buffer, buffer memory not host visible" );
       return;
    }
 
-   // TODO Add offsets to create chunking buffers
-   const VkResult result =
-       vkMapMemory( m_pDevice->getVKDevice(), m_vkMemory, 0, m_size, 0, &m_data );
-   CYDASSERT( result == VK_SUCCESS && "Buffer: Mapping memory failed" );
-}
-
-void Buffer::_unmapMemory()
-{
-   if( !( m_memoryType & CYD::MemoryType::HOST_VISIBLE ) )
+   if( ( offset + size ) > m_size )
    {
-      CYDASSERT( !"Buffer: Cannot unmap memory, buffer memory not host visible" );
+      CYDASSERT( !"Buffer: Offset + size surpasses allocated buffer size" );
       return;
    }
 
-   if( m_data )
-   {
-      vkUnmapMemory( m_pDevice->getVKDevice(), m_vkMemory );
-      m_data = nullptr;
-   }
+   memcpy( pData, static_cast<const unsigned char*>( m_allocation.pMapped ) + offset, size );
 }
 
 void Buffer::_allocateMemory()
@@ -145,16 +134,16 @@ void Buffer::_allocateMemory()
       memoryProperty |= VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
    }
 
-   VkMemoryAllocateInfo allocInfo = {};
-   allocInfo.sType                = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-   allocInfo.allocationSize       = memRequirements.size;
-   allocInfo.memoryTypeIndex =
-       m_pDevice->findMemoryType( memRequirements.memoryTypeBits, memoryProperty );
-
-   VkResult result = vkAllocateMemory( m_pDevice->getVKDevice(), &allocInfo, nullptr, &m_vkMemory );
-   CYDASSERT( result == VK_SUCCESS && "Buffer: Could not allocate device memory" );
+   m_allocation = m_pDevice->getMemoryAllocator().allocate(
+       memRequirements, memoryProperty, MemoryAllocator::ResourceKind::LINEAR );
+   if( !m_allocation.vkMemory )
+   {
+      CYDASSERT( !"Buffer: Could not allocate device memory" );
+      return;
+   }
 
-   vkBindBufferMemory( m_pDevice->getVKDevice(), m_vkBuffer, m_vkMemory, 0 );
+   vkBindBufferMemory(
+       m_pDevice->getVKDevice(), m_vkBuffer, m_allocation.vkMemory, m_allocation.offset );
 }
 
 Buffer::~Buffer() { release(); }
@@ -3,6 +3,7 @@
 #include <Common/Include.h>
 
 #include <Graphics/GraphicsTypes.h>
+#include <Graphics/Vulkan/MemoryAllocator.h>
 
 #include <cstdint>
 
@@ -10,7 +11,6 @@
 // Forwards
 // ================================================================================================
 FWDHANDLE( VkBuffer );
-FWDHANDLE( VkDeviceMemory );
 FWDHANDLE( VkDescriptorSet );
 
 namespace vk
@@ -44,24 +44,42 @@ class Buffer final
    void incUse() { m_useCount++; }
    void decUse() { m_useCount--; }
 
+   // The content of the buffer is still being streamed in, it cannot be drawn from yet
+   bool isStreaming() const noexcept { return m_streaming; }
+   void setStreaming( bool streaming ) { m_streaming = streaming; }
+
+   // Incremented every time this slot is acquired, tells apart resources that used the same slot
+   uint32_t getGeneration() const noexcept { return m_generation; }
+
+   // Same value as VK_QUEUE_FAMILY_IGNORED, the resource was never used on a queue yet
+   static constexpr uint32_t NO_OWNER_FAMILY = ~0U;
+
+   // Queue family currently owning the buffer, buffers are created with exclusive sharing
+   uint32_t getOwnerFamily() const noexcept { return m_ownerFamily; }
+   void setOwnerFamily( uint32_t familyIndex ) { m_ownerFamily = familyIndex; }
+
    void copy( const void* pData, size_t offset, size_t size );
+   void read( void* pData, size_t offset, size_t size ) const;
+
+   // Persistently mapped memory of host visible buffers, nullptr otherwise. Disjoint ranges can be
+   // written to from several threads at once.
+   void* getMappedData() const noexcept { return m_allocation.pMapped; }
 
   private:
-   void _mapMemory();
-   void _unmapMemory();
    void _allocateMemory();
 
    const Device* m_pDevice = nullptr;
 
-   // Used for staging buffers
-   void* m_data = nullptr;
-
    // Common
-   size_t m_size             = 0;
-   VkBuffer m_vkBuffer       = nullptr;
-   VkDeviceMemory m_vkMemory = nullptr;
+   size_t m_size       = 0;
+   VkBuffer m_vkBuffer = nullptr;
+   MemoryAllocation m_allocation;
    CYD::MemoryTypeFlag m_memoryType;
 
-   uint32_t m_useCount = 0;
+   uint32_t m_ownerFamily = NO_OWNER_FAMILY;
+   uint32_t m_generation  = 0;
+   uint32_t m_useCount    = 0;
+
+   bool m_streaming = false;
 };
 }
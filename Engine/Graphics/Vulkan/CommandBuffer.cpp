@@ -9,22 +9,25 @@
 #include <Graphics/Vulkan/Device.h>
 #include <Graphics/Vulkan/PipelineStash.h>
 #include <Graphics/Vulkan/DescriptorPool.h>
+#include <Graphics/Vulkan/BindlessTable.h>
 #include <Graphics/Vulkan/SamplerStash.h>
 #include <Graphics/Vulkan/RenderPassStash.h>
 #include <Graphics/Vulkan/Swapchain.h>
 #include <Graphics/Vulkan/Buffer.h>
 #include <Graphics/Vulkan/Texture.h>
 #include <Graphics/Vulkan/TypeConversions.h>
+#include <Graphics/Vulkan/BarriersHelper.h>
 
+#include <algorithm>
 #include <array>
 
 namespace vk
 {
-static constexpr uint32_t INITIAL_RESOURCE_TO_UPDATE_COUNT = 32;
+static constexpr uint32_t INITIAL_BOUND_RESOURCE_COUNT = 8;
 
 void CommandBuffer::acquire(
     const Device& device,
-    const CommandPool& pool,
+    CommandPool& pool,
     CYD::QueueUsageFlag usage )
 {
    m_pDevice = &device;
@@ -47,10 +50,7 @@ void CommandBuffer::acquire(
    result = vkCreateFence( m_pDevice->getVKDevice(), &fenceInfo, nullptr, &m_vkFence );
    CYDASSERT( result == VK_SUCCESS && "CommandBuffer: Could not create fence" );
 
-   m_defaultSampler = m_pDevice->getSamplerStash().findOrCreate( {} );
-
-   m_buffersToUpdate.reserve( INITIAL_RESOURCE_TO_UPDATE_COUNT );
-   m_texturesToUpdate.reserve( INITIAL_RESOURCE_TO_UPDATE_COUNT );
+   m_setBindings.reserve( INITIAL_BOUND_RESOURCE_COUNT );
 }
 
 void CommandBuffer::release()
@@ -61,17 +61,9 @@ void CommandBuffer::release()
       m_isRecording  = false;
       m_wasSubmitted = false;
 
-      // Clearing tracked descriptor sets
-      std::vector<VkDescriptorSet> vkDescSets;
-      vkDescSets.reserve( m_descSets.size() );
-
-      for( const auto& descSet : m_descSets )
-      {
-         vkDescSets.push_back( descSet.vkDescSet );
-      }
-
-      m_pDevice->getDescriptorPool().free(
-          vkDescSets.data(), static_cast<uint32_t>( vkDescSets.size() ) );
+      // The descriptor sets are reclaimed with their page
+      _releaseDescPages();
+      _releaseUsedResources();
 
       // Clearing accumulated framebuffers
       for( const auto& framebuffer : m_curFramebuffers )
@@ -80,28 +72,42 @@ void CommandBuffer::release()
       }
       m_curFramebuffers.clear();
 
-      m_descSets.clear();
-
       m_semsToWait.clear();
       m_semsToSignal.clear();
+      m_timelinesToWait.clear();
+      m_dependents.clear();
+      m_pendingDependencies = 0;
+      m_submitValue         = 0;
+
+      _abandonOwnershipTransfers();
 
       m_boundPip.reset();
       m_boundPipInfo.reset();
       m_boundPipLayout.reset();
       m_boundRenderPass.reset();
+      m_vertexStreaming = false;
+      m_indexStreaming  = false;
+
+      // A list can be released without ever being recorded, the next user starts clean
+      _clearBindings();
 
       vkDestroyFence( m_pDevice->getVKDevice(), m_vkFence, nullptr );
       vkFreeCommandBuffers(
           m_pDevice->getVKDevice(), m_pPool->getVKCommandPool(), 1, &m_vkCmdBuffer );
 
-      m_defaultSampler = nullptr;
-      m_vkCmdBuffer    = nullptr;
-      m_vkFence        = nullptr;
-      m_pDevice        = nullptr;
-      m_pPool          = nullptr;
+      m_vkCmdBuffer = nullptr;
+      m_vkFence     = nullptr;
+      m_pDevice     = nullptr;
+      m_pPool       = nullptr;
    }
 }
 
+uint32_t CommandBuffer::getFamilyIndex() const { return m_pPool->getFamilyIndex(); }
+
+CYD::QueueUsageFlag CommandBuffer::getQueueType() const { return m_pPool->getType(); }
+
+const VkSemaphore& CommandBuffer::getVKTimeline() const { return m_pPool->getVKTimeline(); }
+
 bool CommandBuffer::isCompleted() const
 {
    return vkGetFenceStatus( m_pDevice->getVKDevice(), m_vkFence ) == VK_SUCCESS;
@@ -137,9 +143,15 @@ void CommandBuffer::endRecording()
    m_boundPip        = std::nullopt;
    m_boundPipLayout  = std::nullopt;
    m_boundRenderPass = std::nullopt;
+   m_vertexStreaming = false;
+   m_indexStreaming  = false;
 
    m_boundPipInfo.reset();
 
+   // Resources can be bound before recording starts, they are only forgotten once it is over. The
+   // sets could also belong to a descriptor pool page that is reset before the next recording.
+   _clearBindings();
+
    m_isRecording = false;
 }
 
@@ -149,14 +161,118 @@ void CommandBuffer::reset()
        !m_isRecording && "CommandBuffer: Cannot reset, command buffer is in recording state" );
 
    vkResetCommandBuffer( m_vkCmdBuffer, {} );
+   vkResetFences( m_pDevice->getVKDevice(), 1, &m_vkFence );
+   m_wasSubmitted = false;
+
+   _abandonOwnershipTransfers();
+   _releaseDescPages();
+   _releaseUsedResources();
+}
+
+void CommandBuffer::releaseUsedResources()
+{
+   if( ( m_usedBuffers.empty() && m_usedTextures.empty() ) || !m_wasSubmitted || !isCompleted() )
+   {
+      return;
+   }
+
+   _releaseUsedResources();
+}
+
+void CommandBuffer::_clearBindings()
+{
+   m_boundSets.fill( nullptr );
+   for( std::vector<BoundResource>& resources : m_boundResources )
+   {
+      resources.clear();
+   }
+   m_dirtySets = 0;
+}
+
+void CommandBuffer::_use( Buffer* buffer )
+{
+   buffer->incUse();
+   m_usedBuffers.push_back( buffer );
+}
+
+void CommandBuffer::_use( Texture* texture )
+{
+   texture->incUse();
+   m_usedTextures.push_back( texture );
+}
+
+void CommandBuffer::_releaseUsedResources()
+{
+   for( Buffer* buffer : m_usedBuffers )
+   {
+      buffer->decUse();
+   }
+   for( Texture* texture : m_usedTextures )
+   {
+      texture->decUse();
+   }
+
+   m_usedBuffers.clear();
+   m_usedTextures.clear();
+}
+
+void CommandBuffer::syncOnCommandBuffer( CommandBuffer* other )
+{
+   CYDASSERT( other != this && "CommandBuffer: Cannot sync on itself" );
+
+   if( other->wasSubmitted() )
+   {
+      syncOnTimeline( other->getVKTimeline(), other->m_submitValue );
+   }
+   else
+   {
+      // Resolved when the other command buffer is submitted
+      other->m_dependents.push_back( this );
+      m_pendingDependencies++;
+   }
+}
+
+void CommandBuffer::syncOnTimeline( VkSemaphore vkTimeline, uint64_t value )
+{
+   m_timelinesToWait.push_back( { vkTimeline, value } );
+}
+
+void CommandBuffer::takeOwnership( Texture* texture )
+{
+   const uint32_t familyIndex = getFamilyIndex();
+   const uint32_t ownerFamily = texture->getOwnerFamily();
+   if( ownerFamily == familyIndex )
+   {
+      return;
+   }
+
+   // An image that was never transitioned has no content worth preserving
+   const bool hasContent = ownerFamily != Texture::NO_OWNER_FAMILY &&
+                           texture->getLayout() != CYD::ImageLayout::UNKNOWN;
 
-   // Clearing tracked descriptor sets
-   for( const auto& descSetInfo : m_descSets )
+   m_ownershipTransfers.push_back(
+       { ownerFamily, texture, nullptr, texture->getLayout(), hasContent } );
+   texture->incUse();
+
+   texture->setOwnerFamily( familyIndex );
+}
+
+void CommandBuffer::takeOwnership( Buffer* buffer )
+{
+   const uint32_t familyIndex = getFamilyIndex();
+   const uint32_t ownerFamily = buffer->getOwnerFamily();
+   if( ownerFamily == familyIndex )
    {
-      m_pDevice->getDescriptorPool().free( descSetInfo.vkDescSet );
+      return;
    }
 
-   m_descSets.clear();
+   const bool hasContent = ownerFamily != Buffer::NO_OWNER_FAMILY;
+
+   m_ownershipTransfers.push_back(
+       { ownerFamily, nullptr, buffer, CYD::ImageLayout::UNKNOWN, hasContent } );
+   buffer->incUse();
+
+   buffer->setOwnerFamily( familyIndex );
 }
 
 void CommandBuffer::updatePushConstants( const CYD::PushConstantRange& range, const void* pData )
@@ -188,11 +304,21 @@ void CommandBuffer::bindPipeline( const CYD::GraphicsPipelineInfo& info )
        "CommandBuffer: Could not find or create pipeline in pipeline stash" );
 
    vkCmdBindPipeline( m_vkCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline );
+   m_dirtySets      = ~0U;  // Every set has to be bound again for the new layout
    m_boundPip       = pipeline;
    m_boundPipLayout = pipLayout;
    m_boundPipInfo   = std::make_unique<CYD::GraphicsPipelineInfo>( info );
 }
 
+bool CommandBuffer::isPipelineReady( const CYD::GraphicsPipelineInfo& info ) const
+{
+   CYDASSERT(
+       m_boundRenderPass.has_value() &&
+       "CommandBuffer: Pipeline readiness depends on the render pass, begin one first" );
+
+   return m_pDevice->getPipelineStash().isReady( info, m_boundRenderPass.value() );
+}
+
 void CommandBuffer::bindPipeline( const CYD::ComputePipelineInfo& info )
 {
    VkPipeline pipeline = m_pDevice->getPipelineStash().findOrCreate( info );
@@ -204,60 +330,89 @@ void CommandBuffer::bindPipeline( const CYD::ComputePipelineInfo& info )
        "CommandBuffer: Could not find or create pipeline in pipeline stash" );
 
    vkCmdBindPipeline( m_vkCmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline );
+   m_dirtySets      = ~0U;  // Every set has to be bound again for the new layout
    m_boundPip       = pipeline;
    m_boundPipLayout = pipLayout;
    m_boundPipInfo   = std::make_unique<CYD::ComputePipelineInfo>( info );
 }
 
-void CommandBuffer::bindVertexBuffer( Buffer* vertexBuffer ) const
+void CommandBuffer::bindVertexBuffer( Buffer* vertexBuffer )
 {
+   takeOwnership( vertexBuffer );
+
    VkBuffer vertexBuffers[] = { vertexBuffer->getVKBuffer() };
    VkDeviceSize offsets[]   = { 0 };
    vkCmdBindVertexBuffers( m_vkCmdBuffer, 0, 1, vertexBuffers, offsets );
 
-   vertexBuffer->incUse();
+   m_vertexStreaming = vertexBuffer->isStreaming();
+
+   _use( vertexBuffer );
 }
 
-void CommandBuffer::bindIndexBuffer( Buffer* indexBuffer, CYD::IndexType type ) const
+void CommandBuffer::bindIndexBuffer( Buffer* indexBuffer, CYD::IndexType type )
 {
+   takeOwnership( indexBuffer );
+
    vkCmdBindIndexBuffer(
        m_vkCmdBuffer, indexBuffer->getVKBuffer(), 0, TypeConversions::cydToVkIndexType( type ) );
 
-   indexBuffer->incUse();
+   m_indexStreaming = indexBuffer->isStreaming();
+
+   _use( indexBuffer );
 }
 
 void CommandBuffer::bindBuffer( Buffer* buffer, uint32_t set, uint32_t binding )
 {
+   takeOwnership( buffer );
+
    // Will need to update this buffer's descriptor set before next draw
-   m_buffersToUpdate.emplace_back( buffer, CYD::ShaderResourceType::STORAGE, set, binding );
+   _bindResource( set, binding, CYD::ShaderResourceType::STORAGE, { buffer, nullptr, nullptr } );
 
-   buffer->incUse();
+   _use( buffer );
 }
 
 void CommandBuffer::bindUniformBuffer( Buffer* buffer, uint32_t set, uint32_t binding )
 {
+   takeOwnership( buffer );
+
    // Will need to update this buffer's descriptor set before next draw
-   m_buffersToUpdate.emplace_back( buffer, CYD::ShaderResourceType::UNIFORM, set, binding );
+   _bindResource( set, binding, CYD::ShaderResourceType::UNIFORM, { buffer, nullptr, nullptr } );
 
-   buffer->incUse();
+   _use( buffer );
 }
 
 void CommandBuffer::bindTexture( Texture* texture, uint32_t set, uint32_t binding )
 {
+   // The content of a texture still being streamed in is not there yet
+   if( Texture* standIn = texture->getStandIn() )
+   {
+      texture = standIn;
+   }
+
+   takeOwnership( texture );
+
+   const VkSampler sampler = m_pDevice->getSamplerStash().getDefault( texture->getMipLevels() );
+
    // Will need to update this texture's descriptor set before next draw
-   m_texturesToUpdate.emplace_back(
-       texture, CYD::ShaderResourceType::COMBINED_IMAGE_SAMPLER, set, binding );
+   _bindResource(
+       set,
+       binding,
+       CYD::ShaderResourceType::COMBINED_IMAGE_SAMPLER,
+       { nullptr, texture, sampler } );
 
-   texture->incUse();
+   _use( texture );
 }
 
 void CommandBuffer::bindImage( Texture* texture, uint32_t set, uint32_t binding )
 {
+   takeOwnership( texture );
+
    // Will need to update this image descriptor set before next draw
-   m_texturesToUpdate.emplace_back( texture, CYD::ShaderResourceType::STORAGE_IMAGE, set, binding );
+   _bindResource(
+       set, binding, CYD::ShaderResourceType::STORAGE_IMAGE, { nullptr, texture, nullptr } );
 
    // TODO Eventually we will need more info when binding an image (level for mipmaps for example)
-   texture->incUse();
+   _use( texture );
 }
 
 void CommandBuffer::setViewport( const CYD::Viewport& viewport ) const
@@ -288,8 +443,12 @@ void CommandBuffer::beginPass( Swapchain& swapchain, bool hasDepth )
 
    m_boundRenderPass = renderPass;
 
-   m_semsToWait.push_back( swapchain.getSemToWait() );
-   m_semsToSignal.push_back( swapchain.getSemToSignal() );
+   // Offscreen swapchains do not go through the presentation engine, there is nothing to wait on
+   if( !swapchain.isOffscreen() )
+   {
+      m_semsToWait.push_back( swapchain.getSemToWait() );
+      m_semsToSignal.push_back( swapchain.getSemToSignal() );
+   }
 
    VkRenderPassBeginInfo passBeginInfo = {};
    passBeginInfo.sType                 = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -370,100 +529,134 @@ void CommandBuffer::beginPass(
    vkCmdBeginRenderPass( m_vkCmdBuffer, &passBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
 }
 
-VkDescriptorSet CommandBuffer::_findOrAllocateDescSet( size_t prevSize, uint32_t set )
+void CommandBuffer::_bindResource(
+    uint32_t set,
+    uint32_t binding,
+    CYD::ShaderResourceType type,
+    const DescriptorPool::Binding& resource )
 {
-   for( auto it = m_descSets.begin() + prevSize; it != m_descSets.end(); ++it )
+   CYDASSERT( set < MAX_BOUND_DESCRIPTOR_SETS && "CommandBuffer: Set index out of range" );
+
+   m_dirtySets |= 1 << set;
+
+   for( BoundResource& bound : m_boundResources[set] )
    {
-      if( it->set == set )
+      if( bound.binding == binding )
       {
-         // This set has already been created during this draw scope, just return it
-         return it->vkDescSet;
+         bound.type     = type;
+         bound.resource = resource;
+         return;
       }
    }
 
-   // Adding this descriptor set to the list of all tracked descriptor set in this command buffer
-   const VkDescriptorSet vkDescSet =
-       m_pDevice->getDescriptorPool().allocate( m_boundPipInfo->pipLayout.descSets[set] );
-
-   m_descSets.push_back( { set, vkDescSet } );
+   m_boundResources[set].push_back( { binding, type, resource } );
+}
 
-   m_boundSets[set] = vkDescSet;
-   return vkDescSet;
+void CommandBuffer::_retainDescPage( uint32_t pageIdx )
+{
+   if( std::find( m_descPages.begin(), m_descPages.end(), pageIdx ) == m_descPages.end() )
+   {
+      m_pDevice->getDescriptorPool().retainPage( pageIdx );
+      m_descPages.push_back( pageIdx );
+   }
 }
 
-void CommandBuffer::_prepareDescriptorSets( CYD::PipelineType pipType )
+void CommandBuffer::_releaseDescPages()
 {
-   // We do not care about any of the descriptor sets before this index
-   const size_t prevSize = m_descSets.size();
+   for( const uint32_t pageIdx : m_descPages )
+   {
+      m_pDevice->getDescriptorPool().releasePage( pageIdx );
+   }
+   m_descPages.clear();
+}
 
-   // Creating write descriptors for resources we want to update for this draw
-   const size_t totalSize = m_buffersToUpdate.size() + m_texturesToUpdate.size();
+static bool isBindlessSet( const CYD::DescriptorSetLayoutInfo& layout )
+{
+   return std::any_of(
+       layout.shaderResources.begin(),
+       layout.shaderResources.end(),
+       []( const CYD::ShaderResourceInfo& resource ) {
+          return resource.type == CYD::ShaderResourceType::BINDLESS_TEXTURES;
+       } );
+}
 
-   // New descriptor sets that need to be allocated for this draw call
-   std::vector<VkDescriptorBufferInfo> bufferInfos;
-   std::vector<VkDescriptorImageInfo> imageInfos;
-   std::vector<VkWriteDescriptorSet> writeDescSets;
-   bufferInfos.reserve( totalSize );
-   imageInfos.reserve( totalSize );
-   writeDescSets.reserve( totalSize );
+void CommandBuffer::_bindBindlessTable( uint32_t set )
+{
+   BindlessTable* bindless = m_pDevice->getBindlessTable();
+   CYDASSERT( bindless && "CommandBuffer: Bindless set used without a bindless table" );
 
-   for( const auto& entry : m_buffersToUpdate )
+   // Any texture of the table can be sampled, they all have to belong to this queue family.
+   // Textures still being streamed in are sampled through their stand-in's slot instead, they stay
+   // with the queue that is copying to them.
+   for( Texture* texture : bindless->getTextures() )
    {
-      VkDescriptorBufferInfo bufferInfo;
-      bufferInfo.buffer = entry.buffer->getVKBuffer();
-      bufferInfo.offset = 0;
-      bufferInfo.range  = entry.buffer->getSize();
-      bufferInfos.push_back( bufferInfo );
+      if( texture && !texture->getStandIn() )
+      {
+         takeOwnership( texture );
+      }
+   }
 
-      VkWriteDescriptorSet descriptorWrite = {};
-      descriptorWrite.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descriptorWrite.dstSet               = _findOrAllocateDescSet( prevSize, entry.set );
-      descriptorWrite.dstBinding           = entry.binding;
-      descriptorWrite.dstArrayElement      = 0;
-      descriptorWrite.descriptorType       = TypeConversions::cydToVkDescriptorType( entry.type );
-      descriptorWrite.descriptorCount      = 1;
-      descriptorWrite.pBufferInfo          = &bufferInfos.back();
+   m_boundSets[set] = bindless->getVKDescSet();
+}
 
-      writeDescSets.push_back( descriptorWrite );
+void CommandBuffer::_prepareDescriptorSets( CYD::PipelineType pipType )
+{
+   if( !m_dirtySets )
+   {
+      // Same resources and same layout as the previous draw, everything is still bound
+      return;
    }
 
-   for( const auto& entry : m_texturesToUpdate )
+   DescriptorPool& descPool = m_pDevice->getDescriptorPool();
+
+   const auto& descSets = m_boundPipInfo->pipLayout.descSets;
+   for( uint32_t set = 0; set < descSets.size(); ++set )
    {
-      VkDescriptorImageInfo imageInfo = {};
+      if( !( m_dirtySets & ( 1 << set ) ) )
+      {
+         continue;
+      }
 
-      // Determine layout based on descriptor type
-      switch( entry.type )
+      if( isBindlessSet( descSets[set] ) )
       {
-         case CYD::ShaderResourceType::COMBINED_IMAGE_SAMPLER:
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            break;
-         default:  // Includes images which need to be in general layout for load/store operations
-            imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+         // Nothing is bound to this set, the shaders index the bindless table directly
+         _bindBindlessTable( set );
+         continue;
       }
 
-      imageInfo.imageView = entry.texture->getVKImageView();
-      imageInfo.sampler   = m_defaultSampler;
-      imageInfos.push_back( imageInfo );
+      // Lining up the bound resources with the shader resources of the layout
+      const auto& shaderResources = descSets[set].shaderResources;
+      m_setBindings.assign( shaderResources.size(), {} );
 
-      VkWriteDescriptorSet descriptorWrite = {};
-      descriptorWrite.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      descriptorWrite.dstSet               = _findOrAllocateDescSet( prevSize, entry.set );
-      descriptorWrite.dstBinding           = entry.binding;
-      descriptorWrite.dstArrayElement      = 0;
-      descriptorWrite.descriptorType       = TypeConversions::cydToVkDescriptorType( entry.type );
-      descriptorWrite.descriptorCount      = 1;
-      descriptorWrite.pImageInfo           = &imageInfos.back();
+      bool hasResources = false;
+      for( size_t i = 0; i < shaderResources.size(); ++i )
+      {
+         for( const BoundResource& bound : m_boundResources[set] )
+         {
+            if( bound.binding == shaderResources[i].binding &&
+                bound.type == shaderResources[i].type )
+            {
+               m_setBindings[i] = bound.resource;
+               hasResources     = true;
+               break;
+            }
+         }
+      }
 
-      writeDescSets.push_back( descriptorWrite );
+      if( hasResources )
+      {
+         uint32_t pageIdx = 0;
+         m_boundSets[set] = descPool.findOrAllocate( descSets[set], m_setBindings.data(), pageIdx );
+         _retainDescPage( pageIdx );
+      }
+      else
+      {
+         // Whatever was bound to this set before does not match the layout anymore
+         m_boundSets[set] = nullptr;
+      }
    }
 
-   // Updating the descriptor sets for this draw
-   vkUpdateDescriptorSets(
-       m_pDevice->getVKDevice(),
-       static_cast<uint32_t>( writeDescSets.size() ),
-       writeDescSets.data(),
-       0,
-       nullptr );
+   m_dirtySets = 0;
 
    // Binding the descriptor sets we want for this draw (expensive apparently)
    VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
@@ -479,18 +672,34 @@ void CommandBuffer::_prepareDescriptorSets( CYD::PipelineType pipType )
          CYDASSERT( !"CommandBuffer: Could not determine pipeline bind point for descriptors" );
    }
 
-   vkCmdBindDescriptorSets(
-       m_vkCmdBuffer,
-       bindPoint,
-       m_boundPipLayout.value(),
-       0,
-       static_cast<uint32_t>( m_boundPipInfo->pipLayout.descSets.size() ),  // Must be this
-       m_boundSets.data(),
-       0,
-       nullptr );
+   // Null handles cannot be bound, the sets are bound in runs that skip the sets without resources
+   const uint32_t setCount = static_cast<uint32_t>( descSets.size() );
+   for( uint32_t first = 0; first < setCount; )
+   {
+      if( !m_boundSets[first] )
+      {
+         ++first;
+         continue;
+      }
 
-   m_buffersToUpdate.clear();
-   m_texturesToUpdate.clear();
+      uint32_t last = first;
+      while( last < setCount && m_boundSets[last] )
+      {
+         ++last;
+      }
+
+      vkCmdBindDescriptorSets(
+          m_vkCmdBuffer,
+          bindPoint,
+          m_boundPipLayout.value(),
+          first,
+          last - first,
+          &m_boundSets[first],
+          0,
+          nullptr );
+
+      first = last;
+   }
 }
 
 void CommandBuffer::draw( size_t vertexCount )
@@ -503,12 +712,18 @@ void CommandBuffer::draw( size_t vertexCount )
        m_boundPip && m_boundPipInfo && ( m_boundPipInfo->type == CYD::PipelineType::GRAPHICS ) &&
        "CommandBuffer: Cannot draw because no pipeline was bound" );
 
+   // The vertices are not there yet, the mesh shows up once they are
+   if( m_vertexStreaming )
+   {
+      return;
+   }
+
    _prepareDescriptorSets( CYD::PipelineType::GRAPHICS );
 
    vkCmdDraw( m_vkCmdBuffer, static_cast<uint32_t>( vertexCount ), 1, 0, 0 );
 }
 
-void CommandBuffer::drawIndexed( size_t indexCount )
+void CommandBuffer::drawIndexed( size_t indexCount, size_t firstIndex )
 {
    CYDASSERT(
        m_usage & CYD::QueueUsage::GRAPHICS &&
@@ -518,9 +733,20 @@ void CommandBuffer::drawIndexed( size_t indexCount )
        m_boundPip && m_boundPipInfo && ( m_boundPipInfo->type == CYD::PipelineType::GRAPHICS ) &&
        "CommandBuffer: Cannot draw because no pipeline was bound" );
 
+   if( m_vertexStreaming || m_indexStreaming )
+   {
+      return;
+   }
+
    _prepareDescriptorSets( CYD::PipelineType::GRAPHICS );
 
-   vkCmdDrawIndexed( m_vkCmdBuffer, static_cast<uint32_t>( indexCount ), 1, 0, 0, 0 );
+   vkCmdDrawIndexed(
+       m_vkCmdBuffer,
+       static_cast<uint32_t>( indexCount ),
+       1,
+       static_cast<uint32_t>( firstIndex ),
+       0,
+       0 );
 }
 
 void CommandBuffer::dispatch( uint32_t workX, uint32_t workY, uint32_t workZ )
@@ -585,32 +811,321 @@ void CommandBuffer::uploadBufferToTex( const Buffer* src, Texture* dst ) const
        &region );
 }
 
-void CommandBuffer::submit()
+void CommandBuffer::copyTexToBuffer( const Texture* src, const Buffer* dst ) const
 {
-   VkSubmitInfo submitInfo       = {};
-   submitInfo.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-   submitInfo.commandBufferCount = 1;
-   submitInfo.pCommandBuffers    = &m_vkCmdBuffer;
+   CYDASSERT(
+       src->getSize() <= dst->getSize() &&
+       "CommandBuffer: Destination buffer is too small for the texture" );
+
+   // Texture is expected to be in transfer source layout
+   VkBufferImageCopy region               = {};
+   region.bufferOffset                    = 0;
+   region.bufferRowLength                 = 0;
+   region.bufferImageHeight               = 0;
+   region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+   region.imageSubresource.mipLevel       = 0;
+   region.imageSubresource.baseArrayLayer = 0;
+   region.imageSubresource.layerCount     = src->getLayers();
+   region.imageOffset                     = {0, 0, 0};
+   region.imageExtent                     = {src->getWidth(), src->getHeight(), 1};
+
+   vkCmdCopyImageToBuffer(
+       m_vkCmdBuffer,
+       src->getVKImage(),
+       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+       dst->getVKBuffer(),
+       1,
+       &region );
+}
+
+void CommandBuffer::readbackTexture( Texture* src, Buffer* dst )
+{
+   takeOwnership( dst );
+
+   const CYD::ImageLayout layout = src->getLayout();
+
+   Barriers::ImageMemory( this, src, CYD::ImageLayout::TRANSFER_SRC );
+   copyTexToBuffer( src, dst );
+   Barriers::ImageMemory( this, src, layout );
+   Barriers::HostRead( this, dst );
+
+   // The buffer is only readable once it is not in use anymore
+   _use( src );
+   _use( dst );
+}
+
+void CommandBuffer::generateMips( Texture* texture )
+{
+   CYDASSERT(
+       ( getQueueType() & CYD::QueueUsage::GRAPHICS ) &&
+       "CommandBuffer: Generating mips requires a graphics queue" );
+   CYDASSERT(
+       texture->getLayout() == CYD::ImageLayout::TRANSFER_DST &&
+       "CommandBuffer: Texture must be in transfer destination layout to generate mips" );
+
+   takeOwnership( texture );
+
+   const VkFormat vkFormat = TypeConversions::cydToVkFormat( texture->getFormat() );
+
+   VkFormatProperties formatProps;
+   vkGetPhysicalDeviceFormatProperties( m_pDevice->getPhysicalDevice(), vkFormat, &formatProps );
+
+   CYDASSERT(
+       ( formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT ) &&
+       ( formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT ) &&
+       "CommandBuffer: Texture format does not support blits" );
+
+   // Falling back to nearest filtering on formats that cannot be linearly filtered
+   const VkFilter filter =
+       ( formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT )
+           ? VK_FILTER_LINEAR
+           : VK_FILTER_NEAREST;
+
+   // Each level is read from once it has been written to
+   VkImageMemoryBarrier barrier            = {};
+   barrier.sType                           = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+   barrier.oldLayout                       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+   barrier.newLayout                       = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+   barrier.srcAccessMask                   = VK_ACCESS_TRANSFER_WRITE_BIT;
+   barrier.dstAccessMask                   = VK_ACCESS_TRANSFER_READ_BIT;
+   barrier.srcQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+   barrier.dstQueueFamilyIndex             = VK_QUEUE_FAMILY_IGNORED;
+   barrier.image                           = texture->getVKImage();
+   barrier.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+   barrier.subresourceRange.levelCount     = 1;
+   barrier.subresourceRange.baseArrayLayer = 0;
+   barrier.subresourceRange.layerCount     = texture->getLayers();
+
+   int32_t mipWidth  = static_cast<int32_t>( texture->getWidth() );
+   int32_t mipHeight = static_cast<int32_t>( texture->getHeight() );
+
+   for( uint32_t level = 0; level < texture->getMipLevels(); ++level )
+   {
+      barrier.subresourceRange.baseMipLevel = level;
+
+      vkCmdPipelineBarrier(
+          m_vkCmdBuffer,
+          VK_PIPELINE_STAGE_TRANSFER_BIT,
+          VK_PIPELINE_STAGE_TRANSFER_BIT,
+          0,
+          0,
+          nullptr,
+          0,
+          nullptr,
+          1,
+          &barrier );
+
+      if( level + 1 == texture->getMipLevels() )
+      {
+         break;
+      }
+
+      const int32_t nextWidth  = std::max( mipWidth / 2, 1 );
+      const int32_t nextHeight = std::max( mipHeight / 2, 1 );
+
+      VkImageBlit blit                   = {};
+      blit.srcOffsets[0]                 = { 0, 0, 0 };
+      blit.srcOffsets[1]                 = { mipWidth, mipHeight, 1 };
+      blit.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+      blit.srcSubresource.mipLevel       = level;
+      blit.srcSubresource.baseArrayLayer = 0;
+      blit.srcSubresource.layerCount     = texture->getLayers();
+      blit.dstOffsets[0]                 = { 0, 0, 0 };
+      blit.dstOffsets[1]                 = { nextWidth, nextHeight, 1 };
+      blit.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+      blit.dstSubresource.mipLevel       = level + 1;
+      blit.dstSubresource.baseArrayLayer = 0;
+      blit.dstSubresource.layerCount     = texture->getLayers();
+
+      vkCmdBlitImage(
+          m_vkCmdBuffer,
+          texture->getVKImage(),
+          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+          texture->getVKImage(),
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          1,
+          &blit,
+          filter );
+
+      mipWidth  = nextWidth;
+      mipHeight = nextHeight;
+   }
+
+   texture->setLayout( CYD::ImageLayout::TRANSFER_SRC );
 
+   _use( texture );
+}
+
+static VkPipelineStageFlags getWaitStages( CYD::QueueUsageFlag usage )
+{
    VkPipelineStageFlags waitStages = 0;
-   if( m_usage & CYD::QueueUsage::GRAPHICS )
+   if( usage & CYD::QueueUsage::GRAPHICS )
    {
       waitStages |= VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
    }
-   if( m_usage & CYD::QueueUsage::TRANSFER )
+   if( usage & CYD::QueueUsage::TRANSFER )
    {
       waitStages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
    }
-   if( m_usage & CYD::QueueUsage::COMPUTE )
+   if( usage & CYD::QueueUsage::COMPUTE )
    {
       waitStages |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
    }
+   return waitStages;
+}
 
-   submitInfo.waitSemaphoreCount   = static_cast<uint32_t>( m_semsToWait.size() );
-   submitInfo.pWaitSemaphores      = m_semsToWait.data();
-   submitInfo.pWaitDstStageMask    = &waitStages;
-   submitInfo.signalSemaphoreCount = static_cast<uint32_t>( m_semsToSignal.size() );
-   submitInfo.pSignalSemaphores    = m_semsToSignal.data();
+void CommandBuffer::_abandonOwnershipTransfers()
+{
+   const uint32_t familyIndex = getFamilyIndex();
+
+   // Never submitted, the resources go back to their previous owner unless another command buffer
+   // took them since
+   for( const OwnershipTransfer& transfer : m_ownershipTransfers )
+   {
+      if( transfer.texture )
+      {
+         if( transfer.texture->getOwnerFamily() == familyIndex )
+         {
+            transfer.texture->setOwnerFamily( transfer.srcFamily );
+         }
+         transfer.texture->decUse();
+      }
+      else
+      {
+         if( transfer.buffer->getOwnerFamily() == familyIndex )
+         {
+            transfer.buffer->setOwnerFamily( transfer.srcFamily );
+         }
+         transfer.buffer->decUse();
+      }
+   }
+
+   m_ownershipTransfers.clear();
+}
+
+void CommandBuffer::_submitOwnershipTransfers()
+{
+   // Resources without content are simply used by this family from now on
+   const auto noBarrier = std::partition(
+       m_ownershipTransfers.begin(),
+       m_ownershipTransfers.end(),
+       []( const OwnershipTransfer& transfer ) { return transfer.hasContent; } );
+
+   for( auto it = noBarrier; it != m_ownershipTransfers.end(); ++it )
+   {
+      it->texture ? it->texture->decUse() : it->buffer->decUse();
+   }
+   m_ownershipTransfers.erase( noBarrier, m_ownershipTransfers.end() );
+
+   if( m_ownershipTransfers.empty() )
+   {
+      return;
+   }
+
+   const uint32_t familyIndex = getFamilyIndex();
+
+   // The acquire halves go in their own command buffer since this one could have been in a render
+   // pass when the resources were bound. Submitted first on the same queue, it executes before.
+   CommandBuffer* acquireCmd = m_pPool->createCommandBuffer( m_pPool->getType() );
+   acquireCmd->startRecording();
+
+   std::sort(
+       m_ownershipTransfers.begin(),
+       m_ownershipTransfers.end(),
+       []( const OwnershipTransfer& a, const OwnershipTransfer& b ) {
+          return a.srcFamily < b.srcFamily;
+       } );
+
+   auto groupBegin = m_ownershipTransfers.begin();
+   while( groupBegin != m_ownershipTransfers.end() )
+   {
+      const uint32_t srcFamily = groupBegin->srcFamily;
+      const auto groupEnd      = std::find_if(
+          groupBegin, m_ownershipTransfers.end(), [srcFamily]( const OwnershipTransfer& t ) {
+             return t.srcFamily != srcFamily;
+          } );
+
+      // The release halves are executed after everything already submitted to the source family
+      CommandPool& srcPool      = m_pDevice->getCommandPool( srcFamily );
+      CommandBuffer* releaseCmd = srcPool.createCommandBuffer( srcPool.getType() );
+      releaseCmd->startRecording();
+
+      for( auto it = groupBegin; it != groupEnd; ++it )
+      {
+         for( const CommandBuffer* cmdBuffer : { releaseCmd, acquireCmd } )
+         {
+            if( it->texture )
+            {
+               Barriers::ImageOwnership(
+                   cmdBuffer, it->texture, it->layout, srcFamily, familyIndex );
+            }
+            else
+            {
+               Barriers::BufferOwnership( cmdBuffer, it->buffer, srcFamily, familyIndex );
+            }
+         }
+
+         it->texture ? it->texture->decUse() : it->buffer->decUse();
+      }
+
+      releaseCmd->endRecording();
+      releaseCmd->submit();
+
+      acquireCmd->syncOnCommandBuffer( releaseCmd );
+
+      groupBegin = groupEnd;
+   }
+
+   m_ownershipTransfers.clear();
+
+   acquireCmd->endRecording();
+   acquireCmd->submit();
+}
+
+void CommandBuffer::submit()
+{
+   CYDASSERT(
+       m_pendingDependencies == 0 &&
+       "CommandBuffer: Submitting before a command buffer this one syncs on" );
+
+   _submitOwnershipTransfers();
+
+   const VkPipelineStageFlags waitStages = getWaitStages( m_usage );
+
+   // Binary semaphores (swapchain) ignore their value in the timeline submit info
+   std::vector<VkSemaphore> waitSems = m_semsToWait;
+   std::vector<uint64_t> waitValues( m_semsToWait.size(), 0 );
+   for( const TimelineWait& wait : m_timelinesToWait )
+   {
+      waitSems.push_back( wait.vkTimeline );
+      waitValues.push_back( wait.value );
+   }
+   const std::vector<VkPipelineStageFlags> waitStageMasks( waitSems.size(), waitStages );
+
+   m_submitValue = m_pPool->nextTimelineValue();
+
+   std::vector<VkSemaphore> signalSems = m_semsToSignal;
+   std::vector<uint64_t> signalValues( m_semsToSignal.size(), 0 );
+   signalSems.push_back( m_pPool->getVKTimeline() );
+   signalValues.push_back( m_submitValue );
+
+   VkTimelineSemaphoreSubmitInfoKHR timelineInfo = {};
+   timelineInfo.sType                            = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+   timelineInfo.waitSemaphoreValueCount          = static_cast<uint32_t>( waitValues.size() );
+   timelineInfo.pWaitSemaphoreValues             = waitValues.data();
+   timelineInfo.signalSemaphoreValueCount        = static_cast<uint32_t>( signalValues.size() );
+   timelineInfo.pSignalSemaphoreValues           = signalValues.data();
+
+   VkSubmitInfo submitInfo         = {};
+   submitInfo.sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+   submitInfo.pNext                = &timelineInfo;
+   submitInfo.commandBufferCount   = 1;
+   submitInfo.pCommandBuffers      = &m_vkCmdBuffer;
+   submitInfo.waitSemaphoreCount   = static_cast<uint32_t>( waitSems.size() );
+   submitInfo.pWaitSemaphores      = waitSems.data();
+   submitInfo.pWaitDstStageMask    = waitStageMasks.data();
+   submitInfo.signalSemaphoreCount = static_cast<uint32_t>( signalSems.size() );
+   submitInfo.pSignalSemaphores    = signalSems.data();
 
    const VkQueue* queue = m_pDevice->getQueueFromFamily( m_pPool->getFamilyIndex() );
    CYDASSERT( queue && "CommandBuffer: Could not find queue to submit to" );
@@ -618,7 +1133,15 @@ void CommandBuffer::submit()
    vkQueueSubmit( *queue, 1, &submitInfo, m_vkFence );
    m_wasSubmitted = true;
 
+   for( CommandBuffer* dependent : m_dependents )
+   {
+      dependent->m_timelinesToWait.push_back( { m_pPool->getVKTimeline(), m_submitValue } );
+      dependent->m_pendingDependencies--;
+   }
+   m_dependents.clear();
+
    m_semsToWait.clear();
    m_semsToSignal.clear();
+   m_timelinesToWait.clear();
 }
 }
@@ -3,6 +3,7 @@
 #include <Common/Include.h>
 
 #include <Graphics/GraphicsTypes.h>
+#include <Graphics/Vulkan/DescriptorPool.h>
 
 #include <array>
 #include <memory>
@@ -19,7 +20,6 @@ FWDHANDLE( VkPipelineLayout );
 FWDHANDLE( VkRenderPass );
 FWDHANDLE( VkDescriptorSet );
 FWDHANDLE( VkFramebuffer );
-FWDHANDLE( VkSampler );
 
 namespace vk
 {
@@ -51,13 +51,23 @@ class CommandBuffer final
 
    // Allocation and Deallocation
    // =============================================================================================
-   void acquire( const Device& device, const CommandPool& pool, CYD::QueueUsageFlag usage );
+   void acquire( const Device& device, CommandPool& pool, CYD::QueueUsageFlag usage );
    void release();
 
+   // Gives back the buffers and textures used by the recorded commands once they have executed.
+   // The command buffer itself stays valid until it is released.
+   void releaseUsedResources();
+
    // Getters
    // =============================================================================================
    const VkCommandBuffer& getVKBuffer() const { return m_vkCmdBuffer; }
    const VkFence& getVKFence() const { return m_vkFence; }
+   uint32_t getFamilyIndex() const;
+   CYD::QueueUsageFlag getQueueType() const;
+
+   // Value the timeline semaphore of this command buffer's family is signaled with on completion
+   const VkSemaphore& getVKTimeline() const;
+   uint64_t getSubmitValue() const noexcept { return m_submitValue; }
 
    // Status
    // =============================================================================================
@@ -72,10 +82,28 @@ class CommandBuffer final
    void submit();
    void reset();
 
+   // Synchronization
+   // =============================================================================================
+   // This command buffer will not start executing before the other one has completed. If the other
+   // command buffer is not submitted yet, it has to be before this one is.
+   void syncOnCommandBuffer( CommandBuffer* other );
+
+   // Same wait on the timeline value of a command buffer that was submitted, it stays valid once
+   // that command buffer is recycled
+   void syncOnTimeline( VkSemaphore vkTimeline, uint64_t value );
+
+   // Exclusive resources last used on another queue family are transferred to this command
+   // buffer's family. The transfer is submitted right before this command buffer, which means the
+   // command buffers that last used them on the other family must already have been submitted.
+   // Resources go back to their previous owner if this command buffer is released or reset
+   // without being submitted.
+   void takeOwnership( Texture* texture );
+   void takeOwnership( Buffer* buffer );
+
    // Bindings
    // =============================================================================================
-   void bindVertexBuffer( Buffer* vertexBuf ) const;
-   void bindIndexBuffer( Buffer* indexBuf, CYD::IndexType type ) const;
+   void bindVertexBuffer( Buffer* vertexBuf );
+   void bindIndexBuffer( Buffer* indexBuf, CYD::IndexType type );
    void bindPipeline( const CYD::GraphicsPipelineInfo& info );
    void bindPipeline( const CYD::ComputePipelineInfo& info );
    void bindBuffer( Buffer* buffer, uint32_t set, uint32_t binding );
@@ -84,6 +112,9 @@ class CommandBuffer final
    void bindImage( Texture* texture, uint32_t set, uint32_t binding );
    void updatePushConstants( const CYD::PushConstantRange& range, const void* pData );
 
+   // Requests the pipeline for the current render pass, binding it before it is ready stalls
+   bool isPipelineReady( const CYD::GraphicsPipelineInfo& info ) const;
+
    // Render Pass
    // =============================================================================================
    void beginPass( Swapchain& swapchain, bool hasDepth );
@@ -100,7 +131,7 @@ class CommandBuffer final
    // Drawing
    // =============================================================================================
    void draw( size_t vertexCount );
-   void drawIndexed( size_t indexCount );
+   void drawIndexed( size_t indexCount, size_t firstIndex = 0 );
 
    // Compute
    // =============================================================================================
@@ -110,23 +141,51 @@ class CommandBuffer final
    // =============================================================================================
    void copyBuffer( const Buffer* src, const Buffer* dst ) const;
    void uploadBufferToTex( const Buffer* src, Texture* dst ) const;
+   void copyTexToBuffer( const Texture* src, const Buffer* dst ) const;
+
+   // Copies the texture to a host visible buffer the host can read once this command buffer has
+   // completed. The texture is left in the layout it was in.
+   void readbackTexture( Texture* src, Buffer* dst );
+
+   // Fills every mip level from the first one, which is expected to be in transfer destination
+   // layout. All the levels are left in transfer source layout. Needs a graphics queue.
+   void generateMips( Texture* texture );
 
   private:
    // The updating and binding of descriptor sets is deferred all the way until we do a draw call.
-   // We will only update and bind the "new" descriptor sets in Vulkan with the descriptor sets that
-   // were bound to the command buffer since the last draw call. This ensures that we do not create
-   // unnecessary descriptor sets and that we only update and bind what is needed for the next draw.
-   VkDescriptorSet _findOrAllocateDescSet( size_t prevSize, uint32_t set );
+   // Only the sets whose resources changed since the last draw are looked up again, and the
+   // descriptor pool hands back an already written set when the same resources were bound before.
+   void _bindResource(
+       uint32_t set,
+       uint32_t binding,
+       CYD::ShaderResourceType type,
+       const DescriptorPool::Binding& resource );
    void _prepareDescriptorSets( CYD::PipelineType pipType );
+   void _bindBindlessTable( uint32_t set );
+   void _retainDescPage( uint32_t pageIdx );
+   void _releaseDescPages();
+
+   void _submitOwnershipTransfers();
+   void _abandonOwnershipTransfers();
 
-   const Device* m_pDevice    = nullptr;
-   const CommandPool* m_pPool = nullptr;
+   void _clearBindings();
+
+   void _use( Buffer* buffer );
+   void _use( Texture* texture );
+   void _releaseUsedResources();
+
+   const Device* m_pDevice = nullptr;
+   CommandPool* m_pPool    = nullptr;
 
    // Info on the currently bound pipeline
    std::optional<VkPipeline> m_boundPip;
    std::optional<VkPipelineLayout> m_boundPipLayout;
    std::optional<VkRenderPass> m_boundRenderPass;
 
+   // The bound geometry is still being streamed in, draws reading it are skipped
+   bool m_vertexStreaming = false;
+   bool m_indexStreaming  = false;
+
    // To keep in scope for destruction
    std::vector<VkFramebuffer> m_curFramebuffers;
 
@@ -137,60 +196,60 @@ class CommandBuffer final
 
    // Currently bound descriptor sets
    static constexpr uint32_t MAX_BOUND_DESCRIPTOR_SETS = 32;
-   std::array<VkDescriptorSet, MAX_BOUND_DESCRIPTOR_SETS> m_boundSets;
+   std::array<VkDescriptorSet, MAX_BOUND_DESCRIPTOR_SETS> m_boundSets = {};
 
-   // All descriptor sets linked to this command buffer
-   struct DescriptorSetInfo
+   // Resources bound to each set, kept until they are bound over
+   struct BoundResource
    {
-      uint32_t set;
-      VkDescriptorSet vkDescSet;
-   };
-   std::vector<DescriptorSetInfo> m_descSets;
-
-   // Used for deferred updating and binding of descriptor sets before a draw command
-   struct BufferUpdateInfo
-   {
-      BufferUpdateInfo(
-          const Buffer* buffer,
-          CYD::ShaderResourceType type,
-          uint32_t set,
-          uint32_t binding )
-          : buffer( buffer ), type( type ), set( set ), binding( binding )
-      {
-      }
-      const Buffer* buffer;
-      CYD::ShaderResourceType type;
-      uint32_t set;
       uint32_t binding;
-   };
-   std::vector<BufferUpdateInfo> m_buffersToUpdate;
-
-   struct TextureUpdateInfo
-   {
-      TextureUpdateInfo(
-          const Texture* texture,
-          CYD::ShaderResourceType type,
-          uint32_t set,
-          uint32_t binding )
-          : texture( texture ), type( type ), set( set ), binding( binding )
-      {
-      }
-      const Texture* texture;
       CYD::ShaderResourceType type;
-      uint32_t set;
-      uint32_t binding;
+      DescriptorPool::Binding resource;
    };
-   std::vector<TextureUpdateInfo> m_texturesToUpdate;
+   std::array<std::vector<BoundResource>, MAX_BOUND_DESCRIPTOR_SETS> m_boundResources;
+   uint32_t m_dirtySets = 0;
+
+   // Scratch space for the bindings of the set being looked up
+   std::vector<DescriptorPool::Binding> m_setBindings;
+
+   // Descriptor pool pages holding the sets used by this command buffer
+   std::vector<uint32_t> m_descPages;
+
+   // Resources referenced by the recorded commands, they cannot be released before completion
+   std::vector<Buffer*> m_usedBuffers;
+   std::vector<Texture*> m_usedTextures;
 
    // Syncing
    std::vector<VkSemaphore> m_semsToWait;
    std::vector<VkSemaphore> m_semsToSignal;
 
+   struct TimelineWait
+   {
+      VkSemaphore vkTimeline;
+      uint64_t value;
+   };
+   std::vector<TimelineWait> m_timelinesToWait;
+
+   // Command buffers waiting on this one that were synced before this one was submitted
+   std::vector<CommandBuffer*> m_dependents;
+   uint32_t m_pendingDependencies = 0;
+   uint64_t m_submitValue         = 0;
+
+   // Every resource taken from another family, or used for the first time, by this command buffer.
+   // The previous owner is restored if this command buffer is never submitted.
+   struct OwnershipTransfer
+   {
+      uint32_t srcFamily;
+      Texture* texture;
+      Buffer* buffer;
+      CYD::ImageLayout layout;
+      bool hasContent;  // Needs release and acquire barriers, otherwise it is simply taken
+   };
+   std::vector<OwnershipTransfer> m_ownershipTransfers;
+
    CYD::QueueUsageFlag m_usage   = CYD::QueueUsage::UNKNOWN;
    bool m_isRecording            = false;
    bool m_wasSubmitted           = false;
    VkCommandBuffer m_vkCmdBuffer = nullptr;
    VkFence m_vkFence             = nullptr;
-   VkSampler m_defaultSampler    = nullptr;
 };
 }
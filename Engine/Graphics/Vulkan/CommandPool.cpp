@@ -25,6 +25,7 @@ CommandPool::CommandPool(
    m_cmdBuffers.resize( MAX_CMD_BUFFERS_IN_FLIGHT );
 
    _createCommandPool();
+   _createTimeline();
 }
 
 void CommandPool::_createCommandPool()
@@ -39,6 +40,22 @@ void CommandPool::_createCommandPool()
    CYDASSERT( result == VK_SUCCESS && "CommandPool: Could not create command pool" );
 }
 
+void CommandPool::_createTimeline()
+{
+   VkSemaphoreTypeCreateInfoKHR typeInfo = {};
+   typeInfo.sType                        = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+   typeInfo.semaphoreType                = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+   typeInfo.initialValue                 = m_timelineValue;
+
+   VkSemaphoreCreateInfo semaphoreInfo = {};
+   semaphoreInfo.sType                 = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+   semaphoreInfo.pNext                 = &typeInfo;
+
+   VkResult result =
+       vkCreateSemaphore( m_pDevice->getVKDevice(), &semaphoreInfo, nullptr, &m_vkTimeline );
+   CYDASSERT( result == VK_SUCCESS && "CommandPool: Could not create timeline semaphore" );
+}
+
 CommandBuffer* CommandPool::createCommandBuffer( CYD::QueueUsageFlag usage )
 {
    // Check to see if we have a free spot for a command buffer. Either one that has never been
@@ -60,12 +77,24 @@ CommandBuffer* CommandPool::createCommandBuffer( CYD::QueueUsageFlag usage )
    return nullptr;
 }
 
+void CommandPool::releaseCompletedResources()
+{
+   for( auto& cmdBuffer : m_cmdBuffers )
+   {
+      if( cmdBuffer.getVKBuffer() )
+      {
+         cmdBuffer.releaseUsedResources();
+      }
+   }
+}
+
 CommandPool::~CommandPool()
 {
    for( auto& cmdBuffer : m_cmdBuffers )
    {
       cmdBuffer.release();
    }
+   vkDestroySemaphore( m_pDevice->getVKDevice(), m_vkTimeline, nullptr );
    vkDestroyCommandPool( m_pDevice->getVKDevice(), m_vkPool, nullptr );
 }
 }
@@ -11,6 +11,7 @@
 // Forwards
 // ================================================================================================
 FWDHANDLE( VkCommandPool );
+FWDHANDLE( VkSemaphore );
 
 namespace vk
 {
@@ -36,15 +37,23 @@ class CommandPool final
    ~CommandPool();
 
    const VkCommandPool& getVKCommandPool() const { return m_vkPool; }
+   const VkSemaphore& getVKTimeline() const { return m_vkTimeline; }
 
    CommandBuffer* createCommandBuffer( CYD::QueueUsageFlag usage );
 
+   // Completed command buffers stop holding on to the resources they used
+   void releaseCompletedResources();
+
    CYD::QueueUsageFlag getType() const noexcept { return m_type; }
    uint32_t getFamilyIndex() const noexcept { return m_familyIndex; }
    bool supportsPresentation() const noexcept { return m_supportsPresentation; }
 
+   // Every submission to this family signals the family's timeline semaphore with a new value
+   uint64_t nextTimelineValue() noexcept { return ++m_timelineValue; }
+
   private:
    void _createCommandPool();
+   void _createTimeline();
 
    const Device* m_pDevice = nullptr;
 
@@ -54,6 +63,9 @@ class CommandPool final
 
    VkCommandPool m_vkPool = nullptr;
 
+   VkSemaphore m_vkTimeline = nullptr;
+   uint64_t m_timelineValue = 0;
+
    CYD::QueueUsageFlag m_type;
    uint32_t m_familyIndex      = 0;
    bool m_supportsPresentation = false;
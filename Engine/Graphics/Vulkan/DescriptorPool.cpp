@@ -5,85 +5,370 @@
 
 #include <Graphics/Vulkan/Device.h>
 #include <Graphics/Vulkan/PipelineStash.h>
+#include <Graphics/Vulkan/Buffer.h>
+#include <Graphics/Vulkan/Texture.h>
+#include <Graphics/Vulkan/TypeConversions.h>
 
 #include <array>
 
+// Descriptor sets per page and descriptors of each type per set on average
+static constexpr uint32_t SETS_PER_PAGE       = 512;
+static constexpr uint32_t DESCRIPTORS_PER_SET = 4;
+
 namespace vk
 {
+// Data layout used by the update templates, one entry per shader resource of the set layout
+union DescriptorInfo
+{
+   VkDescriptorBufferInfo buffer;
+   VkDescriptorImageInfo image;
+};
+
 DescriptorPool::DescriptorPool( const Device& device ) : m_device( device )
 {
-   std::array<VkDescriptorPoolSize, 5> poolSizes = {};
+   m_currentPage = _openPage();
+}
 
-   const auto& limits = m_device.getProperties()->limits;
+// =================================================================================================
+// Pages
 
-   const uint32_t maxDescriptorSetUniformBuffers = limits.maxDescriptorSetUniformBuffers;
-   const uint32_t maxDescriptorSetStorageBuffers = limits.maxDescriptorSetStorageBuffers;
-   const uint32_t maxDescriptorSetSampledImages  = limits.maxDescriptorSetSampledImages;
-   const uint32_t maxDescriptorSetStorageImages  = limits.maxDescriptorSetStorageImages;
-   const uint32_t maxDescriptorSetSamplers       = limits.maxDescriptorSetSamplers;
+uint32_t DescriptorPool::_openPage()
+{
+   if( !m_freePages.empty() )
+   {
+      const uint32_t pageIdx = m_freePages.back();
+      m_freePages.pop_back();
+      return pageIdx;
+   }
 
-   const uint32_t totalDescriptorSets =
-       maxDescriptorSetUniformBuffers + maxDescriptorSetStorageBuffers +
-       maxDescriptorSetSampledImages + maxDescriptorSetStorageImages + maxDescriptorSetSamplers;
+   std::array<VkDescriptorPoolSize, 5> poolSizes = {};
 
-   // TODO Make more descriptor pools based on different types?
    poolSizes[0].type            = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-   poolSizes[0].descriptorCount = maxDescriptorSetUniformBuffers;
+   poolSizes[0].descriptorCount = SETS_PER_PAGE * DESCRIPTORS_PER_SET;
 
    poolSizes[1].type            = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-   poolSizes[1].descriptorCount = maxDescriptorSetStorageBuffers;
+   poolSizes[1].descriptorCount = SETS_PER_PAGE * DESCRIPTORS_PER_SET;
 
    poolSizes[2].type            = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-   poolSizes[2].descriptorCount = maxDescriptorSetSamplers;
+   poolSizes[2].descriptorCount = SETS_PER_PAGE * DESCRIPTORS_PER_SET;
 
    poolSizes[3].type            = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-   poolSizes[3].descriptorCount = maxDescriptorSetStorageImages;
+   poolSizes[3].descriptorCount = SETS_PER_PAGE * DESCRIPTORS_PER_SET;
 
    poolSizes[4].type            = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
-   poolSizes[4].descriptorCount = maxDescriptorSetSampledImages;
+   poolSizes[4].descriptorCount = SETS_PER_PAGE * DESCRIPTORS_PER_SET;
 
+   // No FREE_DESCRIPTOR_SET_BIT, sets are only ever released by resetting the whole pool
    VkDescriptorPoolCreateInfo poolInfo = {};
    poolInfo.sType                      = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-   poolInfo.flags                      = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+   poolInfo.flags                      = 0;
    poolInfo.poolSizeCount              = static_cast<uint32_t>( poolSizes.size() );
    poolInfo.pPoolSizes                 = poolSizes.data();
-   poolInfo.maxSets                    = totalDescriptorSets;
+   poolInfo.maxSets                    = SETS_PER_PAGE;
 
+   Page page;
    VkResult result =
-       vkCreateDescriptorPool( m_device.getVKDevice(), &poolInfo, nullptr, &m_vkDescPool );
-
+       vkCreateDescriptorPool( m_device.getVKDevice(), &poolInfo, nullptr, &page.vkPool );
    CYDASSERT( result == VK_SUCCESS && "DescriptorPool: Could not create descriptor pool" );
+
+   m_pages.push_back( std::move( page ) );
+   return static_cast<uint32_t>( m_pages.size() - 1 );
+}
+
+void DescriptorPool::_resetPage( uint32_t pageIdx )
+{
+   Page& page = m_pages[pageIdx];
+
+   vkResetDescriptorPool( m_device.getVKDevice(), page.vkPool, 0 );
+   page.cache.clear();
+   page.closed = false;
+
+   m_freePages.push_back( pageIdx );
+}
+
+void DescriptorPool::retainPage( uint32_t pageIdx ) { m_pages[pageIdx].users++; }
+
+void DescriptorPool::releasePage( uint32_t pageIdx )
+{
+   Page& page = m_pages[pageIdx];
+   CYDASSERT( page.users > 0 && "DescriptorPool: Releasing a page that was not retained" );
+
+   page.users--;
+   if( page.closed && page.users == 0 )
+   {
+      _resetPage( pageIdx );
+   }
+}
+
+void DescriptorPool::nextFrame()
+{
+   Page& page = m_pages[m_currentPage];
+   if( page.users == 0 )
+   {
+      // Nobody is using the sets of this page, they can stay cached for the next frame
+      return;
+   }
+
+   page.closed   = true;
+   m_currentPage = _openPage();
+}
+
+// =================================================================================================
+// Descriptor sets
+
+static size_t hashBindings(
+    VkDescriptorSetLayout vkLayout,
+    const DescriptorPool::Binding* bindings,
+    size_t count )
+{
+   size_t seed = std::hash<VkDescriptorSetLayout>()( vkLayout );
+   for( size_t i = 0; i < count; ++i )
+   {
+      hashCombine( seed, bindings[i].buffer );
+      hashCombine( seed, bindings[i].texture );
+      hashCombine( seed, bindings[i].sampler );
+   }
+   return seed;
+}
+
+static uint32_t getGeneration( const DescriptorPool::Binding& binding )
+{
+   if( binding.buffer )
+   {
+      return binding.buffer->getGeneration();
+   }
+   if( binding.texture )
+   {
+      return binding.texture->getGeneration();
+   }
+   return 0;
 }
 
-VkDescriptorSet DescriptorPool::allocate( const CYD::DescriptorSetLayoutInfo& layout ) const
+VkDescriptorSet DescriptorPool::findOrAllocate(
+    const CYD::DescriptorSetLayoutInfo& layout,
+    const Binding* bindings,
+    uint32_t& pageIdx )
 {
-   const VkDescriptorSetLayout vkDescSetLayout = m_device.getPipelineStash().findOrCreate( layout );
+   const VkDescriptorSetLayout vkLayout = m_device.getPipelineStash().findOrCreate( layout );
 
+   const size_t count = layout.shaderResources.size();
+   const size_t hash  = hashBindings( vkLayout, bindings, count );
+
+   // Looking for a set written with the same resources during this frame. The generations tell
+   // apart resources that were released and then acquired again in the same slot.
+   Page& page       = m_pages[m_currentPage];
+   const auto range = page.cache.equal_range( hash );
+   for( auto it = range.first; it != range.second; ++it )
+   {
+      const CachedSet& cached = it->second;
+      if( cached.vkLayout != vkLayout || cached.bindings.size() != count )
+      {
+         continue;
+      }
+
+      bool matches = true;
+      for( size_t i = 0; i < count && matches; ++i )
+      {
+         matches = cached.bindings[i].buffer == bindings[i].buffer &&
+                   cached.bindings[i].texture == bindings[i].texture &&
+                   cached.bindings[i].sampler == bindings[i].sampler &&
+                   cached.generations[i] == getGeneration( bindings[i] );
+      }
+
+      if( matches )
+      {
+         pageIdx = m_currentPage;
+         return cached.vkDescSet;
+      }
+   }
+
+   const VkDescriptorSet vkDescSet = _allocate( vkLayout );
+   _write( vkDescSet, vkLayout, layout, bindings );
+
+   CachedSet cached;
+   cached.vkLayout  = vkLayout;
+   cached.vkDescSet = vkDescSet;
+   cached.bindings.assign( bindings, bindings + count );
+   cached.generations.reserve( count );
+   for( size_t i = 0; i < count; ++i )
+   {
+      cached.generations.push_back( getGeneration( bindings[i] ) );
+   }
+
+   // The current page could have changed while allocating
+   m_pages[m_currentPage].cache.insert( { hash, std::move( cached ) } );
+
+   pageIdx = m_currentPage;
+   return vkDescSet;
+}
+
+VkDescriptorSet DescriptorPool::_allocate( VkDescriptorSetLayout vkLayout )
+{
    VkDescriptorSetAllocateInfo allocInfo = {};
    allocInfo.sType                       = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-   allocInfo.descriptorPool              = m_vkDescPool;
+   allocInfo.descriptorPool              = m_pages[m_currentPage].vkPool;
    allocInfo.descriptorSetCount          = 1;
-   allocInfo.pSetLayouts                 = &vkDescSetLayout;
+   allocInfo.pSetLayouts                 = &vkLayout;
 
    VkDescriptorSet vkDescSet;
    VkResult result = vkAllocateDescriptorSets( m_device.getVKDevice(), &allocInfo, &vkDescSet );
-   CYDASSERT( result == VK_SUCCESS && "DescriptorPool: Failed to solo allocate descriptor set" );
+   if( result != VK_SUCCESS )
+   {
+      // The current page is full, moving on to a new one
+      Page& page = m_pages[m_currentPage];
+      if( page.users == 0 )
+      {
+         _resetPage( m_currentPage );
+      }
+      else
+      {
+         page.closed = true;
+      }
+
+      m_currentPage            = _openPage();
+      allocInfo.descriptorPool = m_pages[m_currentPage].vkPool;
 
+      result = vkAllocateDescriptorSets( m_device.getVKDevice(), &allocInfo, &vkDescSet );
+   }
+
+   CYDASSERT( result == VK_SUCCESS && "DescriptorPool: Failed to allocate descriptor set" );
    return vkDescSet;
 }
 
-void DescriptorPool::free( const VkDescriptorSet& descSet ) const
+void DescriptorPool::_write(
+    VkDescriptorSet vkDescSet,
+    VkDescriptorSetLayout vkLayout,
+    const CYD::DescriptorSetLayoutInfo& layout,
+    const Binding* bindings )
 {
-   vkFreeDescriptorSets( m_device.getVKDevice(), m_vkDescPool, 1, &descSet );
+   const size_t count = layout.shaderResources.size();
+
+   std::vector<DescriptorInfo> infos( count );
+
+   bool complete = true;
+   for( size_t i = 0; i < count; ++i )
+   {
+      const Binding& binding = bindings[i];
+      DescriptorInfo& info   = infos[i];
+
+      if( binding.buffer )
+      {
+         info.buffer.buffer = binding.buffer->getVKBuffer();
+         info.buffer.offset = 0;
+         info.buffer.range  = binding.buffer->getSize();
+      }
+      else if( binding.texture )
+      {
+         // Images are in general layout for load/store operations
+         const bool isSampled = layout.shaderResources[i].type ==
+                                CYD::ShaderResourceType::COMBINED_IMAGE_SAMPLER;
+
+         info.image.sampler     = binding.sampler;
+         info.image.imageView   = binding.texture->getVKImageView();
+         info.image.imageLayout = isSampled ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                                            : VK_IMAGE_LAYOUT_GENERAL;
+      }
+      else
+      {
+         complete = false;
+      }
+   }
+
+   if( complete )
+   {
+      vkUpdateDescriptorSetWithTemplate(
+          m_device.getVKDevice(),
+          vkDescSet,
+          _findOrCreateTemplate( vkLayout, layout ),
+          infos.data() );
+      return;
+   }
+
+   // Only writing the resources that were bound
+   std::vector<VkWriteDescriptorSet> writeDescSets;
+   writeDescSets.reserve( count );
+   for( size_t i = 0; i < count; ++i )
+   {
+      if( !bindings[i].buffer && !bindings[i].texture )
+      {
+         continue;
+      }
+
+      const CYD::ShaderResourceInfo& resource = layout.shaderResources[i];
+
+      VkWriteDescriptorSet descriptorWrite = {};
+      descriptorWrite.sType                = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      descriptorWrite.dstSet               = vkDescSet;
+      descriptorWrite.dstBinding           = resource.binding;
+      descriptorWrite.dstArrayElement      = 0;
+      descriptorWrite.descriptorType  = TypeConversions::cydToVkDescriptorType( resource.type );
+      descriptorWrite.descriptorCount = 1;
+      descriptorWrite.pBufferInfo     = bindings[i].buffer ? &infos[i].buffer : nullptr;
+      descriptorWrite.pImageInfo      = bindings[i].texture ? &infos[i].image : nullptr;
+
+      writeDescSets.push_back( descriptorWrite );
+   }
+
+   vkUpdateDescriptorSets(
+       m_device.getVKDevice(),
+       static_cast<uint32_t>( writeDescSets.size() ),
+       writeDescSets.data(),
+       0,
+       nullptr );
 }
 
-void DescriptorPool::free( const VkDescriptorSet* descSets, const uint32_t count ) const
+VkDescriptorUpdateTemplate DescriptorPool::_findOrCreateTemplate(
+    VkDescriptorSetLayout vkLayout,
+    const CYD::DescriptorSetLayoutInfo& layout )
 {
-   vkFreeDescriptorSets( m_device.getVKDevice(), m_vkDescPool, count, descSets );
+   const auto templateIt = m_templates.find( vkLayout );
+   if( templateIt != m_templates.end() )
+   {
+      return templateIt->second;
+   }
+
+   std::vector<VkDescriptorUpdateTemplateEntry> entries;
+   entries.reserve( layout.shaderResources.size() );
+   for( size_t i = 0; i < layout.shaderResources.size(); ++i )
+   {
+      const CYD::ShaderResourceInfo& resource = layout.shaderResources[i];
+
+      VkDescriptorUpdateTemplateEntry entry = {};
+      entry.dstBinding                      = resource.binding;
+      entry.dstArrayElement                 = 0;
+      entry.descriptorCount                 = 1;
+      entry.descriptorType = TypeConversions::cydToVkDescriptorType( resource.type );
+      entry.offset         = i * sizeof( DescriptorInfo );
+      entry.stride         = sizeof( DescriptorInfo );
+
+      entries.push_back( entry );
+   }
+
+   VkDescriptorUpdateTemplateCreateInfo templateInfo = {};
+   templateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+   templateInfo.descriptorUpdateEntryCount = static_cast<uint32_t>( entries.size() );
+   templateInfo.pDescriptorUpdateEntries   = entries.data();
+   templateInfo.templateType        = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+   templateInfo.descriptorSetLayout = vkLayout;
+
+   VkDescriptorUpdateTemplate vkTemplate;
+   VkResult result = vkCreateDescriptorUpdateTemplate(
+       m_device.getVKDevice(), &templateInfo, nullptr, &vkTemplate );
+   CYDASSERT( result == VK_SUCCESS && "DescriptorPool: Could not create update template" );
+
+   return m_templates.insert( { vkLayout, vkTemplate } ).first->second;
 }
 
 DescriptorPool::~DescriptorPool()
 {
-   vkDestroyDescriptorPool( m_device.getVKDevice(), m_vkDescPool, nullptr );
+   for( const auto& templatePair : m_templates )
+   {
+      vkDestroyDescriptorUpdateTemplate( m_device.getVKDevice(), templatePair.second, nullptr );
+   }
+
+   for( const Page& page : m_pages )
+   {
+      vkDestroyDescriptorPool( m_device.getVKDevice(), page.vkPool, nullptr );
+   }
 }
 }
@@ -4,34 +4,103 @@
 
 #include <Graphics/GraphicsTypes.h>
 
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 // ================================================================================================
 // Forwards
 // ================================================================================================
 FWDHANDLE( VkDescriptorPool );
 FWDHANDLE( VkDescriptorSet );
+FWDHANDLE( VkDescriptorSetLayout );
+FWDHANDLE( VkDescriptorUpdateTemplate );
+FWDHANDLE( VkSampler );
 namespace vk
 {
 class Device;
+class Buffer;
+class Texture;
 }
 
 // ================================================================================================
 // Definition
 // ================================================================================================
+/*
+ * Descriptor sets are never freed one by one. They are allocated from pages (Vulkan descriptor
+ * pools) and a new page is opened every frame. A page that was closed is reset as a whole once
+ * every command buffer that used one of its sets has been released.
+ *
+ * The sets written in the current page are cached with the resources they point to, so binding
+ * the same resources with the same layout again reuses the set that was already written.
+ */
 namespace vk
 {
 class DescriptorPool final
 {
   public:
    explicit DescriptorPool( const Device& device );
+   NON_COPIABLE( DescriptorPool );
    ~DescriptorPool();
 
-   VkDescriptorSet allocate( const CYD::DescriptorSetLayoutInfo& layout ) const;
-   void free( const VkDescriptorSet& descSet ) const;
-   void free( const VkDescriptorSet* descSets, const uint32_t count ) const;
+   // Resource bound to one of the shader resources of a set layout
+   struct Binding
+   {
+      const Buffer* buffer   = nullptr;
+      const Texture* texture = nullptr;
+      VkSampler sampler      = nullptr;
+   };
+
+   // There is one binding per shader resource of the layout, in the same order. Returns the page
+   // the set lives in, which has to be retained for as long as the set is used.
+   VkDescriptorSet findOrAllocate(
+       const CYD::DescriptorSetLayoutInfo& layout,
+       const Binding* bindings,
+       uint32_t& pageIdx );
+
+   void retainPage( uint32_t pageIdx );
+   void releasePage( uint32_t pageIdx );
+
+   // Closes the current page, should be called every frame
+   void nextFrame();
 
   private:
+   struct CachedSet
+   {
+      VkDescriptorSetLayout vkLayout;
+      std::vector<Binding> bindings;
+      std::vector<uint32_t> generations;
+      VkDescriptorSet vkDescSet;
+   };
+
+   struct Page
+   {
+      VkDescriptorPool vkPool = nullptr;
+      uint32_t users          = 0;
+      bool closed             = false;
+      std::unordered_multimap<size_t, CachedSet> cache;
+   };
+
+   uint32_t _openPage();
+   void _resetPage( uint32_t pageIdx );
+
+   VkDescriptorSet _allocate( VkDescriptorSetLayout vkLayout );
+   void _write(
+       VkDescriptorSet vkDescSet,
+       VkDescriptorSetLayout vkLayout,
+       const CYD::DescriptorSetLayoutInfo& layout,
+       const Binding* bindings );
+
+   VkDescriptorUpdateTemplate _findOrCreateTemplate(
+       VkDescriptorSetLayout vkLayout,
+       const CYD::DescriptorSetLayoutInfo& layout );
+
    const Device& m_device;
 
-   VkDescriptorPool m_vkDescPool = nullptr;
+   std::vector<Page> m_pages;
+   std::vector<uint32_t> m_freePages;
+   uint32_t m_currentPage = 0;
+
+   std::unordered_map<VkDescriptorSetLayout, VkDescriptorUpdateTemplate> m_templates;
 };
 }
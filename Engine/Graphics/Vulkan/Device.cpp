@@ -13,15 +13,23 @@
 #include <Graphics/Vulkan/Buffer.h>
 #include <Graphics/Vulkan/Texture.h>
 #include <Graphics/Vulkan/DescriptorPool.h>
+#include <Graphics/Vulkan/MemoryAllocator.h>
+#include <Graphics/Vulkan/BindlessTable.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 
-static constexpr float DEFAULT_PRIORITY            = 1.0f;
 static constexpr uint32_t NUMBER_QUEUES_PER_FAMILY = 2;
 
-// VK Resource Pools Sizes
-static constexpr uint32_t MAX_BUFFER_COUNT  = 512;
-static constexpr uint32_t MAX_TEXTURE_COUNT = 512;
+static constexpr std::array<float, NUMBER_QUEUES_PER_FAMILY> DEFAULT_PRIORITIES = { 1.0f, 1.0f };
+
+// VK Resource Pools Sizes, they grow past these when needed
+static constexpr uint32_t INITIAL_BUFFER_COUNT  = 512;
+static constexpr uint32_t INITIAL_TEXTURE_COUNT = 512;
+
+// Upper bound of the bindless texture array, the device limits can lower it
+static constexpr uint32_t MAX_BINDLESS_TEXTURES = 4096;
 
 namespace vk
 {
@@ -37,18 +45,28 @@ Device::Device(
       m_extensions( extensions ),
       m_physDevice( physDevice )
 {
-   m_buffers.resize( MAX_BUFFER_COUNT );
-   m_textures.resize( MAX_TEXTURE_COUNT );
+   m_buffers.reserve( INITIAL_BUFFER_COUNT );
+   m_textures.reserve( INITIAL_TEXTURE_COUNT );
+   m_freeBuffers.reserve( INITIAL_BUFFER_COUNT );
+   m_freeTextures.reserve( INITIAL_TEXTURE_COUNT );
 
    _populateQueueFamilies();
+   _checkOptionalExtensions();
    _createLogicalDevice();
+   _queryComputeLimits();
    _fetchQueues();
    _createCommandPools();
    _createDescriptorPool();
 
+   m_allocator    = std::make_unique<MemoryAllocator>( *this );
    m_renderPasses = std::make_unique<RenderPassStash>( *this );
    m_pipelines    = std::make_unique<PipelineStash>( *this );
    m_samplers     = std::make_unique<SamplerStash>( *this );
+
+   if( m_bindlessCapacity > 0 )
+   {
+      m_bindless = std::make_unique<BindlessTable>( *this );
+   }
 }
 
 void Device::_populateQueueFamilies()
@@ -79,14 +97,117 @@ void Device::_populateQueueFamilies()
       }
 
       VkBool32 supportsPresent = false;
-      vkGetPhysicalDeviceSurfaceSupportKHR(
-          m_physDevice, i, m_surface.getVKSurface(), &supportsPresent );
+      if( m_surface.isHeadless() )
+      {
+         // Offscreen frames are "presented" by the queue that rendered them
+         supportsPresent = ( vkQueueType & VK_QUEUE_GRAPHICS_BIT ) != 0;
+      }
+      else
+      {
+         vkGetPhysicalDeviceSurfaceSupportKHR(
+             m_physDevice, i, m_surface.getVKSurface(), &supportsPresent );
+      }
 
       m_queueFamilies.push_back(
           { {}, i, queueFamilies[i].queueCount, type, static_cast<bool>( supportsPresent ) } );
    }
 }
 
+void Device::_checkOptionalExtensions()
+{
+   uint32_t extensionCount = 0;
+   vkEnumerateDeviceExtensionProperties( m_physDevice, nullptr, &extensionCount, nullptr );
+
+   std::vector<VkExtensionProperties> availableExtensions( extensionCount );
+   vkEnumerateDeviceExtensionProperties(
+       m_physDevice, nullptr, &extensionCount, availableExtensions.data() );
+
+   const auto isSupported = [&availableExtensions]( const char* extensionName ) {
+      return std::any_of(
+          availableExtensions.begin(),
+          availableExtensions.end(),
+          [extensionName]( const VkExtensionProperties& extension ) {
+             return strcmp( extension.extensionName, extensionName ) == 0;
+          } );
+   };
+
+   if( isSupported( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME ) )
+   {
+      _checkBindlessSupport();
+   }
+
+   // Tells if pipelines were found in the pipeline cache and how long they took to create
+   if( isSupported( VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME ) )
+   {
+      m_supportsCreationFeedback = true;
+      m_extensions.push_back( VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME );
+   }
+}
+
+void Device::_checkBindlessSupport()
+{
+   VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+   indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+   VkPhysicalDeviceFeatures2 features = {};
+   features.sType                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+   features.pNext                     = &indexingFeatures;
+   vkGetPhysicalDeviceFeatures2( m_physDevice, &features );
+
+   if( !indexingFeatures.runtimeDescriptorArray ||
+       !indexingFeatures.descriptorBindingPartiallyBound ||
+       !indexingFeatures.descriptorBindingSampledImageUpdateAfterBind ||
+       !indexingFeatures.descriptorBindingUpdateUnusedWhilePending )
+   {
+      return;
+   }
+
+   VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProps = {};
+   indexingProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+   VkPhysicalDeviceProperties2 props = {};
+   props.sType                       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+   props.pNext                       = &indexingProps;
+   vkGetPhysicalDeviceProperties2( m_physDevice, &props );
+
+   // The array is visible to every stage, so it counts against the per-stage limits of each one
+   m_bindlessCapacity = std::min(
+       { MAX_BINDLESS_TEXTURES,
+         indexingProps.maxDescriptorSetUpdateAfterBindSampledImages,
+         indexingProps.maxDescriptorSetUpdateAfterBindSamplers,
+         indexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages,
+         indexingProps.maxPerStageDescriptorUpdateAfterBindSamplers,
+         indexingProps.maxPerStageUpdateAfterBindResources } );
+
+   m_extensions.push_back( VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME );
+}
+
+void Device::_queryComputeLimits()
+{
+   const VkPhysicalDeviceLimits& limits = m_physProps->limits;
+
+   m_computeLimits.maxWorkGroupSize =
+       std::min( limits.maxComputeWorkGroupInvocations, limits.maxComputeWorkGroupSize[0] );
+   m_computeLimits.maxSharedMemorySize = limits.maxComputeSharedMemorySize;
+
+   // Subgroup operations are core since Vulkan 1.1
+   VkPhysicalDeviceSubgroupProperties subgroupProps = {};
+   subgroupProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+
+   VkPhysicalDeviceProperties2 props = {};
+   props.sType                       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+   props.pNext                       = &subgroupProps;
+   vkGetPhysicalDeviceProperties2( m_physDevice, &props );
+
+   const VkSubgroupFeatureFlags shuffleOps =
+       VK_SUBGROUP_FEATURE_BASIC_BIT | VK_SUBGROUP_FEATURE_SHUFFLE_BIT;
+   if( ( subgroupProps.supportedStages & VK_SHADER_STAGE_COMPUTE_BIT ) &&
+       ( subgroupProps.supportedOperations & shuffleOps ) == shuffleOps )
+   {
+      m_computeLimits.subgroupSize = subgroupProps.subgroupSize;
+   }
+}
+
 void Device::_createLogicalDevice()
 {
    // Populating queue infos
@@ -94,15 +215,16 @@ void Device::_createLogicalDevice()
 
    for( auto& family : m_queueFamilies )
    {
-      family.queues.resize( NUMBER_QUEUES_PER_FAMILY );
+      // Some families (transfer only ones especially) only expose a single queue
+      family.queues.resize( std::min( family.queueCount, NUMBER_QUEUES_PER_FAMILY ) );
 
       VkDeviceQueueCreateInfo queueInfo = {};
       queueInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
       queueInfo.pNext                   = nullptr;
       queueInfo.flags                   = 0;
       queueInfo.queueFamilyIndex        = family.index;
-      queueInfo.queueCount              = NUMBER_QUEUES_PER_FAMILY;
-      queueInfo.pQueuePriorities        = &DEFAULT_PRIORITY;
+      queueInfo.queueCount              = static_cast<uint32_t>( family.queues.size() );
+      queueInfo.pQueuePriorities        = DEFAULT_PRIORITIES.data();
 
       queueInfos.push_back( std::move( queueInfo ) );
    }
@@ -116,9 +238,27 @@ void Device::_createLogicalDevice()
 
    const std::vector<const char*> layers = m_instance.getLayers();
 
+   // Command lists on different queue families are synchronized with timeline semaphores
+   VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures = {};
+   timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+   timelineFeatures.timelineSemaphore = VK_TRUE;
+
+   // Bindless textures, only chained when the device supports them
+   VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures = {};
+   indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+   indexingFeatures.runtimeDescriptorArray                       = VK_TRUE;
+   indexingFeatures.descriptorBindingPartiallyBound              = VK_TRUE;
+   indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+   indexingFeatures.descriptorBindingUpdateUnusedWhilePending    = VK_TRUE;
+
+   if( m_bindlessCapacity > 0 )
+   {
+      timelineFeatures.pNext = &indexingFeatures;
+   }
+
    VkDeviceCreateInfo deviceInfo      = {};
    deviceInfo.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-   deviceInfo.pNext                   = nullptr;
+   deviceInfo.pNext                   = &timelineFeatures;
    deviceInfo.flags                   = 0;
    deviceInfo.queueCreateInfoCount    = static_cast<uint32_t>( queueInfos.size() );
    deviceInfo.pQueueCreateInfos       = queueInfos.data();
@@ -158,27 +298,47 @@ void Device::_createDescriptorPool() { m_descPool = std::make_unique<DescriptorP
 // =================================================================================================
 // Command buffers
 
+static uint32_t countBits( CYD::QueueUsageFlag flags )
+{
+   uint32_t count = 0;
+   for( ; flags; flags &= flags - 1 )
+   {
+      count++;
+   }
+   return count;
+}
+
 CommandBuffer* Device::createCommandBuffer( CYD::QueueUsageFlag usage, bool presentable )
 {
-   // TODO Implement support for EXACT type so that we can possibly send work (like transfer for
-   // example) to another queue family
+   // Looking for the family that supports all of the usage with the fewest extra capabilities. This
+   // way, transfer and compute work goes to the dedicated families when there are some and can run
+   // concurrently with the graphics work. Falling back on any family partially supporting it.
+   CommandPool* bestPool = nullptr;
+   uint32_t bestScore    = ~0U;
 
-   CommandBuffer* cmdBuffer = nullptr;
+   for( const auto& pool : m_commandPools )
+   {
+      if( !( usage & pool->getType() ) || ( presentable && !pool->supportsPresentation() ) )
+      {
+         continue;
+      }
 
-   // Attempting to find an adequate type
-   const auto it = std::find_if(
-       m_commandPools.begin(),
-       m_commandPools.end(),
-       [usage, presentable]( const std::unique_ptr<CommandPool>& pool ) {
-          return ( usage & pool->getType() ) && !( presentable && !pool->supportsPresentation() );
-       } );
-   if( it != m_commandPools.end() )
+      const uint32_t missing = countBits( usage & ~pool->getType() );
+      const uint32_t extra   = countBits( pool->getType() & ~usage );
+      const uint32_t score   = missing * 8 + extra;
+      if( score < bestScore )
+      {
+         bestPool  = pool.get();
+         bestScore = score;
+      }
+   }
+
+   if( bestPool )
    {
-      // Found an adequate command pool
-      cmdBuffer = ( *it )->createCommandBuffer( usage );
+      return bestPool->createCommandBuffer( usage );
    }
 
-   return cmdBuffer;
+   return nullptr;
 }
 
 // =================================================================================================
@@ -187,20 +347,20 @@ CommandBuffer* Device::createCommandBuffer( CYD::QueueUsageFlag usage, bool pres
 Buffer*
 Device::_createBuffer( size_t size, CYD::BufferUsageFlag usage, CYD::MemoryTypeFlag memoryType )
 {
-   // Check to see if we have a free spot for a buffer.
-   auto it = std::find_if(
-       m_buffers.rbegin(), m_buffers.rend(), []( Buffer& buffer ) { return !buffer.inUse(); } );
-
-   if( it != m_buffers.rend() )
+   Buffer* buffer = nullptr;
+   if( m_freeBuffers.empty() )
+   {
+      m_buffers.push_back( std::make_unique<Buffer>() );
+      buffer = m_buffers.back().get();
+   }
+   else
    {
-      // We found a buffer that can be replaced
-      it->release();
-      it->acquire( *this, size, usage, memoryType );
-      return &*it;
+      buffer = m_freeBuffers.back();
+      m_freeBuffers.pop_back();
    }
 
-   CYDASSERT( !"Device: Too many buffers in flight" );
-   return nullptr;
+   buffer->acquire( *this, size, usage, memoryType );
+   return buffer;
 }
 
 Buffer* Device::createVertexBuffer( size_t size )
@@ -246,22 +406,33 @@ Buffer* Device::createBuffer( size_t size )
 
 Texture* Device::createTexture( const CYD::TextureDescription& desc )
 {
-   // Check to see if we have a free spot for a texture.
-   auto it = std::find_if( m_textures.rbegin(), m_textures.rend(), []( Texture& texture ) {
-      return !texture.inUse();
-   } );
-
-   if( it != m_textures.rend() )
+   Texture* texture = nullptr;
+   if( m_freeTextures.empty() )
    {
-      // We found a texture that can be replaced
-      it->release();
-      it->acquire( *this, desc );
-
-      return &*it;
+      m_textures.push_back( std::make_unique<Texture>() );
+      texture = m_textures.back().get();
+   }
+   else
+   {
+      texture = m_freeTextures.back();
+      m_freeTextures.pop_back();
    }
 
-   CYDASSERT( !"Device: Too many textures in flight" );
-   return nullptr;
+   texture->acquire( *this, desc );
+   return texture;
+}
+
+void Device::destroyBuffer( Buffer* buffer )
+{
+   // Dropping the reference taken at creation, command buffers may still hold theirs
+   buffer->decUse();
+   m_destroyedBuffers.push_back( buffer );
+}
+
+void Device::destroyTexture( Texture* texture )
+{
+   texture->decUse();
+   m_destroyedTextures.push_back( texture );
 }
 
 // =================================================================================================
@@ -281,30 +452,49 @@ Swapchain* Device::createSwapchain( const CYD::SwapchainInfo& scInfo )
 // =================================================================================================
 // Cleanup
 
-void Device::cleanup()
+template <class Resource>
+static void releaseUnused( std::vector<Resource*>& destroyed, std::vector<Resource*>& freeList )
 {
-   // Cleaning up textures
-   for( auto& texture : m_textures )
+   for( size_t i = 0; i < destroyed.size(); )
    {
-      if( texture.getVKImage() && !texture.inUse() )
+      Resource* resource = destroyed[i];
+      if( resource->inUse() )
       {
-         texture.release();
+         ++i;
+         continue;
       }
+
+      resource->release();
+      freeList.push_back( resource );
+
+      // Order does not matter, swapping with the last one
+      destroyed[i] = destroyed.back();
+      destroyed.pop_back();
    }
+}
 
-   // Cleaning up device buffers
-   for( auto& buffer : m_buffers )
+void Device::cleanup()
+{
+   // Command buffers that completed give back the resources they used
+   for( auto& commandPool : m_commandPools )
    {
-      if( buffer.getVKBuffer() && !buffer.inUse() )
-      {
-         buffer.release();
-      }
+      commandPool->releaseCompletedResources();
    }
+
+   // Only the destroyed resources are looked at, the cost does not depend on how many are alive
+   releaseUnused( m_destroyedTextures, m_freeTextures );
+   releaseUnused( m_destroyedBuffers, m_freeBuffers );
 }
 
 // =================================================================================================
 // Getters
 
+CommandPool& Device::getCommandPool( uint32_t familyIndex ) const
+{
+   // Command pools are created in the same order as the queue families
+   return *m_commandPools[familyIndex];
+}
+
 const VkQueue* Device::getQueueFromFamily( uint32_t familyIndex ) const
 {
    const std::vector<VkQueue>& vkQueues = m_queueFamilies[familyIndex].queues;
@@ -368,25 +558,29 @@ Device::~Device()
 {
    vkDeviceWaitIdle( m_vkDevice );
 
+   // Offscreen swapchains own textures and buffers, they have to go first
+   m_swapchain.reset();
+
    for( auto& buffer : m_buffers )
    {
-      buffer.release();
+      buffer->release();
    }
 
    for( auto& texture : m_textures )
    {
-      texture.release();
+      texture->release();
    }
 
+   m_bindless.reset();
    m_samplers.reset();
    m_pipelines.reset();
    m_renderPasses.reset();
-   m_swapchain.reset();
    for( auto& commandPool : m_commandPools )
    {
       commandPool.reset();
    }
    m_descPool.reset();
+   m_allocator.reset();
 
    vkDestroyDevice( m_vkDevice, nullptr );
 }
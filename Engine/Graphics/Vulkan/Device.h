@@ -34,6 +34,8 @@ class CommandBuffer;
 class Buffer;
 class Texture;
 class DescriptorPool;
+class MemoryAllocator;
+class BindlessTable;
 }
 
 // ================================================================================================
@@ -65,6 +67,10 @@ class Device final
    Buffer* createBuffer( size_t size );
    Texture* createTexture( const CYD::TextureDescription& desc );
 
+   // Released once the command buffers using them have completed, during a later cleanup
+   void destroyBuffer( Buffer* buffer );
+   void destroyTexture( Texture* texture );
+
    void cleanup();  // Clean up unused resources
 
    // Getters
@@ -75,11 +81,21 @@ class Device final
        const;
 
    Swapchain* getSwapchain() const { return m_swapchain.get(); }
+   CommandPool& getCommandPool( uint32_t familyIndex ) const;
 
    PipelineStash& getPipelineStash() const { return *m_pipelines; }
    RenderPassStash& getRenderPassStash() const { return *m_renderPasses; }
    SamplerStash& getSamplerStash() const { return *m_samplers; }
    DescriptorPool& getDescriptorPool() const { return *m_descPool; }
+   MemoryAllocator& getMemoryAllocator() const { return *m_allocator; }
+
+   // Null when descriptor indexing is not supported
+   BindlessTable* getBindlessTable() const { return m_bindless.get(); }
+   uint32_t getBindlessCapacity() const noexcept { return m_bindlessCapacity; }
+
+   bool supportsCreationFeedback() const noexcept { return m_supportsCreationFeedback; }
+
+   const CYD::ComputeLimits& getComputeLimits() const noexcept { return m_computeLimits; }
 
    // Support
    uint32_t findMemoryType( uint32_t typeFilter, uint32_t properties ) const;
@@ -91,14 +107,16 @@ class Device final
    // Private Functions
    // =============================================================================================
    void _populateQueueFamilies();
+   void _checkOptionalExtensions();
+   void _checkBindlessSupport();
    void _createLogicalDevice();
+   void _queryComputeLimits();
    void _fetchQueues();
    void _createCommandPools();
    void _createDescriptorPool();
 
    // Common buffer function
    Buffer* _createBuffer( size_t size, CYD::BufferUsageFlag usage, CYD::MemoryTypeFlag memoryType );
-   void _destroyBuffer( Buffer* buffer );
 
    // =============================================================================================
    // Private Members
@@ -108,15 +126,26 @@ class Device final
    const Instance& m_instance;
    const Surface& m_surface;
 
-   std::vector<Buffer> m_buffers;
-   std::vector<Texture> m_textures;
+   // Resources are never moved once created, the handles and command buffers point to them
+   std::vector<std::unique_ptr<Buffer>> m_buffers;
+   std::vector<std::unique_ptr<Texture>> m_textures;
+
+   // Released and ready to be acquired again
+   std::vector<Buffer*> m_freeBuffers;
+   std::vector<Texture*> m_freeTextures;
+
+   // Destroyed but possibly still used by command buffers in flight
+   std::vector<Buffer*> m_destroyedBuffers;
+   std::vector<Texture*> m_destroyedTextures;
    std::vector<std::unique_ptr<CommandPool>> m_commandPools;
 
+   std::unique_ptr<MemoryAllocator> m_allocator;
    std::unique_ptr<DescriptorPool> m_descPool;
    std::unique_ptr<Swapchain> m_swapchain;
    std::unique_ptr<RenderPassStash> m_renderPasses;
    std::unique_ptr<SamplerStash> m_samplers;
    std::unique_ptr<PipelineStash> m_pipelines;
+   std::unique_ptr<BindlessTable> m_bindless;
 
    struct QueueFamily
    {
@@ -128,8 +157,15 @@ class Device final
    };
    std::vector<QueueFamily> m_queueFamilies;
 
-   // Extensions used to create the device
-   const std::vector<const char*>& m_extensions;
+   // Extensions used to create the device, supported optional ones are appended to it
+   std::vector<const char*> m_extensions;
+
+   // Size of the bindless texture array, 0 when descriptor indexing is not supported
+   uint32_t m_bindlessCapacity = 0;
+
+   bool m_supportsCreationFeedback = false;
+
+   CYD::ComputeLimits m_computeLimits;
 
    VkDevice m_vkDevice           = nullptr;
    VkPhysicalDevice m_physDevice = nullptr;
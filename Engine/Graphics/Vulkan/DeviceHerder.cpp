@@ -19,7 +19,11 @@ DeviceHerder::DeviceHerder(
     : m_instance( instance ), m_window( window ), m_surface( surface )
 {
    // Desired extensions to be used when creating logical devices
-   m_extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+   m_extensions = {VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME};
+   if( !m_surface.isHeadless() )
+   {
+      m_extensions.push_back( VK_KHR_SWAPCHAIN_EXTENSION_NAME );
+   }
 
    uint32_t physicalDeviceCount;
    vkEnumeratePhysicalDevices( instance.getVKInstance(), &physicalDeviceCount, nullptr );
@@ -33,38 +37,77 @@ DeviceHerder::DeviceHerder(
    CYDASSERT( !physicalDevices.empty() && "DeviceHerder: No devices supporting Vulkan" );
 
    // TODO Add support for multiple devices
+   // Discrete GPUs are preferred, software rasterizers like lavapipe are only used as a last
+   // resort, for example on CI machines without a GPU
+   VkPhysicalDevice chosenDevice = nullptr;
+   uint32_t chosenRank           = 0;
    for( const auto& physDevice : physicalDevices )
    {
-      if( _checkDevice( m_surface, physDevice ) )
+      const uint32_t rank = _rankDevice( m_surface, physDevice );
+      if( rank > chosenRank )
       {
-         // Found suitable device, add it to the currently managed devices
-         m_devices.emplace_back(
-             std::make_unique<Device>( m_window, m_instance, m_surface, physDevice, m_extensions ) );
-         break;
+         chosenDevice = physDevice;
+         chosenRank   = rank;
       }
    }
+
+   CYDASSERT( chosenDevice && "DeviceHerder: No suitable device found" );
+
+   if( chosenDevice )
+   {
+      VkPhysicalDeviceProperties properties = {};
+      vkGetPhysicalDeviceProperties( chosenDevice, &properties );
+
+      // Device will be added to the device manager, dump some info
+      fprintf(
+          stdout,
+          "DeviceHerder: adding device to manager\n\tDevice Name: %s\n\tAPI Version: "
+          "%u.%u.%u\n",
+          properties.deviceName,
+          VK_VERSION_MAJOR( properties.apiVersion ),
+          VK_VERSION_MINOR( properties.apiVersion ),
+          VK_VERSION_PATCH( properties.apiVersion ) );
+
+      // Found suitable device, add it to the currently managed devices
+      m_devices.emplace_back(
+          std::make_unique<Device>( m_window, m_instance, m_surface, chosenDevice, m_extensions ) );
+   }
 }
 
-bool DeviceHerder::_checkDevice( const Surface& surface, const VkPhysicalDevice& physDevice )
+static uint32_t getTypeRank( VkPhysicalDeviceType type )
+{
+   switch( type )
+   {
+      case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+         return 5;
+      case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+         return 4;
+      case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+         return 3;
+      case VK_PHYSICAL_DEVICE_TYPE_CPU:
+         return 2;
+      default:
+         return 1;
+   }
+}
+
+uint32_t DeviceHerder::_rankDevice( const Surface& surface, const VkPhysicalDevice& physDevice )
 {
    VkPhysicalDeviceProperties properties = {};
    vkGetPhysicalDeviceProperties( physDevice, &properties );
 
-   VkPhysicalDeviceFeatures features = {};
-   vkGetPhysicalDeviceFeatures( physDevice, &features );
-
    uint32_t queueFamilyCount = 0;
    vkGetPhysicalDeviceQueueFamilyProperties( physDevice, &queueFamilyCount, nullptr );
 
    std::vector<VkQueueFamilyProperties> queueFamilies( queueFamilyCount );
    vkGetPhysicalDeviceQueueFamilyProperties( physDevice, &queueFamilyCount, queueFamilies.data() );
 
-   const bool isDiscrete = properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
-
    VkBool32 supportsGraphics = false;
    VkBool32 supportsTransfer = false;
    VkBool32 supportsCompute  = false;
-   VkBool32 supportsPresent  = false;
+
+   // Without a surface there is nothing to present to
+   VkBool32 supportsPresent = surface.isHeadless();
 
    for( uint32_t i = 0; i < queueFamilies.size(); ++i )
    {
@@ -93,22 +136,14 @@ bool DeviceHerder::_checkDevice( const Surface& surface, const VkPhysicalDevice&
 
    const bool supportsExtensions = _checkDeviceExtensionSupport( physDevice );
 
-   const bool isChosen = isDiscrete && supportsGraphics && supportsTransfer && supportsCompute &&
-                         supportsPresent && supportsExtensions;
-   if( isChosen )
+   const bool isSuitable = supportsGraphics && supportsTransfer && supportsCompute &&
+                           supportsPresent && supportsExtensions;
+   if( !isSuitable )
    {
-      // Device will be added to the device manager, dump some info
-      fprintf(
-          stdout,
-          "DeviceHerder: adding device to manager\n\tDevice Name: %s\n\tAPI Version: "
-          "%u.%u.%u\n",
-          properties.deviceName,
-          VK_VERSION_MAJOR( properties.apiVersion ),
-          VK_VERSION_MINOR( properties.apiVersion ),
-          VK_VERSION_PATCH( properties.apiVersion ) );
+      return 0;
    }
 
-   return isChosen;
+   return getTypeRank( properties.deviceType );
 }
 
 bool DeviceHerder::_checkDeviceExtensionSupport( const VkPhysicalDevice& physDevice )
@@ -42,7 +42,8 @@ class DeviceHerder final
    // =============================================================================================
    // Private Functions
    // =============================================================================================
-   bool _checkDevice( const Surface& surface, const VkPhysicalDevice& physDevice );
+   // 0 when the device cannot be used, higher is better
+   uint32_t _rankDevice( const Surface& surface, const VkPhysicalDevice& physDevice );
    bool _checkDeviceExtensionSupport( const VkPhysicalDevice& physDevice );
 
    // =============================================================================================
@@ -0,0 +1,647 @@
+#include <Graphics/Vulkan/MemoryAllocator.h>
+
+#include <Common/Assert.h>
+#include <Common/Vulkan.h>
+
+#include <Graphics/Vulkan/Device.h>
+
+#include <algorithm>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#endif
+
+// Size of the device memory blocks requested from the driver
+static constexpr size_t DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+static constexpr size_t MIN_BLOCK_SIZE     = 4 * 1024 * 1024;
+
+// TLSF parameters. The second level splits every power of two in 2^SL_LOG2 bins and sizes below
+// SMALL_SIZE are binned linearly in steps of MIN_ALIGNMENT.
+static constexpr uint32_t SL_LOG2       = 5;
+static constexpr uint32_t SL_COUNT      = 1 << SL_LOG2;
+static constexpr uint32_t ALIGN_LOG2    = 4;
+static constexpr size_t MIN_ALIGNMENT   = size_t( 1 ) << ALIGN_LOG2;
+static constexpr uint32_t FL_SHIFT      = SL_LOG2 + ALIGN_LOG2;
+static constexpr size_t SMALL_SIZE      = size_t( 1 ) << FL_SHIFT;
+static constexpr uint32_t FL_COUNT      = 32;
+static constexpr uint32_t INVALID_INDEX = ~0u;
+
+static uint32_t findLastSet( uint64_t value )
+{
+#if defined( _MSC_VER )
+   unsigned long index = 0;
+   _BitScanReverse64( &index, value );
+   return static_cast<uint32_t>( index );
+#else
+   return 63 - static_cast<uint32_t>( __builtin_clzll( value ) );
+#endif
+}
+
+static uint32_t findFirstSet( uint32_t value )
+{
+#if defined( _MSC_VER )
+   unsigned long index = 0;
+   _BitScanForward( &index, value );
+   return static_cast<uint32_t>( index );
+#else
+   return static_cast<uint32_t>( __builtin_ctz( value ) );
+#endif
+}
+
+static size_t alignUp( size_t value, size_t alignment )
+{
+   return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+// Maps a size to its first and second level bins
+static void mapping( size_t size, uint32_t& fl, uint32_t& sl )
+{
+   if( size < SMALL_SIZE )
+   {
+      fl = 0;
+      sl = static_cast<uint32_t>( size >> ALIGN_LOG2 );
+   }
+   else
+   {
+      const uint32_t log2 = findLastSet( size );
+      sl                  = static_cast<uint32_t>( size >> ( log2 - SL_LOG2 ) ) ^ SL_COUNT;
+      fl                  = log2 - FL_SHIFT + 1;
+   }
+}
+
+namespace vk
+{
+// =================================================================================================
+// Block
+
+class MemoryAllocator::Block final
+{
+  public:
+   Block( VkDeviceMemory vkMemory, size_t size, void* pMapped )
+       : vkMemory( vkMemory ), size( size ), pMapped( pMapped )
+   {
+      for( auto& heads : m_heads )
+      {
+         heads.fill( INVALID_INDEX );
+      }
+
+      // The whole block starts as a single free region
+      m_firstNode               = _newNode();
+      m_nodes[m_firstNode].size = size;
+      _insertFree( m_firstNode );
+   }
+   NON_COPIABLE( Block );
+   ~Block() = default;
+
+   bool allocate( size_t reqSize, size_t reqAlignment, size_t& offset, uint32_t& nodeIdx )
+   {
+      const size_t alignment = std::max( reqAlignment, MIN_ALIGNMENT );
+      const size_t allocSize = alignUp( reqSize, MIN_ALIGNMENT );
+
+      // Looking for a region that can fit the worst case alignment padding
+      const size_t searchSize = allocSize + ( alignment - MIN_ALIGNMENT );
+      const uint32_t idx      = _findFree( searchSize );
+      if( idx == INVALID_INDEX )
+      {
+         return false;
+      }
+
+      _removeFree( idx );
+
+      // Splitting the alignment padding in its own free region
+      const size_t padding = alignUp( m_nodes[idx].offset, alignment ) - m_nodes[idx].offset;
+      if( padding > 0 )
+      {
+         const uint32_t prefixIdx = _newNode();
+         Node& node               = m_nodes[idx];
+         Node& prefix             = m_nodes[prefixIdx];
+
+         prefix          = {};
+         prefix.offset   = node.offset;
+         prefix.size     = padding;
+         prefix.prevPhys = node.prevPhys;
+         prefix.nextPhys = idx;
+
+         if( node.prevPhys != INVALID_INDEX )
+         {
+            m_nodes[node.prevPhys].nextPhys = prefixIdx;
+         }
+         if( m_firstNode == idx )
+         {
+            m_firstNode = prefixIdx;
+         }
+
+         node.prevPhys = prefixIdx;
+         node.offset += padding;
+         node.size -= padding;
+
+         _insertFree( prefixIdx );
+      }
+
+      // Returning the remainder of the region to the free lists
+      if( m_nodes[idx].size > allocSize )
+      {
+         const uint32_t suffixIdx = _newNode();
+         Node& node               = m_nodes[idx];
+         Node& suffix             = m_nodes[suffixIdx];
+
+         suffix          = {};
+         suffix.offset   = node.offset + allocSize;
+         suffix.size     = node.size - allocSize;
+         suffix.prevPhys = idx;
+         suffix.nextPhys = node.nextPhys;
+
+         if( node.nextPhys != INVALID_INDEX )
+         {
+            m_nodes[node.nextPhys].prevPhys = suffixIdx;
+         }
+
+         node.nextPhys = suffixIdx;
+         node.size     = allocSize;
+
+         _insertFree( suffixIdx );
+      }
+
+      m_nodes[idx].free = false;
+      m_usedBytes += m_nodes[idx].size;
+      ++m_allocationCount;
+
+      offset  = m_nodes[idx].offset;
+      nodeIdx = idx;
+      return true;
+   }
+
+   void free( uint32_t nodeIdx )
+   {
+      CYDASSERT( !m_nodes[nodeIdx].free && "MemoryAllocator: Double free of a sub-allocation" );
+
+      m_usedBytes -= m_nodes[nodeIdx].size;
+      --m_allocationCount;
+
+      uint32_t idx = nodeIdx;
+
+      // Merging with the previous region
+      const uint32_t prevIdx = m_nodes[idx].prevPhys;
+      if( prevIdx != INVALID_INDEX && m_nodes[prevIdx].free )
+      {
+         _removeFree( prevIdx );
+         _absorbNext( prevIdx );
+         idx = prevIdx;
+      }
+
+      // Merging with the next region
+      const uint32_t nextIdx = m_nodes[idx].nextPhys;
+      if( nextIdx != INVALID_INDEX && m_nodes[nextIdx].free )
+      {
+         _removeFree( nextIdx );
+         _absorbNext( idx );
+      }
+
+      _insertFree( idx );
+   }
+
+   bool isEmpty() const { return m_allocationCount == 0; }
+   uint32_t getAllocationCount() const { return m_allocationCount; }
+   uint32_t getFreeRegionCount() const { return m_freeRegionCount; }
+   size_t getUsedBytes() const { return m_usedBytes; }
+
+   size_t getLargestFreeRegion() const
+   {
+      size_t largest = 0;
+      for( uint32_t idx = m_firstNode; idx != INVALID_INDEX; idx = m_nodes[idx].nextPhys )
+      {
+         if( m_nodes[idx].free )
+         {
+            largest = std::max( largest, m_nodes[idx].size );
+         }
+      }
+      return largest;
+   }
+
+   VkDeviceMemory vkMemory = nullptr;
+   size_t size             = 0;
+   void* pMapped           = nullptr;
+
+  private:
+   struct Node
+   {
+      size_t offset     = 0;
+      size_t size       = 0;
+      uint32_t prevPhys = INVALID_INDEX;
+      uint32_t nextPhys = INVALID_INDEX;
+      uint32_t prevFree = INVALID_INDEX;
+      uint32_t nextFree = INVALID_INDEX;
+      bool free         = true;
+   };
+
+   uint32_t _newNode()
+   {
+      if( !m_unusedNodes.empty() )
+      {
+         const uint32_t idx = m_unusedNodes.back();
+         m_unusedNodes.pop_back();
+         return idx;
+      }
+
+      m_nodes.emplace_back();
+      return static_cast<uint32_t>( m_nodes.size() - 1 );
+   }
+
+   // Merges the physical successor of a region into it and recycles the successor's node
+   void _absorbNext( uint32_t idx )
+   {
+      const uint32_t nextIdx = m_nodes[idx].nextPhys;
+      const Node& next       = m_nodes[nextIdx];
+
+      m_nodes[idx].size += next.size;
+      m_nodes[idx].nextPhys = next.nextPhys;
+      if( next.nextPhys != INVALID_INDEX )
+      {
+         m_nodes[next.nextPhys].prevPhys = idx;
+      }
+
+      m_unusedNodes.push_back( nextIdx );
+   }
+
+   void _insertFree( uint32_t idx )
+   {
+      uint32_t fl, sl;
+      mapping( m_nodes[idx].size, fl, sl );
+
+      Node& node    = m_nodes[idx];
+      node.free     = true;
+      node.prevFree = INVALID_INDEX;
+      node.nextFree = m_heads[fl][sl];
+      if( node.nextFree != INVALID_INDEX )
+      {
+         m_nodes[node.nextFree].prevFree = idx;
+      }
+
+      m_heads[fl][sl] = idx;
+      m_flBitmap |= 1u << fl;
+      m_slBitmaps[fl] |= 1u << sl;
+
+      ++m_freeRegionCount;
+   }
+
+   void _removeFree( uint32_t idx )
+   {
+      uint32_t fl, sl;
+      mapping( m_nodes[idx].size, fl, sl );
+
+      Node& node = m_nodes[idx];
+      if( node.prevFree != INVALID_INDEX )
+      {
+         m_nodes[node.prevFree].nextFree = node.nextFree;
+      }
+      if( node.nextFree != INVALID_INDEX )
+      {
+         m_nodes[node.nextFree].prevFree = node.prevFree;
+      }
+
+      if( m_heads[fl][sl] == idx )
+      {
+         m_heads[fl][sl] = node.nextFree;
+         if( m_heads[fl][sl] == INVALID_INDEX )
+         {
+            m_slBitmaps[fl] &= ~( 1u << sl );
+            if( m_slBitmaps[fl] == 0 )
+            {
+               m_flBitmap &= ~( 1u << fl );
+            }
+         }
+      }
+
+      node.free     = false;
+      node.prevFree = INVALID_INDEX;
+      node.nextFree = INVALID_INDEX;
+
+      --m_freeRegionCount;
+   }
+
+   // Finds a free region of at least the requested size in constant time
+   uint32_t _findFree( size_t size ) const
+   {
+      // Rounding up to the next bin so that any region found is guaranteed to be large enough
+      if( size >= SMALL_SIZE )
+      {
+         size += ( size_t( 1 ) << ( findLastSet( size ) - SL_LOG2 ) ) - 1;
+      }
+
+      uint32_t fl, sl;
+      mapping( size, fl, sl );
+      if( fl >= FL_COUNT )
+      {
+         return INVALID_INDEX;
+      }
+
+      uint32_t slMap = sl < SL_COUNT ? m_slBitmaps[fl] & ( ~0u << sl ) : 0;
+      if( slMap == 0 )
+      {
+         const uint32_t flMap = ( fl + 1 < FL_COUNT ) ? m_flBitmap & ( ~0u << ( fl + 1 ) ) : 0;
+         if( flMap == 0 )
+         {
+            return INVALID_INDEX;
+         }
+
+         fl    = findFirstSet( flMap );
+         slMap = m_slBitmaps[fl];
+      }
+
+      sl = findFirstSet( slMap );
+      return m_heads[fl][sl];
+   }
+
+   std::vector<Node> m_nodes;
+   std::vector<uint32_t> m_unusedNodes;
+   uint32_t m_firstNode = INVALID_INDEX;
+
+   uint32_t m_flBitmap = 0;
+   std::array<uint32_t, FL_COUNT> m_slBitmaps                   = {};
+   std::array<std::array<uint32_t, SL_COUNT>, FL_COUNT> m_heads = {};
+
+   size_t m_usedBytes         = 0;
+   uint32_t m_allocationCount = 0;
+   uint32_t m_freeRegionCount = 0;
+};
+
+// =================================================================================================
+// Pool
+
+struct MemoryAllocator::Pool
+{
+   uint32_t memoryTypeIdx = 0;
+   std::vector<std::unique_ptr<Block>> blocks;
+};
+
+// =================================================================================================
+// Allocator
+
+MemoryAllocator::MemoryAllocator( const Device& device ) : m_device( device )
+{
+   VkPhysicalDeviceMemoryProperties memProperties;
+   vkGetPhysicalDeviceMemoryProperties( m_device.getPhysicalDevice(), &memProperties );
+
+   // Two pools per memory type, one for linear resources and one for optimal resources
+   m_pools.resize( memProperties.memoryTypeCount * 2 );
+   m_hostVisibleTypes.resize( memProperties.memoryTypeCount );
+
+   size_t smallestHeap = DEFAULT_BLOCK_SIZE * 8;
+   for( uint32_t i = 0; i < memProperties.memoryTypeCount; ++i )
+   {
+      const VkMemoryType& memoryType = memProperties.memoryTypes[i];
+
+      m_pools[_poolIndex( i, ResourceKind::LINEAR )].memoryTypeIdx  = i;
+      m_pools[_poolIndex( i, ResourceKind::OPTIMAL )].memoryTypeIdx = i;
+
+      m_hostVisibleTypes[i] =
+          ( memoryType.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT ) != 0;
+
+      const size_t heapSize =
+          static_cast<size_t>( memProperties.memoryHeaps[memoryType.heapIndex].size );
+      smallestHeap = std::min( smallestHeap, heapSize );
+   }
+
+   // Small heaps get smaller blocks so a single block cannot starve them
+   m_blockSize = std::max( std::min( DEFAULT_BLOCK_SIZE, smallestHeap / 8 ), MIN_BLOCK_SIZE );
+}
+
+uint32_t MemoryAllocator::_poolIndex( uint32_t memoryTypeIdx, ResourceKind kind ) const
+{
+   return memoryTypeIdx * 2 + ( kind == ResourceKind::OPTIMAL ? 1 : 0 );
+}
+
+VkDeviceMemory
+MemoryAllocator::_allocateDeviceMemory( size_t size, uint32_t memoryTypeIdx, void** ppMapped )
+{
+   VkMemoryAllocateInfo allocInfo = {};
+   allocInfo.sType                = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+   allocInfo.allocationSize       = size;
+   allocInfo.memoryTypeIndex      = memoryTypeIdx;
+
+   *ppMapped = nullptr;
+
+   VkDeviceMemory vkMemory = nullptr;
+   VkResult result = vkAllocateMemory( m_device.getVKDevice(), &allocInfo, nullptr, &vkMemory );
+   if( result != VK_SUCCESS )
+   {
+      CYDASSERT( !"MemoryAllocator: Could not allocate device memory" );
+      return nullptr;
+   }
+
+   // Host visible memory stays mapped for its whole lifetime
+   if( m_hostVisibleTypes[memoryTypeIdx] )
+   {
+      result = vkMapMemory( m_device.getVKDevice(), vkMemory, 0, VK_WHOLE_SIZE, 0, ppMapped );
+      if( result != VK_SUCCESS )
+      {
+         CYDASSERT( !"MemoryAllocator: Mapping memory failed" );
+         vkFreeMemory( m_device.getVKDevice(), vkMemory, nullptr );
+         *ppMapped = nullptr;
+         return nullptr;
+      }
+   }
+
+   return vkMemory;
+}
+
+MemoryAllocation MemoryAllocator::_allocateDedicated( size_t size, uint32_t memoryTypeIdx )
+{
+   MemoryAllocation allocation;
+   allocation.vkMemory = _allocateDeviceMemory( size, memoryTypeIdx, &allocation.pMapped );
+   if( !allocation.vkMemory )
+   {
+      return {};
+   }
+
+   allocation.offset    = 0;
+   allocation.size      = size;
+   allocation.poolIdx   = memoryTypeIdx;
+   allocation.dedicated = true;
+
+   ++m_dedicatedCount;
+   m_dedicatedBytes += size;
+
+   return allocation;
+}
+
+MemoryAllocation MemoryAllocator::allocate(
+    const VkMemoryRequirements& requirements,
+    uint32_t properties,
+    ResourceKind kind )
+{
+   const uint32_t memoryTypeIdx =
+       m_device.findMemoryType( requirements.memoryTypeBits, properties );
+
+   std::scoped_lock<std::mutex> lock( m_mutex );
+
+   // Huge resources get their own memory instead of eating most of a block
+   if( requirements.size > m_blockSize / 2 )
+   {
+      return _allocateDedicated( requirements.size, memoryTypeIdx );
+   }
+
+   const uint32_t poolIdx = _poolIndex( memoryTypeIdx, kind );
+   Pool& pool             = m_pools[poolIdx];
+
+   MemoryAllocation allocation;
+   allocation.poolIdx = poolIdx;
+
+   for( uint32_t i = 0; i < pool.blocks.size(); ++i )
+   {
+      Block* block = pool.blocks[i].get();
+      if( block && block->allocate(
+                       requirements.size,
+                       requirements.alignment,
+                       allocation.offset,
+                       allocation.nodeIdx ) )
+      {
+         allocation.vkMemory = block->vkMemory;
+         allocation.size     = requirements.size;
+         allocation.blockIdx = i;
+         allocation.pMapped =
+             block->pMapped ? static_cast<char*>( block->pMapped ) + allocation.offset : nullptr;
+         return allocation;
+      }
+   }
+
+   // No block could fit the allocation, creating a new one. The pool is left untouched when the
+   // device is out of memory.
+   void* pMapped                 = nullptr;
+   const VkDeviceMemory vkMemory = _allocateDeviceMemory( m_blockSize, memoryTypeIdx, &pMapped );
+   if( !vkMemory )
+   {
+      return {};
+   }
+
+   // Reusing a released slot if any
+   auto it = std::find( pool.blocks.begin(), pool.blocks.end(), nullptr );
+   if( it == pool.blocks.end() )
+   {
+      it = pool.blocks.insert( pool.blocks.end(), nullptr );
+   }
+
+   *it = std::make_unique<Block>( vkMemory, m_blockSize, pMapped );
+
+   const bool allocated = ( *it )->allocate(
+       requirements.size, requirements.alignment, allocation.offset, allocation.nodeIdx );
+   CYDASSERT( allocated && "MemoryAllocator: Could not sub-allocate from a fresh block" );
+
+   allocation.vkMemory = vkMemory;
+   allocation.size     = requirements.size;
+   allocation.blockIdx = static_cast<uint32_t>( std::distance( pool.blocks.begin(), it ) );
+   allocation.pMapped  = pMapped ? static_cast<char*>( pMapped ) + allocation.offset : nullptr;
+
+   return allocation;
+}
+
+void MemoryAllocator::free( MemoryAllocation& allocation )
+{
+   if( !allocation.vkMemory )
+   {
+      return;
+   }
+
+   std::scoped_lock<std::mutex> lock( m_mutex );
+
+   if( allocation.dedicated )
+   {
+      vkFreeMemory( m_device.getVKDevice(), allocation.vkMemory, nullptr );
+
+      --m_dedicatedCount;
+      m_dedicatedBytes -= allocation.size;
+   }
+   else
+   {
+      Pool& pool                    = m_pools[allocation.poolIdx];
+      std::unique_ptr<Block>& block = pool.blocks[allocation.blockIdx];
+
+      block->free( allocation.nodeIdx );
+
+      // Keeping one block alive per pool to avoid thrashing on allocate/free patterns
+      if( block->isEmpty() )
+      {
+         const size_t liveBlocks = std::count_if(
+             pool.blocks.begin(), pool.blocks.end(), []( const std::unique_ptr<Block>& other ) {
+                return other != nullptr;
+             } );
+
+         if( liveBlocks > 1 )
+         {
+            vkFreeMemory( m_device.getVKDevice(), block->vkMemory, nullptr );
+            block.reset();
+         }
+      }
+   }
+
+   allocation = {};
+}
+
+// =================================================================================================
+// Statistics
+
+MemoryAllocator::Statistics MemoryAllocator::getStatistics() const
+{
+   std::scoped_lock<std::mutex> lock( m_mutex );
+
+   Statistics stats;
+   stats.dedicatedCount  = m_dedicatedCount;
+   stats.allocationCount = m_dedicatedCount;
+   stats.reservedBytes   = m_dedicatedBytes;
+   stats.usedBytes       = m_dedicatedBytes;
+
+   for( const Pool& pool : m_pools )
+   {
+      for( const auto& block : pool.blocks )
+      {
+         if( block )
+         {
+            stats.blockCount++;
+            stats.allocationCount += block->getAllocationCount();
+            stats.freeRegionCount += block->getFreeRegionCount();
+            stats.reservedBytes += block->size;
+            stats.usedBytes += block->getUsedBytes();
+            stats.largestFreeRegionBytes =
+                std::max( stats.largestFreeRegionBytes, block->getLargestFreeRegion() );
+         }
+      }
+   }
+
+   return stats;
+}
+
+void MemoryAllocator::printStatistics() const
+{
+   const Statistics stats = getStatistics();
+
+   printf(
+       "MemoryAllocator: %u allocations (%u dedicated) in %u blocks\n",
+       stats.allocationCount,
+       stats.dedicatedCount,
+       stats.blockCount );
+   printf(
+       "MemoryAllocator: %zu/%zu bytes used, %u free regions, largest free region %zu bytes\n",
+       stats.usedBytes,
+       stats.reservedBytes,
+       stats.freeRegionCount,
+       stats.largestFreeRegionBytes );
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+   for( Pool& pool : m_pools )
+   {
+      for( auto& block : pool.blocks )
+      {
+         if( block )
+         {
+            CYDASSERT(
+                block->isEmpty() &&
+                "MemoryAllocator: Destroying allocator while sub-allocations are still alive" );
+
+            vkFreeMemory( m_device.getVKDevice(), block->vkMemory, nullptr );
+         }
+      }
+   }
+}
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ================================================================================================
+// Forwards
+// ================================================================================================
+FWDHANDLE( VkDeviceMemory );
+struct VkMemoryRequirements;
+
+namespace vk
+{
+class Device;
+}
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * Device memory sub-allocator. Memory is requested from the driver in large blocks per memory
+ * type and split between resources using a two-level segregated fit (TLSF) scheme, which gives
+ * constant time allocations and frees. Linear (buffers) and optimal (images) resources are placed
+ * in separate blocks so bufferImageGranularity never has to be taken into account between two
+ * neighbouring allocations. Resources that are too large to share a block get their own
+ * dedicated device memory.
+ */
+namespace vk
+{
+struct MemoryAllocation
+{
+   VkDeviceMemory vkMemory = nullptr;
+   size_t offset           = 0;
+   size_t size             = 0;
+
+   // Points to the start of this allocation when the memory is host visible
+   void* pMapped = nullptr;
+
+   // Bookkeeping for the allocator
+   uint32_t poolIdx  = 0;
+   uint32_t blockIdx = 0;
+   uint32_t nodeIdx  = 0;
+   bool dedicated    = false;
+};
+
+class MemoryAllocator final
+{
+  public:
+   explicit MemoryAllocator( const Device& device );
+   NON_COPIABLE( MemoryAllocator );
+   ~MemoryAllocator();
+
+   enum class ResourceKind
+   {
+      LINEAR,  // Buffers and linearly tiled images
+      OPTIMAL  // Optimally tiled images
+   };
+
+   // Returns an empty allocation, with no device memory, when the device is out of memory
+   MemoryAllocation
+   allocate( const VkMemoryRequirements& requirements, uint32_t properties, ResourceKind kind );
+   void free( MemoryAllocation& allocation );
+
+   struct Statistics
+   {
+      uint32_t blockCount           = 0;
+      uint32_t dedicatedCount       = 0;
+      uint32_t allocationCount      = 0;
+      uint32_t freeRegionCount      = 0;
+      size_t reservedBytes          = 0;  // Device memory owned by the allocator
+      size_t usedBytes              = 0;  // Bytes handed out to resources
+      size_t largestFreeRegionBytes = 0;
+   };
+
+   Statistics getStatistics() const;
+   void printStatistics() const;
+
+  private:
+   class Block;
+   struct Pool;
+
+   uint32_t _poolIndex( uint32_t memoryTypeIdx, ResourceKind kind ) const;
+   MemoryAllocation _allocateDedicated( size_t size, uint32_t memoryTypeIdx );
+   VkDeviceMemory _allocateDeviceMemory( size_t size, uint32_t memoryTypeIdx, void** ppMapped );
+
+   const Device& m_device;
+
+   mutable std::mutex m_mutex;
+
+   std::vector<Pool> m_pools;
+   std::vector<bool> m_hostVisibleTypes;
+
+   size_t m_blockSize = 0;
+
+   uint32_t m_dedicatedCount = 0;
+   size_t m_dedicatedBytes   = 0;
+};
+}
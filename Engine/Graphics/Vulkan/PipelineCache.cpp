@@ -0,0 +1,309 @@
+#include <Graphics/Vulkan/PipelineCache.h>
+
+#include <Common/Assert.h>
+#include <Common/Vulkan.h>
+
+#include <Graphics/Vulkan/Device.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// Time in between two saves of a cache that changed
+static constexpr std::chrono::seconds SAVE_INTERVAL( 60 );
+
+// Pipelines taking longer than this to create are reported as they are created
+static constexpr double STALL_THRESHOLD_MS = 1.0;
+
+static constexpr uint32_t CACHE_FILE_MAGIC   = 0x43505943;  // "CYPC"
+static constexpr uint32_t CACHE_FILE_VERSION = 1;
+
+namespace vk
+{
+// Written in front of the data returned by the driver
+struct CacheFileHeader
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t vendorID;
+   uint32_t deviceID;
+   uint32_t driverVersion;
+   uint8_t driverUUID[VK_UUID_SIZE];
+   uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+   uint64_t dataSize;
+   uint64_t dataHash;
+};
+
+static uint64_t hashData( const char* pData, size_t size )
+{
+   // FNV-1a, only used to detect truncated or corrupted files
+   uint64_t hash = 0xcbf29ce484222325ULL;
+   for( size_t i = 0; i < size; ++i )
+   {
+      hash ^= static_cast<unsigned char>( pData[i] );
+      hash *= 0x100000001b3ULL;
+   }
+   return hash;
+}
+
+static CacheFileHeader getDeviceHeader( const Device& device )
+{
+   VkPhysicalDeviceIDProperties idProps = {};
+   idProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+
+   VkPhysicalDeviceProperties2 props = {};
+   props.sType                       = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+   props.pNext                       = &idProps;
+   vkGetPhysicalDeviceProperties2( device.getPhysicalDevice(), &props );
+
+   CacheFileHeader header = {};
+   header.magic           = CACHE_FILE_MAGIC;
+   header.version         = CACHE_FILE_VERSION;
+   header.vendorID        = props.properties.vendorID;
+   header.deviceID        = props.properties.deviceID;
+   header.driverVersion   = props.properties.driverVersion;
+   memcpy( header.driverUUID, idProps.driverUUID, VK_UUID_SIZE );
+   memcpy( header.pipelineCacheUUID, props.properties.pipelineCacheUUID, VK_UUID_SIZE );
+
+   return header;
+}
+
+PipelineCache::PipelineCache( const Device& device, std::string path )
+    : m_device( device ), m_path( std::move( path ) )
+{
+   const auto loadStart = std::chrono::steady_clock::now();
+
+   std::vector<char> data;
+   m_stats.seededFromDisk = _load( data );
+
+   VkPipelineCacheCreateInfo cacheInfo = {};
+   cacheInfo.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+   cacheInfo.initialDataSize           = data.size();
+   cacheInfo.pInitialData              = data.data();
+
+   VkResult result =
+       vkCreatePipelineCache( m_device.getVKDevice(), &cacheInfo, nullptr, &m_vkCache );
+   if( result != VK_SUCCESS && m_stats.seededFromDisk )
+   {
+      // The driver refused the data, starting over with an empty cache
+      m_stats.seededFromDisk = false;
+
+      cacheInfo.initialDataSize = 0;
+      cacheInfo.pInitialData    = nullptr;
+
+      result = vkCreatePipelineCache( m_device.getVKDevice(), &cacheInfo, nullptr, &m_vkCache );
+   }
+   CYDASSERT( result == VK_SUCCESS && "PipelineCache: Could not create pipeline cache" );
+
+   const auto loadEnd = std::chrono::steady_clock::now();
+
+   m_stats.loadedBytes = m_stats.seededFromDisk ? data.size() : 0;
+   m_stats.loadDurationMs =
+       std::chrono::duration<double, std::milli>( loadEnd - loadStart ).count();
+
+   m_lastSave = loadEnd;
+
+   printf(
+       "PipelineCache: %s start, %zu bytes loaded from %s in %.2f ms\n",
+       m_stats.seededFromDisk ? "Warm" : "Cold",
+       m_stats.loadedBytes,
+       m_path.c_str(),
+       m_stats.loadDurationMs );
+}
+
+bool PipelineCache::_load( std::vector<char>& data ) const
+{
+   std::ifstream file( m_path, std::ios::binary | std::ios::ate );
+   if( !file.is_open() )
+   {
+      return false;
+   }
+
+   const size_t fileSize = static_cast<size_t>( file.tellg() );
+   if( fileSize < sizeof( CacheFileHeader ) )
+   {
+      return false;
+   }
+
+   CacheFileHeader fileHeader = {};
+   file.seekg( 0 );
+   file.read( reinterpret_cast<char*>( &fileHeader ), sizeof( fileHeader ) );
+
+   // Pipeline caches are only valid for the exact device and driver that produced them
+   const CacheFileHeader deviceHeader = getDeviceHeader( m_device );
+   if( fileHeader.magic != deviceHeader.magic || fileHeader.version != deviceHeader.version ||
+       fileHeader.vendorID != deviceHeader.vendorID ||
+       fileHeader.deviceID != deviceHeader.deviceID ||
+       fileHeader.driverVersion != deviceHeader.driverVersion ||
+       memcmp( fileHeader.driverUUID, deviceHeader.driverUUID, VK_UUID_SIZE ) != 0 ||
+       memcmp( fileHeader.pipelineCacheUUID, deviceHeader.pipelineCacheUUID, VK_UUID_SIZE ) != 0 )
+   {
+      printf( "PipelineCache: %s was produced by another device or driver\n", m_path.c_str() );
+      return false;
+   }
+
+   if( fileHeader.dataSize != fileSize - sizeof( CacheFileHeader ) )
+   {
+      printf( "PipelineCache: %s is truncated\n", m_path.c_str() );
+      return false;
+   }
+
+   data.resize( static_cast<size_t>( fileHeader.dataSize ) );
+   file.read( data.data(), data.size() );
+
+   if( !file || hashData( data.data(), data.size() ) != fileHeader.dataHash )
+   {
+      printf( "PipelineCache: %s is corrupted\n", m_path.c_str() );
+      data.clear();
+      return false;
+   }
+
+   return true;
+}
+
+bool PipelineCache::save()
+{
+   std::lock_guard<std::mutex> lock( m_mutex );
+   return _save();
+}
+
+bool PipelineCache::_save()
+{
+   size_t dataSize = 0;
+   VkResult result =
+       vkGetPipelineCacheData( m_device.getVKDevice(), m_vkCache, &dataSize, nullptr );
+   if( result != VK_SUCCESS )
+   {
+      return false;
+   }
+
+   std::vector<char> data( dataSize );
+   result = vkGetPipelineCacheData( m_device.getVKDevice(), m_vkCache, &dataSize, data.data() );
+   if( result != VK_SUCCESS )
+   {
+      return false;
+   }
+
+   CacheFileHeader header = getDeviceHeader( m_device );
+   header.dataSize        = dataSize;
+   header.dataHash        = hashData( data.data(), dataSize );
+
+   // Writing to a temporary file first, an interrupted save leaves the previous cache intact
+   const std::string tempPath = m_path + ".tmp";
+   {
+      std::ofstream file( tempPath, std::ios::binary | std::ios::trunc );
+      if( !file.is_open() )
+      {
+         return false;
+      }
+
+      file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+      file.write( data.data(), dataSize );
+      if( !file )
+      {
+         return false;
+      }
+   }
+
+   std::error_code error;
+   std::filesystem::rename( tempPath, m_path, error );
+   if( error )
+   {
+      return false;
+   }
+
+   m_dirty    = false;
+   m_lastSave = std::chrono::steady_clock::now();
+
+   return true;
+}
+
+void PipelineCache::update()
+{
+   std::lock_guard<std::mutex> lock( m_mutex );
+
+   const auto now = std::chrono::steady_clock::now();
+   if( m_dirty && now - m_lastSave >= SAVE_INTERVAL )
+   {
+      // Not retrying before the next interval when the save fails
+      m_lastSave = now;
+      _save();
+   }
+}
+
+void PipelineCache::onPipelineCreated( const char* name, double durationMs, Lookup lookup )
+{
+   std::lock_guard<std::mutex> lock( m_mutex );
+
+   m_dirty = true;
+
+   switch( lookup )
+   {
+      case Lookup::HIT:
+         m_stats.hitCount++;
+         m_stats.hitTotalMs += durationMs;
+         break;
+      case Lookup::MISS:
+         m_stats.missCount++;
+         m_stats.missTotalMs += durationMs;
+         break;
+      case Lookup::UNKNOWN:
+         m_stats.unknownCount++;
+         m_stats.unknownTotalMs += durationMs;
+         break;
+   }
+
+   m_stats.slowestMs = std::max( m_stats.slowestMs, durationMs );
+
+   if( durationMs >= STALL_THRESHOLD_MS )
+   {
+      static constexpr const char* LOOKUP_STRINGS[] = { "unknown", "cache hit", "cache miss" };
+      printf(
+          "PipelineCache: %s took %.2f ms to create (%s)\n",
+          name,
+          durationMs,
+          LOOKUP_STRINGS[static_cast<uint32_t>( lookup )] );
+   }
+}
+
+PipelineCache::Statistics PipelineCache::getStatistics() const
+{
+   std::lock_guard<std::mutex> lock( m_mutex );
+   return m_stats;
+}
+
+void PipelineCache::printStatistics() const
+{
+   std::lock_guard<std::mutex> lock( m_mutex );
+
+   printf(
+       "PipelineCache: %s start, %zu bytes loaded in %.2f ms\n",
+       m_stats.seededFromDisk ? "Warm" : "Cold",
+       m_stats.loadedBytes,
+       m_stats.loadDurationMs );
+   printf(
+       "PipelineCache: %u hits in %.2f ms, %u misses in %.2f ms, %u unknown in %.2f ms, slowest "
+       "%.2f ms\n",
+       m_stats.hitCount,
+       m_stats.hitTotalMs,
+       m_stats.missCount,
+       m_stats.missTotalMs,
+       m_stats.unknownCount,
+       m_stats.unknownTotalMs,
+       m_stats.slowestMs );
+}
+
+PipelineCache::~PipelineCache()
+{
+   printStatistics();
+
+   if( m_dirty || !m_stats.seededFromDisk )
+   {
+      _save();
+   }
+
+   vkDestroyPipelineCache( m_device.getVKDevice(), m_vkCache, nullptr );
+}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// ================================================================================================
+// Forwards
+// ================================================================================================
+FWDHANDLE( VkPipelineCache );
+
+namespace vk
+{
+class Device;
+}
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * Pipeline cache persisted on disk in between runs. The file starts with a header identifying
+ * the vendor, device and driver that produced the data, a cache produced by anything else is
+ * discarded and pipelines are compiled from scratch again.
+ *
+ * The cache is written back when it is destroyed, and periodically when new pipelines were
+ * created so that a crash does not lose everything that was compiled during the run.
+ *
+ * Pipelines can be created from several threads at once, the Vulkan cache is internally
+ * synchronized and the bookkeeping here is guarded by a mutex.
+ */
+namespace vk
+{
+class PipelineCache final
+{
+  public:
+   PipelineCache( const Device& device, std::string path );
+   NON_COPIABLE( PipelineCache );
+   ~PipelineCache();
+
+   VkPipelineCache getVKPipelineCache() const noexcept { return m_vkCache; }
+
+   // Writes the cache to disk if there is something new and enough time has passed since the
+   // last save, should be called every frame
+   void update();
+   bool save();
+
+   // Creation tracking
+   // =============================================================================================
+   enum class Lookup
+   {
+      UNKNOWN,  // The driver does not tell, VK_EXT_pipeline_creation_feedback is not supported
+      HIT,
+      MISS
+   };
+
+   void onPipelineCreated( const char* name, double durationMs, Lookup lookup );
+
+   struct Statistics
+   {
+      bool seededFromDisk   = false;
+      size_t loadedBytes    = 0;
+      double loadDurationMs = 0.0;
+
+      uint32_t hitCount     = 0;
+      uint32_t missCount    = 0;
+      uint32_t unknownCount = 0;
+      double hitTotalMs     = 0.0;
+      double missTotalMs    = 0.0;
+      double unknownTotalMs = 0.0;
+      double slowestMs      = 0.0;
+   };
+
+   Statistics getStatistics() const;
+   void printStatistics() const;
+
+  private:
+   bool _load( std::vector<char>& data ) const;
+   bool _save();
+
+   const Device& m_device;
+   const std::string m_path;
+
+   VkPipelineCache m_vkCache = nullptr;
+
+   // Pipelines were created since the last save
+   bool m_dirty = false;
+   std::chrono::steady_clock::time_point m_lastSave;
+
+   Statistics m_stats;
+
+   mutable std::mutex m_mutex;
+};
+}
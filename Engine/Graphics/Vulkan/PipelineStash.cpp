@@ -6,19 +6,67 @@
 #include <Graphics/GraphicsTypes.h>
 
 #include <Graphics/Vulkan/Device.h>
+#include <Graphics/Vulkan/PipelineCache.h>
 #include <Graphics/Vulkan/Shader.h>
 #include <Graphics/Vulkan/ShaderStash.h>
 #include <Graphics/Vulkan/TypeConversions.h>
 
-#include <array>
+#include <algorithm>
+#include <chrono>
 #include <unordered_set>
 #include <vector>
 
+static constexpr char PIPELINE_CACHE_PATH[] = "Data/Pipelines/PipelineCache.bin";
+
+// Drivers tend to serialize compilation past a few threads, and the game needs the other cores
+static constexpr uint32_t MAX_COMPILE_THREADS = 4;
+
 namespace vk
 {
 PipelineStash::PipelineStash( const Device& device ) : m_device( device )
 {
    m_shaderStash = std::make_unique<ShaderStash>( m_device );
+   m_cache       = std::make_unique<PipelineCache>( m_device, PIPELINE_CACHE_PATH );
+
+   // Leaving a core to the main thread
+   const uint32_t hardwareThreads = std::thread::hardware_concurrency();
+   const uint32_t threadCount =
+       std::clamp( hardwareThreads > 1 ? hardwareThreads - 1 : 1, 1u, MAX_COMPILE_THREADS );
+
+   m_workers.reserve( threadCount );
+   for( uint32_t i = 0; i < threadCount; ++i )
+   {
+      m_workers.emplace_back( &PipelineStash::_workerLoop, this );
+   }
+}
+
+size_t PipelineStash::GraphicsKeyHash::operator()( const GraphicsKey& key ) const
+{
+   size_t seed = 0;
+   hashCombine( seed, key.info );
+   hashCombine( seed, key.renderPass );
+   return seed;
+}
+
+void PipelineStash::update() { m_cache->update(); }
+
+static PipelineCache::Lookup getLookup( const VkPipelineCreationFeedbackEXT& feedback )
+{
+   if( !( feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT ) )
+   {
+      return PipelineCache::Lookup::UNKNOWN;
+   }
+   if( feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT )
+   {
+      return PipelineCache::Lookup::HIT;
+   }
+   return PipelineCache::Lookup::MISS;
+}
+
+static double elapsedMs( std::chrono::steady_clock::time_point start )
+{
+   const auto end = std::chrono::steady_clock::now();
+   return std::chrono::duration<double, std::milli>( end - start ).count();
 }
 
 static VkShaderStageFlagBits shaderTypeToVKShaderStage( Shader::Type shaderType )
@@ -37,6 +85,18 @@ static VkShaderStageFlagBits shaderTypeToVKShaderStage( Shader::Type shaderType
 }
 
 const VkDescriptorSetLayout PipelineStash::findOrCreate( const CYD::DescriptorSetLayoutInfo& info )
+{
+   std::lock_guard<std::mutex> lock( m_layoutMutex );
+   return _findOrCreate( info );
+}
+
+const VkPipelineLayout PipelineStash::findOrCreate( const CYD::PipelineLayoutInfo& info )
+{
+   std::lock_guard<std::mutex> lock( m_layoutMutex );
+   return _findOrCreate( info );
+}
+
+const VkDescriptorSetLayout PipelineStash::_findOrCreate( const CYD::DescriptorSetLayoutInfo& info )
 {
    // Creating the descriptor set layout
    const auto layoutIt = m_descSetLayouts.find( info );
@@ -48,6 +108,9 @@ const VkDescriptorSetLayout PipelineStash::findOrCreate( const CYD::DescriptorSe
    std::vector<VkDescriptorSetLayoutBinding> descSetLayoutBindings;
    std::vector<VkDescriptorBindingFlagsEXT> descBindingFlags;
    descSetLayoutBindings.reserve( info.shaderResources.size() );
+   descBindingFlags.reserve( info.shaderResources.size() );
+
+   bool isBindless = false;
    for( const auto& object : info.shaderResources )
    {
       // TODO Add UBO arrays
@@ -58,14 +121,45 @@ const VkDescriptorSetLayout PipelineStash::findOrCreate( const CYD::DescriptorSe
       descSetLayoutBinding.stageFlags      = TypeConversions::cydToVkShaderStages( object.stages );
       descSetLayoutBinding.pImmutableSamplers = nullptr;
 
+      VkDescriptorBindingFlagsEXT bindingFlags = 0;
+      if( object.type == CYD::ShaderResourceType::BINDLESS_TEXTURES )
+      {
+         // Always the exact same binding so that all bindless layouts are identically defined
+         // and the set of the bindless table can be bound with any of them
+         descSetLayoutBinding.descriptorCount = m_device.getBindlessCapacity();
+         descSetLayoutBinding.stageFlags      = VK_SHADER_STAGE_ALL;
+
+         bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+                        VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+                        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+         isBindless = true;
+      }
+
       descSetLayoutBindings.push_back( descSetLayoutBinding );
+      descBindingFlags.push_back( bindingFlags );
    }
 
+   CYDASSERT(
+       ( !isBindless || m_device.getBindlessCapacity() > 0 ) &&
+       "PipelineStash: Bindless shader resource used without descriptor indexing support" );
+
+   VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo = {};
+   bindingFlagsInfo.sType =
+       VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+   bindingFlagsInfo.bindingCount  = static_cast<uint32_t>( descBindingFlags.size() );
+   bindingFlagsInfo.pBindingFlags = descBindingFlags.data();
+
    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
    layoutInfo.sType                           = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
    layoutInfo.bindingCount = static_cast<uint32_t>( descSetLayoutBindings.size() );
    layoutInfo.pBindings    = descSetLayoutBindings.data();
 
+   if( isBindless )
+   {
+      layoutInfo.pNext = &bindingFlagsInfo;
+      layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+   }
+
    VkDescriptorSetLayout descSetLayout;
    VkResult result =
        vkCreateDescriptorSetLayout( m_device.getVKDevice(), &layoutInfo, nullptr, &descSetLayout );
@@ -74,7 +168,7 @@ const VkDescriptorSetLayout PipelineStash::findOrCreate( const CYD::DescriptorSe
    return m_descSetLayouts.insert( { info, descSetLayout } ).first->second;
 }
 
-const VkPipelineLayout PipelineStash::findOrCreate( const CYD::PipelineLayoutInfo& info )
+const VkPipelineLayout PipelineStash::_findOrCreate( const CYD::PipelineLayoutInfo& info )
 {
    const auto layoutIt = m_pipLayouts.find( info );
    if( layoutIt != m_pipLayouts.end() )
@@ -98,7 +192,7 @@ const VkPipelineLayout PipelineStash::findOrCreate( const CYD::PipelineLayoutInf
    descSetLayouts.reserve( info.descSets.size() );
    for( const auto& descSetLayout : info.descSets )
    {
-      descSetLayouts.push_back( findOrCreate( descSetLayout ) );
+      descSetLayouts.push_back( _findOrCreate( descSetLayout ) );
    }
    // Vector containing unique VkDescriptorSetLayouts
    std::vector<VkDescriptorSetLayout> descSetLayoutsVec(
@@ -119,15 +213,8 @@ const VkPipelineLayout PipelineStash::findOrCreate( const CYD::PipelineLayoutInf
    return m_pipLayouts.insert( { info, pipLayout } ).first->second;
 }
 
-const VkPipeline PipelineStash::findOrCreate( const CYD::ComputePipelineInfo& info )
+VkPipeline PipelineStash::_createPipeline( const CYD::ComputePipelineInfo& info )
 {
-   // Attempting to find pipeline
-   const auto pipIt = m_computePipelines.find( info );
-   if( pipIt != m_computePipelines.end() )
-   {
-      return pipIt->second;
-   }
-
    VkResult result;
 
    // Building shader constants
@@ -179,25 +266,43 @@ const VkPipeline PipelineStash::findOrCreate( const CYD::ComputePipelineInfo& in
    pipelineInfo.basePipelineHandle          = nullptr;
    pipelineInfo.basePipelineIndex           = -1;
 
-   VkPipeline pipeline;
+   // Finding out if the pipeline cache had it, when the driver can tell
+   VkPipelineCreationFeedbackEXT pipFeedback   = {};
+   VkPipelineCreationFeedbackEXT stageFeedback = {};
+
+   VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo = {};
+   feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+   feedbackInfo.pPipelineCreationFeedback          = &pipFeedback;
+   feedbackInfo.pipelineStageCreationFeedbackCount = 1;
+   feedbackInfo.pPipelineStageCreationFeedbacks    = &stageFeedback;
+
+   if( m_device.supportsCreationFeedback() )
+   {
+      pipelineInfo.pNext = &feedbackInfo;
+   }
+
+   const auto createStart = std::chrono::steady_clock::now();
+
+   VkPipeline pipeline = nullptr;
    result = vkCreateComputePipelines(
-       m_device.getVKDevice(), nullptr, 1, &pipelineInfo, nullptr, &pipeline );
+       m_device.getVKDevice(),
+       m_cache->getVKPipelineCache(),
+       1,
+       &pipelineInfo,
+       nullptr,
+       &pipeline );
    CYDASSERT( result == VK_SUCCESS && "PipelineStash: Could not create compute pipeline" );
 
-   return m_computePipelines.insert( { info, pipeline } ).first->second;
+   m_cache->onPipelineCreated(
+       info.shader.c_str(), elapsedMs( createStart ), getLookup( pipFeedback ) );
+
+   return pipeline;
 }
 
-const VkPipeline PipelineStash::findOrCreate(
+VkPipeline PipelineStash::_createPipeline(
     const CYD::GraphicsPipelineInfo& info,
     VkRenderPass renderPass )
 {
-   // Attempting to find pipeline
-   const auto pipIt = m_graphicsPipelines.find( info );
-   if( pipIt != m_graphicsPipelines.end() )
-   {
-      return pipIt->second;
-   }
-
    VkResult result;
 
    // Scope protection for shader info structs
@@ -259,35 +364,23 @@ const VkPipeline PipelineStash::findOrCreate(
    // TODO Instancing
    VkVertexInputBindingDescription vertexBindingDesc = {};
    vertexBindingDesc.binding                         = 0;
-   vertexBindingDesc.stride                          = sizeof( CYD::Vertex );
+   vertexBindingDesc.stride                          = info.vertexLayout.stride;
    vertexBindingDesc.inputRate                       = VK_VERTEX_INPUT_RATE_VERTEX;
 
-   // Vertex attributes
-   std::array<VkVertexInputAttributeDescription, 4> attributeDescs = {};
-
-   // Position
-   attributeDescs[0].binding  = 0;
-   attributeDescs[0].location = 0;
-   attributeDescs[0].format   = VK_FORMAT_R32G32B32_SFLOAT;
-   attributeDescs[0].offset   = offsetof( CYD::Vertex, pos );
-
-   // Color
-   attributeDescs[1].binding  = 0;
-   attributeDescs[1].location = 1;
-   attributeDescs[1].format   = VK_FORMAT_R32G32B32A32_SFLOAT;
-   attributeDescs[1].offset   = offsetof( CYD::Vertex, col );
-
-   // Texture Coordinates
-   attributeDescs[3].binding  = 0;
-   attributeDescs[3].location = 2;
-   attributeDescs[3].format   = VK_FORMAT_R32G32B32_SFLOAT;
-   attributeDescs[3].offset   = offsetof( CYD::Vertex, uv );
-
-   // Normals
-   attributeDescs[2].binding  = 0;
-   attributeDescs[2].location = 3;
-   attributeDescs[2].format   = VK_FORMAT_R32G32B32_SFLOAT;
-   attributeDescs[2].offset   = offsetof( CYD::Vertex, normal );
+   // Vertex attributes, as declared by the pipeline
+   std::vector<VkVertexInputAttributeDescription> attributeDescs;
+   attributeDescs.reserve( info.vertexLayout.attributes.size() );
+
+   for( const CYD::VertexAttribute& attribute : info.vertexLayout.attributes )
+   {
+      VkVertexInputAttributeDescription attributeDesc = {};
+      attributeDesc.binding                           = 0;
+      attributeDesc.location = static_cast<uint32_t>( attribute.semantic );
+      attributeDesc.format   = TypeConversions::cydToVkFormat( attribute.format );
+      attributeDesc.offset   = attribute.offset;
+
+      attributeDescs.push_back( attributeDesc );
+   }
 
    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -402,23 +495,193 @@ const VkPipeline PipelineStash::findOrCreate(
    pipelineInfo.subpass                      = 0;
    pipelineInfo.basePipelineHandle           = nullptr;
 
-   VkPipeline pipeline;
+   // Finding out if the pipeline cache had it, when the driver can tell
+   VkPipelineCreationFeedbackEXT pipFeedback = {};
+   std::vector<VkPipelineCreationFeedbackEXT> stageFeedbacks( shaderCreateInfos.size() );
+
+   VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo = {};
+   feedbackInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+   feedbackInfo.pPipelineCreationFeedback = &pipFeedback;
+   feedbackInfo.pipelineStageCreationFeedbackCount =
+       static_cast<uint32_t>( stageFeedbacks.size() );
+   feedbackInfo.pPipelineStageCreationFeedbacks = stageFeedbacks.data();
+
+   if( m_device.supportsCreationFeedback() )
+   {
+      pipelineInfo.pNext = &feedbackInfo;
+   }
+
+   const auto createStart = std::chrono::steady_clock::now();
+
+   VkPipeline pipeline = nullptr;
    result = vkCreateGraphicsPipelines(
-       m_device.getVKDevice(), nullptr, 1, &pipelineInfo, nullptr, &pipeline );
+       m_device.getVKDevice(),
+       m_cache->getVKPipelineCache(),
+       1,
+       &pipelineInfo,
+       nullptr,
+       &pipeline );
    CYDASSERT( result == VK_SUCCESS && "PipelineStash: Could not create graphics pipeline" );
 
-   return m_graphicsPipelines.insert( { info, pipeline } ).first->second;
+   m_cache->onPipelineCreated(
+       info.shaders.front().c_str(), elapsedMs( createStart ), getLookup( pipFeedback ) );
+
+   return pipeline;
+}
+
+PipelineStash::PipelineFuture PipelineStash::_request(
+    const CYD::GraphicsPipelineInfo& info,
+    VkRenderPass renderPass,
+    bool async )
+{
+   PipelineTask task;
+   PipelineFuture future;
+   {
+      std::lock_guard<std::mutex> lock( m_pipelineMutex );
+
+      GraphicsKey key = { info, renderPass };
+
+      const auto pipIt = m_graphicsPipelines.find( key );
+      if( pipIt != m_graphicsPipelines.end() )
+      {
+         return pipIt->second;
+      }
+
+      // Registering the future before compiling so that nobody else compiles it in the meantime
+      task = PipelineTask(
+          [this, info, renderPass]() { return _createPipeline( info, renderPass ); } );
+      future = task.get_future().share();
+
+      m_graphicsPipelines.insert( { std::move( key ), future } );
+   }
+
+   _run( std::move( task ), async );
+   return future;
+}
+
+PipelineStash::PipelineFuture PipelineStash::_request(
+    const CYD::ComputePipelineInfo& info,
+    bool async )
+{
+   PipelineTask task;
+   PipelineFuture future;
+   {
+      std::lock_guard<std::mutex> lock( m_pipelineMutex );
+
+      const auto pipIt = m_computePipelines.find( info );
+      if( pipIt != m_computePipelines.end() )
+      {
+         return pipIt->second;
+      }
+
+      task   = PipelineTask( [this, info]() { return _createPipeline( info ); } );
+      future = task.get_future().share();
+
+      m_computePipelines.insert( { info, future } );
+   }
+
+   _run( std::move( task ), async );
+   return future;
+}
+
+void PipelineStash::_run( PipelineTask&& task, bool async )
+{
+   if( !async )
+   {
+      task();
+      return;
+   }
+
+   {
+      std::lock_guard<std::mutex> lock( m_jobMutex );
+      m_jobs.push_back( std::move( task ) );
+   }
+   m_jobCondition.notify_one();
+}
+
+void PipelineStash::_workerLoop()
+{
+   for( ;; )
+   {
+      PipelineTask task;
+      {
+         std::unique_lock<std::mutex> lock( m_jobMutex );
+         m_jobCondition.wait( lock, [this]() { return m_stopWorkers || !m_jobs.empty(); } );
+
+         // Going through the remaining jobs before stopping so that every future is fulfilled
+         if( m_jobs.empty() )
+         {
+            return;
+         }
+
+         task = std::move( m_jobs.front() );
+         m_jobs.pop_front();
+      }
+
+      task();
+   }
+}
+
+const VkPipeline PipelineStash::findOrCreate(
+    const CYD::GraphicsPipelineInfo& info,
+    VkRenderPass renderPass )
+{
+   return _request( info, renderPass, false ).get();
+}
+
+const VkPipeline PipelineStash::findOrCreate( const CYD::ComputePipelineInfo& info )
+{
+   return _request( info, false ).get();
+}
+
+std::shared_future<VkPipeline> PipelineStash::requestAsync(
+    const CYD::GraphicsPipelineInfo& info,
+    VkRenderPass renderPass )
+{
+   return _request( info, renderPass, true );
+}
+
+std::shared_future<VkPipeline> PipelineStash::requestAsync( const CYD::ComputePipelineInfo& info )
+{
+   return _request( info, true );
+}
+
+static bool isFutureReady( const std::shared_future<VkPipeline>& future )
+{
+   return future.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
+
+bool PipelineStash::isReady( const CYD::GraphicsPipelineInfo& info, VkRenderPass renderPass )
+{
+   return isFutureReady( requestAsync( info, renderPass ) );
+}
+
+bool PipelineStash::isReady( const CYD::ComputePipelineInfo& info )
+{
+   return isFutureReady( requestAsync( info ) );
 }
 
 PipelineStash::~PipelineStash()
 {
+   {
+      std::lock_guard<std::mutex> lock( m_jobMutex );
+      m_stopWorkers = true;
+   }
+   m_jobCondition.notify_all();
+
+   for( std::thread& worker : m_workers )
+   {
+      worker.join();
+   }
+
+   // Every future is fulfilled at this point
    for( const auto& pipeline : m_graphicsPipelines )
    {
-      vkDestroyPipeline( m_device.getVKDevice(), pipeline.second, nullptr );
+      vkDestroyPipeline( m_device.getVKDevice(), pipeline.second.get(), nullptr );
    }
    for( const auto& pipeline : m_computePipelines )
    {
-      vkDestroyPipeline( m_device.getVKDevice(), pipeline.second, nullptr );
+      vkDestroyPipeline( m_device.getVKDevice(), pipeline.second.get(), nullptr );
    }
    for( const auto& pipLayout : m_pipLayouts )
    {
@@ -428,5 +691,8 @@ PipelineStash::~PipelineStash()
    {
       vkDestroyDescriptorSetLayout( m_device.getVKDevice(), descSetLayout.second, nullptr );
    }
+
+   // Saving what was compiled during this run for the next one
+   m_cache.reset();
 }
 }
@@ -5,8 +5,14 @@
 #include <Graphics/GraphicsTypes.h>
 #include <Graphics/PipelineInfos.h>
 
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 // ================================================================================================
 // Forwards
@@ -20,11 +26,20 @@ namespace vk
 {
 class Device;
 class ShaderStash;
+class PipelineCache;
 }
 
 // ================================================================================================
 // Definition
 // ================================================================================================
+/*
+ * Owns every layout and pipeline of a device. Pipelines can be compiled on the calling thread
+ * with findOrCreate, or requested ahead of time with requestAsync and compiled by a small pool of
+ * worker threads. A pipeline that is already being compiled is never compiled twice, asking for
+ * it again returns the same future.
+ *
+ * Graphics pipelines are keyed with the render pass they were compiled for.
+ */
 namespace vk
 {
 class PipelineStash final
@@ -39,18 +54,78 @@ class PipelineStash final
 
    const VkPipelineLayout findOrCreate( const CYD::PipelineLayoutInfo& info );
 
+   // Blocking, waits for the pipeline when it is already being compiled
    const VkPipeline findOrCreate( const CYD::GraphicsPipelineInfo& info, VkRenderPass renderPass );
    const VkPipeline findOrCreate( const CYD::ComputePipelineInfo& info );
 
+   // Non-blocking, the pipeline is compiled on a worker thread
+   std::shared_future<VkPipeline> requestAsync(
+       const CYD::GraphicsPipelineInfo& info,
+       VkRenderPass renderPass );
+   std::shared_future<VkPipeline> requestAsync( const CYD::ComputePipelineInfo& info );
+
+   // Requests the pipeline if needed and tells if it can be bound without waiting
+   bool isReady( const CYD::GraphicsPipelineInfo& info, VkRenderPass renderPass );
+   bool isReady( const CYD::ComputePipelineInfo& info );
+
+   // Saves the pipeline cache periodically, should be called every frame
+   void update();
+
   private:
+   using PipelineFuture = std::shared_future<VkPipeline>;
+   using PipelineTask   = std::packaged_task<VkPipeline()>;
+
+   struct GraphicsKey
+   {
+      CYD::GraphicsPipelineInfo info;
+      VkRenderPass renderPass;
+
+      bool operator==( const GraphicsKey& other ) const
+      {
+         return renderPass == other.renderPass && info == other.info;
+      }
+   };
+
+   struct GraphicsKeyHash
+   {
+      size_t operator()( const GraphicsKey& key ) const;
+   };
+
+   PipelineFuture _request(
+       const CYD::GraphicsPipelineInfo& info,
+       VkRenderPass renderPass,
+       bool async );
+   PipelineFuture _request( const CYD::ComputePipelineInfo& info, bool async );
+   void _run( PipelineTask&& task, bool async );
+   void _workerLoop();
+
+   // Layouts, expect the layout mutex to be locked
+   const VkDescriptorSetLayout _findOrCreate( const CYD::DescriptorSetLayoutInfo& info );
+   const VkPipelineLayout _findOrCreate( const CYD::PipelineLayoutInfo& info );
+
+   // Pipelines, only touch the stash to get layouts and can run on any thread
+   VkPipeline _createPipeline( const CYD::GraphicsPipelineInfo& info, VkRenderPass renderPass );
+   VkPipeline _createPipeline( const CYD::ComputePipelineInfo& info );
+
    const Device& m_device;
 
    std::unique_ptr<ShaderStash> m_shaderStash;
+   std::unique_ptr<PipelineCache> m_cache;
 
+   std::mutex m_layoutMutex;
    std::unordered_map<CYD::DescriptorSetLayoutInfo, VkDescriptorSetLayout> m_descSetLayouts;
    std::unordered_map<CYD::PipelineLayoutInfo, VkPipelineLayout> m_pipLayouts;
-   
-   std::unordered_map<CYD::GraphicsPipelineInfo, VkPipeline> m_graphicsPipelines;
-   std::unordered_map<CYD::ComputePipelineInfo, VkPipeline> m_computePipelines;
+
+   // Pipelines that are either ready or being compiled
+   std::mutex m_pipelineMutex;
+   std::unordered_map<GraphicsKey, PipelineFuture, GraphicsKeyHash> m_graphicsPipelines;
+   std::unordered_map<CYD::ComputePipelineInfo, PipelineFuture> m_computePipelines;
+
+   // Compilation workers
+   std::mutex m_jobMutex;
+   std::condition_variable m_jobCondition;
+   std::deque<PipelineTask> m_jobs;
+   std::vector<std::thread> m_workers;
+   bool m_stopWorkers = false;
 };
 }
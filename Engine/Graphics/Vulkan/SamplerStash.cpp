@@ -6,9 +6,26 @@
 #include <Graphics/Vulkan/Device.h>
 #include <Graphics/Vulkan/TypeConversions.h>
 
+#include <algorithm>
+
 namespace vk
 {
-SamplerStash::SamplerStash( const Device& device ) : m_device( device ) {}
+SamplerStash::SamplerStash( const Device& device ) : m_device( device )
+{
+   VkPhysicalDeviceFeatures features = {};
+   vkGetPhysicalDeviceFeatures( m_device.getPhysicalDevice(), &features );
+
+   m_supportsAnisotropy = features.samplerAnisotropy;
+   m_maxAnisotropy      = m_device.getProperties()->limits.maxSamplerAnisotropy;
+
+   m_defaultSampler = findOrCreate( {} );
+
+   CYD::SamplerInfo mipmappedInfo = {};
+   mipmappedInfo.magFilter        = CYD::Filter::LINEAR;
+   mipmappedInfo.minFilter        = CYD::Filter::LINEAR;
+   mipmappedInfo.mipFilter        = CYD::Filter::LINEAR;
+   m_mipmappedSampler             = findOrCreate( mipmappedInfo );
+}
 
 const VkSampler SamplerStash::findOrCreate( const CYD::SamplerInfo& info )
 {
@@ -28,13 +45,18 @@ const VkSampler SamplerStash::findOrCreate( const CYD::SamplerInfo& info )
    samplerInfo.addressModeU            = addressMode;
    samplerInfo.addressModeV            = addressMode;
    samplerInfo.addressModeW            = addressMode;
-   samplerInfo.anisotropyEnable        = info.useAnisotropy;
-   samplerInfo.maxAnisotropy           = info.maxAnisotropy;
+   samplerInfo.anisotropyEnable        = info.useAnisotropy && m_supportsAnisotropy;
+   samplerInfo.maxAnisotropy           = std::clamp( info.maxAnisotropy, 1.0f, m_maxAnisotropy );
    samplerInfo.borderColor             = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
    samplerInfo.unnormalizedCoordinates = VK_FALSE;
    samplerInfo.compareEnable           = VK_FALSE;
    samplerInfo.compareOp               = VK_COMPARE_OP_ALWAYS;
-   samplerInfo.mipmapMode              = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+   samplerInfo.mipmapMode              = info.mipFilter == CYD::Filter::NEAREST
+                                             ? VK_SAMPLER_MIPMAP_MODE_NEAREST
+                                             : VK_SAMPLER_MIPMAP_MODE_LINEAR;
+   samplerInfo.minLod                  = info.minLod;
+   samplerInfo.maxLod                  = info.maxLod;
+   samplerInfo.mipLodBias              = info.lodBias;
 
    VkSampler vkSampler;
    VkResult result = vkCreateSampler( m_device.getVKDevice(), &samplerInfo, nullptr, &vkSampler );
@@ -29,8 +29,20 @@ class SamplerStash final
 
    const VkSampler findOrCreate( const CYD::SamplerInfo& info );
 
+   // Used for textures bound without a sampler, trilinear and anisotropic when they have mips
+   VkSampler getDefault( uint32_t mipLevels ) const
+   {
+      return mipLevels > 1 ? m_mipmappedSampler : m_defaultSampler;
+   }
+
   private:
    const Device& m_device;
    std::unordered_map<CYD::SamplerInfo, VkSampler> m_samplers;
+
+   bool m_supportsAnisotropy = false;
+   float m_maxAnisotropy     = 1.0f;
+
+   VkSampler m_defaultSampler   = nullptr;
+   VkSampler m_mipmappedSampler = nullptr;
 };
 }
@@ -5,16 +5,18 @@
 
 #include <Graphics/Vulkan/Device.h>
 
-#include <fstream>
-
 namespace vk
 {
-Shader::Shader( const Device& device, const std::string& shaderPath )
-    : m_device( device ), m_shaderPath( shaderPath )
+Shader::Shader(
+    const Device& device,
+    const std::string& shaderPath,
+    const void* pByteCode,
+    size_t byteCodeSize )
+    : m_device( device )
 {
    // Parsing shader type
-   size_t dotIndex  = m_shaderPath.find_last_of( "." );
-   std::string type = m_shaderPath.substr( dotIndex - 4, 4 );
+   size_t dotIndex  = shaderPath.find_last_of( "." );
+   std::string type = shaderPath.substr( dotIndex - 4, 4 );
 
    if( type == "VERT" )
    {
@@ -34,30 +36,15 @@ Shader::Shader( const Device& device, const std::string& shaderPath )
    }
 
    // Creating shader
-   _readShaderFile();
-   _createShaderModule();
-}
-
-void Shader::_readShaderFile()
-{
-   std::ifstream shaderFile( m_shaderPath, std::ios::ate | std::ios::binary );
-   CYDASSERT( shaderFile.is_open() && "Shader: Could not open shader file" );
-
-   size_t shaderSize = static_cast<size_t>( shaderFile.tellg() );
-
-   m_byteCode.resize( shaderSize );
-
-   shaderFile.seekg( 0 );
-   shaderFile.read( m_byteCode.data(), shaderSize );
-   shaderFile.close();
+   _createShaderModule( pByteCode, byteCodeSize );
 }
 
-void Shader::_createShaderModule()
+void Shader::_createShaderModule( const void* pByteCode, size_t byteCodeSize )
 {
    VkShaderModuleCreateInfo createInfo = {};
    createInfo.sType                    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-   createInfo.codeSize                 = m_byteCode.size();
-   createInfo.pCode                    = reinterpret_cast<const uint32_t*>( m_byteCode.data() );
+   createInfo.codeSize                 = byteCodeSize;
+   createInfo.pCode                    = static_cast<const uint32_t*>( pByteCode );
 
    VkResult result =
        vkCreateShaderModule( m_device.getVKDevice(), &createInfo, nullptr, &m_vkShader );
@@ -2,8 +2,8 @@
 
 #include <Common/Include.h>
 
+#include <cstddef>
 #include <string>
-#include <vector>
 
 // ================================================================================================
 // Forwards
@@ -23,7 +23,12 @@ namespace vk
 class Shader final
 {
   public:
-   Shader( const Device& device, const std::string& shaderName );
+   // The byte code only has to live for the duration of the constructor
+   Shader(
+       const Device& device,
+       const std::string& shaderPath,
+       const void* pByteCode,
+       size_t byteCodeSize );
    ~Shader();
 
    enum class Type
@@ -38,13 +43,10 @@ class Shader final
    const VkShaderModule& getModule() const { return m_vkShader; }
 
   private:
-   void _readShaderFile();
-   void _createShaderModule();
+   void _createShaderModule( const void* pByteCode, size_t byteCodeSize );
 
    const Device& m_device;
 
-   std::vector<char> m_byteCode;
-   std::string m_shaderPath;
    Type m_type;
 
    VkShaderModule m_vkShader;
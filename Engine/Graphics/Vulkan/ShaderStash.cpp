@@ -2,39 +2,79 @@
 
 #include <Common/Assert.h>
 
+#include <Graphics/Utility/MappedFile.h>
 #include <Graphics/Vulkan/Shader.h>
 
-#include <filesystem>
+#include <cstring>
 
 // Hard-coded shader directories
 static constexpr char SPIRV_SHADER_DIR[] = "Data/Shaders/SPIR-V/";
 
 namespace vk
 {
-ShaderStash::ShaderStash( const Device& device ) : _device( device ) { _initializeAllShaders(); }
+static uint64_t hashByteCode( const void* pData, size_t size )
+{
+   // FNV-1a over the SPIR-V words, the size is mixed in so that only equal sizes can collide
+   const uint32_t* pWords = static_cast<const uint32_t*>( pData );
+
+   uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+   for( size_t i = 0; i < size / sizeof( uint32_t ); ++i )
+   {
+      hash ^= pWords[i];
+      hash *= 0x100000001b3ULL;
+   }
+   return hash;
+}
+
+ShaderStash::ShaderStash( const Device& device ) : m_device( device ) {}
 ShaderStash::~ShaderStash() = default;
 
-void ShaderStash::_initializeAllShaders()
+const Shader* ShaderStash::getShader( const std::string& shaderName )
 {
-   auto directory = std::filesystem::directory_iterator( SPIRV_SHADER_DIR );
-   CYDASSERT( directory->exists() && "ShaderStash: Could not find compiled shader directory" );
+   std::lock_guard<std::mutex> lock( m_mutex );
 
-   for( const auto& entry : directory )
+   const auto it = m_shaders.find( shaderName );
+   if( it != m_shaders.end() )
    {
-      std::string shaderPath = entry.path().generic_string();
-
-      _shaders.insert( {shaderPath, std::make_unique<Shader>( _device, shaderPath )} );
+      return it->second;
    }
+
+   const Shader* shader = _loadShader( shaderName );
+   m_shaders.insert( { shaderName, shader } );
+
+   return shader;
 }
 
-const Shader* ShaderStash::getShader( const std::string& shaderName )
+const Shader* ShaderStash::_loadShader( const std::string& shaderName )
 {
-   auto it = _shaders.find( SPIRV_SHADER_DIR + shaderName + ".spv" );
-   if( it != _shaders.end() )
+   const std::string shaderPath = SPIRV_SHADER_DIR + shaderName + ".spv";
+
+   // The file is only mapped for as long as it takes the driver to create the module
+   CYD::MappedFile file;
+   if( !file.open( shaderPath ) )
    {
-      return it->second.get();
+      CYDASSERT( !"ShaderStash: Could not find shader in herder" );
+      return nullptr;
    }
-   CYDASSERT( !"ShaderStash: Could not find shader in herder" );
-   return nullptr;
+
+   const uint64_t hash = hashByteCode( file.getData(), file.getSize() );
+
+   // Same hash and size, only the byte code itself can tell if the module can be shared
+   std::vector<Module>& modules = m_modules[hash];
+   for( const Module& module : modules )
+   {
+      CYD::MappedFile otherFile;
+      if( otherFile.open( module.path ) && otherFile.getSize() == file.getSize() &&
+          memcmp( otherFile.getData(), file.getData(), file.getSize() ) == 0 )
+      {
+         return module.shader.get();
+      }
+   }
+
+   modules.push_back(
+       { shaderPath,
+         std::make_unique<Shader>( m_device, shaderPath, file.getData(), file.getSize() ) } );
+
+   return modules.back().shader.get();
+}
 }
-}
\ No newline at end of file
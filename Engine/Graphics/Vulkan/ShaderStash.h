@@ -1,7 +1,13 @@
 #pragma once
 
+#include <Common/Include.h>
+
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 // ================================================================================================
 // Forwards
@@ -15,22 +21,42 @@ class Shader;
 // ================================================================================================
 // Definition
 // ================================================================================================
+/*
+ * Shader modules are only created the first time they are asked for, straight from the mapped
+ * SPIR-V file. Shaders whose byte code is identical share the same module.
+ *
+ * Looking a shader up is a single map find once it is loaded, no path is built for it.
+ * Safe to use from the pipeline compilation workers.
+ */
 namespace vk
 {
 class ShaderStash final
 {
   public:
    explicit ShaderStash( const Device& device );
+   NON_COPIABLE( ShaderStash );
    ~ShaderStash();
 
    // Shader names are unique. Shader types are inferred from file name
    const Shader* getShader( const std::string& shaderName );
 
   private:
-   void _initializeAllShaders();
+   const Shader* _loadShader( const std::string& shaderName );
+
+   const Device& m_device;
+
+   std::mutex m_mutex;
+
+   // Shaders that were requested at least once, by name
+   std::unordered_map<std::string, const Shader*> m_shaders;
 
-   const Device& _device;
+   struct Module
+   {
+      std::string path;  // Mapped again to tell apart byte codes whose hash collide
+      std::unique_ptr<Shader> shader;
+   };
 
-   std::unordered_map<std::string, std::unique_ptr<Shader>> _shaders;
+   // Modules keyed by the hash of their byte code
+   std::unordered_map<uint64_t, std::vector<Module>> m_modules;
 };
 }
@@ -0,0 +1,672 @@
+#include <Graphics/Vulkan/StagingRing.h>
+
+#include <Common/Assert.h>
+#include <Common/Vulkan.h>
+
+#include <Graphics/Vulkan/Device.h>
+#include <Graphics/Vulkan/Buffer.h>
+#include <Graphics/Vulkan/Texture.h>
+#include <Graphics/Vulkan/CommandBuffer.h>
+#include <Graphics/Vulkan/BarriersHelper.h>
+
+#include <algorithm>
+#include <cstring>
+
+// Satisfies the offset requirements of both buffer and buffer to image copies
+static constexpr size_t STAGING_ALIGNMENT = 16;
+
+static size_t alignUp( size_t value, size_t alignment )
+{
+   return ( value + alignment - 1 ) & ~( alignment - 1 );
+}
+
+namespace vk
+{
+// Size of a mip level, all layers included
+static size_t getLevelSize( const Texture* texture, uint32_t level )
+{
+   const size_t texelCount =
+       static_cast<size_t>( texture->getWidth() ) * texture->getHeight() * texture->getLayers();
+   const size_t texelSize = texture->getSize() / texelCount;
+
+   const size_t width  = std::max( texture->getWidth() >> level, 1u );
+   const size_t height = std::max( texture->getHeight() >> level, 1u );
+   return width * height * texelSize * texture->getLayers();
+}
+
+static size_t getMipChainSize( const Texture* texture )
+{
+   size_t size = 0;
+   for( uint32_t level = 0; level < texture->getMipLevels(); ++level )
+   {
+      size += getLevelSize( texture, level );
+   }
+   return size;
+}
+
+StagingRing::StagingRing( Device& device, size_t capacity, size_t frameBudget )
+    : m_device( device ), m_capacity( capacity ), m_frameBudget( frameBudget )
+{
+   // The ring buffer is never given back to the device until the ring itself is destroyed
+   m_buffer = m_device.createStagingBuffer( m_capacity );
+   CYDASSERT( m_buffer && "StagingRing: Could not create staging buffer" );
+
+   m_standIn2D    = _createStandIn( CYD::ImageType::TEXTURE_2D, 1 );
+   m_standInArray = _createStandIn( CYD::ImageType::TEXTURE_2D_ARRAY, 1 );
+   m_standInCube  = _createStandIn( CYD::ImageType::TEXTURE_2D, 6 );
+}
+
+Texture* StagingRing::_createStandIn( CYD::ImageType type, uint32_t layers )
+{
+   CYD::TextureDescription desc;
+   desc.size   = 4 * layers;
+   desc.width  = 1;
+   desc.height = 1;
+   desc.layers = layers;
+   desc.type   = type;
+   desc.format = CYD::PixelFormat::RGBA8_SRGB;
+   desc.usage  = CYD::ImageUsage::SAMPLED | CYD::ImageUsage::TRANSFER_DST;
+   desc.stages = CYD::ShaderStage::FRAGMENT_STAGE;
+
+   const std::vector<unsigned char> white( desc.size, 255 );
+
+   Texture* standIn = m_device.createTexture( desc );
+
+   // A few texels always fit in the budget, they are copied right away
+   CommandBuffer* cmdBuffer = m_device.createCommandBuffer( CYD::QueueUsage::TRANSFER );
+   cmdBuffer->startRecording();
+   stageTexture( cmdBuffer, standIn, white.data(), desc.size, CYD::ImageLayout::SHADER_READ );
+   flush( cmdBuffer );
+   cmdBuffer->endRecording();
+   cmdBuffer->submit();
+   onSubmit( cmdBuffer );
+
+   return standIn;
+}
+
+Texture* StagingRing::_getStandIn( const Texture* texture ) const
+{
+   // Same rules as the view type of the texture itself
+   if( texture->getType() == CYD::ImageType::TEXTURE_2D_ARRAY )
+   {
+      return m_standInArray;
+   }
+   if( texture->getLayers() == 6 )
+   {
+      return m_standInCube;
+   }
+   if( texture->getLayers() > 1 )
+   {
+      return m_standInArray;
+   }
+   return m_standIn2D;
+}
+
+// =================================================================================================
+// Staging
+
+void StagingRing::stageBuffer(
+    CommandBuffer* cmdBuffer,
+    Buffer* dst,
+    const void* pData,
+    size_t size )
+{
+   size_t offset = 0;
+   if( m_frameUsedBytes + size <= m_frameBudget && _allocate( cmdBuffer, size, offset ) )
+   {
+      m_buffer->copy( pData, offset, size );
+      m_pending[cmdBuffer].buffers[dst].push_back( { offset, 0, size } );
+      m_frameUsedBytes += size;
+      return;
+   }
+
+   // Over budget, the upload will be streamed during the next frames
+   DeferredUpload upload;
+   upload.buffer = dst;
+   upload.data.assign(
+       static_cast<const unsigned char*>( pData ),
+       static_cast<const unsigned char*>( pData ) + size );
+
+   dst->setStreaming( true );
+   dst->incUse();
+   m_deferred.push_back( std::move( upload ) );
+}
+
+void StagingRing::stageTexture(
+    CommandBuffer* cmdBuffer,
+    Texture* dst,
+    const void* pData,
+    size_t size,
+    CYD::ImageLayout finalLayout )
+{
+   void* pStaging = reserveTexture( cmdBuffer, dst, size, finalLayout );
+   memcpy( pStaging, pData, size );
+}
+
+void* StagingRing::reserveTexture(
+    CommandBuffer* cmdBuffer,
+    Texture* dst,
+    size_t size,
+    CYD::ImageLayout finalLayout )
+{
+   // Either only the first level is provided and the others are generated, or all of them are
+   const bool hasAllLevels = dst->getMipLevels() > 1 && size == getMipChainSize( dst );
+   CYDASSERT(
+       ( size == dst->getSize() || hasAllLevels ) && "StagingRing: Texture upload size mismatch" );
+
+   size_t offset = 0;
+   if( m_frameUsedBytes + size <= m_frameBudget && _allocate( cmdBuffer, size, offset ) )
+   {
+      void* pStaging = static_cast<unsigned char*>( m_buffer->getMappedData() ) + offset;
+      m_frameUsedBytes += size;
+
+      Barriers::ImageMemory( cmdBuffer, dst, CYD::ImageLayout::TRANSFER_DST );
+
+      PendingCopies& pending = m_pending[cmdBuffer];
+
+      const uint32_t levelCount = hasAllLevels ? dst->getMipLevels() : 1;
+      for( uint32_t level = 0; level < levelCount; ++level )
+      {
+         const size_t layerSize = getLevelSize( dst, level ) / dst->getLayers();
+         const uint32_t height  = std::max( dst->getHeight() >> level, 1u );
+         for( uint32_t layer = 0; layer < dst->getLayers(); ++layer )
+         {
+            pending.textures[dst].push_back( { offset, level, layer, 0, height } );
+            offset += layerSize;
+         }
+      }
+      pending.finalLayouts[dst] = finalLayout;
+
+      if( dst->getMipLevels() > 1 && !hasAllLevels )
+      {
+         pending.mipTextures.push_back( dst );
+      }
+      return pStaging;
+   }
+
+   // Over budget, the content will be streamed during the next frames. The texture is only
+   // transitioned to its final layout once all of it has been copied, the stand-in is sampled
+   // instead until then.
+   DeferredUpload upload;
+   upload.texture     = dst;
+   upload.finalLayout = finalLayout;
+   upload.data.resize( size );
+
+   dst->setStandIn( _getStandIn( dst ) );
+   dst->incUse();
+   m_deferred.push_back( std::move( upload ) );
+
+   // Growing a deque does not move its elements, the data stays where it is until it is streamed
+   return m_deferred.back().data.data();
+}
+
+// =================================================================================================
+// Submission tracking
+
+void StagingRing::flush( CommandBuffer* cmdBuffer )
+{
+   auto it = m_pending.find( cmdBuffer );
+   if( it == m_pending.end() )
+   {
+      return;
+   }
+
+   const PendingCopies& pending = it->second;
+
+   // One copy command per destination
+   std::vector<VkBufferCopy> bufferRegions;
+   for( const auto& [dst, copies] : pending.buffers )
+   {
+      cmdBuffer->takeOwnership( dst );
+
+      bufferRegions.clear();
+      for( const BufferCopy& copy : copies )
+      {
+         bufferRegions.push_back( { copy.srcOffset, copy.dstOffset, copy.size } );
+      }
+
+      vkCmdCopyBuffer(
+          cmdBuffer->getVKBuffer(),
+          m_buffer->getVKBuffer(),
+          dst->getVKBuffer(),
+          static_cast<uint32_t>( bufferRegions.size() ),
+          bufferRegions.data() );
+   }
+
+   std::vector<VkBufferImageCopy> imageRegions;
+   for( const auto& [dst, copies] : pending.textures )
+   {
+      imageRegions.clear();
+      for( const TextureCopy& copy : copies )
+      {
+         const uint32_t width = std::max( dst->getWidth() >> copy.mipLevel, 1u );
+
+         VkBufferImageCopy region               = {};
+         region.bufferOffset                    = copy.srcOffset;
+         region.bufferRowLength                 = 0;
+         region.bufferImageHeight               = 0;
+         region.imageSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+         region.imageSubresource.mipLevel       = copy.mipLevel;
+         region.imageSubresource.baseArrayLayer = copy.layer;
+         region.imageSubresource.layerCount     = 1;
+         region.imageOffset                     = { 0, static_cast<int32_t>( copy.row ), 0 };
+         region.imageExtent                     = { width, copy.rowCount, 1 };
+         imageRegions.push_back( region );
+      }
+
+      vkCmdCopyBufferToImage(
+          cmdBuffer->getVKBuffer(),
+          m_buffer->getVKBuffer(),
+          dst->getVKImage(),
+          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+          static_cast<uint32_t>( imageRegions.size() ),
+          imageRegions.data() );
+   }
+
+   CommandBuffer* mipCmdBuffer = cmdBuffer;
+   if( !pending.mipTextures.empty() && !( cmdBuffer->getQueueType() & CYD::QueueUsage::GRAPHICS ) )
+   {
+      mipCmdBuffer = m_device.createCommandBuffer( CYD::QueueUsage::GRAPHICS );
+      mipCmdBuffer->startRecording();
+      mipCmdBuffer->syncOnCommandBuffer( cmdBuffer );
+
+      m_mipCmdBuffers[cmdBuffer] = mipCmdBuffer;
+   }
+
+   for( Texture* texture : pending.mipTextures )
+   {
+      mipCmdBuffer->generateMips( texture );
+   }
+
+   for( const auto& [dst, layout] : pending.finalLayouts )
+   {
+      const auto& mipTextures = pending.mipTextures;
+      const bool hasMips =
+          std::find( mipTextures.begin(), mipTextures.end(), dst ) != mipTextures.end();
+
+      Barriers::ImageMemory( hasMips ? mipCmdBuffer : cmdBuffer, dst, layout );
+   }
+
+   if( mipCmdBuffer != cmdBuffer )
+   {
+      mipCmdBuffer->endRecording();
+   }
+
+   m_pending.erase( it );
+}
+
+void StagingRing::onSubmit( const CommandBuffer* cmdBuffer )
+{
+   CYDASSERT(
+       m_pending.find( cmdBuffer ) == m_pending.end() &&
+       "StagingRing: Command buffer was submitted without flushing its uploads" );
+
+   const auto mipIt = m_mipCmdBuffers.find( cmdBuffer );
+   if( mipIt != m_mipCmdBuffers.end() )
+   {
+      // Waits on the copies on the GPU
+      mipIt->second->submit();
+      m_mipCmdBuffers.erase( mipIt );
+   }
+
+   const auto isUnsubmitted = [cmdBuffer]( const Segment& segment ) {
+      return segment.owner == cmdBuffer && !segment.vkFence && !segment.abandoned;
+   };
+
+   if( std::none_of( m_segments.begin(), m_segments.end(), isUnsubmitted ) )
+   {
+      return;
+   }
+
+   // An empty submission signals its fence once all the work previously submitted to the queue
+   // has completed, which includes the command buffer reading from the ring
+   const VkFence vkFence = _acquireFence();
+
+   const VkQueue* queue = m_device.getQueueFromFamily( cmdBuffer->getFamilyIndex() );
+   CYDASSERT( queue && "StagingRing: Could not find queue to submit to" );
+
+   const VkResult result = vkQueueSubmit( *queue, 0, nullptr, vkFence );
+   CYDASSERT( result == VK_SUCCESS && "StagingRing: Could not submit fence" );
+
+   for( Segment& segment : m_segments )
+   {
+      if( isUnsubmitted( segment ) )
+      {
+         segment.vkFence = vkFence;
+         m_fenceRefs[vkFence]++;
+      }
+   }
+}
+
+void StagingRing::abandon( const CommandBuffer* cmdBuffer )
+{
+   m_pending.erase( cmdBuffer );
+
+   const auto mipIt = m_mipCmdBuffers.find( cmdBuffer );
+   if( mipIt != m_mipCmdBuffers.end() )
+   {
+      mipIt->second->release();
+      m_mipCmdBuffers.erase( mipIt );
+   }
+
+   for( Segment& segment : m_segments )
+   {
+      if( segment.owner == cmdBuffer && !segment.vkFence )
+      {
+         segment.abandoned = true;
+      }
+   }
+
+   _reclaim();
+}
+
+void StagingRing::update()
+{
+   m_frameUsedBytes = 0;
+
+   _reclaim();
+   _streamDeferred();
+}
+
+// =================================================================================================
+// Ring management
+
+bool StagingRing::_allocate( const CommandBuffer* owner, size_t size, size_t& offset )
+{
+   for( uint32_t attempt = 0; attempt < 2; ++attempt )
+   {
+      // Free space is always the contiguous range going from the head up to the oldest segment
+      size_t start    = alignUp( m_head, STAGING_ALIGNMENT );
+      size_t consumed = ( start - m_head ) + size;
+      if( start + size > m_capacity )
+      {
+         // Wrapping around, the end of the ring is wasted until this segment retires
+         start    = 0;
+         consumed = ( m_capacity - m_head ) + size;
+      }
+
+      if( consumed <= m_capacity - m_allocatedSize )
+      {
+         m_head = start + size;
+         m_allocatedSize += consumed;
+
+         if( !m_segments.empty() && m_segments.back().owner == owner &&
+             !m_segments.back().vkFence && !m_segments.back().abandoned )
+         {
+            m_segments.back().size += consumed;
+         }
+         else
+         {
+            Segment segment;
+            segment.owner = owner;
+            segment.size  = consumed;
+            m_segments.push_back( std::move( segment ) );
+         }
+
+         offset = start;
+         return true;
+      }
+
+      _reclaim();
+   }
+
+   return false;
+}
+
+void StagingRing::_reclaim()
+{
+   // Segments retire strictly in order so the free space stays contiguous
+   while( !m_segments.empty() )
+   {
+      Segment& segment = m_segments.front();
+
+      if( !segment.abandoned )
+      {
+         if( !segment.vkFence ||
+             vkGetFenceStatus( m_device.getVKDevice(), segment.vkFence ) != VK_SUCCESS )
+         {
+            break;
+         }
+
+         if( --m_fenceRefs[segment.vkFence] == 0 )
+         {
+            m_fenceRefs.erase( segment.vkFence );
+            vkResetFences( m_device.getVKDevice(), 1, &segment.vkFence );
+            m_freeFences.push_back( segment.vkFence );
+         }
+      }
+
+      for( Buffer* buffer : segment.buffers )
+      {
+         buffer->decUse();
+      }
+      for( Texture* texture : segment.textures )
+      {
+         texture->decUse();
+      }
+
+      m_allocatedSize -= segment.size;
+      m_segments.pop_front();
+   }
+
+   if( m_segments.empty() )
+   {
+      m_head = 0;
+   }
+}
+
+VkFence StagingRing::_acquireFence()
+{
+   if( !m_freeFences.empty() )
+   {
+      const VkFence vkFence = m_freeFences.back();
+      m_freeFences.pop_back();
+      return vkFence;
+   }
+
+   VkFenceCreateInfo fenceInfo = {};
+   fenceInfo.sType             = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+   VkFence vkFence       = nullptr;
+   const VkResult result = vkCreateFence( m_device.getVKDevice(), &fenceInfo, nullptr, &vkFence );
+   CYDASSERT( result == VK_SUCCESS && "StagingRing: Could not create fence" );
+
+   return vkFence;
+}
+
+// =================================================================================================
+// Deferred uploads
+
+void StagingRing::_streamDeferred()
+{
+   if( m_deferred.empty() )
+   {
+      return;
+   }
+
+   CommandBuffer* cmdBuffer = m_device.createCommandBuffer( CYD::QueueUsage::TRANSFER );
+   cmdBuffer->startRecording();
+
+   // Large chunks would starve the ring for the direct uploads
+   const size_t streamBudget = std::min( m_frameBudget, m_capacity / 2 );
+   size_t budget             = streamBudget;
+
+   while( !m_deferred.empty() && budget > 0 )
+   {
+      DeferredUpload& upload = m_deferred.front();
+
+      const size_t staged = upload.texture ? _stageTextureChunk( cmdBuffer, upload, budget )
+                                           : _stageBufferChunk( cmdBuffer, upload, budget );
+      if( staged == 0 )
+      {
+         // Ring is full or the budget cannot fit a single chunk anymore
+         break;
+      }
+
+      budget -= staged;
+
+      if( upload.uploaded == upload.data.size() )
+      {
+         if( upload.texture )
+         {
+            PendingCopies& pending = m_pending[cmdBuffer];
+            if( upload.texture->getMipLevels() > 1 &&
+                upload.data.size() == upload.texture->getSize() )
+            {
+               pending.mipTextures.push_back( upload.texture );
+            }
+
+            // Transitioned when this command buffer is flushed, which is submitted before any
+            // command buffer recorded from now on can sample the texture
+            pending.finalLayouts[upload.texture] = upload.finalLayout;
+            upload.texture->setStandIn( nullptr );
+         }
+         else
+         {
+            upload.buffer->setStreaming( false );
+         }
+
+         // The destination can only be released once the GPU is done copying to it
+         Segment& segment = m_segments.back();
+         if( upload.texture )
+         {
+            segment.textures.push_back( upload.texture );
+         }
+         else
+         {
+            segment.buffers.push_back( upload.buffer );
+         }
+
+         m_deferred.pop_front();
+      }
+   }
+
+   m_frameUsedBytes = streamBudget - budget;
+
+   flush( cmdBuffer );
+   cmdBuffer->endRecording();
+   cmdBuffer->submit();
+   onSubmit( cmdBuffer );
+}
+
+size_t StagingRing::_stageBufferChunk(
+    CommandBuffer* cmdBuffer,
+    DeferredUpload& upload,
+    size_t budget )
+{
+   const size_t size = std::min( upload.data.size() - upload.uploaded, budget );
+
+   size_t offset = 0;
+   if( !_allocate( cmdBuffer, size, offset ) )
+   {
+      return 0;
+   }
+
+   m_buffer->copy( upload.data.data() + upload.uploaded, offset, size );
+   m_pending[cmdBuffer].buffers[upload.buffer].push_back( { offset, upload.uploaded, size } );
+
+   upload.uploaded += size;
+   return size;
+}
+
+size_t StagingRing::_stageTextureChunk(
+    CommandBuffer* cmdBuffer,
+    DeferredUpload& upload,
+    size_t budget )
+{
+   Texture* texture = upload.texture;
+
+   // Finding the level the upload is at, levels are packed one after the other
+   uint32_t level     = 0;
+   size_t levelOffset = upload.uploaded;
+   while( levelOffset >= getLevelSize( texture, level ) )
+   {
+      levelOffset -= getLevelSize( texture, level );
+      level++;
+   }
+
+   // Chunks are made of whole rows and never cross a layer or level boundary
+   const uint32_t height  = std::max( texture->getHeight() >> level, 1u );
+   const size_t layerSize = getLevelSize( texture, level ) / texture->getLayers();
+   const size_t rowPitch  = layerSize / height;
+   const uint32_t layer   = static_cast<uint32_t>( levelOffset / layerSize );
+   const uint32_t row     = static_cast<uint32_t>( ( levelOffset % layerSize ) / rowPitch );
+
+   const uint32_t rowCount = static_cast<uint32_t>(
+       std::min<size_t>( height - row, budget / rowPitch ) );
+   if( rowCount == 0 )
+   {
+      return 0;
+   }
+
+   const size_t size = rowCount * rowPitch;
+
+   size_t offset = 0;
+   if( !_allocate( cmdBuffer, size, offset ) )
+   {
+      return 0;
+   }
+
+   m_buffer->copy( upload.data.data() + upload.uploaded, offset, size );
+
+   PendingCopies& pending = m_pending[cmdBuffer];
+
+   // The texture stays in transfer destination layout in between frames, this only orders the
+   // copies after the ones of the previous frames
+   if( pending.textures.find( texture ) == pending.textures.end() )
+   {
+      Barriers::ImageMemory( cmdBuffer, texture, CYD::ImageLayout::TRANSFER_DST );
+   }
+
+   pending.textures[texture].push_back( { offset, level, layer, row, rowCount } );
+
+   upload.uploaded += size;
+   return size;
+}
+
+StagingRing::~StagingRing()
+{
+   // Waiting on everything that could still be reading from the ring
+   for( const auto& [vkFence, refs] : m_fenceRefs )
+   {
+      vkWaitForFences( m_device.getVKDevice(), 1, &vkFence, VK_TRUE, UINTMAX_MAX );
+      vkDestroyFence( m_device.getVKDevice(), vkFence, nullptr );
+   }
+
+   for( const VkFence vkFence : m_freeFences )
+   {
+      vkDestroyFence( m_device.getVKDevice(), vkFence, nullptr );
+   }
+
+   for( const Segment& segment : m_segments )
+   {
+      for( Buffer* buffer : segment.buffers )
+      {
+         buffer->decUse();
+      }
+      for( Texture* texture : segment.textures )
+      {
+         texture->decUse();
+      }
+   }
+
+   for( const DeferredUpload& upload : m_deferred )
+   {
+      if( upload.texture )
+      {
+         upload.texture->setStandIn( nullptr );
+         upload.texture->decUse();
+      }
+      else
+      {
+         upload.buffer->setStreaming( false );
+         upload.buffer->decUse();
+      }
+   }
+
+   m_device.destroyTexture( m_standIn2D );
+   m_device.destroyTexture( m_standInArray );
+   m_device.destroyTexture( m_standInCube );
+   m_device.destroyBuffer( m_buffer );
+}
+}
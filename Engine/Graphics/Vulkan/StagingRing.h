@@ -0,0 +1,180 @@
+#pragma once
+
+#include <Common/Include.h>
+
+#include <Graphics/GraphicsTypes.h>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+// ================================================================================================
+// Forwards
+// ================================================================================================
+FWDHANDLE( VkFence );
+
+namespace vk
+{
+class Device;
+class Buffer;
+class Texture;
+class CommandBuffer;
+}
+
+// ================================================================================================
+// Definition
+// ================================================================================================
+/*
+ * Fixed-size, persistently mapped staging buffer used for every upload to device local resources.
+ * Space is handed out linearly and wraps around, and it is reclaimed in order once the fence of
+ * the submission that read it has signaled.
+ *
+ * Uploads staged on a command buffer are only recorded when that command buffer is flushed, so
+ * that all the copies going to the same destination end up in a single copy command. Uploads that
+ * do not fit in what is left of the per-frame budget are kept on the CPU and streamed in chunks
+ * over the next frames on a command buffer owned by the ring. Textures stay in transfer destination
+ * layout until their last chunk is copied, and a 1x1 white stand-in with the same view type is
+ * sampled in their place until then. Draws reading vertices or indices from a buffer that is still
+ * streaming are skipped.
+ */
+namespace vk
+{
+class StagingRing final
+{
+  public:
+   StagingRing( Device& device, size_t capacity, size_t frameBudget );
+   NON_COPIABLE( StagingRing );
+   ~StagingRing();
+
+   // Staging
+   // =============================================================================================
+   void stageBuffer( CommandBuffer* cmdBuffer, Buffer* dst, const void* pData, size_t size );
+
+   // Layers are expected to be tightly packed one after the other in pData. When it holds every mip
+   // level, they follow each other starting with the first, otherwise the levels are generated.
+   void stageTexture(
+       CommandBuffer* cmdBuffer,
+       Texture* dst,
+       const void* pData,
+       size_t size,
+       CYD::ImageLayout finalLayout );
+
+   // Same as stageTexture, but returns the staging memory the texels have to be written to instead
+   // of copying them. The memory has to be filled before the command buffer is flushed and before
+   // the next update, and can be written to from any thread.
+   void* reserveTexture(
+       CommandBuffer* cmdBuffer,
+       Texture* dst,
+       size_t size,
+       CYD::ImageLayout finalLayout );
+
+   // Submission tracking
+   // =============================================================================================
+   // Records all the pending copies of this command buffer, and the mips of the textures that were
+   // fully uploaded. Must be called before ending recording.
+   void flush( CommandBuffer* cmdBuffer );
+
+   // Must be called right after the command buffer was submitted so its staging space can be
+   // reclaimed once the GPU is done with it
+   void onSubmit( const CommandBuffer* cmdBuffer );
+
+   // The command buffer will never be submitted, its staging space can be reused right away
+   void abandon( const CommandBuffer* cmdBuffer );
+
+   // Reclaims completed staging space and streams deferred uploads, should be called every frame
+   void update();
+
+   size_t getCapacity() const noexcept { return m_capacity; }
+   size_t getUsedSize() const noexcept { return m_allocatedSize; }
+   bool hasDeferredUploads() const noexcept { return !m_deferred.empty(); }
+
+  private:
+   // A contiguous range of the ring that is read by a single command buffer
+   struct Segment
+   {
+      const CommandBuffer* owner = nullptr;
+      size_t size                = 0;
+      VkFence vkFence            = nullptr;
+      bool abandoned             = false;
+
+      // Destinations of completed deferred uploads, released when the segment retires
+      std::vector<Buffer*> buffers;
+      std::vector<Texture*> textures;
+   };
+
+   struct BufferCopy
+   {
+      size_t srcOffset;
+      size_t dstOffset;
+      size_t size;
+   };
+
+   struct TextureCopy
+   {
+      size_t srcOffset;
+      uint32_t mipLevel;
+      uint32_t layer;
+      uint32_t row;
+      uint32_t rowCount;
+   };
+
+   struct PendingCopies
+   {
+      std::unordered_map<Buffer*, std::vector<BufferCopy>> buffers;
+      std::unordered_map<Texture*, std::vector<TextureCopy>> textures;
+      std::unordered_map<Texture*, CYD::ImageLayout> finalLayouts;
+
+      // Textures whose first level is complete once these copies are done
+      std::vector<Texture*> mipTextures;
+   };
+
+   struct DeferredUpload
+   {
+      Buffer* buffer   = nullptr;
+      Texture* texture = nullptr;
+      CYD::ImageLayout finalLayout;
+      std::vector<unsigned char> data;
+      size_t uploaded = 0;
+   };
+
+   bool _allocate( const CommandBuffer* owner, size_t size, size_t& offset );
+   void _reclaim();
+   void _streamDeferred();
+
+   size_t _stageBufferChunk( CommandBuffer* cmdBuffer, DeferredUpload& upload, size_t budget );
+   size_t _stageTextureChunk( CommandBuffer* cmdBuffer, DeferredUpload& upload, size_t budget );
+   Texture* _createStandIn( CYD::ImageType type, uint32_t layers );
+   Texture* _getStandIn( const Texture* texture ) const;
+
+   VkFence _acquireFence();
+
+   Device& m_device;
+
+   Buffer* m_buffer = nullptr;
+
+   // One stand-in per image view type, a cube map cannot be sampled from a 2D view
+   Texture* m_standIn2D    = nullptr;
+   Texture* m_standInArray = nullptr;
+   Texture* m_standInCube  = nullptr;
+
+   size_t m_capacity      = 0;
+   size_t m_head          = 0;
+   size_t m_allocatedSize = 0;
+
+   size_t m_frameBudget    = 0;
+   size_t m_frameUsedBytes = 0;
+
+   std::deque<Segment> m_segments;
+   std::unordered_map<const CommandBuffer*, PendingCopies> m_pending;
+
+   // Blits cannot be recorded on transfer queues, the mips of textures uploaded on one are
+   // generated by a graphics command buffer submitted right after it
+   std::unordered_map<const CommandBuffer*, CommandBuffer*> m_mipCmdBuffers;
+   std::deque<DeferredUpload> m_deferred;
+
+   // Fences are shared between all the segments of a submission
+   std::unordered_map<VkFence, uint32_t> m_fenceRefs;
+   std::vector<VkFence> m_freeFences;
+};
+}
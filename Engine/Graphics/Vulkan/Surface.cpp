@@ -14,6 +14,12 @@ namespace vk
 Surface::Surface( const CYD::Window& window, const Instance& instance )
     : m_window( window ), m_instance( instance )
 {
+   if( m_window.isHeadless() )
+   {
+      // Rendering offscreen, nothing to present to
+      return;
+   }
+
    VkResult result = glfwCreateWindowSurface(
        m_instance.getVKInstance(), m_window.getGLFWwindow(), nullptr, &m_vkSurface );
    CYDASSERT( result == VK_SUCCESS && "Surface: Could not create surface" );
@@ -21,6 +27,7 @@ Surface::Surface( const CYD::Window& window, const Instance& instance )
 
 Surface::~Surface()
 {
+   // Destroying a null surface is valid
    vkDestroySurfaceKHR( m_instance.getVKInstance(), m_vkSurface, nullptr );
    m_vkSurface = nullptr;
 }
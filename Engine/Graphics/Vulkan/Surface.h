@@ -30,6 +30,9 @@ class Surface final
 
    const VkSurfaceKHR& getVKSurface() const { return m_vkSurface; }
 
+   // Headless windows have no surface, devices are then picked without presentation support
+   bool isHeadless() const { return m_vkSurface == nullptr; }
+
   private:
    const CYD::Window& m_window;
 
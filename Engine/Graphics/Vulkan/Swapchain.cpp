@@ -5,6 +5,9 @@
 
 #include <Graphics/Vulkan/Device.h>
 #include <Graphics/Vulkan/Surface.h>
+#include <Graphics/Vulkan/Buffer.h>
+#include <Graphics/Vulkan/Texture.h>
+#include <Graphics/Vulkan/BarriersHelper.h>
 #include <Graphics/Vulkan/CommandBuffer.h>
 #include <Graphics/Vulkan/RenderPassStash.h>
 #include <Graphics/Vulkan/TypeConversions.h>
@@ -17,23 +20,32 @@ static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
 namespace vk
 {
 Swapchain::Swapchain( Device& device, const Surface& surface, const CYD::SwapchainInfo& info )
-    : m_device( device ), m_surface( surface )
+    : m_device( device ), m_surface( surface ), m_offscreen( surface.isHeadless() )
 {
    // Initializing attachments
    m_colorPresentation.format  = info.format;
    m_colorPresentation.loadOp  = CYD::LoadOp::CLEAR;
    m_colorPresentation.storeOp = CYD::StoreOp::STORE;
-   m_colorPresentation.type    = CYD::AttachmentType::COLOR_PRESENTATION;
+   m_colorPresentation.type =
+       m_offscreen ? CYD::AttachmentType::COLOR : CYD::AttachmentType::COLOR_PRESENTATION;
 
    m_depthPresentation.format  = CYD::PixelFormat::D32_SFLOAT;
    m_depthPresentation.loadOp  = CYD::LoadOp::CLEAR;
    m_depthPresentation.storeOp = CYD::StoreOp::DONT_CARE;
    m_depthPresentation.type    = CYD::AttachmentType::DEPTH_STENCIL;
 
-   _createSwapchain( info );
-   _createImageViews();
+   if( m_offscreen )
+   {
+      _createOffscreenTargets( info );
+   }
+   else
+   {
+      _createSwapchain( info );
+      _createImageViews();
+      _createSyncObjects();
+   }
+
    _createDepthResources();
-   _createSyncObjects();
 }
 
 static uint32_t chooseImageCount( const VkSurfaceCapabilitiesKHR& caps )
@@ -220,6 +232,41 @@ void Swapchain::_createImageViews()
    }
 }
 
+void Swapchain::_createOffscreenTargets( const CYD::SwapchainInfo& info )
+{
+   CYDASSERT(
+       ( info.format == CYD::PixelFormat::BGRA8_UNORM ||
+         info.format == CYD::PixelFormat::RGBA8_SRGB ) &&
+       "Swapchain: Offscreen targets only support 8-bit RGBA formats" );
+
+   m_surfaceFormat             = std::make_unique<VkSurfaceFormatKHR>();
+   m_surfaceFormat->format     = TypeConversions::cydToVkFormat( info.format );
+   m_surfaceFormat->colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+
+   m_extent         = std::make_unique<VkExtent2D>();
+   m_extent->width  = info.extent.width;
+   m_extent->height = info.extent.height;
+
+   m_imageCount  = MAX_FRAMES_IN_FLIGHT;
+   m_presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+
+   CYD::TextureDescription desc = {};
+   desc.size                    = info.extent.width * info.extent.height * 4;
+   desc.width                   = info.extent.width;
+   desc.height                  = info.extent.height;
+   desc.format                  = info.format;
+   desc.usage                   = CYD::ImageUsage::COLOR | CYD::ImageUsage::TRANSFER_SRC;
+
+   for( uint32_t i = 0; i < m_imageCount; ++i )
+   {
+      Texture* target = m_device.createTexture( desc );
+
+      m_colorTargets.push_back( target );
+      m_images.push_back( target->getVKImage() );
+      m_imageViews.push_back( target->getVKImageView() );
+   }
+}
+
 void Swapchain::_createDepthResources()
 {
    VkResult result;
@@ -297,24 +344,29 @@ void Swapchain::_createSyncObjects()
    }
 }
 
-void Swapchain::initFramebuffers( bool hasDepth )
+VkRenderPass Swapchain::getRenderPass( bool hasDepth )
 {
-   // If we are switching from depth on/off or never initialized the render pass
-   if( ( hasDepth != m_hasDepth ) || !( m_vkRenderPass ) )
-   {
-      CYD::RenderPassInfo renderPassInfo = {};
+   CYD::RenderPassInfo renderPassInfo = {};
 
-      renderPassInfo.attachments.push_back( m_colorPresentation );
+   renderPassInfo.attachments.push_back( m_colorPresentation );
 
-      if( hasDepth )
-      {
-         renderPassInfo.attachments.push_back( m_depthPresentation );
-      }
+   if( hasDepth )
+   {
+      renderPassInfo.attachments.push_back( m_depthPresentation );
+   }
+
+   VkRenderPass renderPass = m_device.getRenderPassStash().findOrCreate( renderPassInfo );
+   CYDASSERT( renderPass && "Swapchain: Could not find render pass" );
 
-      VkRenderPass renderPass = m_device.getRenderPassStash().findOrCreate( renderPassInfo );
-      CYDASSERT( renderPass && "CommandBuffer: Could not find render pass" );
+   return renderPass;
+}
 
-      m_vkRenderPass = renderPass;
+void Swapchain::initFramebuffers( bool hasDepth )
+{
+   // If we are switching from depth on/off or never initialized the render pass
+   if( ( hasDepth != m_hasDepth ) || !( m_vkRenderPass ) )
+   {
+      m_vkRenderPass = getRenderPass( hasDepth );
 
       m_frameBuffers.resize( m_imageCount );
       for( size_t i = 0; i < m_imageCount; i++ )
@@ -347,6 +399,16 @@ void Swapchain::initFramebuffers( bool hasDepth )
 
 void Swapchain::acquireImage()
 {
+   if( m_offscreen )
+   {
+      // The copy reading this target has to be done before rendering to it again
+      _collectReadback( m_currentFrame, true );
+
+      m_imageIndex = m_currentFrame;
+      m_ready      = true;
+      return;
+   }
+
    vkAcquireNextImageKHR(
        m_device.getVKDevice(),
        m_vkSwapchain,
@@ -364,6 +426,20 @@ void Swapchain::present()
        m_ready &&
        "Swapchain: No image was acquired before presenting. Are you rendering to the swapchain?" );
 
+   if( m_offscreen )
+   {
+      if( m_readbackEnabled )
+      {
+         _recordReadback();
+      }
+
+      m_frameNumber++;
+      m_currentFrame = ( m_currentFrame + 1 ) % MAX_FRAMES_IN_FLIGHT;
+
+      m_ready = false;
+      return;
+   }
+
    const VkQueue* presentQueue = m_device.getQueueFromUsage( CYD::QueueUsage::GRAPHICS, true );
    if( presentQueue )
    {
@@ -389,9 +465,110 @@ void Swapchain::present()
    }
 }
 
+// =================================================================================================
+// Offscreen readback
+
+void Swapchain::setReadback( bool enable )
+{
+   CYDASSERT( m_offscreen && "Swapchain: Only offscreen swapchains can read frames back" );
+
+   if( enable && m_readbacks.empty() )
+   {
+      VkFenceCreateInfo fenceInfo = {};
+      fenceInfo.sType             = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+      m_readbacks.resize( MAX_FRAMES_IN_FLIGHT );
+      for( Readback& readback : m_readbacks )
+      {
+         readback.buffer = m_device.createBuffer( m_colorTargets[0]->getSize() );
+
+         const VkResult result =
+             vkCreateFence( m_device.getVKDevice(), &fenceInfo, nullptr, &readback.vkFence );
+         CYDASSERT( result == VK_SUCCESS && "Swapchain: Could not create readback fence" );
+      }
+   }
+
+   m_readbackEnabled = enable;
+}
+
+void Swapchain::_recordReadback()
+{
+   Readback& readback = m_readbacks[m_currentFrame];
+   Texture* target    = m_colorTargets[m_currentFrame];
+
+   CommandBuffer* cmdBuffer = m_device.createCommandBuffer( CYD::QueueUsage::GRAPHICS, true );
+   cmdBuffer->startRecording();
+
+   // The render pass leaves the target as a color attachment
+   target->setLayout( CYD::ImageLayout::COLOR_ATTACHMENT );
+   Barriers::ImageMemory( cmdBuffer, target, CYD::ImageLayout::TRANSFER_SRC );
+   cmdBuffer->copyTexToBuffer( target, readback.buffer );
+
+   cmdBuffer->endRecording();
+   cmdBuffer->submit();
+
+   // The pool can recycle the command buffer as soon as it completes, an empty submission signals
+   // a fence we own once the copy is done instead
+   const VkQueue* queue = m_device.getQueueFromFamily( cmdBuffer->getFamilyIndex() );
+   CYDASSERT( queue && "Swapchain: Could not find queue to submit to" );
+
+   const VkResult result = vkQueueSubmit( *queue, 0, nullptr, readback.vkFence );
+   CYDASSERT( result == VK_SUCCESS && "Swapchain: Could not submit readback fence" );
+
+   readback.frameNumber = m_frameNumber;
+   readback.pending     = true;
+}
+
+void Swapchain::_collectReadback( uint32_t frame, bool wait )
+{
+   if( m_readbacks.empty() || !m_readbacks[frame].pending )
+   {
+      return;
+   }
+
+   Readback& readback      = m_readbacks[frame];
+   const VkDevice vkDevice = m_device.getVKDevice();
+
+   if( wait )
+   {
+      vkWaitForFences( vkDevice, 1, &readback.vkFence, VK_TRUE, UINT64_MAX );
+   }
+   else if( vkGetFenceStatus( vkDevice, readback.vkFence ) != VK_SUCCESS )
+   {
+      return;
+   }
+
+   vkResetFences( vkDevice, 1, &readback.vkFence );
+   readback.pending = false;
+
+   // Slots are not necessarily collected in the order they were presented
+   if( m_lastFrame.empty() || readback.frameNumber > m_lastFrameNumber )
+   {
+      m_lastFrame.resize( readback.buffer->getSize() );
+      readback.buffer->read( m_lastFrame.data(), 0, m_lastFrame.size() );
+      m_lastFrameNumber = readback.frameNumber;
+   }
+}
+
+bool Swapchain::getLastFrame( std::vector<uint8_t>& pixels )
+{
+   for( uint32_t i = 0; i < m_readbacks.size(); ++i )
+   {
+      _collectReadback( i, false );
+   }
+
+   if( m_lastFrame.empty() )
+   {
+      return false;
+   }
+
+   pixels = m_lastFrame;
+   return true;
+}
+
 Swapchain::~Swapchain()
 {
-   for( uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
+   for( uint32_t i = 0; i < m_availableSems.size(); i++ )
    {
       vkDestroySemaphore( m_device.getVKDevice(), m_renderDoneSems[i], nullptr );
       vkDestroySemaphore( m_device.getVKDevice(), m_availableSems[i], nullptr );
@@ -402,15 +579,32 @@ Swapchain::~Swapchain()
       vkDestroyFramebuffer( m_device.getVKDevice(), frameBuffer, nullptr );
    }
 
-   for( auto imageView : m_imageViews )
-   {
-      vkDestroyImageView( m_device.getVKDevice(), imageView, nullptr );
-   }
-
    vkDestroyImageView( m_device.getVKDevice(), m_depthImageView, nullptr );
    vkDestroyImage( m_device.getVKDevice(), m_depthImage, nullptr );
    vkFreeMemory( m_device.getVKDevice(), m_depthImageMemory, nullptr );
 
-   vkDestroySwapchainKHR( m_device.getVKDevice(), m_vkSwapchain, nullptr );
+   if( m_offscreen )
+   {
+      for( Readback& readback : m_readbacks )
+      {
+         vkDestroyFence( m_device.getVKDevice(), readback.vkFence, nullptr );
+         m_device.destroyBuffer( readback.buffer );
+      }
+
+      // The image views belong to the targets
+      for( Texture* target : m_colorTargets )
+      {
+         m_device.destroyTexture( target );
+      }
+   }
+   else
+   {
+      for( auto imageView : m_imageViews )
+      {
+         vkDestroyImageView( m_device.getVKDevice(), imageView, nullptr );
+      }
+
+      vkDestroySwapchainKHR( m_device.getVKDevice(), m_vkSwapchain, nullptr );
+   }
 }
 }
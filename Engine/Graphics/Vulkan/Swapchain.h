@@ -28,6 +28,8 @@ namespace vk
 class Device;
 class Surface;
 class CommandBuffer;
+class Buffer;
+class Texture;
 }
 
 // ================================================================================================
@@ -47,6 +49,9 @@ class Swapchain final
    VkFramebuffer getCurrentFramebuffer() const { return m_frameBuffers[m_currentFrame]; }
    VkRenderPass getCurrentRenderPass() const { return m_vkRenderPass; }
 
+   // Render pass used to draw to the swapchain, pipelines can be compiled for it ahead of time
+   VkRenderPass getRenderPass( bool hasDepth );
+
    const VkSwapchainKHR& getVKSwapchain() const noexcept { return m_vkSwapchain; }
    const VkSurfaceFormatKHR& getFormat() const noexcept { return *m_surfaceFormat; }
    const VkSemaphore& getSemToWait() const noexcept { return m_availableSems[m_currentFrame]; }
@@ -56,12 +61,26 @@ class Swapchain final
    void acquireImage();
    void present();
 
+   // Without a surface, frames are rendered to textures and presenting them does nothing unless
+   // they are read back
+   bool isOffscreen() const noexcept { return m_offscreen; }
+
+   // Offscreen only, presented frames are copied to host memory without stalling the GPU
+   void setReadback( bool enable );
+
+   // Latest frame done copying, tightly packed rows in the swapchain format
+   bool getLastFrame( std::vector<uint8_t>& pixels );
+
   private:
    void _createSwapchain( const CYD::SwapchainInfo& info );
    void _createImageViews();
+   void _createOffscreenTargets( const CYD::SwapchainInfo& info );
    void _createDepthResources();
    void _createSyncObjects();
 
+   void _recordReadback();
+   void _collectReadback( uint32_t frame, bool wait );
+
    // Used to create the swapchain
    Device& m_device;
    const Surface& m_surface;
@@ -90,6 +109,24 @@ class Swapchain final
 
    VkSwapchainKHR m_vkSwapchain = nullptr;
 
+   // Offscreen
+   bool m_offscreen = false;
+   std::vector<Texture*> m_colorTargets;
+
+   struct Readback
+   {
+      Buffer* buffer       = nullptr;
+      VkFence vkFence      = nullptr;
+      uint64_t frameNumber = 0;
+      bool pending         = false;
+   };
+   std::vector<Readback> m_readbacks;  // One per frame in flight, created on first use
+   bool m_readbackEnabled = false;
+
+   uint64_t m_frameNumber     = 0;
+   uint64_t m_lastFrameNumber = 0;
+   std::vector<uint8_t> m_lastFrame;
+
    // Swapchain Properties
    VkPresentModeKHR m_presentMode;                       // Presentation mode
    std::unique_ptr<VkSurfaceFormatKHR> m_surfaceFormat;  // Swapchain image format
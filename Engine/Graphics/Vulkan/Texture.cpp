@@ -4,56 +4,90 @@
 #include <Common/Vulkan.h>
 
 #include <Graphics/Vulkan/Device.h>
+#include <Graphics/Vulkan/BindlessTable.h>
+#include <Graphics/Vulkan/SamplerStash.h>
 #include <Graphics/Vulkan/TypeConversions.h>
 
+#include <algorithm>
+
 namespace vk
 {
+static uint32_t getMaxMipLevels( uint32_t width, uint32_t height )
+{
+   uint32_t levels = 1;
+   for( uint32_t size = std::max( width, height ); size > 1; size /= 2 )
+   {
+      levels++;
+   }
+   return levels;
+}
+
 void Texture::acquire( const Device& device, const CYD::TextureDescription& desc )
 {
-   m_pDevice = &device;
-   m_size    = desc.size;
-   m_width   = desc.width;
-   m_height  = desc.height;
-   m_layers  = desc.layers;
-   m_type    = desc.type;
-   m_format  = desc.format;
-   m_usage   = desc.usage;
-   m_stages  = desc.stages;
+   m_pDevice   = &device;
+   m_size      = desc.size;
+   m_width     = desc.width;
+   m_height    = desc.height;
+   m_layers    = desc.layers;
+   m_mipLevels = std::clamp( desc.mipLevels, 1u, getMaxMipLevels( desc.width, desc.height ) );
+   m_type      = desc.type;
+   m_format    = desc.format;
+   m_usage     = desc.usage;
+   m_stages    = desc.stages;
 
    _createImage();
    _allocateMemory();
    _createImageView();
 
+   // Plain 2D textures sampled in shaders are visible through the bindless array
+   BindlessTable* bindless = m_pDevice->getBindlessTable();
+   if( bindless && ( m_usage & CYD::ImageUsage::SAMPLED ) &&
+       m_type == CYD::ImageType::TEXTURE_2D && m_layers == 1 )
+   {
+      m_bindlessSlot =
+          bindless->add( this, m_pDevice->getSamplerStash().getDefault( m_mipLevels ) );
+   }
+
    CYDASSERT(
        m_useCount == 0 &&
        "Texture: Texture use count not 0. This texture was probably not released" );
 
    m_useCount = 1;
+   m_generation++;
 }
 
 void Texture::release()
 {
    if( m_pDevice )
    {
+      if( BindlessTable* bindless = m_pDevice->getBindlessTable() )
+      {
+         bindless->remove( m_bindlessSlot );
+      }
+
       vkDestroyImageView( m_pDevice->getVKDevice(), m_vkImageView, nullptr );
       vkDestroyImage( m_pDevice->getVKDevice(), m_vkImage, nullptr );
-      vkFreeMemory( m_pDevice->getVKDevice(), m_vkMemory, nullptr );
-
-      m_size   = 0;
-      m_width  = 0;
-      m_height = 0;
-      m_layers = 1;
-      m_type   = CYD::ImageType::TEXTURE_2D;
-      m_format = CYD::PixelFormat::RGBA8_SRGB;
-      m_usage  = 0;
-      m_stages = 0;
+      m_pDevice->getMemoryAllocator().free( m_allocation );
+
+      m_size      = 0;
+      m_width     = 0;
+      m_height    = 0;
+      m_layers    = 1;
+      m_mipLevels = 1;
+      m_type      = CYD::ImageType::TEXTURE_2D;
+      m_format    = CYD::PixelFormat::RGBA8_SRGB;
+      m_layout    = CYD::ImageLayout::UNKNOWN;
+      m_usage     = 0;
+      m_stages    = 0;
 
       m_pDevice     = nullptr;
       m_vkImageView = nullptr;
       m_vkImage     = nullptr;
-      m_vkMemory    = nullptr;
+      m_pStandIn    = nullptr;
 
-      m_useCount = 0;
+      m_ownerFamily  = NO_OWNER_FAMILY;
+      m_bindlessSlot = BindlessTable::INVALID_SLOT;
+      m_useCount     = 0;
    }
 }
 
@@ -69,6 +103,7 @@ void Texture::_createImage()
          imageInfo.imageType = VK_IMAGE_TYPE_1D;
          break;
       case CYD::ImageType::TEXTURE_2D:
+      case CYD::ImageType::TEXTURE_2D_ARRAY:
          imageInfo.imageType = VK_IMAGE_TYPE_2D;
          break;
       case CYD::ImageType::TEXTURE_3D:
@@ -76,8 +111,8 @@ void Texture::_createImage()
          break;
    }
 
-   // TODO A 6-layer image is always "promoted" to a cube map
-   if( m_layers == 6 )
+   // TODO A 6-layer image is always "promoted" to a cube map, unless it is explicitly an array
+   if( m_layers == 6 && m_type != CYD::ImageType::TEXTURE_2D_ARRAY )
    {
       imageInfo.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
    }
@@ -85,13 +120,14 @@ void Texture::_createImage()
    imageInfo.extent.width  = m_width;
    imageInfo.extent.height = m_height;
    imageInfo.extent.depth  = 1;
-   imageInfo.mipLevels     = 1;
+   imageInfo.mipLevels     = m_mipLevels;
    imageInfo.arrayLayers   = m_layers;
    imageInfo.format        = TypeConversions::cydToVkFormat( m_format );
    imageInfo.tiling        = VK_IMAGE_TILING_OPTIMAL;
    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-   if( m_usage & CYD::ImageUsage::TRANSFER_SRC )
+   // Mip levels are generated by blitting each level from the previous one
+   if( ( m_usage & CYD::ImageUsage::TRANSFER_SRC ) || m_mipLevels > 1 )
    {
       imageInfo.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
    }
@@ -128,16 +164,19 @@ void Texture::_allocateMemory()
    VkMemoryRequirements memRequirements;
    vkGetImageMemoryRequirements( m_pDevice->getVKDevice(), m_vkImage, &memRequirements );
 
-   VkMemoryAllocateInfo allocInfo = {};
-   allocInfo.sType                = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-   allocInfo.allocationSize       = memRequirements.size;
-   allocInfo.memoryTypeIndex      = m_pDevice->findMemoryType(
-       memRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT );
-
-   VkResult result = vkAllocateMemory( m_pDevice->getVKDevice(), &allocInfo, nullptr, &m_vkMemory );
-   CYDASSERT( result == VK_SUCCESS && "Texture: Could not allocate memory" );
+   // Optimal tiling, kept apart from linear resources to respect bufferImageGranularity
+   m_allocation = m_pDevice->getMemoryAllocator().allocate(
+       memRequirements,
+       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+       MemoryAllocator::ResourceKind::OPTIMAL );
+   if( !m_allocation.vkMemory )
+   {
+      CYDASSERT( !"Texture: Could not allocate memory" );
+      return;
+   }
 
-   vkBindImageMemory( m_pDevice->getVKDevice(), m_vkImage, m_vkMemory, 0 );
+   vkBindImageMemory(
+       m_pDevice->getVKDevice(), m_vkImage, m_allocation.vkMemory, m_allocation.offset );
 }
 
 static VkImageAspectFlagBits getAspectBit( CYD::PixelFormat format )
@@ -160,13 +199,14 @@ void Texture::_createImageView()
    {
       if( m_height > 0 )
       {
-         if( m_layers == 6 )
+         if( m_layers == 6 && m_type != CYD::ImageType::TEXTURE_2D_ARRAY )
          {
             viewInfo.viewType = VK_IMAGE_VIEW_TYPE_CUBE;
          }
-         else if( m_layers > 1 )
+         else if( m_layers > 1 || m_type == CYD::ImageType::TEXTURE_2D_ARRAY )
          {
-            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_3D;
+            // The image is still 2D, the layers are indexed
+            viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
          }
          else
          {
@@ -186,9 +226,9 @@ void Texture::_createImageView()
    viewInfo.format                          = TypeConversions::cydToVkFormat( m_format );
    viewInfo.subresourceRange.aspectMask     = getAspectBit( m_format );
    viewInfo.subresourceRange.baseMipLevel   = 0;
-   viewInfo.subresourceRange.levelCount     = 1;
+   viewInfo.subresourceRange.levelCount     = m_mipLevels;
    viewInfo.subresourceRange.baseArrayLayer = 0;
-   viewInfo.subresourceRange.layerCount     = 1;
+   viewInfo.subresourceRange.layerCount     = m_layers;
 
    VkResult result =
        vkCreateImageView( m_pDevice->getVKDevice(), &viewInfo, nullptr, &m_vkImageView );
@@ -3,6 +3,7 @@
 #include <Common/Include.h>
 
 #include <Graphics/GraphicsTypes.h>
+#include <Graphics/Vulkan/MemoryAllocator.h>
 
 #include <cstdint>
 
@@ -11,7 +12,6 @@
 // ================================================================================================
 FWDHANDLE( VkImage );
 FWDHANDLE( VkImageView );
-FWDHANDLE( VkDeviceMemory );
 FWDHANDLE( VkDescriptorSet );
 
 namespace vk
@@ -38,11 +38,35 @@ class Texture final
    uint32_t getWidth() const noexcept { return m_width; }
    uint32_t getHeight() const noexcept { return m_height; }
    uint32_t getLayers() const noexcept { return m_layers; }
+   uint32_t getMipLevels() const noexcept { return m_mipLevels; }
+   CYD::ImageType getType() const noexcept { return m_type; }
+   CYD::PixelFormat getFormat() const noexcept { return m_format; }
    CYD::ShaderStageFlag getStages() const noexcept { return m_stages; }
 
    CYD::ImageLayout getLayout() const noexcept { return m_layout; }
    void setLayout( CYD::ImageLayout layout ) { m_layout = layout; }
 
+   // Incremented every time this slot is acquired, tells apart resources that used the same slot
+   uint32_t getGeneration() const noexcept { return m_generation; }
+
+   // Same value as VK_QUEUE_FAMILY_IGNORED, the resource was never used on a queue yet
+   static constexpr uint32_t NO_OWNER_FAMILY = ~0U;
+
+   // Queue family currently owning the image, images are created with exclusive sharing
+   uint32_t getOwnerFamily() const noexcept { return m_ownerFamily; }
+   void setOwnerFamily( uint32_t familyIndex ) { m_ownerFamily = familyIndex; }
+
+   // Texture sampled in place of this one while its content is still being streamed in
+   Texture* getStandIn() const noexcept { return m_pStandIn; }
+   void setStandIn( Texture* standIn ) { m_pStandIn = standIn; }
+
+   // Index of this texture in the device's bindless texture array, if it has one. Textures that
+   // are still being streamed in point to the slot of their stand-in.
+   uint32_t getBindlessSlot() const noexcept
+   {
+      return m_pStandIn ? m_pStandIn->m_bindlessSlot : m_bindlessSlot;
+   }
+
    const VkImage& getVKImage() const noexcept { return m_vkImage; }
    const VkImageView& getVKImageView() const noexcept { return m_vkImageView; }
    bool inUse() const { return m_useCount > 0; }
@@ -62,6 +86,7 @@ class Texture final
    uint32_t m_width              = 0;
    uint32_t m_height             = 0;
    uint32_t m_layers             = 1;  // For 3D images and cube maps
+   uint32_t m_mipLevels          = 1;
    CYD::ImageType m_type         = CYD::ImageType::TEXTURE_2D;
    CYD::PixelFormat m_format     = CYD::PixelFormat::BGRA8_UNORM;
    CYD::ImageLayout m_layout     = CYD::ImageLayout::UNKNOWN;
@@ -70,8 +95,13 @@ class Texture final
 
    VkImage m_vkImage         = nullptr;
    VkImageView m_vkImageView = nullptr;
-   VkDeviceMemory m_vkMemory = nullptr;
+   MemoryAllocation m_allocation;
+
+   Texture* m_pStandIn = nullptr;
 
-   uint32_t m_useCount = 0;
+   uint32_t m_ownerFamily  = NO_OWNER_FAMILY;
+   uint32_t m_bindlessSlot = ~0U;  // BindlessTable::INVALID_SLOT
+   uint32_t m_generation   = 0;
+   uint32_t m_useCount     = 0;
 };
 }
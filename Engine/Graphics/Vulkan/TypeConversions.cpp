@@ -41,6 +41,37 @@ VkFormat cydToVkFormat( CYD::PixelFormat format )
    return VK_FORMAT_B8G8R8A8_UNORM;
 }
 
+VkFormat cydToVkFormat( CYD::VertexFormat format )
+{
+   switch( format )
+   {
+      case CYD::VertexFormat::FLOAT2:
+         return VK_FORMAT_R32G32_SFLOAT;
+      case CYD::VertexFormat::FLOAT3:
+         return VK_FORMAT_R32G32B32_SFLOAT;
+      case CYD::VertexFormat::FLOAT4:
+         return VK_FORMAT_R32G32B32A32_SFLOAT;
+      case CYD::VertexFormat::HALF2:
+         return VK_FORMAT_R16G16_SFLOAT;
+      case CYD::VertexFormat::HALF4:
+         return VK_FORMAT_R16G16B16A16_SFLOAT;
+      case CYD::VertexFormat::UNORM8x4:
+         return VK_FORMAT_R8G8B8A8_UNORM;
+      case CYD::VertexFormat::SNORM8x4:
+         return VK_FORMAT_R8G8B8A8_SNORM;
+      case CYD::VertexFormat::UNORM16x2:
+         return VK_FORMAT_R16G16_UNORM;
+      case CYD::VertexFormat::SNORM16x2:
+         return VK_FORMAT_R16G16_SNORM;
+      case CYD::VertexFormat::UNORM16x4:
+         return VK_FORMAT_R16G16B16A16_UNORM;
+      case CYD::VertexFormat::SNORM16x4:
+         return VK_FORMAT_R16G16B16A16_SNORM;
+   }
+
+   return VK_FORMAT_R32G32B32_SFLOAT;
+}
+
 VkColorSpaceKHR cydToVkSpace( CYD::ColorSpace space )
 {
    switch( space )
@@ -154,6 +185,8 @@ VkDescriptorType cydToVkDescriptorType( CYD::ShaderResourceType type )
          return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
       case CYD::ShaderResourceType::SAMPLED_IMAGE:
          return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+      case CYD::ShaderResourceType::BINDLESS_TEXTURES:
+         return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
    }
 
    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -24,6 +24,7 @@ namespace vk::TypeConversions
 {
 VkIndexType cydToVkIndexType( CYD::IndexType type );
 VkFormat cydToVkFormat( CYD::PixelFormat format );
+VkFormat cydToVkFormat( CYD::VertexFormat format );
 VkColorSpaceKHR cydToVkSpace( CYD::ColorSpace space );
 VkAttachmentLoadOp cydToVkOp( CYD::LoadOp op );
 VkAttachmentStoreOp cydToVkOp( CYD::StoreOp op );
@@ -40,11 +40,39 @@ bool Window::init( uint32_t width, uint32_t height, const char* title )
    return true;
 }
 
-bool Window::isRunning() const { return !glfwWindowShouldClose( m_glfwWindow ); }
+bool Window::initHeadless( uint32_t width, uint32_t height )
+{
+   m_extent   = { width, height };
+   m_headless = true;
+
+   // Only the surface extensions come from GLFW, none are needed without a surface
+   m_extensions.clear();
+
+#if _DEBUG
+   m_extensions.push_back( VK_EXT_DEBUG_UTILS_EXTENSION_NAME );
+#endif
+
+   printf( "Window: Running headless at %ux%u\n", width, height );
+
+   return true;
+}
+
+bool Window::isRunning() const
+{
+   if( m_headless )
+   {
+      return !m_closed;
+   }
+
+   return !m_closed && !glfwWindowShouldClose( m_glfwWindow );
+}
 
 Window::~Window()
 {
-   glfwDestroyWindow( m_glfwWindow );
-   glfwTerminate();
+   if( !m_headless )
+   {
+      glfwDestroyWindow( m_glfwWindow );
+      glfwTerminate();
+   }
 }
 }
@@ -31,7 +31,15 @@ class Window final
 
    bool init( uint32_t width, uint32_t height, const char* title );
 
+   // No window or surface is created, frames are rendered to offscreen targets
+   bool initHeadless( uint32_t width, uint32_t height );
+
    bool isRunning() const;
+   bool isHeadless() const noexcept { return m_headless; }
+
+   // Headless windows have no close button, they run until closed from code
+   void close() noexcept { m_closed = true; }
+
    const Extent2D& getExtent() const noexcept { return m_extent; }
    GLFWwindow* getGLFWwindow() const noexcept { return m_glfwWindow; }
    std::vector<const char*> getExtensionsFromGLFW() const noexcept { return m_extensions; };
@@ -42,6 +50,9 @@ class Window final
    // Window is the owner of this GLFWwindow
    GLFWwindow* m_glfwWindow = nullptr;
 
+   bool m_headless = false;
+   bool m_closed   = false;
+
    // Dimensions
    Extent2D m_extent = {0, 0};
 };